@@ -1,4 +1,4 @@
 #include <ccc/cc_arena.cch>
 
 cc_atomic_u64 cc_arena_prov_counter = 1;
-
+cc_atomic_size cc_arena_heap_bytes = 0;
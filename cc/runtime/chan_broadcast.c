@@ -0,0 +1,527 @@
+/*
+ * Broadcast (1:N) channels.
+ *
+ * A CC_CHAN_TOPO_1_N channel does not hand each value to one receiver. It
+ * keeps one shared ring of published values plus a cursor per subscription,
+ * and every subscription observes every value published after it subscribed.
+ *
+ *   root CCChan       the handle returned by create/pair: the publisher, and
+ *                     (lazily, on its first recv) a default subscription
+ *   cc_chan_subscribe returns an extra CCChan* subscription handle; free it
+ *                     with cc_chan_free to unsubscribe
+ *
+ * Ring: `cap` (power of two) slots, each with a seqlock stamp. The publisher
+ * writes slot seq & mask as stamp 2*seq+1 -> payload -> 2*seq+2, then
+ * advances `tail`. Readers copy lock-free and re-check the stamp, so a value
+ * overwritten mid-copy is detected instead of torn. A subscription's cursor
+ * is CAS-advanced, so several fibers may share one subscription handle.
+ *
+ * Slow-subscriber policy (CCChanBroadcastPolicy):
+ *   BLOCK       publisher waits until the slowest cursor frees a slot
+ *   DROP_NEW    send returns EAGAIN instead of waiting (CC_CHAN_MODE_DROP_NEW)
+ *   DROP_OLDEST publisher overwrites; lagging cursors skip forward silently
+ *               (default: the spec's "send never blocks on subscribers")
+ *   LAG_ERROR   as DROP_OLDEST, but the lagging subscription's next recv
+ *               returns EOVERFLOW once (count via cc_chan_broadcast_lagged)
+ *
+ * Waiting: receivers park on their own subscription CCChan (recv waiter list /
+ * not_empty), so select and the socket-signal helpers work unchanged. Each
+ * publish runs one wake wave across all subscriptions that have waiters and
+ * flushes the fiber wake batch once. A publisher blocked in BLOCK mode parks
+ * on the root's send waiter list; readers only touch it while
+ * `pub_waiting` is set.
+ *
+ * Lock order: pub_lock -> subs_mu -> CCChan.mu. pub_lock is never held
+ * across a park.
+ */
+
+#include <limits.h>
+
+typedef struct cc__chan_bcast_sub {
+    struct cc__chan_bcast_sub* next;
+    struct cc__chan_bcast_sub* prev;
+    CCChan* ch;                                     /* Handle receivers park on */
+    _Atomic uint64_t cursor __attribute__((aligned(64))); /* Next sequence to read */
+    _Atomic uint64_t lagged;                        /* Values skipped by overwrite */
+    _Atomic int detached;                           /* Closed/unsubscribed: no longer holds back the publisher */
+} cc__chan_bcast_sub;
+
+typedef struct cc__chan_bcast {
+    pthread_mutex_t subs_mu;                        /* Guards subs, refs, root, lazy ring setup */
+    cc__chan_bcast_sub* subs;
+    int refs;                                       /* Root + subscription handles */
+    CCChan* root;
+    size_t cap;                                     /* Ring slots (power of two) */
+    size_t mask;
+    _Atomic size_t elem_size;                       /* 0 until the ring is allocated */
+    _Atomic uint64_t* stamps;
+    unsigned char* data;
+    _Atomic int policy;
+    _Atomic int closed;
+    _Atomic int pub_lock;                           /* Serializes publishers (1:N expects one) */
+    uint64_t min_cursor;                            /* Cached slowest cursor; guarded by pub_lock */
+    _Atomic int pub_waiting;                        /* Publishers parked on a full ring */
+    _Atomic uint64_t progress;                      /* Bumped by readers that free space for a parked publisher */
+    _Atomic uint64_t tail __attribute__((aligned(64))); /* Next sequence to publish */
+} cc__chan_bcast;
+
+static inline uint64_t cc__chan_bcast_stamp(uint64_t seq) { return 2 * seq + 2; }
+
+static cc__chan_bcast* cc__chan_bcast_create(CCChan* root, size_t capacity, CCChanMode mode) {
+    cc__chan_bcast* bc = (cc__chan_bcast*)calloc(1, sizeof(*bc));
+    if (!bc) return NULL;
+    pthread_mutex_init(&bc->subs_mu, NULL);
+    bc->refs = 1;
+    bc->root = root;
+    bc->cap = next_power_of_2(capacity ? capacity : 1);
+    bc->mask = bc->cap - 1;
+    CCChanBroadcastPolicy policy = CC_CHAN_BCAST_DROP_OLDEST;
+    if (mode == CC_CHAN_MODE_DROP_NEW) policy = CC_CHAN_BCAST_DROP_NEW;
+    atomic_init(&bc->policy, (int)policy);
+    return bc;
+}
+
+/* Allocate the shared ring on first use of an element size (init_elem or the
+ * first send/recv). Every handle must agree on the element size. */
+static int cc__chan_bcast_ensure(CCChan* ch, size_t elem_size) {
+    cc__chan_bcast* bc = ch->bcast;
+    size_t have = atomic_load_explicit(&bc->elem_size, memory_order_acquire);
+    if (have == 0) {
+        pthread_mutex_lock(&bc->subs_mu);
+        have = atomic_load_explicit(&bc->elem_size, memory_order_relaxed);
+        if (have == 0) {
+            bc->stamps = (_Atomic uint64_t*)calloc(bc->cap, sizeof(*bc->stamps));
+            bc->data = (unsigned char*)malloc(bc->cap * elem_size);
+            if (!bc->stamps || !bc->data) {
+                free((void*)bc->stamps);
+                free(bc->data);
+                bc->stamps = NULL;
+                bc->data = NULL;
+                pthread_mutex_unlock(&bc->subs_mu);
+                return ENOMEM;
+            }
+            atomic_store_explicit(&bc->elem_size, elem_size, memory_order_release);
+            have = elem_size;
+        }
+        pthread_mutex_unlock(&bc->subs_mu);
+    }
+    if (have != elem_size) return EINVAL;
+    ch->elem_size = elem_size;
+    return 0;
+}
+
+/* Link a new subscription starting at the current tail (must hold subs_mu). */
+static cc__chan_bcast_sub* cc__chan_bcast_link_sub_locked(cc__chan_bcast* bc, CCChan* ch) {
+    cc__chan_bcast_sub* s = (cc__chan_bcast_sub*)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->ch = ch;
+    atomic_init(&s->cursor, atomic_load_explicit(&bc->tail, memory_order_acquire));
+    s->next = bc->subs;
+    if (bc->subs) bc->subs->prev = s;
+    bc->subs = s;
+    return s;
+}
+
+static void cc__chan_bcast_unlink_sub_locked(cc__chan_bcast* bc, cc__chan_bcast_sub* s) {
+    if (s->prev) s->prev->next = s->next;
+    else bc->subs = s->next;
+    if (s->next) s->next->prev = s->prev;
+    free(s);
+}
+
+/* The root's default subscription is created on its first recv so a
+ * publisher that never reads its own handle does not hold the ring. */
+static cc__chan_bcast_sub* cc__chan_bcast_sub_of(CCChan* ch) {
+    cc__chan_bcast_sub* s = atomic_load_explicit(&ch->bcast_sub, memory_order_acquire);
+    if (s) return s;
+    cc__chan_bcast* bc = ch->bcast;
+    pthread_mutex_lock(&bc->subs_mu);
+    s = atomic_load_explicit(&ch->bcast_sub, memory_order_relaxed);
+    if (!s) {
+        s = cc__chan_bcast_link_sub_locked(bc, ch);
+        if (s) atomic_store_explicit(&ch->bcast_sub, s, memory_order_release);
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    return s;
+}
+
+/* Slowest live cursor, or `tail` when nobody is subscribed. */
+static uint64_t cc__chan_bcast_min_cursor(cc__chan_bcast* bc, uint64_t tail) {
+    uint64_t min = tail;
+    pthread_mutex_lock(&bc->subs_mu);
+    for (cc__chan_bcast_sub* s = bc->subs; s; s = s->next) {
+        if (atomic_load_explicit(&s->detached, memory_order_acquire)) continue;
+        uint64_t c = atomic_load_explicit(&s->cursor, memory_order_seq_cst);
+        if (c < min) min = c;
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    return min;
+}
+
+static inline void cc__chan_bcast_pub_lock(cc__chan_bcast* bc) {
+    for (;;) {
+        if (!atomic_exchange_explicit(&bc->pub_lock, 1, memory_order_acquire)) return;
+        while (atomic_load_explicit(&bc->pub_lock, memory_order_relaxed)) {
+            cc__chan_spin_hint();
+        }
+    }
+}
+
+static inline void cc__chan_bcast_pub_unlock(cc__chan_bcast* bc) {
+    atomic_store_explicit(&bc->pub_lock, 0, memory_order_release);
+}
+
+/* Wake wave: signal every recv waiter on every subscription that has one,
+ * then flush the fiber wake batch once. */
+static void cc__chan_bcast_wake_subscribers(cc__chan_bcast* bc) {
+    /* Dekker pair with cc__chan_bcast_arm_recv_waiter: tail store above,
+     * waiter-count loads below. */
+    atomic_thread_fence(memory_order_seq_cst);
+    int woke = 0;
+    pthread_mutex_lock(&bc->subs_mu);
+    for (cc__chan_bcast_sub* s = bc->subs; s; s = s->next) {
+        CCChan* sc = s->ch;
+        if (sc->recv_signal) cc_socket_signal_signal(sc->recv_signal);
+        int fiber_waiters = atomic_load_explicit(&sc->has_recv_waiters, memory_order_relaxed);
+        int thread_waiters = atomic_load_explicit(&sc->thread_recv_waiters, memory_order_relaxed);
+        if (!fiber_waiters && !thread_waiters) continue;
+        cc_chan_lock(sc);
+        if (fiber_waiters) woke += cc__chan_signal_recv_waiters(sc, INT_MAX);
+        if (thread_waiters) pthread_cond_broadcast(&sc->not_empty);
+        cc_chan_unlock(sc);
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    if (woke) wake_batch_flush();
+}
+
+/* A reader advanced its cursor while a publisher is parked on a full ring. */
+static void cc__chan_bcast_wake_publisher(cc__chan_bcast* bc) {
+    atomic_fetch_add_explicit(&bc->progress, 1, memory_order_seq_cst);
+    pthread_mutex_lock(&bc->subs_mu);
+    CCChan* root = bc->root;
+    if (root) {
+        cc_chan_lock(root);
+        cc__chan_wake_one_send_waiter(root);
+        pthread_cond_broadcast(&root->not_full);
+        cc_chan_unlock(root);
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    wake_batch_flush();
+}
+
+static inline int cc__chan_bcast_readable(CCChan* ch, cc__chan_bcast_sub* s) {
+    cc__chan_bcast* bc = ch->bcast;
+    return atomic_load_explicit(&s->detached, memory_order_acquire) ||
+           atomic_load_explicit(&bc->closed, memory_order_acquire) ||
+           atomic_load_explicit(&s->cursor, memory_order_seq_cst) !=
+               atomic_load_explicit(&bc->tail, memory_order_seq_cst);
+}
+
+/* Called by cc__chan_add_recv_waiter (holding ch->mu) for subscription
+ * handles: covers the try-then-publish-waiter gap for select and recv by
+ * signaling the new node immediately if a value is already readable. */
+static void cc__chan_bcast_arm_recv_waiter(CCChan* ch) {
+    /* No lazy creation here: ch->mu is held and subs_mu ranks above it. The
+     * try_recv that precedes every park has already created the cursor. */
+    cc__chan_bcast_sub* s = atomic_load_explicit(&ch->bcast_sub, memory_order_acquire);
+    if (!s) return;
+    atomic_thread_fence(memory_order_seq_cst);
+    if (cc__chan_bcast_readable(ch, s)) {
+        (void)cc__chan_signal_recv_waiters(ch, INT_MAX);
+    }
+}
+
+static inline int cc__chan_bcast_close_errno(CCChan* ch) {
+    return ch->tx_error_code ? ch->tx_error_code : EPIPE;
+}
+
+/* One non-blocking read attempt. Returns 0, EAGAIN, EOVERFLOW (LAG_ERROR
+ * skip), or the close errno once the subscription is drained. */
+static int cc__chan_bcast_try_read(CCChan* ch, void* out_value) {
+    cc__chan_bcast* bc = ch->bcast;
+    cc__chan_bcast_sub* s = cc__chan_bcast_sub_of(ch);
+    if (!s) return ENOMEM;
+    if (atomic_load_explicit(&s->detached, memory_order_acquire)) return cc__chan_bcast_close_errno(ch);
+    size_t es = atomic_load_explicit(&bc->elem_size, memory_order_acquire);
+    for (;;) {
+        uint64_t c = atomic_load_explicit(&s->cursor, memory_order_acquire);
+        uint64_t t = atomic_load_explicit(&bc->tail, memory_order_acquire);
+        if (c == t) {
+            if (!atomic_load_explicit(&bc->closed, memory_order_acquire)) return EAGAIN;
+            /* Close is stored after the final publish; re-read tail to drain. */
+            if (atomic_load_explicit(&bc->tail, memory_order_acquire) != c) continue;
+            return cc__chan_bcast_close_errno(ch);
+        }
+        if (t - c > bc->cap) {
+            uint64_t oldest = t - bc->cap;
+            if (!atomic_compare_exchange_weak(&s->cursor, &c, oldest)) continue;
+            atomic_fetch_add_explicit(&s->lagged, oldest - c, memory_order_relaxed);
+            if (atomic_load_explicit(&bc->policy, memory_order_relaxed) == CC_CHAN_BCAST_LAG_ERROR) {
+                return EOVERFLOW;
+            }
+            continue;
+        }
+        size_t i = (size_t)(c & bc->mask);
+        uint64_t want = cc__chan_bcast_stamp(c);
+        uint64_t s1 = atomic_load_explicit(&bc->stamps[i], memory_order_acquire);
+        if (s1 != want) {
+            /* Slot already rewritten for a later lap (we lag) or mid-write. */
+            cc__chan_spin_hint();
+            continue;
+        }
+        memcpy(out_value, bc->data + i * es, es);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&bc->stamps[i], memory_order_relaxed) != s1) continue;
+        if (!atomic_compare_exchange_strong(&s->cursor, &c, c + 1)) continue;
+        /* A parked publisher stopped at tail; only the slowest cursor (a full
+         * ring behind it) can free the slot it is waiting for. */
+        if (atomic_load_explicit(&bc->pub_waiting, memory_order_seq_cst) &&
+            atomic_load_explicit(&bc->tail, memory_order_seq_cst) - c >= bc->cap) {
+            cc__chan_bcast_wake_publisher(bc);
+        }
+        return 0;
+    }
+}
+
+/* Park until the subscription is readable (fiber or thread). */
+static int cc__chan_bcast_wait_readable(CCChan* ch, const struct timespec* deadline) {
+    cc__chan_bcast_sub* s = cc__chan_bcast_sub_of(ch);
+    if (!s) return ENOMEM;
+    cc__fiber* fiber = cc__fiber_in_context() ? cc__fiber_current() : NULL;
+    cc_chan_lock(ch);
+    if (fiber) {
+        cc__fiber_wait_node node = {0};
+        node.fiber = fiber;
+        atomic_store(&node.notified, 0);
+        /* add_recv_waiter re-checks readability and self-signals the node. */
+        cc__chan_add_recv_waiter(ch, &node);
+        cc_chan_unlock(ch);
+        wake_batch_flush();
+        cc_sched_wait_result wait_rc = cc__chan_wait_notified_mark_close(&node, deadline, "chan_bcast_recv_wait", ch);
+        cc_chan_lock(ch);
+        cc__chan_remove_recv_waiter(ch, &node);
+        cc_chan_unlock(ch);
+        return wait_rc == CC_SCHED_WAIT_TIMEOUT ? ETIMEDOUT : 0;
+    }
+    int err = 0;
+    cc__chan_thread_recv_waiter_inc(ch);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!cc__chan_bcast_readable(ch, s) && err == 0) {
+        if (deadline) {
+            err = pthread_cond_timedwait(&ch->not_empty, &ch->mu, deadline);
+        } else {
+            pthread_cond_wait(&ch->not_empty, &ch->mu);
+        }
+    }
+    cc__chan_thread_recv_waiter_dec(ch);
+    cc_chan_unlock(ch);
+    return err == ETIMEDOUT ? ETIMEDOUT : 0;
+}
+
+static int cc__chan_bcast_recv(CCChan* ch, void* out_value, size_t value_size,
+                               const struct timespec* deadline, int try_only) {
+    int rc = cc__chan_bcast_ensure(ch, value_size);
+    if (rc != 0) return rc;
+    for (;;) {
+        rc = cc__chan_bcast_try_read(ch, out_value);
+        if (rc != EAGAIN || try_only) return rc;
+        rc = cc__chan_bcast_wait_readable(ch, deadline);
+        if (rc != 0) {
+            /* Close/data wins over timeout once observed. */
+            int last = cc__chan_bcast_try_read(ch, out_value);
+            return last == EAGAIN ? rc : last;
+        }
+    }
+}
+
+/* Park the publisher until some reader frees a slot (progress moves), the
+ * channel closes, or the deadline passes. */
+static int cc__chan_bcast_wait_space(cc__chan_bcast* bc, uint64_t seq, const struct timespec* deadline) {
+    CCChan* root = bc->root;
+    uint64_t gen = atomic_load_explicit(&bc->progress, memory_order_seq_cst);
+    atomic_fetch_add_explicit(&bc->pub_waiting, 1, memory_order_seq_cst);
+    int rc = 0;
+    if (seq - cc__chan_bcast_min_cursor(bc, seq) < bc->cap) goto out;
+    cc__fiber* fiber = cc__fiber_in_context() ? cc__fiber_current() : NULL;
+    cc_chan_lock(root);
+    if (fiber) {
+        if (atomic_load_explicit(&bc->progress, memory_order_seq_cst) != gen || root->closed) {
+            cc_chan_unlock(root);
+            goto out;
+        }
+        cc__fiber_wait_node node = {0};
+        node.fiber = fiber;
+        atomic_store(&node.notified, 0);
+        cc__chan_add_send_waiter(root, &node);
+        cc_chan_unlock(root);
+        cc_sched_wait_result wait_rc = cc__chan_wait_notified_mark_close(&node, deadline, "chan_bcast_send_wait", root);
+        cc_chan_lock(root);
+        cc__chan_remove_send_waiter(root, &node);
+        cc_chan_unlock(root);
+        if (wait_rc == CC_SCHED_WAIT_TIMEOUT) rc = ETIMEDOUT;
+        goto out;
+    }
+    while (atomic_load_explicit(&bc->progress, memory_order_seq_cst) == gen && !root->closed) {
+        if (deadline) {
+            if (pthread_cond_timedwait(&root->not_full, &root->mu, deadline) == ETIMEDOUT) {
+                rc = ETIMEDOUT;
+                break;
+            }
+        } else {
+            pthread_cond_wait(&root->not_full, &root->mu);
+        }
+    }
+    cc_chan_unlock(root);
+out:
+    atomic_fetch_sub_explicit(&bc->pub_waiting, 1, memory_order_seq_cst);
+    return rc;
+}
+
+static int cc__chan_bcast_send(CCChan* ch, const void* value, size_t value_size,
+                               const struct timespec* deadline, int try_only) {
+    cc__chan_bcast* bc = ch->bcast;
+    /* Subscription handles are receive-only. */
+    if (ch != bc->root) return EINVAL;
+    int rc = cc__chan_bcast_ensure(ch, value_size);
+    if (rc != 0) return rc;
+    for (;;) {
+        if (ch->closed) return cc__chan_send_close_errno(ch);
+        if (ch->rx_error_closed) return ch->rx_error_code;
+        cc__chan_bcast_pub_lock(bc);
+        uint64_t seq = atomic_load_explicit(&bc->tail, memory_order_relaxed);
+        int policy = atomic_load_explicit(&bc->policy, memory_order_relaxed);
+        if (policy == CC_CHAN_BCAST_BLOCK || policy == CC_CHAN_BCAST_DROP_NEW) {
+            /* Only rescan subscriptions when the cached minimum says full. */
+            if (seq - bc->min_cursor >= bc->cap) bc->min_cursor = cc__chan_bcast_min_cursor(bc, seq);
+            if (seq - bc->min_cursor >= bc->cap) {
+                cc__chan_bcast_pub_unlock(bc);
+                if (policy == CC_CHAN_BCAST_DROP_NEW || try_only) return EAGAIN;
+                rc = cc__chan_bcast_wait_space(bc, seq, deadline);
+                if (rc != 0) return rc;
+                continue;
+            }
+        }
+        size_t i = (size_t)(seq & bc->mask);
+        atomic_store_explicit(&bc->stamps[i], 2 * seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        memcpy(bc->data + i * value_size, value, value_size);
+        atomic_store_explicit(&bc->stamps[i], cc__chan_bcast_stamp(seq), memory_order_release);
+        atomic_store_explicit(&bc->tail, seq + 1, memory_order_seq_cst);
+        cc__chan_bcast_pub_unlock(bc);
+        cc__chan_bcast_wake_subscribers(bc);
+        return 0;
+    }
+}
+
+/* Close hook, run after cc__chan_close_common updated and woke `ch` itself.
+ * Closing the root closes the broadcast for every subscription (each drains
+ * what it has not read yet); closing a subscription only detaches it. */
+static void cc__chan_bcast_after_close(CCChan* ch, bool close_tx) {
+    cc__chan_bcast* bc = ch->bcast;
+    if (ch != bc->root) {
+        cc__chan_bcast_sub* s = atomic_load_explicit(&ch->bcast_sub, memory_order_acquire);
+        if (s) atomic_store_explicit(&s->detached, 1, memory_order_seq_cst);
+        if (atomic_load_explicit(&bc->pub_waiting, memory_order_seq_cst)) cc__chan_bcast_wake_publisher(bc);
+        return;
+    }
+    if (!close_tx) return;
+    pthread_mutex_lock(&bc->subs_mu);
+    /* Stamp the close error on every subscription before publishing
+     * `closed`, so a reader that drains and sees it reports the right errno. */
+    for (cc__chan_bcast_sub* s = bc->subs; s; s = s->next) {
+        CCChan* sc = s->ch;
+        if (sc == ch) continue;
+        cc_chan_lock(sc);
+        sc->closed = 1;
+        sc->tx_error_code = ch->tx_error_code;
+        sc->tx_io_error = ch->tx_io_error;
+        sc->tx_io_error_set = ch->tx_io_error_set;
+        cc_chan_unlock(sc);
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    /* Order `closed` after any in-flight publish. */
+    cc__chan_bcast_pub_lock(bc);
+    atomic_store_explicit(&bc->closed, 1, memory_order_seq_cst);
+    cc__chan_bcast_pub_unlock(bc);
+    pthread_mutex_lock(&bc->subs_mu);
+    for (cc__chan_bcast_sub* s = bc->subs; s; s = s->next) {
+        CCChan* sc = s->ch;
+        if (sc == ch) continue;
+        cc_chan_lock(sc);
+        pthread_cond_broadcast(&sc->not_empty);
+        cc__chan_wake_all_waiters(sc);
+        cc_chan_unlock(sc);
+        if (sc->recv_signal) cc_socket_signal_signal(sc->recv_signal);
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    wake_batch_flush();
+}
+
+/* Free hook: drop this handle's subscription and its reference on the
+ * shared ring. Freeing the root closes the broadcast first. */
+static void cc__chan_bcast_release(CCChan* ch) {
+    cc__chan_bcast* bc = ch->bcast;
+    if (ch == bc->root && !atomic_load_explicit(&bc->closed, memory_order_acquire)) {
+        cc_chan_close(ch);
+    }
+    pthread_mutex_lock(&bc->subs_mu);
+    cc__chan_bcast_sub* s = atomic_load_explicit(&ch->bcast_sub, memory_order_relaxed);
+    if (s) cc__chan_bcast_unlink_sub_locked(bc, s);
+    atomic_store_explicit(&ch->bcast_sub, NULL, memory_order_relaxed);
+    if (ch == bc->root) bc->root = NULL;
+    int last = (--bc->refs == 0);
+    int wake = !last && atomic_load_explicit(&bc->pub_waiting, memory_order_seq_cst);
+    pthread_mutex_unlock(&bc->subs_mu);
+    ch->bcast = NULL;
+    if (wake) cc__chan_bcast_wake_publisher(bc);
+    if (!last) return;
+    pthread_mutex_destroy(&bc->subs_mu);
+    free((void*)bc->stamps);
+    free(bc->data);
+    free(bc);
+}
+
+CCChan* cc_chan_subscribe(CCChan* ch) {
+    if (!ch || !ch->bcast) return NULL;
+    cc__chan_bcast* bc = ch->bcast;
+    CCChan* sub = cc_chan_create_internal(0, ch->mode, false, ch->is_sync, CC_CHAN_TOPO_DEFAULT);
+    if (!sub) return NULL;
+    sub->topology = CC_CHAN_TOPO_1_N;
+    sub->is_ordered = ch->is_ordered;
+    sub->bcast = bc;
+    sub->elem_size = atomic_load_explicit(&bc->elem_size, memory_order_acquire);
+    pthread_mutex_lock(&bc->subs_mu);
+    cc__chan_bcast_sub* s = cc__chan_bcast_link_sub_locked(bc, sub);
+    if (!s) {
+        pthread_mutex_unlock(&bc->subs_mu);
+        sub->bcast = NULL;
+        cc_chan_free(sub);
+        return NULL;
+    }
+    atomic_store_explicit(&sub->bcast_sub, s, memory_order_release);
+    bc->refs++;
+    if (atomic_load_explicit(&bc->closed, memory_order_acquire) && bc->root) {
+        sub->closed = 1;
+        sub->tx_error_code = bc->root->tx_error_code;
+        sub->tx_io_error = bc->root->tx_io_error;
+        sub->tx_io_error_set = bc->root->tx_io_error_set;
+    }
+    pthread_mutex_unlock(&bc->subs_mu);
+    return sub;
+}
+
+int cc_chan_broadcast_set_policy(CCChan* ch, CCChanBroadcastPolicy policy) {
+    if (!ch || !ch->bcast) return EINVAL;
+    if (policy < CC_CHAN_BCAST_BLOCK || policy > CC_CHAN_BCAST_LAG_ERROR) return EINVAL;
+    cc__chan_bcast* bc = ch->bcast;
+    atomic_store_explicit(&bc->policy, (int)policy, memory_order_relaxed);
+    /* A publisher parked under BLOCK must re-evaluate under the new policy. */
+    if (atomic_load_explicit(&bc->pub_waiting, memory_order_seq_cst)) cc__chan_bcast_wake_publisher(bc);
+    return 0;
+}
+
+uint64_t cc_chan_broadcast_lagged(CCChan* ch) {
+    if (!ch || !ch->bcast) return 0;
+    cc__chan_bcast_sub* s = atomic_load_explicit(&ch->bcast_sub, memory_order_acquire);
+    return s ? atomic_load_explicit(&s->lagged, memory_order_relaxed) : 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Select watchers and compiled select sets.
+ *
+ * The node-based select in cc_chan_match_deadline links one wait node into
+ * every case's waiter list, which costs each case's ch->mu three times per
+ * park (link, wake parked peers, unlink) and makes a 16-way select contend
+ * with every producer on all 16 channels. A receive case on a buffered
+ * channel does not need any of that: nothing is handed off directly, the
+ * select only has to learn that a value became visible. So it watches:
+ *
+ *   token   CCChanSelectSet.armed, the waiting fiber's "selection won"
+ *           flag. The waiter sets it before parking; the first producer to
+ *           exchange it back to 0 owns the wake, later ones see 0 and move
+ *           on. The winner's case index seeds the next try pass.
+ *   watch   a cc__chan_select_watch on the channel's watch list. The list
+ *           has its own spinlock (never ch->mu), held only to link/unlink
+ *           and while a producer walks it.
+ *   armed   CCChan.select_watch_armed counts armed watches. Producers load
+ *           it after the seq_cst fence they already issue for parked
+ *           receivers; the waiter bumps it, fences, then re-tries, so a
+ *           value enqueued concurrently is either seen by the re-try or
+ *           fires the token.
+ *
+ * Every path that makes a buffered channel readable — close included — ends
+ * in cc__chan_signal_recv_ready() or the lock-free early-outs next to the
+ * ch->recv_signal pokes, which are the fire points: watchers see exactly
+ * what socket-signal consumers see.
+ *
+ * A compiled set (cc_chan_select_set_create) links its watches once and
+ * leaves them linked, so each wait is a try pass, one atomic add per case
+ * to arm, a re-try, the park, and one atomic sub per case to disarm. A
+ * one-shot cc_chan_match_deadline() over receive cases builds the same set
+ * on its stack. Send cases, unbuffered, broadcast, pool and ordered
+ * channels, and non-fiber callers keep the node-based path.
+ *
+ * Lock order: select_watch_lock is a leaf; it is never held across ch->mu
+ * or a park.
+ */
+
+typedef struct cc__chan_select_watch {
+    struct cc__chan_select_watch* next;
+    struct cc__chan_select_watch* prev;
+    struct CCChanSelectSet* set;
+    CCChan* ch;
+    size_t index;                                   /* Case index in set->cases */
+} cc__chan_select_watch;
+
+struct CCChanSelectSet {
+    CCChanMatchCase* cases;
+    size_t n;
+    size_t rr;                                      /* Next try-pass start */
+    int watched;                                    /* Watches linked: lock-free wait */
+    cc__fiber* fiber;                               /* Waiter, valid while armed */
+    _Atomic int armed;                              /* 1 while parked-or-parking */
+    _Atomic int fired;                              /* Case that fired the token, -1 none */
+    cc__chan_select_watch* watches;                 /* One per case (unused for NULL ch) */
+};
+
+static inline void cc__chan_select_watch_lock(CCChan* ch) {
+    while (atomic_exchange_explicit(&ch->select_watch_lock, 1, memory_order_acquire)) {
+        while (atomic_load_explicit(&ch->select_watch_lock, memory_order_relaxed)) {
+            cc__chan_spin_hint();
+        }
+    }
+}
+
+static inline void cc__chan_select_watch_unlock(CCChan* ch) {
+    atomic_store_explicit(&ch->select_watch_lock, 0, memory_order_release);
+}
+
+static void cc__chan_select_watch_fire(CCChan* ch) {
+    int woke = 0;
+    cc__chan_select_watch_lock(ch);
+    for (cc__chan_select_watch* w = ch->select_watch_head; w; w = w->next) {
+        struct CCChanSelectSet* set = w->set;
+        if (atomic_load_explicit(&set->armed, memory_order_relaxed) == 0) continue;
+        if (atomic_exchange_explicit(&set->armed, 0, memory_order_acq_rel) == 0) continue;
+        atomic_store_explicit(&set->fired, (int)w->index, memory_order_relaxed);
+        wake_batch_add(set->fiber);
+        woke = 1;
+    }
+    /* The waiter unlinks (and may free the set) only under this lock, so
+     * set->fiber stayed valid for the wake_batch_add above. */
+    cc__chan_select_watch_unlock(ch);
+    if (woke) wake_batch_flush();
+}
+
+static int cc__chan_select_watchable(const CCChanMatchCase* cases, size_t n) {
+    size_t live = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const CCChanMatchCase* c = &cases[i];
+        if (!c->ch || c->elem_size == 0) continue;
+        if (c->is_send || c->ch->cap == 0 || c->ch->bcast || c->ch->is_owned || c->ch->is_ordered) {
+            return 0;
+        }
+        live++;
+    }
+    return live != 0;
+}
+
+static void cc__chan_select_set_link(struct CCChanSelectSet* set) {
+    for (size_t i = 0; i < set->n; ++i) {
+        CCChanMatchCase* c = &set->cases[i];
+        cc__chan_select_watch* w = &set->watches[i];
+        w->set = set;
+        w->index = i;
+        w->ch = (c->ch && c->elem_size) ? c->ch : NULL;
+        w->prev = NULL;
+        w->next = NULL;
+        if (!w->ch) continue;
+        cc__chan_select_watch_lock(w->ch);
+        w->next = w->ch->select_watch_head;
+        if (w->next) w->next->prev = w;
+        w->ch->select_watch_head = w;
+        cc__chan_select_watch_unlock(w->ch);
+    }
+}
+
+static void cc__chan_select_set_unlink(struct CCChanSelectSet* set) {
+    for (size_t i = 0; i < set->n; ++i) {
+        cc__chan_select_watch* w = &set->watches[i];
+        if (!w->ch) continue;
+        cc__chan_select_watch_lock(w->ch);
+        if (w->prev) w->prev->next = w->next;
+        else w->ch->select_watch_head = w->next;
+        if (w->next) w->next->prev = w->prev;
+        cc__chan_select_watch_unlock(w->ch);
+        w->next = w->prev = NULL;
+    }
+}
+
+static void cc__chan_select_set_arm(struct CCChanSelectSet* set, int delta) {
+    for (size_t i = 0; i < set->n; ++i) {
+        CCChan* ch = set->watches[i].ch;
+        if (ch) atomic_fetch_add_explicit(&ch->select_watch_armed, delta, memory_order_seq_cst);
+    }
+}
+
+/* Try pass, then arm -> re-try -> park until a watched channel fires the
+ * token, the deadline passes, or a case resolves. Caller owns linking. */
+static int cc__chan_select_set_park(struct CCChanSelectSet* set, size_t* ready_index,
+                                    const struct timespec* deadline) {
+    size_t n = set->n;
+    cc__fiber* fiber = cc__fiber_current();
+    while (1) {
+        int rc = cc__chan_match_try_from(set->cases, n, ready_index, set->rr % n);
+        if (rc == EAGAIN) {
+            if (deadline) {
+                struct timespec now;
+                clock_gettime(CLOCK_REALTIME, &now);
+                if (now.tv_sec > deadline->tv_sec ||
+                    (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec)) {
+                    return ETIMEDOUT;
+                }
+            }
+            set->fiber = fiber;
+            atomic_store_explicit(&set->fired, -1, memory_order_relaxed);
+            atomic_store_explicit(&set->armed, 1, memory_order_relaxed);
+            cc__chan_select_set_arm(set, 1);
+            atomic_thread_fence(memory_order_seq_cst);
+            rc = cc__chan_match_try_from(set->cases, n, ready_index, set->rr % n);
+            if (rc == EAGAIN) {
+                cc__fiber_clear_pending_unpark();
+                if (deadline) {
+                    (void)CC_FIBER_PARK_IF_UNTIL(&set->armed, 1, deadline, "chan_select: watching");
+                } else {
+                    CC_FIBER_PARK_IF(&set->armed, 1, "chan_select: watching");
+                }
+            }
+            atomic_store_explicit(&set->armed, 0, memory_order_relaxed);
+            cc__chan_select_set_arm(set, -1);
+            if (rc == EAGAIN) {
+                /* Start the next pass at the case that fired. */
+                int fired = atomic_load_explicit(&set->fired, memory_order_relaxed);
+                if (fired >= 0) set->rr = (size_t)fired;
+                continue;
+            }
+        }
+        /* Rotate past the winner so one busy channel cannot starve the rest. */
+        if (rc == 0 || rc == EPIPE) set->rr = *ready_index + 1;
+        return rc;
+    }
+}
+
+static int cc__chan_select_watch_wait(CCChanMatchCase* cases, size_t n, size_t* ready_index,
+                                      const struct timespec* deadline, size_t start) {
+    cc__chan_select_watch watches[n];
+    struct CCChanSelectSet set = {
+        .cases = cases,
+        .n = n,
+        .rr = start,
+        .watched = 1,
+        .watches = watches,
+    };
+    cc__chan_select_set_link(&set);
+    int rc = cc__chan_select_set_park(&set, ready_index, deadline);
+    cc__chan_select_set_unlink(&set);
+    return rc;
+}
+
+CCChanSelectSet* cc_chan_select_set_create(const CCChanMatchCase* cases, size_t n) {
+    if (!cases || n == 0) return NULL;
+    CCChanSelectSet* set = (CCChanSelectSet*)calloc(1, sizeof(*set));
+    if (!set) return NULL;
+    set->cases = (CCChanMatchCase*)malloc(n * sizeof(*cases));
+    set->watches = (cc__chan_select_watch*)calloc(n, sizeof(*set->watches));
+    if (!set->cases || !set->watches) {
+        free(set->cases);
+        free(set->watches);
+        free(set);
+        return NULL;
+    }
+    memcpy(set->cases, cases, n * sizeof(*cases));
+    set->n = n;
+    atomic_store_explicit(&set->fired, -1, memory_order_relaxed);
+    set->watched = cc__chan_select_watchable(set->cases, n);
+    if (set->watched) cc__chan_select_set_link(set);
+    return set;
+}
+
+int cc_chan_select_set_wait(CCChanSelectSet* set, size_t* ready_index, const CCDeadline* deadline) {
+    if (!set || !ready_index) return EINVAL;
+    if (!set->watched || !cc__fiber_in_context()) {
+        return cc_chan_match_deadline(set->cases, set->n, ready_index, deadline);
+    }
+    struct timespec ts;
+    const struct timespec* p = cc_deadline_as_timespec(deadline, &ts);
+    return cc__chan_select_set_park(set, ready_index, p);
+}
+
+void cc_chan_select_set_free(CCChanSelectSet* set) {
+    if (!set) return;
+    if (set->watched) cc__chan_select_set_unlink(set);
+    free(set->watches);
+    free(set->cases);
+    free(set);
+}
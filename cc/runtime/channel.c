@@ -154,6 +154,24 @@ static inline void cc__chan_post_dequeue_notify(CCChan* ch, int mu_held);
 static inline void cc__chan_dekker_wake_recv_before_park(CCChan* ch);
 static inline void cc__chan_dekker_wake_send_before_park(CCChan* ch);
 
+/* Broadcast channels (chan_broadcast.c, same TU) */
+struct cc__chan_bcast;
+static struct cc__chan_bcast* cc__chan_bcast_create(CCChan* root, size_t capacity, CCChanMode mode);
+static int cc__chan_bcast_ensure(CCChan* ch, size_t elem_size);
+static int cc__chan_bcast_send(CCChan* ch, const void* value, size_t value_size,
+                               const struct timespec* deadline, int try_only);
+static int cc__chan_bcast_recv(CCChan* ch, void* out_value, size_t value_size,
+                               const struct timespec* deadline, int try_only);
+static void cc__chan_bcast_arm_recv_waiter(CCChan* ch);
+static void cc__chan_bcast_after_close(CCChan* ch, bool close_tx);
+static void cc__chan_bcast_release(CCChan* ch);
+/* Select watchers and compiled select sets: see chan_select_set.c. */
+struct cc__chan_select_watch;
+static void cc__chan_select_watch_fire(CCChan* ch);
+static int cc__chan_select_watchable(const CCChanMatchCase* cases, size_t n);
+static int cc__chan_select_watch_wait(CCChanMatchCase* cases, size_t n, size_t* ready_index,
+                                      const struct timespec* deadline, size_t start);
+
 /* Add a fiber to the wake batch */
 static inline void wake_batch_add(cc__fiber* f) {
     if (!f) return;
@@ -657,6 +675,17 @@ struct CCChan {
     _Atomic size_t slot_counter;                    /* Per-channel slot counter for large elements */
     CCSocketSignal* recv_signal;                    /* If set, signaled when recv may make progress */
 
+    /* Broadcast (CC_CHAN_TOPO_1_N) support: see chan_broadcast.c */
+    struct cc__chan_bcast* bcast;                   /* Shared ring; NULL for ordinary channels */
+    _Atomic(struct cc__chan_bcast_sub*) bcast_sub;  /* This handle's cursor (lazy on the root) */
+
+    /* Select watchers (see chan_select_set.c): linked under select_watch_lock,
+     * never ch->mu. Producers walk the list only while select_watch_armed
+     * (number of armed watches) is non-zero. */
+    struct cc__chan_select_watch* select_watch_head;
+    _Atomic int select_watch_lock;
+    _Atomic int select_watch_armed;
+
 
 };
 
@@ -1101,6 +1130,9 @@ static void cc__chan_add_recv_waiter(CCChan* ch, cc__fiber_wait_node* node) {
     }
     cc__chan_trace_recv_empty(ch, "recv_add", node,
                               atomic_load_explicit(&node->notified, memory_order_relaxed));
+    if (__builtin_expect(ch->bcast != NULL, 0)) {
+        cc__chan_bcast_arm_recv_waiter(ch);
+    }
 }
 
 /* Remove a fiber from a wait queue (must hold ch->mu) */
@@ -1567,10 +1599,26 @@ static void cc__chan_signal_activity(CCChan* ch) {
     cc__chan_broadcast_activity();
 }
 
+/* Fire armed select watchers: ch just became readable (or closed).
+ * _fenced: the caller already issued the seq_cst fence that orders its
+ * enqueue before this load; the watching select arms, fences, then re-tries,
+ * so one side always sees the other. */
+static inline void cc__chan_select_watch_recv_ready_fenced(CCChan* ch) {
+    if (__builtin_expect(atomic_load_explicit(&ch->select_watch_armed, memory_order_relaxed) != 0, 0)) {
+        cc__chan_select_watch_fire(ch);
+    }
+}
+
 static void cc__chan_signal_recv_ready(CCChan* ch) {
     if (ch && ch->recv_signal) {
         cc_socket_signal_signal(ch->recv_signal);
     }
+    /* Unbuffered channels are never watched (see chan_select_set.c), so the
+     * rendezvous path skips the fence. */
+    if (ch && ch->cap != 0) {
+        atomic_thread_fence(memory_order_seq_cst);
+        cc__chan_select_watch_recv_ready_fenced(ch);
+    }
     cc__chan_broadcast_activity();
 }
 
@@ -1616,9 +1664,11 @@ static inline void cc__chan_post_lockfree_enqueue_signal_receivers(CCChan* ch,
     if (fiber_waiters == 0 && thread_waiters == 0) {
         /* No fiber/thread receivers parked.  Still need to poke the socket
          * signal if one is registered (used by wait_recv_or_socket consumers
-         * like handle_client) so the pipe-based waiter wakes up. */
+         * like handle_client) so the pipe-based waiter wakes up, and any
+         * select watching this channel. */
         if (ch->recv_signal)
             cc_socket_signal_signal(ch->recv_signal);
+        cc__chan_select_watch_recv_ready_fenced(ch);
         return;
     }
     /* Wake coalescing: when fiber-only receivers are parked and our wake
@@ -1634,6 +1684,7 @@ static inline void cc__chan_post_lockfree_enqueue_signal_receivers(CCChan* ch,
         if (inflight >= target) {
             if (ch->recv_signal)
                 cc_socket_signal_signal(ch->recv_signal);
+            cc__chan_select_watch_recv_ready_fenced(ch);
             (void)trace_event; /* no lock taken => no tracing event emitted */
             return;
         }
@@ -1718,6 +1769,18 @@ static CCChan* cc_chan_create_internal(size_t capacity, CCChanMode mode, bool al
     atomic_store(&ch->lfqueue_count, 0);
     atomic_store(&ch->lfqueue_inflight, 0);
     atomic_store(&ch->slot_counter, 0);
+
+    if (topology == CC_CHAN_TOPO_1_N) {
+        /* Broadcast: one shared ring with per-subscriber cursors replaces the
+         * queue. Pointer/slice take is single-owner and cannot fan out. */
+        ch->allow_take = 0;
+        ch->bcast = cc__chan_bcast_create(ch, cap, mode);
+        if (!ch->bcast) {
+            cc_chan_free(ch);
+            return NULL;
+        }
+        return ch;
+    }
     
     if (cap > 1) {  /* Only use lock-free for cap > 1 (liblfds needs at least 2) */
         const char* disable_lf = getenv("CC_CHAN_NO_LOCKFREE");
@@ -1936,6 +1999,7 @@ static void cc__chan_close_common(CCChan* ch,
     cc__chan_trace_close(ch, trace_end, NULL, CC_CHAN_NOTIFY_CLOSE);
     pthread_mutex_unlock(&ch->mu);
     wake_batch_flush();  /* Flush fiber wakes immediately */
+    if (ch->bcast) cc__chan_bcast_after_close(ch, close_tx);
     cc__chan_signal_recv_ready(ch);
 }
 
@@ -2005,6 +2069,7 @@ int cc__chan_has_close_error(CCChan* ch, bool is_recv) {
 
 void cc_chan_free(CCChan* ch) {
     if (!ch) return;
+    if (ch->bcast) cc__chan_bcast_release(ch);
     
     
     /* For owned channels, destroy remaining items in the buffer */
@@ -2057,6 +2122,7 @@ void cc_chan_free(CCChan* ch) {
 
 // Ensure buffer is allocated with the given element size; only allowed to set once.
 static int cc_chan_ensure_buf(CCChan* ch, size_t elem_size) {
+    if (ch->bcast) return cc__chan_bcast_ensure(ch, elem_size);
     if (ch->elem_size == 0) {
         ch->elem_size = elem_size;
         
@@ -3522,6 +3588,13 @@ static int cc_chan_handle_full_send(CCChan* ch, const void* value, const struct
     }
 }
 
+/* cc_chan_send / cc_chan_recv / cc_chan_try_send / cc_chan_try_recv keep
+ * only the branded fast path; everything else lives in a noinline _slow
+ * sibling. Small entry points are what lets `ccc build --lto` inline the
+ * steady-state enqueue/dequeue into user loops instead of calling through
+ * the whole send/recv state machine. */
+static int cc__chan_send_slow(CCChan* ch, const void* value, size_t value_size);
+
 int cc_chan_send(CCChan* ch, const void* value, size_t value_size) {
     /* Minimal fast path: branded channel, just enqueue and return.
      * Skips guards, debug, timing, signal_activity.
@@ -3540,6 +3613,11 @@ int cc_chan_send(CCChan* ch, const void* value, size_t value_size) {
         }
         /* Buffer full — fall through to full path for yield-retry / blocking */
     }
+    return cc__chan_send_slow(ch, value, value_size);
+}
+
+__attribute__((noinline))
+static int cc__chan_send_slow(CCChan* ch, const void* value, size_t value_size) {
     if (!ch || !value || value_size == 0) return EINVAL;
     
     /* Owned channel (pool): call on_reset before returning item to pool */
@@ -3555,6 +3633,7 @@ int cc_chan_send(CCChan* ch, const void* value, size_t value_size) {
     if (current_deadline) {
         return cc_chan_deadline_send(ch, value, value_size, current_deadline);
     }
+    if (ch->bcast) return cc__chan_bcast_send(ch, value, value_size, NULL, 0);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -3816,6 +3895,8 @@ static int cc_chan_recv_owned(CCChan* ch, void* out_value, size_t value_size) {
     return rc;
 }
 
+static int cc__chan_recv_slow(CCChan* ch, void* out_value, size_t value_size);
+
 int cc_chan_recv(CCChan* ch, void* out_value, size_t value_size) {
     /* Minimal fast path: branded channel, just dequeue and return.
      * Skips guards, debug, timing, signal_activity.
@@ -3843,6 +3924,11 @@ int cc_chan_recv(CCChan* ch, void* out_value, size_t value_size) {
         }
         /* Buffer empty — fall through to full path for yield-retry / blocking */
     }
+    return cc__chan_recv_slow(ch, out_value, value_size);
+}
+
+__attribute__((noinline))
+static int cc__chan_recv_slow(CCChan* ch, void* out_value, size_t value_size) {
     if (!ch || !out_value || value_size == 0) return EINVAL;
     
     /* Owned channel (pool) special handling */
@@ -3856,6 +3942,7 @@ int cc_chan_recv(CCChan* ch, void* out_value, size_t value_size) {
     if (current_deadline) {
         return cc_chan_deadline_recv(ch, out_value, value_size, current_deadline);
     }
+    if (ch->bcast) return cc__chan_bcast_recv(ch, out_value, value_size, NULL, 0);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -4232,8 +4319,26 @@ int cc_chan_recv(CCChan* ch, void* out_value, size_t value_size) {
 }
 
 
+static int cc__chan_try_send_slow(CCChan* ch, const void* value, size_t value_size);
+
 int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
+    /* Same brand as cc_chan_send's minimal path: open, lock-free, buffered. */
+    if (ch && value && ch->fast_path_ok && value_size == ch->elem_size &&
+        !cc__chan_mutex_minimal_enabled()) {
+        if (cc__chan_enqueue_lockfree_minimal(ch, value, NULL) == 0) {
+            cc__chan_post_lockfree_enqueue_signal_receivers(ch, value,
+                                                            "try_send_minimal_seen_waiter");
+            return 0;
+        }
+        /* Full (or raced a close): the slow path sorts out EAGAIN vs EPIPE. */
+    }
+    return cc__chan_try_send_slow(ch, value, value_size);
+}
+
+__attribute__((noinline))
+static int cc__chan_try_send_slow(CCChan* ch, const void* value, size_t value_size) {
     if (!ch || !value || value_size == 0) return EINVAL;
+    if (ch->bcast) return cc__chan_bcast_send(ch, value, value_size, NULL, 1);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -4252,6 +4357,9 @@ int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
         int rc = cc__chan_try_enqueue_lockfree_impl(ch, value);
         chan_inflight_dec(ch);
         if (rc == 0) {
+            /* Same Dekker pair as cc__chan_post_lockfree_enqueue_signal_receivers:
+             * order the enqueue before the waiter/watcher loads. */
+            atomic_thread_fence(memory_order_seq_cst);
             int fiber_waiters = atomic_load_explicit(&ch->has_recv_waiters, memory_order_acquire);
             int thread_waiters = atomic_load_explicit(&ch->thread_recv_waiters, memory_order_acquire);
             if (fiber_waiters || thread_waiters) {
@@ -4261,8 +4369,9 @@ int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
                 pthread_mutex_unlock(&ch->mu);
                 wake_batch_flush();
                 cc__chan_signal_recv_ready(ch);
-            } else if (ch->recv_signal) {
-                cc_socket_signal_signal(ch->recv_signal);
+            } else {
+                if (ch->recv_signal) cc_socket_signal_signal(ch->recv_signal);
+                cc__chan_select_watch_recv_ready_fenced(ch);
             }
             return 0;
         }
@@ -4319,6 +4428,9 @@ int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
         int rc = cc__chan_try_enqueue_lockfree_impl(ch, value);
         chan_inflight_dec(ch);
         if (rc == 0) {
+            /* Same Dekker pair as cc__chan_post_lockfree_enqueue_signal_receivers:
+             * order the enqueue before the waiter/watcher loads. */
+            atomic_thread_fence(memory_order_seq_cst);
             int fiber_waiters = atomic_load_explicit(&ch->has_recv_waiters, memory_order_acquire);
             int thread_waiters = atomic_load_explicit(&ch->thread_recv_waiters, memory_order_acquire);
             if (fiber_waiters || thread_waiters) {
@@ -4328,8 +4440,9 @@ int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
                 pthread_mutex_unlock(&ch->mu);
                 wake_batch_flush();
                 cc__chan_signal_recv_ready(ch);
-            } else if (ch->recv_signal) {
-                cc_socket_signal_signal(ch->recv_signal);
+            } else {
+                if (ch->recv_signal) cc_socket_signal_signal(ch->recv_signal);
+                cc__chan_select_watch_recv_ready_fenced(ch);
             }
             return 0;
         }
@@ -4346,8 +4459,24 @@ int cc_chan_try_send(CCChan* ch, const void* value, size_t value_size) {
     return 0;
 }
 
+static int cc__chan_try_recv_slow(CCChan* ch, void* out_value, size_t value_size);
+
 int cc_chan_try_recv(CCChan* ch, void* out_value, size_t value_size) {
+    if (ch && out_value && ch->fast_path_ok && value_size == ch->elem_size &&
+        !cc__chan_mutex_minimal_enabled()) {
+        if (cc__chan_dequeue_lockfree_minimal(ch, out_value, NULL) == 0) {
+            cc__chan_post_lockfree_dequeue_signal_senders(ch);
+            return 0;
+        }
+        /* Empty: the slow path resolves EAGAIN vs closed. */
+    }
+    return cc__chan_try_recv_slow(ch, out_value, value_size);
+}
+
+__attribute__((noinline))
+static int cc__chan_try_recv_slow(CCChan* ch, void* out_value, size_t value_size) {
     if (!ch || !out_value || value_size == 0) return EINVAL;
+    if (ch->bcast) return cc__chan_bcast_recv(ch, out_value, value_size, NULL, 1);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -4420,6 +4549,7 @@ int cc_chan_try_recv(CCChan* ch, void* out_value, size_t value_size) {
 
 int cc_chan_timed_send(CCChan* ch, const void* value, size_t value_size, const struct timespec* abs_deadline) {
     if (!ch || !value || value_size == 0) return EINVAL;
+    if (ch->bcast) return cc__chan_bcast_send(ch, value, value_size, abs_deadline, 0);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -4616,6 +4746,7 @@ int cc_chan_timed_send(CCChan* ch, const void* value, size_t value_size, const s
 
 int cc_chan_timed_recv(CCChan* ch, void* out_value, size_t value_size, const struct timespec* abs_deadline) {
     if (!ch || !out_value || value_size == 0) return EINVAL;
+    if (ch->bcast) return cc__chan_bcast_recv(ch, out_value, value_size, abs_deadline, 0);
     
     /* Lock-free fast path for buffered channels.
      * Large by-value elements stay lock-free only on the ring backend. */
@@ -5000,10 +5131,12 @@ int cc_chan_match_deadline(CCChanMatchCase* cases, size_t n, size_t* ready_index
     
     /* Multi-channel select: Use global broadcast condvar.
        Any channel activity (send/recv/close) wakes all waiters.
-       Simple, deadlock-free, at cost of some spurious wakeups. */
-    static _Atomic uint64_t g_match_rr = 0;
+       Simple, deadlock-free, at cost of some spurious wakeups.
+       The try-pass rotation is per thread: a shared counter here was one
+       more contended cache line for every concurrent select. */
+    static __thread size_t tls_match_rr = 0;
     while (1) {
-        size_t start = n ? (size_t)(atomic_fetch_add_explicit(&g_match_rr, 1, memory_order_relaxed) % n) : 0;
+        size_t start = tls_match_rr++ % n;
         int rc = cc__chan_match_try_from(cases, n, ready_index, start);
         if (rc == 0) { cc__chan_select_dbg_inc(&g_dbg_select_try_returned); return rc; }
         if (rc == EPIPE) { cc__chan_select_dbg_inc(&g_dbg_select_close_returned); return rc; }
@@ -5015,6 +5148,13 @@ int cc_chan_match_deadline(CCChanMatchCase* cases, size_t n, size_t* ready_index
             }
         }
         
+        /* Receive-only selects over buffered channels watch the channels
+         * instead of linking a wait node into each one: no ch->mu on the
+         * way in or out (chan_select_set.c). */
+        if (fiber && cc__chan_select_watchable(cases, n)) {
+            return cc__chan_select_watch_wait(cases, n, ready_index, p, start);
+        }
+
         /* Wait for any channel activity */
         if (fiber && !p) {
             /* Clear any stale pending_unpark from previous operations.
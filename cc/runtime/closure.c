@@ -14,6 +14,7 @@
 
 /* TSan annotations for closure capture synchronization */
 #include "tsan_helpers.h"
+#include "sched_v2.h"
 
 typedef struct {
     CCClosure0 c;
@@ -28,6 +29,7 @@ static void* cc__closure0_trampoline(void* p) {
     atomic_thread_fence(memory_order_acquire);
     TSAN_ACQUIRE(c.env);
     void* r = NULL;
+    sched_v2_set_spawn_site((void*)c.fn);
     if (c.fn) r = c.fn(c.env);
     if (c.drop) c.drop(c.env);
     return r;
@@ -45,6 +47,17 @@ int cc_nursery_spawn_closure0(CCNursery* n, CCClosure0 c) {
     return err;
 }
 
+int cc_nursery_spawn_closure0_prio(CCNursery* n, CCClosure0 c, CCPriority p) {
+    if (!n || !c.fn) return EINVAL;
+    CCClosure0Heap* h = (CCClosure0Heap*)malloc(sizeof(CCClosure0Heap));
+    if (!h) return ENOMEM;
+    h->c = c;
+    TSAN_RELEASE(c.env);
+    int err = cc_nursery_spawn_prio(n, cc__closure0_trampoline, h, p);
+    if (err != 0) free(h);
+    return err;
+}
+
 /* spawnhybrid is a source-compat alias for spawn now that V2 is the default. */
 int cc_nursery_spawnhybrid_closure0(CCNursery* n, CCClosure0 c) {
     return cc_nursery_spawn_closure0(n, c);
@@ -76,6 +89,7 @@ static void* cc__closure1_trampoline(void* p) {
     atomic_thread_fence(memory_order_acquire);
     TSAN_ACQUIRE(c.env);
     void* r = NULL;
+    sched_v2_set_spawn_site((void*)c.fn);
     if (c.fn) r = c.fn(c.env, a0);
     if (c.drop) c.drop(c.env);
     return r;
@@ -122,6 +136,7 @@ static void* cc__closure2_trampoline(void* p) {
     atomic_thread_fence(memory_order_acquire);
     TSAN_ACQUIRE(c.env);
     void* r = NULL;
+    sched_v2_set_spawn_site((void*)c.fn);
     if (c.fn) r = c.fn(c.env, a0, a1);
     if (c.drop) c.drop(c.env);
     return r;
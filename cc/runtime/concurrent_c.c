@@ -11,8 +11,12 @@
  */
 
 #include "channel.c"
+#include "chan_broadcast.c"
+#include "chan_select_set.c"
 #include "sched_v2.c"
+#include "sched_trace.c"
 #include "fiber_sched.c"
+#include "sched_prof.c"
 #include "scheduler.c"
 #include "nursery.c"
 #include "fiber_sched_boundary.c"
@@ -25,10 +29,12 @@
 #include "arena_state.c"
 #include "io_wait.c"
 #include "net.c"
+#include "dns.c"
 #include "socket.c"
 #include "select.c"
 #include "dir.c"
 #include "process.c"
+#include "metrics.c"
 
 #ifdef CC_ENABLE_ASYNC
 #include "async_chan.c"
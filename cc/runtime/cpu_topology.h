@@ -0,0 +1,171 @@
+/*
+ * CPU topology and thread pinning for worker placement
+ *
+ * sched_v2 can pin its workers (CC_V2_AFFINITY, cc_sched_set_worker_affinity)
+ * and prefers waking an idle worker on the signaller's NUMA node. This
+ * header supplies the small amount of platform plumbing that needs:
+ *
+ *   cc_cpu_topology_load   the CPUs this process may run on, in placement
+ *                          order (grouped by NUMA node, node 0 first), with
+ *                          the node of each. Nodes come from
+ *                          /sys/devices/system/node; without it (or off
+ *                          Linux) everything is node 0.
+ *   cc_cpu_list_parse      "0-3,8,10-11" -> CPU ids, in the order written.
+ *   cc_thread_pin_cpus     restrict the calling thread to a set of CPUs.
+ *   cc_current_cpu_node    NUMA node the calling thread is running on now.
+ *
+ * Linux only, through raw syscalls (sched_setaffinity, getcpu) so no
+ * _GNU_SOURCE or libnuma is needed. Elsewhere pinning reports ENOTSUP and
+ * the scheduler runs unpinned; macOS has no hard affinity to offer.
+ */
+
+#ifndef CC_CPU_TOPOLOGY_H
+#define CC_CPU_TOPOLOGY_H
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#define CC_TOPO_MAX_CPUS 1024
+#define CC_TOPO_MAX_NODES 64
+
+typedef struct {
+    int ncpu;                       /* usable CPUs */
+    int nnodes;                     /* distinct nodes among them (>= 1) */
+    int cpu[CC_TOPO_MAX_CPUS];      /* CPU ids, node-major */
+    int node[CC_TOPO_MAX_CPUS];     /* node of cpu[i] */
+} cc_cpu_topology;
+
+#define CC_TOPO_MASK_WORDS (CC_TOPO_MAX_CPUS / (8 * sizeof(unsigned long)))
+#define CC_TOPO_MASK_BITS (8 * sizeof(unsigned long))
+
+/* Parse a kernel-style CPU list. Returns the number of ids stored, or -1
+ * on a malformed list. Ids outside [0, CC_TOPO_MAX_CPUS) are rejected. */
+static inline int cc_cpu_list_parse(const char* s, int* out, int cap) {
+    int n = 0;
+    if (!s) return -1;
+    while (*s) {
+        while (*s == ' ' || *s == '\t' || *s == '\n') s++;
+        if (!*s) break;
+        if (!isdigit((unsigned char)*s)) return -1;
+        char* end = NULL;
+        long lo = strtol(s, &end, 10);
+        long hi = lo;
+        s = end;
+        if (*s == '-') {
+            s++;
+            if (!isdigit((unsigned char)*s)) return -1;
+            hi = strtol(s, &end, 10);
+            s = end;
+        }
+        if (lo < 0 || hi < lo || hi >= CC_TOPO_MAX_CPUS) return -1;
+        for (long c = lo; c <= hi && n < cap; c++) out[n++] = (int)c;
+        while (*s == ' ' || *s == '\t' || *s == '\n') s++;
+        if (*s == ',') s++;
+        else if (*s) return -1;
+    }
+    return n;
+}
+
+#if defined(__linux__)
+static inline int cc__topo_mask_has(const unsigned long* m, int cpu) {
+    return (m[cpu / CC_TOPO_MASK_BITS] >> (cpu % CC_TOPO_MASK_BITS)) & 1ul;
+}
+#endif
+
+static inline void cc_cpu_topology_load(cc_cpu_topology* t) {
+    memset(t, 0, sizeof(*t));
+    t->nnodes = 1;
+#if defined(__linux__)
+    unsigned long allowed[CC_TOPO_MASK_WORDS];
+    memset(allowed, 0, sizeof(allowed));
+    if (syscall(SYS_sched_getaffinity, 0, sizeof(allowed), allowed) > 0) {
+        int seen[CC_TOPO_MAX_CPUS];
+        memset(seen, 0, sizeof(seen));
+        int nodes = 0;
+        for (int nd = 0; nd < CC_TOPO_MAX_NODES; nd++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", nd);
+            FILE* f = fopen(path, "r");
+            if (!f) continue;
+            char buf[1024];
+            int ids[CC_TOPO_MAX_CPUS];
+            int k = fgets(buf, sizeof(buf), f) ? cc_cpu_list_parse(buf, ids, CC_TOPO_MAX_CPUS) : -1;
+            fclose(f);
+            int added = 0;
+            for (int i = 0; i < k; i++) {
+                int c = ids[i];
+                if (seen[c] || !cc__topo_mask_has(allowed, c)) continue;
+                seen[c] = 1;
+                t->cpu[t->ncpu] = c;
+                t->node[t->ncpu] = nd;
+                t->ncpu++;
+                added = 1;
+            }
+            nodes += added;
+        }
+        /* Allowed CPUs sysfs did not place (no NUMA support): node 0. */
+        for (int c = 0; c < CC_TOPO_MAX_CPUS; c++) {
+            if (!cc__topo_mask_has(allowed, c) || seen[c]) continue;
+            t->cpu[t->ncpu] = c;
+            t->node[t->ncpu] = 0;
+            t->ncpu++;
+        }
+        if (nodes > 1) t->nnodes = nodes;
+        if (t->ncpu > 0) return;
+    }
+#endif
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > CC_TOPO_MAX_CPUS) n = CC_TOPO_MAX_CPUS;
+    for (int i = 0; i < (int)n; i++) {
+        t->cpu[i] = i;
+        t->node[i] = 0;
+    }
+    t->ncpu = (int)n;
+}
+
+/* Node of `cpu` per the topology, or -1 if it is not a usable CPU. */
+static inline int cc_cpu_topology_node_of(const cc_cpu_topology* t, int cpu) {
+    for (int i = 0; i < t->ncpu; i++) {
+        if (t->cpu[i] == cpu) return t->node[i];
+    }
+    return -1;
+}
+
+/* Restrict the calling thread to `cpus`. Returns 0 or an errno value. */
+static inline int cc_thread_pin_cpus(const int* cpus, int n) {
+#if defined(__linux__)
+    unsigned long m[CC_TOPO_MASK_WORDS];
+    memset(m, 0, sizeof(m));
+    for (int i = 0; i < n; i++) {
+        int c = cpus[i];
+        if (c < 0 || c >= CC_TOPO_MAX_CPUS) return EINVAL;
+        m[c / CC_TOPO_MASK_BITS] |= 1ul << (c % CC_TOPO_MASK_BITS);
+    }
+    if (syscall(SYS_sched_setaffinity, 0, sizeof(m), m) != 0) return errno;
+    return 0;
+#else
+    (void)cpus;
+    (void)n;
+    return ENOTSUP;
+#endif
+}
+
+/* NUMA node the calling thread is on right now; 0 when unknown. */
+static inline int cc_current_cpu_node(void) {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return (int)node;
+#endif
+    return 0;
+}
+
+#endif /* CC_CPU_TOPOLOGY_H */
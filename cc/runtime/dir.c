@@ -5,8 +5,12 @@
  */
 
 #include <ccc/std/dir.cch>
+#include <ccc/cc_channel.cch>
+#include <ccc/cc_nursery.cch>
 
 #include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -21,6 +25,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #define PATH_SEP '/'
 #endif
@@ -48,6 +53,17 @@ struct CCDirIter {
  * For EOF on directory iteration, use CC_IO_OTHER with os_code=0. */
 #define CC_DIR_EOF_ERROR ((CCIoError){.kind = CC_IO_OTHER, .os_code = 0})
 
+#ifndef _WIN32
+static CCDirEntryType cc__dir_stat_type(DIR* dir, const char* name) {
+    struct stat st;
+    if (fstatat(dirfd(dir), name, &st, AT_SYMLINK_NOFOLLOW) != 0) return CC_DIRENT_OTHER;
+    if (S_ISREG(st.st_mode)) return CC_DIRENT_FILE;
+    if (S_ISDIR(st.st_mode)) return CC_DIRENT_DIR;
+    if (S_ISLNK(st.st_mode)) return CC_DIRENT_SYMLINK;
+    return CC_DIRENT_OTHER;
+}
+#endif
+
 /* ============================================================================
  * Directory Iteration
  * ============================================================================ */
@@ -162,16 +178,18 @@ CCResult_CCDirEntry_CCIoError cc_dir_next(CCDirIter* iter, CCArena* arena) {
     entry.name.ptr = name_copy;
     entry.name.len = name_len;
 
+    /* d_type saves a stat per entry; some filesystems report DT_UNKNOWN,
+     * and only those entries pay for an fstatat. */
 #ifdef DT_DIR
     switch (de->d_type) {
         case DT_REG: entry.type = CC_DIRENT_FILE; break;
         case DT_DIR: entry.type = CC_DIRENT_DIR; break;
         case DT_LNK: entry.type = CC_DIRENT_SYMLINK; break;
+        case DT_UNKNOWN: entry.type = cc__dir_stat_type(iter->dir, de->d_name); break;
         default:     entry.type = CC_DIRENT_OTHER; break;
     }
 #else
-    /* Fallback: stat the file */
-    entry.type = CC_DIRENT_OTHER;
+    entry.type = cc__dir_stat_type(iter->dir, de->d_name);
 #endif
 #endif
 
@@ -418,145 +436,426 @@ bool cc_glob_match(const char* pattern, const char* name) {
 #endif
 }
 
-/* Helper: add path to glob result */
-static void glob_add(CCGlobResult* result, CCArena* arena, const char* path, size_t len) {
-    if (result->count >= result->capacity) {
-        size_t new_cap = result->capacity ? result->capacity * 2 : 16;
-        CCSlice* new_paths = cc_arena_alloc(arena, new_cap * sizeof(CCSlice), _Alignof(CCSlice));
-        if (!new_paths) return;
-        if (result->paths && result->count > 0) {
-            memcpy(new_paths, result->paths, result->count * sizeof(CCSlice));
+/* ============================================================================
+ * Parallel glob walk
+ * ============================================================================
+ *
+ * A pattern compiles to a plan:
+ *
+ *   root     the leading components without wildcards, opened directly
+ *            ("." when there are none);
+ *   segs     wildcard components between root and `**` (or the file
+ *            component); a directory at depth d is entered only if its name
+ *            matches segs[d], so with a "lib*" segment under src the walk
+ *            never reads src/app;
+ *   tail     what a file must match once every seg matched: the file
+ *            component, or every component after `**`, matched against the
+ *            same number of trailing path components.
+ *
+ * Directories are read by one fiber per scheduler worker. Each fiber pops a
+ * directory from a shared stack, reads it with cc_dir_next (d_type, with a
+ * stat only for DT_UNKNOWN), pushes matching subdirectories in one locked
+ * batch and hands matching files to an emit callback. `pending` counts
+ * directories queued or being read; whoever drops it to zero closes the
+ * wake channel, which releases the idle fibers. An idle fiber bumps `idle`
+ * and blocks on the wake channel; a pusher spends one token per idle fiber
+ * it can feed.
+ */
+
+#define CC_GLOB_MAX_SEGS 64
+
+typedef struct {
+    char root[4096];
+    char* segs[CC_GLOB_MAX_SEGS];
+    size_t nseg;
+    int recursive;
+    char* tail;
+    size_t tail_parts;
+    char buf[4096];         /* storage for segs and tail */
+} cc__glob_plan;
+
+typedef int (*cc__glob_emit_fn)(void* ctx, const char* path, size_t len, CCDirEntryType type);
+
+typedef struct cc__glob_dir {
+    struct cc__glob_dir* next;
+    size_t depth;           /* segs matched so far */
+    size_t len;
+    char path[];
+} cc__glob_dir;
+
+typedef struct {
+    const cc__glob_plan* plan;
+    cc__glob_emit_fn emit;
+    void* ctx;
+    pthread_mutex_t mu;
+    cc__glob_dir* stack;
+    size_t pending;
+    size_t idle;
+    int done;
+    _Atomic int stop;
+    int root_err;
+    CCChan* wake;
+} cc__glob_walk;
+
+static int cc__glob_is_sep(char c) {
+    return c == '/' || c == PATH_SEP;
+}
+
+static int cc__glob_has_wild(const char* s) {
+    return strpbrk(s, "*?[") != NULL;
+}
+
+static int cc__glob_compile(const char* pattern, cc__glob_plan* plan) {
+    memset(plan, 0, sizeof(*plan));
+    size_t plen = strlen(pattern);
+    if (plen == 0 || plen >= sizeof(plan->buf)) return ENAMETOOLONG;
+    memcpy(plan->buf, pattern, plen + 1);
+
+    /* Split in place on separators. */
+    char* parts[CC_GLOB_MAX_SEGS * 2];
+    size_t nparts = 0;
+    int absolute = cc__glob_is_sep(plan->buf[0]);
+    char* p = plan->buf;
+    while (*p) {
+        while (*p && cc__glob_is_sep(*p)) *p++ = '\0';
+        if (!*p) break;
+        if (nparts == sizeof(parts) / sizeof(parts[0])) return ENAMETOOLONG;
+        parts[nparts++] = p;
+        while (*p && !cc__glob_is_sep(*p)) p++;
+    }
+    if (nparts == 0) return EINVAL;
+
+    size_t star = nparts;
+    for (size_t i = 0; i < nparts; ++i) {
+        if (strstr(parts[i], "**")) { star = i; break; }
+    }
+    size_t file_at = star < nparts ? star : nparts - 1;
+
+    size_t i = 0;
+    size_t rlen = 0;
+    if (absolute) plan->root[rlen++] = PATH_SEP;
+    for (; i < file_at && !cc__glob_has_wild(parts[i]); ++i) {
+        size_t n = strlen(parts[i]);
+        if (rlen + n + 2 >= sizeof(plan->root)) return ENAMETOOLONG;
+        if (rlen > 0 && !cc__glob_is_sep(plan->root[rlen - 1])) plan->root[rlen++] = PATH_SEP;
+        memcpy(plan->root + rlen, parts[i], n);
+        rlen += n;
+    }
+    if (rlen == 0) plan->root[rlen++] = '.';
+    plan->root[rlen] = '\0';
+    for (; i < file_at; ++i) {
+        if (plan->nseg == CC_GLOB_MAX_SEGS) return ENAMETOOLONG;
+        plan->segs[plan->nseg++] = parts[i];
+    }
+
+    if (star < nparts) {
+        plan->recursive = 1;
+        if (star + 1 == nparts) {
+            plan->tail = "*";
+            plan->tail_parts = 1;
+        } else {
+            /* Re-join the components after ** with '/' for matching. */
+            plan->tail = parts[star + 1];
+            plan->tail_parts = nparts - star - 1;
+            for (size_t k = star + 2; k < nparts; ++k) parts[k][-1] = '/';
         }
-        result->paths = new_paths;
-        result->capacity = new_cap;
+    } else {
+        plan->tail = parts[nparts - 1];
+        plan->tail_parts = 1;
     }
+    return 0;
+}
 
-    char* copy = cc_arena_alloc(arena, len + 1, 1);
-    if (!copy) return;
-    memcpy(copy, path, len);
-    copy[len] = '\0';
+static int cc__glob_match_path(const char* pattern, const char* path) {
+#ifdef _WIN32
+    return cc_glob_match(pattern, path);
+#else
+    return fnmatch(pattern, path, FNM_PATHNAME) == 0;
+#endif
+}
 
-    result->paths[result->count].ptr = copy;
-    result->paths[result->count].len = len;
-    result->count++;
+/* Does a file at `path` (whose last component is `name`) match the tail? */
+static int cc__glob_tail_match(const cc__glob_plan* plan, const char* path, size_t len, const char* name) {
+    if (plan->tail_parts == 1) return cc_glob_match(plan->tail, name);
+    size_t need = plan->tail_parts - 1;
+    size_t root_len = strlen(plan->root);
+    const char* end = path + len;
+    /* First byte the tail may cover: past the root and the fixed segments.
+     * The separator in front of it still counts, so ** can match zero
+     * directories. */
+    const char* first = path + root_len;
+    if (!cc__glob_is_sep(first[-1])) first++;
+    for (size_t k = 0; k < plan->nseg && first < end; ++k) {
+        while (first < end && !cc__glob_is_sep(*first)) first++;
+        first++;
+    }
+    const char* start = end;
+    for (;;) {
+        if (start < first) return 0;
+        --start;
+        if (cc__glob_is_sep(*start) && need-- == 0) break;
+    }
+    char tmp[4096];
+    size_t tlen = (size_t)(path + len - (start + 1));
+    if (tlen >= sizeof(tmp)) return 0;
+    memcpy(tmp, start + 1, tlen);
+    tmp[tlen] = '\0';
+#ifdef _WIN32
+    for (size_t k = 0; k < tlen; ++k) if (tmp[k] == PATH_SEP) tmp[k] = '/';
+#endif
+    return cc__glob_match_path(plan->tail, tmp);
 }
 
-/* Helper: recursive glob */
-static void glob_recurse(CCArena* arena, CCGlobResult* result,
-                         const char* dir, const char* pattern, int recursive);
+static cc__glob_dir* cc__glob_dir_new(const char* parent, size_t parent_len, const char* name, size_t name_len, size_t depth) {
+    size_t len = name ? parent_len + 1 + name_len : parent_len;
+    cc__glob_dir* d = (cc__glob_dir*)malloc(sizeof(*d) + len + 1);
+    if (!d) return NULL;
+    memcpy(d->path, parent, parent_len);
+    if (name) {
+        d->path[parent_len] = PATH_SEP;
+        memcpy(d->path + parent_len + 1, name, name_len);
+    }
+    d->path[len] = '\0';
+    d->len = len;
+    d->depth = depth;
+    d->next = NULL;
+    return d;
+}
 
-static void glob_dir(CCArena* arena, CCGlobResult* result,
-                     const char* dir, const char* pattern, int recursive) {
-    CCResult_CCDirIterptr_CCIoError iter_res = cc_dir_open(arena, dir);
-    if (cc_is_err(iter_res)) return;
+static void cc__glob_push(cc__glob_walk* w, cc__glob_dir* head, cc__glob_dir* tail, size_t n) {
+    size_t wake = 0;
+    pthread_mutex_lock(&w->mu);
+    tail->next = w->stack;
+    w->stack = head;
+    w->pending += n;
+    wake = w->idle < n ? w->idle : n;
+    w->idle -= wake;
+    pthread_mutex_unlock(&w->mu);
+    for (size_t i = 0; i < wake; ++i) {
+        char tok = 0;
+        (void)cc_chan_try_send(w->wake, &tok, sizeof(tok));
+    }
+}
 
+static void cc__glob_scan_dir(cc__glob_walk* w, cc__glob_dir* d, CCArena* scratch) {
+    const cc__glob_plan* plan = w->plan;
+    CCResult_CCDirIterptr_CCIoError iter_res = cc_dir_open(scratch, d->path);
+    if (cc_is_err(iter_res)) {
+        if (d->depth == 0 && d->len == strlen(plan->root)) {
+            CCIoError e = cc_unwrap_err(iter_res);
+            w->root_err = e.os_code ? e.os_code : EIO;
+        }
+        return;
+    }
     CCDirIter* iter = cc_unwrap(iter_res);
-    while (1) {
-        CCResult_CCDirEntry_CCIoError entry_res = cc_dir_next(iter, arena);
+    cc__glob_dir* head = NULL;
+    cc__glob_dir* tail = NULL;
+    size_t nsub = 0;
+    char path[4096];
+    while (!atomic_load_explicit(&w->stop, memory_order_relaxed)) {
+        CCResult_CCDirEntry_CCIoError entry_res = cc_dir_next(iter, scratch);
         if (cc_is_err(entry_res)) break;
-
         CCDirEntry entry = cc_unwrap(entry_res);
         const char* name = (const char*)entry.name.ptr;
 
-        /* Build full path */
-        size_t dir_len = strlen(dir);
-        size_t name_len = entry.name.len;
-        size_t path_len = dir_len + 1 + name_len;
-        char* full_path = cc_arena_alloc(arena, path_len + 1, 1);
-        if (!full_path) continue;
-
-        memcpy(full_path, dir, dir_len);
-        full_path[dir_len] = PATH_SEP;
-        memcpy(full_path + dir_len + 1, name, name_len);
-        full_path[path_len] = '\0';
-
         if (entry.type == CC_DIRENT_DIR) {
-            if (recursive) {
-                glob_recurse(arena, result, full_path, pattern, recursive);
-            }
-        } else {
-            if (cc_glob_match(pattern, name)) {
-                glob_add(result, arena, full_path, path_len);
+            size_t depth;
+            if (d->depth < plan->nseg) {
+                if (!cc_glob_match(plan->segs[d->depth], name)) continue;
+                depth = d->depth + 1;
+            } else if (plan->recursive) {
+                depth = d->depth;
+            } else {
+                continue;
             }
+            cc__glob_dir* sub = cc__glob_dir_new(d->path, d->len, name, entry.name.len, depth);
+            if (!sub) continue;
+            if (tail) tail->next = sub;
+            else head = sub;
+            tail = sub;
+            nsub++;
+            continue;
         }
-    }
 
+        if (d->depth != plan->nseg) continue;
+        size_t len = d->len + 1 + entry.name.len;
+        if (len >= sizeof(path)) continue;
+        memcpy(path, d->path, d->len);
+        path[d->len] = PATH_SEP;
+        memcpy(path + d->len + 1, name, entry.name.len);
+        path[len] = '\0';
+        if (!cc__glob_tail_match(plan, path, len, name)) continue;
+        if (w->emit(w->ctx, path, len, entry.type) != 0) {
+            atomic_store_explicit(&w->stop, 1, memory_order_relaxed);
+        }
+    }
     cc_dir_close(iter);
+    if (!head) return;
+    if (atomic_load_explicit(&w->stop, memory_order_relaxed)) {
+        while (head) {
+            cc__glob_dir* next = head->next;
+            free(head);
+            head = next;
+        }
+        return;
+    }
+    cc__glob_push(w, head, tail, nsub);
 }
 
-static void glob_recurse(CCArena* arena, CCGlobResult* result,
-                         const char* dir, const char* pattern, int recursive) {
-    glob_dir(arena, result, dir, pattern, recursive);
-
-    /* Recurse into subdirectories */
-    CCResult_CCDirIterptr_CCIoError iter_res = cc_dir_open(arena, dir);
-    if (cc_is_err(iter_res)) return;
-
-    CCDirIter* iter = cc_unwrap(iter_res);
-    while (1) {
-        CCResult_CCDirEntry_CCIoError entry_res = cc_dir_next(iter, arena);
-        if (cc_is_err(entry_res)) break;
-
-        CCDirEntry entry = cc_unwrap(entry_res);
-        if (entry.type != CC_DIRENT_DIR) continue;
-
-        size_t dir_len = strlen(dir);
-        size_t name_len = entry.name.len;
-        size_t path_len = dir_len + 1 + name_len;
-        char* subdir = cc_arena_alloc(arena, path_len + 1, 1);
-        if (!subdir) continue;
+static void* cc__glob_worker(void* arg) {
+    cc__glob_walk* w = (cc__glob_walk*)arg;
+    CCArena scratch = cc_arena_heap(16 * 1024);
+    if (!scratch.base) return NULL;
+    for (;;) {
+        pthread_mutex_lock(&w->mu);
+        cc__glob_dir* d = w->stack;
+        int done = w->done;
+        if (d) w->stack = d->next;
+        else if (!done) w->idle++;
+        pthread_mutex_unlock(&w->mu);
+        if (!d) {
+            char tok;
+            if (done || cc_chan_recv(w->wake, &tok, sizeof(tok)) != 0) break;
+            continue;
+        }
+        if (!atomic_load_explicit(&w->stop, memory_order_relaxed)) cc__glob_scan_dir(w, d, &scratch);
+        free(d);
+        cc_arena_reset(&scratch);
+        pthread_mutex_lock(&w->mu);
+        int finished = --w->pending == 0;
+        if (finished) w->done = 1;
+        pthread_mutex_unlock(&w->mu);
+        if (finished) cc_chan_close(w->wake);
+    }
+    cc_arena_free(&scratch);
+    return NULL;
+}
 
-        memcpy(subdir, dir, dir_len);
-        subdir[dir_len] = PATH_SEP;
-        memcpy(subdir + dir_len + 1, entry.name.ptr, name_len);
-        subdir[path_len] = '\0';
+/* Walk `plan` on one fiber per scheduler worker; returns once every queued
+ * directory has been read. Returns 0 or the errno from opening the root. */
+static int cc__glob_run(const cc__glob_plan* plan, cc__glob_emit_fn emit, void* ctx) {
+    cc__glob_walk w = {.plan = plan, .emit = emit, .ctx = ctx};
+    pthread_mutex_init(&w.mu, NULL);
+    atomic_init(&w.stop, 0);
+    size_t workers = (size_t)sched_v2_detect_num_threads();
+    if (workers < 1) workers = 1;
+
+    cc__glob_dir* root = cc__glob_dir_new(plan->root, strlen(plan->root), NULL, 0, 0);
+    w.wake = cc_chan_create(workers);
+    CCNursery* n = root && w.wake ? cc_nursery_create(NULL) : NULL;
+    if (!n) {
+        free(root);
+        if (w.wake) cc_chan_free(w.wake);
+        pthread_mutex_destroy(&w.mu);
+        return ENOMEM;
+    }
+    cc_chan_init_elem(w.wake, sizeof(char));
+    w.stack = root;
+    w.pending = 1;
+    size_t spawned = 0;
+    for (size_t i = 0; i < workers; ++i) {
+        if (cc_nursery_spawn(n, cc__glob_worker, &w) == 0) spawned++;
+    }
+    if (spawned == 0) (void)cc__glob_worker(&w);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    cc_chan_free(w.wake);
+    pthread_mutex_destroy(&w.mu);
+    return w.root_err;
+}
 
-        glob_recurse(arena, result, subdir, pattern, recursive);
+/* cc_glob: collect under a lock, then copy into the arena in sorted order. */
+typedef struct {
+    pthread_mutex_t mu;
+    char** paths;
+    size_t count;
+    size_t cap;
+} cc__glob_collect;
+
+static int cc__glob_collect_emit(void* ctx, const char* path, size_t len, CCDirEntryType type) {
+    (void)type;
+    cc__glob_collect* c = (cc__glob_collect*)ctx;
+    char* copy = (char*)malloc(len + 1);
+    if (!copy) return 0;
+    memcpy(copy, path, len + 1);
+    pthread_mutex_lock(&c->mu);
+    if (c->count == c->cap) {
+        size_t next_cap = c->cap ? c->cap * 2 : 64;
+        char** next = (char**)realloc(c->paths, next_cap * sizeof(*next));
+        if (!next) {
+            pthread_mutex_unlock(&c->mu);
+            free(copy);
+            return 0;
+        }
+        c->paths = next;
+        c->cap = next_cap;
     }
+    c->paths[c->count++] = copy;
+    pthread_mutex_unlock(&c->mu);
+    return 0;
+}
 
-    cc_dir_close(iter);
+static int cc__glob_path_cmp(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
 }
 
 CCGlobResult cc_glob(CCArena* arena, const char* pattern) {
     CCGlobResult result = {0};
     if (!arena || !pattern) return result;
 
-    /* Check for ** (recursive) */
-    int recursive = (strstr(pattern, "**") != NULL);
-
-    /* Find directory and file pattern parts */
-    const char* last_sep = strrchr(pattern, PATH_SEP);
-#ifndef _WIN32
-    if (!last_sep) last_sep = strrchr(pattern, '/');
-#endif
-
-    char dir[4096];
-    const char* file_pattern;
-
-    if (last_sep) {
-        size_t dir_len = (size_t)(last_sep - pattern);
-        if (dir_len >= sizeof(dir)) return result;
-        memcpy(dir, pattern, dir_len);
-        dir[dir_len] = '\0';
-        file_pattern = last_sep + 1;
-
-        /* Handle ** in directory part */
-        char* star_star = strstr(dir, "**");
-        if (star_star) {
-            *star_star = '\0';  /* Truncate at ** */
-            if (dir[0] == '\0') strcpy(dir, ".");
-            recursive = 1;
+    cc__glob_plan plan;
+    if (cc__glob_compile(pattern, &plan) != 0) return result;
+
+    cc__glob_collect c = {0};
+    pthread_mutex_init(&c.mu, NULL);
+    (void)cc__glob_run(&plan, cc__glob_collect_emit, &c);
+    pthread_mutex_destroy(&c.mu);
+
+    if (c.count > 0) {
+        qsort(c.paths, c.count, sizeof(*c.paths), cc__glob_path_cmp);
+        result.paths = cc_arena_alloc(arena, c.count * sizeof(CCSlice), _Alignof(CCSlice));
+        if (result.paths) result.capacity = c.count;
+    }
+    for (size_t i = 0; i < c.count; ++i) {
+        size_t len = strlen(c.paths[i]);
+        char* copy = result.paths ? cc_arena_alloc(arena, len + 1, 1) : NULL;
+        if (copy) {
+            memcpy(copy, c.paths[i], len + 1);
+            result.paths[result.count].ptr = copy;
+            result.paths[result.count].len = len;
+            result.count++;
         }
-    } else {
-        strcpy(dir, ".");
-        file_pattern = pattern;
+        free(c.paths[i]);
     }
+    free(c.paths);
+    return result;
+}
 
-    if (recursive) {
-        glob_recurse(arena, &result, dir, file_pattern, 1);
-    } else {
-        glob_dir(arena, &result, dir, file_pattern, 0);
-    }
+static int cc__glob_stream_emit(void* ctx, const char* path, size_t len, CCDirEntryType type) {
+    CCChan* out = (CCChan*)ctx;
+    CCGlobEntry e = {.path = (char*)malloc(len + 1), .len = len, .type = type};
+    if (!e.path) return 0;
+    memcpy(e.path, path, len + 1);
+    if (cc_chan_send(out, &e, sizeof(e)) != 0) {
+        /* Receiver closed the channel: stop walking. */
+        free(e.path);
+        return 1;
+    }
+    return 0;
+}
 
-    return result;
+int cc_glob_stream(const char* pattern, CCChan* out) {
+    if (!pattern || !out) return EINVAL;
+    cc__glob_plan plan;
+    int err = cc__glob_compile(pattern, &plan);
+    if (err == 0) err = cc__glob_run(&plan, cc__glob_stream_emit, out);
+    cc_chan_close(out);
+    return err;
+}
+
+void cc_glob_entry_free(CCGlobEntry* e) {
+    if (!e) return;
+    free(e->path);
+    e->path = NULL;
+    e->len = 0;
 }
@@ -0,0 +1,1280 @@
+/*
+ * Concurrent-C DNS Stub Resolver
+ *
+ * Replaces getaddrinfo() for <std/dns.cch> and hostname-based net.c calls.
+ * Queries go out over UDP (TCP on truncation) through non-blocking sockets
+ * parked on io_wait, so a lookup inside a fiber never stalls its worker.
+ *
+ *   - /etc/hosts is consulted first (re-read when its mtime changes).
+ *   - /etc/resolv.conf supplies nameservers, search/domain, and the
+ *     ndots/timeout/attempts options.
+ *   - Answers are cached per (name, family) for their TTL; NXDOMAIN/NODATA
+ *     are cached for the SOA negative TTL.
+ *   - Concurrent lookups of the same key coalesce onto one in-flight query.
+ *
+ * Environment:
+ *   CC_DNS_RESOLV_CONF   alternate resolv.conf path
+ *   CC_DNS_HOSTS         alternate hosts path
+ *   CC_DNS_NAMESERVERS   comma-separated "ip[:port]" list; overrides resolv.conf
+ *   CC_DNS_SYSTEM=1      bypass the stub and use blocking getaddrinfo()
+ *   CC_DNS_TRACE=1       log queries and cache decisions to stderr
+ */
+
+#include <ccc/std/dns.cch>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "fiber_internal.h"
+#include "io_wait.h"
+
+/* Defined in net.c (same translation unit via concurrent_c.c). */
+static CCNetError errno_to_net_error(int err);
+static int cc__net_set_nonblocking(int fd);
+static void cc__net_set_cloexec_best_effort(int fd);
+static void cc__net_disable_sigpipe_best_effort(int fd);
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define CC_DNS_MAX_SERVERS 3
+#define CC_DNS_MAX_SEARCH 6
+#define CC_DNS_MAX_NAME 256
+#define CC_DNS_MAX_ADDRS 32
+#define CC_DNS_MAX_CNAME_CHAIN 8
+#define CC_DNS_UDP_MAX 1232
+#define CC_DNS_TCP_MAX 65535
+#define CC_DNS_QUERY_MAX (12 + CC_DNS_MAX_NAME + 4)
+#define CC_DNS_CACHE_BUCKETS 256
+#define CC_DNS_CACHE_MAX_ENTRIES 4096
+#define CC_DNS_MAX_TTL_SEC 86400u
+#define CC_DNS_DEFAULT_NEG_TTL_SEC 5u
+#define CC_DNS_HOSTS_RECHECK_NS 1000000000ull
+
+#define CC_DNS_TYPE_A 1
+#define CC_DNS_TYPE_CNAME 5
+#define CC_DNS_TYPE_SOA 6
+#define CC_DNS_TYPE_PTR 12
+#define CC_DNS_TYPE_AAAA 28
+#define CC_DNS_CLASS_IN 1
+
+#define CC_DNS_RCODE_NOERROR 0
+#define CC_DNS_RCODE_NXDOMAIN 3
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+typedef struct cc__dns_server {
+    struct sockaddr_storage sa;
+    socklen_t sa_len;
+} cc__dns_server;
+
+typedef struct cc__dns_host {
+    char* name;
+    CCIpAddr addr;
+} cc__dns_host;
+
+typedef struct cc__dns_waiter {
+    struct cc__dns_waiter* next;
+    void* fiber;
+    uint64_t wait_ticket;
+    _Atomic int ready;
+} cc__dns_waiter;
+
+typedef struct cc__dns_entry {
+    struct cc__dns_entry* next;
+    uint64_t hash;
+    CCDnsFamily family;
+    int absolute;          /* "host." skips the search list: not the same key as "host" */
+    int pending;           /* Query in flight; waiters queue on this entry */
+    int linked;            /* Still reachable from the bucket chain */
+    int refs;              /* Guarded by g_cc_dns.mu */
+    CCNetError err;        /* CC_NET_OK, or the cached negative result */
+    uint64_t expires_ns;
+    size_t count;
+    CCIpAddr* addrs;
+    cc__dns_waiter* waiters;
+    char name[];
+} cc__dns_entry;
+
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t cond;        /* Thread (non-fiber) waiters on pending entries */
+    int loaded;
+    cc__dns_server servers[CC_DNS_MAX_SERVERS];
+    int nservers;
+    char search[CC_DNS_MAX_SEARCH][CC_DNS_MAX_NAME];
+    int nsearch;
+    int ndots;
+    int timeout_ms;
+    int attempts;
+    cc__dns_host* hosts;
+    size_t nhosts;
+    time_t hosts_mtime;
+    uint64_t hosts_checked_ns;
+    cc__dns_entry* buckets[CC_DNS_CACHE_BUCKETS];
+    size_t nentries;
+    _Atomic uint32_t next_id;
+} cc__dns_state;
+
+static cc__dns_state g_cc_dns = {
+    .mu = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static int cc__dns_env_flag(const char* name) {
+    const char* env = getenv(name);
+    return (env && env[0] && !(env[0] == '0' && env[1] == '\0')) ? 1 : 0;
+}
+
+static int cc__dns_trace_enabled(void) {
+    static int mode = -1;
+    if (mode >= 0) return mode;
+    mode = cc__dns_env_flag("CC_DNS_TRACE");
+    return mode;
+}
+
+#define CC_DNS_TRACE(...) do { \
+    if (cc__dns_trace_enabled()) { fprintf(stderr, "[cc:dns] " __VA_ARGS__); fputc('\n', stderr); } \
+} while (0)
+
+static uint64_t cc__dns_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* io_wait deadlines are CLOCK_REALTIME (see cc__fiber_park_if_until). */
+static struct timespec cc__dns_deadline_after_ms(int ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+/* Transaction IDs are drawn from the OS CSPRNG, one draw per query: an
+ * off-path spoofer must not be able to predict them from the start time,
+ * the pid or an earlier ID.  The clock fallback only runs when the kernel
+ * offers no entropy source at all. */
+static uint16_t cc__dns_next_id(void) {
+    uint16_t id = 0;
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    arc4random_buf(&id, sizeof(id));
+    return id;
+#else
+#if defined(__linux__) && defined(SYS_getrandom)
+    for (;;) {
+        /* GRND_NONBLOCK (1): before the pool is seeded, use urandom below. */
+        long n = syscall(SYS_getrandom, &id, sizeof(id), 1);
+        if (n == (long)sizeof(id)) return id;
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+#endif
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ssize_t n;
+        do {
+            n = read(fd, &id, sizeof(id));
+        } while (n < 0 && errno == EINTR);
+        close(fd);
+        if (n == (ssize_t)sizeof(id)) return id;
+    }
+    uint32_t x = (uint32_t)cc__dns_now_ns() ^
+                 atomic_fetch_add_explicit(&g_cc_dns.next_id, 0x9e3779b9u, memory_order_relaxed);
+    return (uint16_t)(x ^ (x >> 16));
+#endif
+}
+
+static uint64_t cc__dns_hash(const char* name, int absolute, CCDnsFamily family) {
+    uint64_t h = 1469598103934665603ull ^ (uint64_t)family ^ ((uint64_t)(absolute != 0) << 8);
+    for (const char* p = name; *p; ++p) {
+        h ^= (uint8_t)*p;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/* Lowercase, strip one trailing dot, validate length.  *out_absolute reports
+ * whether the caller wrote a fully-qualified name ("host."). */
+static int cc__dns_normalize(const char* in, size_t len, char* out, int* out_absolute) {
+    *out_absolute = 0;
+    if (len > 0 && in[len - 1] == '.') {
+        *out_absolute = 1;
+        len--;
+    }
+    if (len == 0 || len >= CC_DNS_MAX_NAME - 2) return -1;
+    for (size_t i = 0; i < len; ++i) {
+        char c = in[i];
+        if (c == '\0') return -1;
+        out[i] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+    out[len] = '\0';
+    return 0;
+}
+
+static int cc__dns_parse_ip(const char* s, CCIpAddr* out) {
+    struct in_addr in4;
+    struct in6_addr in6;
+    memset(out, 0, sizeof(*out));
+    if (inet_pton(AF_INET, s, &in4) == 1) {
+        out->family = 4;
+        memcpy(out->addr.v4, &in4, 4);
+        return 0;
+    }
+    if (inet_pton(AF_INET6, s, &in6) == 1) {
+        out->family = 6;
+        memcpy(out->addr.v6, &in6, 16);
+        return 0;
+    }
+    return -1;
+}
+
+static int cc__dns_family_match(CCDnsFamily family, const CCIpAddr* addr) {
+    return family == CC_DNS_ANY || (int)family == (int)addr->family;
+}
+
+/* ============================================================================
+ * Configuration: resolv.conf and hosts
+ * ============================================================================ */
+
+static int cc__dns_parse_server(const char* text, cc__dns_server* out) {
+    char buf[128];
+    size_t len = strlen(text);
+    if (len == 0 || len >= sizeof(buf)) return -1;
+    memcpy(buf, text, len + 1);
+
+    char* host = buf;
+    int port = 53;
+    if (buf[0] == '[') {
+        char* close_br = strchr(buf, ']');
+        if (!close_br) return -1;
+        *close_br = '\0';
+        host = buf + 1;
+        if (close_br[1] == ':') port = atoi(close_br + 2);
+    } else {
+        char* colon = strchr(buf, ':');
+        if (colon && !strchr(colon + 1, ':')) {
+            *colon = '\0';
+            port = atoi(colon + 1);
+        }
+    }
+    if (port <= 0 || port > 65535) return -1;
+
+    /* Drop any IPv6 zone suffix; link-local nameservers are rare enough
+     * that we do not thread scope ids through. */
+    char* zone = strchr(host, '%');
+    if (zone) *zone = '\0';
+
+    memset(out, 0, sizeof(*out));
+    struct sockaddr_in* sin = (struct sockaddr_in*)&out->sa;
+    struct sockaddr_in6* sin6 = (struct sockaddr_in6*)&out->sa;
+    if (inet_pton(AF_INET, host, &sin->sin_addr) == 1) {
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons((uint16_t)port);
+        out->sa_len = sizeof(*sin);
+        return 0;
+    }
+    if (inet_pton(AF_INET6, host, &sin6->sin6_addr) == 1) {
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = htons((uint16_t)port);
+        out->sa_len = sizeof(*sin6);
+        return 0;
+    }
+    return -1;
+}
+
+static void cc__dns_add_search_locked(const char* domain) {
+    if (g_cc_dns.nsearch >= CC_DNS_MAX_SEARCH) return;
+    int absolute = 0;
+    char norm[CC_DNS_MAX_NAME];
+    if (cc__dns_normalize(domain, strlen(domain), norm, &absolute) != 0) return;
+    memcpy(g_cc_dns.search[g_cc_dns.nsearch++], norm, strlen(norm) + 1);
+}
+
+static void cc__dns_load_resolv_conf_locked(void) {
+    const char* path = getenv("CC_DNS_RESOLV_CONF");
+    if (!path || !path[0]) path = "/etc/resolv.conf";
+
+    g_cc_dns.nservers = 0;
+    g_cc_dns.nsearch = 0;
+    g_cc_dns.ndots = 1;
+    g_cc_dns.timeout_ms = 5000;
+    g_cc_dns.attempts = 2;
+
+    FILE* f = fopen(path, "r");
+    if (f) {
+        char line[512];
+        while (fgets(line, sizeof(line), f)) {
+            char* save = NULL;
+            char* key = strtok_r(line, " \t\r\n", &save);
+            if (!key || key[0] == '#' || key[0] == ';') continue;
+            if (strcmp(key, "nameserver") == 0) {
+                char* val = strtok_r(NULL, " \t\r\n", &save);
+                if (val && g_cc_dns.nservers < CC_DNS_MAX_SERVERS &&
+                    cc__dns_parse_server(val, &g_cc_dns.servers[g_cc_dns.nservers]) == 0) {
+                    g_cc_dns.nservers++;
+                }
+            } else if (strcmp(key, "search") == 0 || strcmp(key, "domain") == 0) {
+                /* Last search/domain line wins, as in glibc. */
+                g_cc_dns.nsearch = 0;
+                char* val;
+                while ((val = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+                    cc__dns_add_search_locked(val);
+                }
+            } else if (strcmp(key, "options") == 0) {
+                char* opt;
+                while ((opt = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+                    if (strncmp(opt, "ndots:", 6) == 0) {
+                        int v = atoi(opt + 6);
+                        g_cc_dns.ndots = v < 0 ? 0 : (v > 15 ? 15 : v);
+                    } else if (strncmp(opt, "timeout:", 8) == 0) {
+                        int v = atoi(opt + 8);
+                        g_cc_dns.timeout_ms = (v < 1 ? 1 : (v > 30 ? 30 : v)) * 1000;
+                    } else if (strncmp(opt, "attempts:", 9) == 0) {
+                        int v = atoi(opt + 9);
+                        g_cc_dns.attempts = v < 1 ? 1 : (v > 5 ? 5 : v);
+                    }
+                }
+            }
+        }
+        fclose(f);
+    }
+
+    const char* override = getenv("CC_DNS_NAMESERVERS");
+    if (override && override[0]) {
+        char buf[512];
+        snprintf(buf, sizeof(buf), "%s", override);
+        g_cc_dns.nservers = 0;
+        char* save = NULL;
+        for (char* tok = strtok_r(buf, ", \t", &save); tok; tok = strtok_r(NULL, ", \t", &save)) {
+            if (g_cc_dns.nservers < CC_DNS_MAX_SERVERS &&
+                cc__dns_parse_server(tok, &g_cc_dns.servers[g_cc_dns.nservers]) == 0) {
+                g_cc_dns.nservers++;
+            }
+        }
+    }
+
+    /* Same default as glibc when resolv.conf names no server. */
+    if (g_cc_dns.nservers == 0) {
+        (void)cc__dns_parse_server("127.0.0.1", &g_cc_dns.servers[0]);
+        g_cc_dns.nservers = 1;
+    }
+}
+
+static const char* cc__dns_hosts_path(void) {
+    const char* path = getenv("CC_DNS_HOSTS");
+    return (path && path[0]) ? path : "/etc/hosts";
+}
+
+static void cc__dns_free_hosts_locked(void) {
+    for (size_t i = 0; i < g_cc_dns.nhosts; ++i) free(g_cc_dns.hosts[i].name);
+    free(g_cc_dns.hosts);
+    g_cc_dns.hosts = NULL;
+    g_cc_dns.nhosts = 0;
+}
+
+static void cc__dns_load_hosts_locked(void) {
+    cc__dns_free_hosts_locked();
+    struct stat st;
+    const char* path = cc__dns_hosts_path();
+    g_cc_dns.hosts_mtime = (stat(path, &st) == 0) ? st.st_mtime : 0;
+
+    FILE* f = fopen(path, "r");
+    if (!f) return;
+    size_t cap = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* save = NULL;
+        char* ip = strtok_r(line, " \t\r\n", &save);
+        if (!ip) continue;
+        CCIpAddr addr;
+        if (cc__dns_parse_ip(ip, &addr) != 0) continue;
+        char* name;
+        while ((name = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+            int absolute = 0;
+            char norm[CC_DNS_MAX_NAME];
+            if (cc__dns_normalize(name, strlen(name), norm, &absolute) != 0) continue;
+            if (g_cc_dns.nhosts == cap) {
+                size_t ncap = cap ? cap * 2 : 32;
+                cc__dns_host* grown = (cc__dns_host*)realloc(g_cc_dns.hosts, ncap * sizeof(*grown));
+                if (!grown) break;
+                g_cc_dns.hosts = grown;
+                cap = ncap;
+            }
+            char* copy = strdup(norm);
+            if (!copy) break;
+            g_cc_dns.hosts[g_cc_dns.nhosts].name = copy;
+            g_cc_dns.hosts[g_cc_dns.nhosts].addr = addr;
+            g_cc_dns.nhosts++;
+        }
+    }
+    fclose(f);
+}
+
+/* Loads config on first use and re-reads hosts at most once a second when
+ * its mtime moves.  Caller holds g_cc_dns.mu. */
+static void cc__dns_ensure_config_locked(void) {
+    uint64_t now = cc__dns_now_ns();
+    if (!g_cc_dns.loaded) {
+        cc__dns_load_resolv_conf_locked();
+        cc__dns_load_hosts_locked();
+        g_cc_dns.hosts_checked_ns = now;
+        g_cc_dns.loaded = 1;
+        return;
+    }
+    if (now - g_cc_dns.hosts_checked_ns < CC_DNS_HOSTS_RECHECK_NS) return;
+    g_cc_dns.hosts_checked_ns = now;
+    struct stat st;
+    time_t mtime = (stat(cc__dns_hosts_path(), &st) == 0) ? st.st_mtime : 0;
+    if (mtime != g_cc_dns.hosts_mtime) cc__dns_load_hosts_locked();
+}
+
+static size_t cc__dns_hosts_lookup_locked(const char* name, CCDnsFamily family,
+                                          CCIpAddr* out, size_t max) {
+    size_t n = 0;
+    /* IPv4 entries first so "localhost:port" keeps binding 127.0.0.1. */
+    for (int pass = 0; pass < 2; ++pass) {
+        uint8_t want = pass == 0 ? 4 : 6;
+        for (size_t i = 0; i < g_cc_dns.nhosts && n < max; ++i) {
+            const cc__dns_host* h = &g_cc_dns.hosts[i];
+            if (h->addr.family != want || !cc__dns_family_match(family, &h->addr)) continue;
+            if (strcmp(h->name, name) != 0) continue;
+            out[n++] = h->addr;
+        }
+    }
+    return n;
+}
+
+/* ============================================================================
+ * Wire format
+ * ============================================================================ */
+
+static uint16_t cc__dns_rd16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static uint32_t cc__dns_rd32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static size_t cc__dns_build_query(uint8_t* out, size_t cap, uint16_t id,
+                                  const char* name, uint16_t qtype) {
+    size_t name_len = strlen(name);
+    if (cap < 12 + name_len + 2 + 4) return 0;
+    memset(out, 0, 12);
+    out[0] = (uint8_t)(id >> 8);
+    out[1] = (uint8_t)id;
+    out[2] = 0x01;  /* RD */
+    out[5] = 1;     /* QDCOUNT */
+    size_t off = 12;
+    const char* label = name;
+    while (*label) {
+        const char* dot = strchr(label, '.');
+        size_t llen = dot ? (size_t)(dot - label) : strlen(label);
+        if (llen == 0 || llen > 63) return 0;
+        out[off++] = (uint8_t)llen;
+        memcpy(out + off, label, llen);
+        off += llen;
+        label += llen;
+        if (*label == '.') label++;
+    }
+    out[off++] = 0;
+    out[off++] = (uint8_t)(qtype >> 8);
+    out[off++] = (uint8_t)qtype;
+    out[off++] = 0;
+    out[off++] = CC_DNS_CLASS_IN;
+    return off;
+}
+
+/* Decode a (possibly compressed) name at *off into out as lowercase dotted
+ * text.  out may be NULL to skip.  Advances *off past the name. */
+static int cc__dns_read_name(const uint8_t* msg, size_t len, size_t* off, char* out, size_t out_cap) {
+    size_t pos = *off;
+    size_t out_len = 0;
+    int jumped = 0;
+    int hops = 0;
+    while (1) {
+        if (pos >= len) return -1;
+        uint8_t l = msg[pos];
+        if ((l & 0xC0) == 0xC0) {
+            if (pos + 1 >= len || ++hops > 64) return -1;
+            if (!jumped) *off = pos + 2;
+            jumped = 1;
+            pos = ((size_t)(l & 0x3F) << 8) | msg[pos + 1];
+            continue;
+        }
+        if (l & 0xC0) return -1;
+        pos++;
+        if (l == 0) break;
+        if (pos + l > len) return -1;
+        if (out) {
+            if (out_len + l + 2 > out_cap) return -1;
+            if (out_len) out[out_len++] = '.';
+            for (uint8_t i = 0; i < l; ++i) {
+                char c = (char)msg[pos + i];
+                out[out_len++] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+            }
+        }
+        pos += l;
+    }
+    if (out) out[out_len] = '\0';
+    if (!jumped) *off = pos;
+    return 0;
+}
+
+typedef struct cc__dns_answer {
+    int rcode;
+    int truncated;
+    size_t count;
+    CCIpAddr addrs[CC_DNS_MAX_ADDRS];
+    uint32_t ttl;          /* Min TTL over the records we used */
+    uint32_t neg_ttl;      /* From the SOA in the authority section */
+    char ptr_name[CC_DNS_MAX_NAME];
+} cc__dns_answer;
+
+/* Owner names an answer may carry records for: qname, then each CNAME
+ * target along the chain that starts at it, in the answer section at `off`
+ * (`an` records).  Records may come in any order, so each link is found
+ * with a fresh scan.  Returns the number of names in chain[], or -1 on a
+ * malformed section. */
+static int cc__dns_cname_chain(const uint8_t* msg, size_t len, size_t off, uint16_t an,
+                               const char* qname, char chain[][CC_DNS_MAX_NAME]) {
+    int n = 1;
+    snprintf(chain[0], CC_DNS_MAX_NAME, "%s", qname);
+    while (n < CC_DNS_MAX_CNAME_CHAIN) {
+        size_t pos = off;
+        int linked = 0;
+        for (uint16_t i = 0; i < an && !linked; ++i) {
+            char owner[CC_DNS_MAX_NAME];
+            if (cc__dns_read_name(msg, len, &pos, owner, sizeof(owner)) != 0) return -1;
+            if (pos + 10 > len) return -1;
+            uint16_t type = cc__dns_rd16(msg + pos);
+            uint16_t klass = cc__dns_rd16(msg + pos + 2);
+            uint16_t rdlen = cc__dns_rd16(msg + pos + 8);
+            pos += 10;
+            if (pos + rdlen > len) return -1;
+            if (type == CC_DNS_TYPE_CNAME && klass == CC_DNS_CLASS_IN &&
+                strcmp(owner, chain[n - 1]) == 0) {
+                size_t rd_off = pos;
+                if (cc__dns_read_name(msg, len, &rd_off, chain[n], CC_DNS_MAX_NAME) != 0) return -1;
+                for (int k = 0; k < n; ++k) {
+                    if (strcmp(chain[k], chain[n]) == 0) return n;  /* Loop */
+                }
+                n++;
+                linked = 1;
+            }
+            pos += rdlen;
+        }
+        if (!linked) break;
+    }
+    return n;
+}
+
+static int cc__dns_in_chain(char chain[][CC_DNS_MAX_NAME], int n, const char* name) {
+    for (int i = 0; i < n; ++i) {
+        if (strcmp(chain[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+/* Returns 0 when msg is a well-formed response to (id, qname, qtype).
+ * Answer records count only when their owner is qname or a CNAME target
+ * along its chain; anything else in the section is ignored. */
+static int cc__dns_parse_response(const uint8_t* msg, size_t len, uint16_t id,
+                                  const char* qname, uint16_t qtype, cc__dns_answer* out) {
+    if (len < 12 || cc__dns_rd16(msg) != id) return -1;
+    if (!(msg[2] & 0x80)) return -1;  /* Not a response */
+    memset(out, 0, sizeof(*out));
+    out->rcode = msg[3] & 0x0F;
+    out->truncated = (msg[2] & 0x02) != 0;
+    out->ttl = CC_DNS_MAX_TTL_SEC;
+    out->neg_ttl = CC_DNS_DEFAULT_NEG_TTL_SEC;
+    uint16_t qd = cc__dns_rd16(msg + 4);
+    uint16_t an = cc__dns_rd16(msg + 6);
+    uint16_t ns = cc__dns_rd16(msg + 8);
+    if (qd != 1) return -1;
+
+    size_t off = 12;
+    char name[CC_DNS_MAX_NAME];
+    if (cc__dns_read_name(msg, len, &off, name, sizeof(name)) != 0) return -1;
+    if (off + 4 > len) return -1;
+    if (strcmp(name, qname) != 0 || cc__dns_rd16(msg + off) != qtype) return -1;
+    off += 4;
+    if (out->truncated) return 0;
+
+    char chain[CC_DNS_MAX_CNAME_CHAIN][CC_DNS_MAX_NAME];
+    int nchain = cc__dns_cname_chain(msg, len, off, an, qname, chain);
+    if (nchain < 0) return -1;
+
+    for (uint32_t i = 0; i < (uint32_t)an + ns; ++i) {
+        if (cc__dns_read_name(msg, len, &off, name, sizeof(name)) != 0) return -1;
+        if (off + 10 > len) return -1;
+        uint16_t type = cc__dns_rd16(msg + off);
+        uint16_t klass = cc__dns_rd16(msg + off + 2);
+        uint32_t ttl = cc__dns_rd32(msg + off + 4);
+        uint16_t rdlen = cc__dns_rd16(msg + off + 8);
+        off += 10;
+        if (off + rdlen > len) return -1;
+        if (ttl > CC_DNS_MAX_TTL_SEC) ttl = CC_DNS_MAX_TTL_SEC;
+        if (klass == CC_DNS_CLASS_IN && i < an && cc__dns_in_chain(chain, nchain, name)) {
+            int used = 0;
+            if (type == CC_DNS_TYPE_A && qtype == CC_DNS_TYPE_A && rdlen == 4 &&
+                out->count < CC_DNS_MAX_ADDRS) {
+                out->addrs[out->count].family = 4;
+                memcpy(out->addrs[out->count].addr.v4, msg + off, 4);
+                out->count++;
+                used = 1;
+            } else if (type == CC_DNS_TYPE_AAAA && qtype == CC_DNS_TYPE_AAAA && rdlen == 16 &&
+                       out->count < CC_DNS_MAX_ADDRS) {
+                out->addrs[out->count].family = 6;
+                memcpy(out->addrs[out->count].addr.v6, msg + off, 16);
+                out->count++;
+                used = 1;
+            } else if (type == CC_DNS_TYPE_PTR && qtype == CC_DNS_TYPE_PTR && !out->ptr_name[0]) {
+                size_t rd_off = off;
+                if (cc__dns_read_name(msg, len, &rd_off, out->ptr_name, sizeof(out->ptr_name)) != 0) {
+                    out->ptr_name[0] = '\0';
+                } else {
+                    used = 1;
+                }
+            } else if (type == CC_DNS_TYPE_CNAME) {
+                used = 1;  /* Chain link: its TTL bounds the answer's lifetime */
+            }
+            if (used && ttl < out->ttl) out->ttl = ttl;
+        } else if (type == CC_DNS_TYPE_SOA && i >= an && rdlen >= 22) {
+            uint32_t minimum = cc__dns_rd32(msg + off + rdlen - 4);
+            out->neg_ttl = ttl < minimum ? ttl : minimum;
+        }
+        off += rdlen;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Transport
+ * ============================================================================ */
+
+typedef struct cc__dns_question {
+    const char* name;
+    uint16_t qtype;
+    uint16_t id;
+    int done;
+    size_t qlen;
+    uint8_t query[CC_DNS_QUERY_MAX];
+    cc__dns_answer answer;
+} cc__dns_question;
+
+static int cc__dns_open_socket(int family, int type) {
+    int fd = socket(family, type, 0);
+    if (fd < 0) return -1;
+    if (cc__net_set_nonblocking(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    cc__net_set_cloexec_best_effort(fd);
+    return fd;
+}
+
+static int cc__dns_io_until(int fd, short events, const struct timespec* deadline) {
+    int err = cc__io_wait_fd_until(fd, events, deadline);
+    if (err != EIO) return err;
+    /* io_wait reports POLLERR/POLLHUP as EIO; let the syscall surface the
+     * real error instead, unless we are already out of time. */
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    if (now.tv_sec > deadline->tv_sec ||
+        (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec)) {
+        return ETIMEDOUT;
+    }
+    return 0;
+}
+
+static int cc__dns_tcp_io(int fd, uint8_t* buf, size_t len, int writing,
+                          const struct timespec* deadline) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = writing ? send(fd, buf + done, len - done, MSG_NOSIGNAL)
+                            : recv(fd, buf + done, len - done, 0);
+        if (n > 0) {
+            done += (size_t)n;
+            continue;
+        }
+        if (n == 0) return ECONNRESET;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return errno;
+        int err = cc__dns_io_until(fd, writing ? POLLOUT : POLLIN, deadline);
+        if (err != 0) return err;
+    }
+    return 0;
+}
+
+/* Re-ask one truncated question over TCP (RFC 7766). */
+static int cc__dns_exchange_tcp(const cc__dns_server* srv, cc__dns_question* q,
+                                const struct timespec* deadline) {
+    int fd = cc__dns_open_socket(srv->sa.ss_family, SOCK_STREAM);
+    if (fd < 0) return errno;
+    cc__net_disable_sigpipe_best_effort(fd);
+    int err = 0;
+    uint8_t* resp = NULL;
+    if (connect(fd, (const struct sockaddr*)&srv->sa, srv->sa_len) != 0) {
+        if (errno != EINPROGRESS) {
+            err = errno;
+            goto out;
+        }
+        err = cc__dns_io_until(fd, POLLOUT, deadline);
+        if (err != 0) goto out;
+        int so_err = 0;
+        socklen_t so_len = sizeof(so_err);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_err, &so_len) != 0) so_err = errno;
+        if (so_err != 0) {
+            err = so_err;
+            goto out;
+        }
+    }
+
+    uint8_t frame[2 + CC_DNS_QUERY_MAX];
+    frame[0] = (uint8_t)(q->qlen >> 8);
+    frame[1] = (uint8_t)q->qlen;
+    memcpy(frame + 2, q->query, q->qlen);
+    err = cc__dns_tcp_io(fd, frame, q->qlen + 2, 1, deadline);
+    if (err != 0) goto out;
+
+    uint8_t len_buf[2];
+    err = cc__dns_tcp_io(fd, len_buf, 2, 0, deadline);
+    if (err != 0) goto out;
+    size_t rlen = cc__dns_rd16(len_buf);
+    resp = (uint8_t*)malloc(rlen ? rlen : 1);
+    if (!resp) {
+        err = ENOMEM;
+        goto out;
+    }
+    err = cc__dns_tcp_io(fd, resp, rlen, 0, deadline);
+    if (err != 0) goto out;
+    if (cc__dns_parse_response(resp, rlen, q->id, q->name, q->qtype, &q->answer) != 0 ||
+        q->answer.truncated) {
+        err = EPROTO;
+        goto out;
+    }
+    q->done = 1;
+out:
+    free(resp);
+    cc__io_wait_forget_fd(fd);
+    close(fd);
+    return err;
+}
+
+/* One UDP round against one server: send every unanswered question, then
+ * collect replies until all are answered or the per-try timeout expires. */
+static void cc__dns_exchange_udp(const cc__dns_server* srv, cc__dns_question* qs, int nq, int timeout_ms) {
+    int fd = cc__dns_open_socket(srv->sa.ss_family, SOCK_DGRAM);
+    if (fd < 0) return;
+    /* connect() makes the kernel drop datagrams from any other source. */
+    if (connect(fd, (const struct sockaddr*)&srv->sa, srv->sa_len) != 0) {
+        close(fd);
+        return;
+    }
+    struct timespec deadline = cc__dns_deadline_after_ms(timeout_ms);
+    int pending = 0;
+    for (int i = 0; i < nq; ++i) {
+        if (qs[i].done) continue;
+        qs[i].id = cc__dns_next_id();
+        qs[i].query[0] = (uint8_t)(qs[i].id >> 8);
+        qs[i].query[1] = (uint8_t)qs[i].id;
+        if (send(fd, qs[i].query, qs[i].qlen, 0) == (ssize_t)qs[i].qlen) pending++;
+        CC_DNS_TRACE("query %s type=%u id=%u", qs[i].name, qs[i].qtype, qs[i].id);
+    }
+
+    uint8_t buf[CC_DNS_UDP_MAX];
+    while (pending > 0) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) break;
+            if (cc__dns_io_until(fd, POLLIN, &deadline) != 0) break;
+            continue;
+        }
+        if (n < 12) continue;
+        uint16_t id = cc__dns_rd16(buf);
+        for (int i = 0; i < nq; ++i) {
+            cc__dns_question* q = &qs[i];
+            if (q->done || q->id != id) continue;
+            if (cc__dns_parse_response(buf, (size_t)n, q->id, q->name, q->qtype, &q->answer) != 0) break;
+            if (q->answer.truncated) {
+                CC_DNS_TRACE("truncated %s type=%u, retrying over tcp", q->name, q->qtype);
+                (void)cc__dns_exchange_tcp(srv, q, &deadline);
+            } else {
+                q->done = 1;
+            }
+            /* SERVFAIL/REFUSED: leave undone so the next server is asked. */
+            if (q->done && q->answer.rcode != CC_DNS_RCODE_NOERROR &&
+                q->answer.rcode != CC_DNS_RCODE_NXDOMAIN) {
+                q->done = 0;
+            }
+            pending--;
+            break;
+        }
+    }
+    cc__io_wait_forget_fd(fd);
+    close(fd);
+}
+
+/* Returns CC_NET_OK once every question has a definitive answer. */
+static CCNetError cc__dns_exchange(cc__dns_question* qs, int nq) {
+    cc__dns_server servers[CC_DNS_MAX_SERVERS];
+    int nservers, attempts, timeout_ms;
+    pthread_mutex_lock(&g_cc_dns.mu);
+    nservers = g_cc_dns.nservers;
+    memcpy(servers, g_cc_dns.servers, sizeof(servers));
+    attempts = g_cc_dns.attempts;
+    timeout_ms = g_cc_dns.timeout_ms;
+    pthread_mutex_unlock(&g_cc_dns.mu);
+
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        for (int s = 0; s < nservers; ++s) {
+            cc__dns_exchange_udp(&servers[s], qs, nq, timeout_ms);
+            int all_done = 1;
+            for (int i = 0; i < nq; ++i) all_done &= qs[i].done;
+            if (all_done) return CC_NET_OK;
+        }
+    }
+    return CC_NET_TIMED_OUT;
+}
+
+/* Ask one fully-qualified candidate name.  NXDOMAIN and NODATA come back as
+ * CC_NET_DNS_FAILURE with *neg_ttl set so the result can be cached. */
+static CCNetError cc__dns_query_name(const char* fqdn, CCDnsFamily family,
+                                     CCIpAddr* out, size_t max, size_t* out_count,
+                                     uint32_t* out_ttl) {
+    cc__dns_question qs[2];
+    int nq = 0;
+    memset(qs, 0, sizeof(qs));
+    if (family != CC_DNS_IPV6) qs[nq++].qtype = CC_DNS_TYPE_A;
+    if (family != CC_DNS_IPV4) qs[nq++].qtype = CC_DNS_TYPE_AAAA;
+    for (int i = 0; i < nq; ++i) {
+        qs[i].name = fqdn;
+        qs[i].qlen = cc__dns_build_query(qs[i].query, sizeof(qs[i].query), 0, fqdn, qs[i].qtype);
+        if (qs[i].qlen == 0) return CC_NET_INVALID_ADDRESS;
+    }
+
+    CCNetError err = cc__dns_exchange(qs, nq);
+    if (err != CC_NET_OK) return err;
+
+    size_t n = 0;
+    uint32_t ttl = CC_DNS_MAX_TTL_SEC;
+    uint32_t neg_ttl = CC_DNS_MAX_TTL_SEC;
+    for (int i = 0; i < nq; ++i) {
+        const cc__dns_answer* a = &qs[i].answer;
+        for (size_t j = 0; j < a->count && n < max; ++j) out[n++] = a->addrs[j];
+        if (a->count > 0 && a->ttl < ttl) ttl = a->ttl;
+        if (a->neg_ttl < neg_ttl) neg_ttl = a->neg_ttl;
+    }
+    *out_count = n;
+    *out_ttl = n > 0 ? ttl : neg_ttl;
+    return n > 0 ? CC_NET_OK : CC_NET_DNS_FAILURE;
+}
+
+/* Walk the resolv.conf search list the way res_search does. */
+static CCNetError cc__dns_query_search(const char* name, int absolute, CCDnsFamily family,
+                                       CCIpAddr* out, size_t max, size_t* out_count,
+                                       uint32_t* out_ttl) {
+    char search[CC_DNS_MAX_SEARCH][CC_DNS_MAX_NAME];
+    int nsearch, ndots;
+    pthread_mutex_lock(&g_cc_dns.mu);
+    nsearch = absolute ? 0 : g_cc_dns.nsearch;
+    ndots = g_cc_dns.ndots;
+    memcpy(search, g_cc_dns.search, sizeof(search));
+    pthread_mutex_unlock(&g_cc_dns.mu);
+
+    int dots = 0;
+    for (const char* p = name; *p; ++p) dots += (*p == '.');
+    int as_is_first = absolute || dots >= ndots;
+
+    CCNetError last = CC_NET_DNS_FAILURE;
+    uint32_t neg_ttl = CC_DNS_MAX_TTL_SEC;
+    char candidate[CC_DNS_MAX_NAME * 2];
+    for (int i = -1; i <= nsearch; ++i) {
+        /* i == -1: as-is before the search list; i == nsearch: as-is after. */
+        if (i == -1 && !as_is_first) continue;
+        if (i == nsearch && (as_is_first || absolute)) continue;
+        if (i >= 0 && i < nsearch) {
+            snprintf(candidate, sizeof(candidate), "%s.%s", name, search[i]);
+            if (strlen(candidate) >= CC_DNS_MAX_NAME - 2) continue;
+        } else {
+            snprintf(candidate, sizeof(candidate), "%s", name);
+        }
+        uint32_t ttl = 0;
+        last = cc__dns_query_name(candidate, family, out, max, out_count, &ttl);
+        if (last == CC_NET_OK) {
+            *out_ttl = ttl;
+            return CC_NET_OK;
+        }
+        if (last != CC_NET_DNS_FAILURE) return last;  /* Transport failure: stop */
+        if (ttl < neg_ttl) neg_ttl = ttl;
+    }
+    *out_count = 0;
+    *out_ttl = neg_ttl;
+    return last;
+}
+
+/* ============================================================================
+ * Cache
+ * ============================================================================ */
+
+static void cc__dns_entry_release_locked(cc__dns_entry* e) {
+    if (--e->refs == 0 && !e->linked) {
+        free(e->addrs);
+        free(e);
+    }
+}
+
+static void cc__dns_unlink_locked(cc__dns_entry** link) {
+    cc__dns_entry* e = *link;
+    *link = e->next;
+    e->next = NULL;
+    e->linked = 0;
+    g_cc_dns.nentries--;
+    e->refs++;
+    cc__dns_entry_release_locked(e);
+}
+
+/* Sweep expired entries; if still over budget, drop every settled entry. */
+static void cc__dns_evict_locked(uint64_t now) {
+    for (int pass = 0; pass < 2 && g_cc_dns.nentries >= CC_DNS_CACHE_MAX_ENTRIES; ++pass) {
+        for (size_t b = 0; b < CC_DNS_CACHE_BUCKETS; ++b) {
+            cc__dns_entry** link = &g_cc_dns.buckets[b];
+            while (*link) {
+                cc__dns_entry* e = *link;
+                if (!e->pending && (pass == 1 || e->expires_ns <= now)) {
+                    cc__dns_unlink_locked(link);
+                } else {
+                    link = &e->next;
+                }
+            }
+        }
+    }
+}
+
+static size_t cc__dns_copy_out(const cc__dns_entry* e, CCIpAddr* out, size_t max) {
+    size_t n = e->count < max ? e->count : max;
+    if (n) memcpy(out, e->addrs, n * sizeof(CCIpAddr));
+    return n;
+}
+
+static void cc__dns_wait_pending_locked(cc__dns_entry* e) {
+    if (cc__fiber_in_context()) {
+        cc__dns_waiter w = {0};
+        w.fiber = cc__fiber_current();
+        w.wait_ticket = cc__fiber_publish_wait_ticket(w.fiber);
+        w.next = e->waiters;
+        e->waiters = &w;
+        pthread_mutex_unlock(&g_cc_dns.mu);
+        cc__fiber_set_park_obj(e);
+        CC_FIBER_SUSPEND_UNTIL_READY(&w.ready, 0, "dns_lookup");
+        cc__fiber_set_park_obj(NULL);
+        pthread_mutex_lock(&g_cc_dns.mu);
+        return;
+    }
+    cc_external_wait_enter();
+    while (e->pending) pthread_cond_wait(&g_cc_dns.cond, &g_cc_dns.mu);
+    cc_external_wait_leave();
+}
+
+static void cc__dns_publish_locked(cc__dns_entry* e) {
+    cc__dns_waiter* w = e->waiters;
+    e->waiters = NULL;
+    e->pending = 0;
+    pthread_cond_broadcast(&g_cc_dns.cond);
+    while (w) {
+        /* The node lives on the waiter's stack: read it before the store
+         * that lets the waiter return. */
+        cc__dns_waiter* next = w->next;
+        void* fiber = w->fiber;
+        int wake = cc__fiber_wait_ticket_matches(fiber, w->wait_ticket);
+        atomic_store_explicit(&w->ready, 1, memory_order_release);
+        if (wake) cc__fiber_unpark(fiber);
+        w = next;
+    }
+}
+
+static CCNetError cc__dns_resolve_cached(const char* name, int absolute, CCDnsFamily family,
+                                         CCIpAddr* out, size_t max, size_t* out_count) {
+    uint64_t hash = cc__dns_hash(name, absolute, family);
+    size_t bucket = (size_t)(hash % CC_DNS_CACHE_BUCKETS);
+    size_t name_len = strlen(name);
+
+    pthread_mutex_lock(&g_cc_dns.mu);
+    cc__dns_entry* e = NULL;
+    for (cc__dns_entry** link = &g_cc_dns.buckets[bucket]; *link; ) {
+        cc__dns_entry* cur = *link;
+        if (cur->hash == hash && cur->family == family && cur->absolute == absolute &&
+            strcmp(cur->name, name) == 0) {
+            if (!cur->pending && cur->expires_ns <= cc__dns_now_ns()) {
+                cc__dns_unlink_locked(link);
+                continue;
+            }
+            e = cur;
+            break;
+        }
+        link = &cur->next;
+    }
+
+    if (e) {
+        e->refs++;
+        if (e->pending) {
+            CC_DNS_TRACE("coalesce %s family=%d", name, (int)family);
+            cc__dns_wait_pending_locked(e);
+        } else {
+            CC_DNS_TRACE("cache hit %s family=%d err=%d", name, (int)family, (int)e->err);
+        }
+        CCNetError err = e->err;
+        *out_count = err == CC_NET_OK ? cc__dns_copy_out(e, out, max) : 0;
+        cc__dns_entry_release_locked(e);
+        pthread_mutex_unlock(&g_cc_dns.mu);
+        return err;
+    }
+
+    uint64_t now = cc__dns_now_ns();
+    cc__dns_evict_locked(now);
+    e = (cc__dns_entry*)calloc(1, sizeof(*e) + name_len + 1);
+    if (!e) {
+        pthread_mutex_unlock(&g_cc_dns.mu);
+        return CC_NET_OTHER;
+    }
+    e->hash = hash;
+    e->family = family;
+    e->absolute = absolute;
+    e->pending = 1;
+    e->linked = 1;
+    e->refs = 1;
+    memcpy(e->name, name, name_len + 1);
+    e->next = g_cc_dns.buckets[bucket];
+    g_cc_dns.buckets[bucket] = e;
+    g_cc_dns.nentries++;
+    pthread_mutex_unlock(&g_cc_dns.mu);
+
+    CCIpAddr found[CC_DNS_MAX_ADDRS * 2];
+    size_t count = 0;
+    uint32_t ttl = 0;
+    CCNetError err = cc__dns_query_search(name, absolute, family, found,
+                                          sizeof(found) / sizeof(found[0]), &count, &ttl);
+    CC_DNS_TRACE("resolved %s family=%d err=%d count=%zu ttl=%u", name, (int)family, (int)err, count, ttl);
+
+    pthread_mutex_lock(&g_cc_dns.mu);
+    e->err = err;
+    if (err == CC_NET_OK && count > 0) {
+        e->addrs = (CCIpAddr*)malloc(count * sizeof(CCIpAddr));
+        if (e->addrs) {
+            memcpy(e->addrs, found, count * sizeof(CCIpAddr));
+            e->count = count;
+        } else {
+            e->err = CC_NET_OTHER;
+        }
+    }
+    /* Transport failures are not negative answers: expire immediately so
+     * the next caller retries, but still hand the error to coalesced waiters. */
+    int cacheable = err == CC_NET_OK || err == CC_NET_DNS_FAILURE;
+    e->expires_ns = cacheable ? now + (uint64_t)ttl * 1000000000ull : 0;
+    cc__dns_publish_locked(e);
+    *out_count = e->err == CC_NET_OK ? cc__dns_copy_out(e, out, max) : 0;
+    err = e->err;
+    cc__dns_entry_release_locked(e);
+    pthread_mutex_unlock(&g_cc_dns.mu);
+    return err;
+}
+
+/* ============================================================================
+ * Entry points
+ * ============================================================================ */
+
+static CCNetError cc__dns_resolve_system(const char* name, CCDnsFamily family,
+                                         CCIpAddr* out, size_t max, size_t* out_count) {
+    struct addrinfo hints = {0};
+    hints.ai_family = family == CC_DNS_IPV4 ? AF_INET : (family == CC_DNS_IPV6 ? AF_INET6 : AF_UNSPEC);
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = NULL;
+    if (getaddrinfo(name, NULL, &hints, &res) != 0) return CC_NET_DNS_FAILURE;
+    size_t n = 0;
+    for (struct addrinfo* p = res; p && n < max; p = p->ai_next) {
+        if (p->ai_family == AF_INET) {
+            out[n].family = 4;
+            memcpy(out[n].addr.v4, &((struct sockaddr_in*)p->ai_addr)->sin_addr, 4);
+            n++;
+        } else if (p->ai_family == AF_INET6) {
+            out[n].family = 6;
+            memcpy(out[n].addr.v6, &((struct sockaddr_in6*)p->ai_addr)->sin6_addr, 16);
+            n++;
+        }
+    }
+    freeaddrinfo(res);
+    *out_count = n;
+    return n > 0 ? CC_NET_OK : CC_NET_DNS_FAILURE;
+}
+
+/* Resolve host (literal, hosts file, cache, then network) into out[0..max).
+ * Used by cc_dns_lookup* and by net.c when parsing "host:port". */
+static CCNetError cc__dns_resolve_host(const char* host, size_t host_len, CCDnsFamily family,
+                                       CCIpAddr* out, size_t max, size_t* out_count) {
+    *out_count = 0;
+    if (!host || max == 0) return CC_NET_INVALID_ADDRESS;
+
+    char name[CC_DNS_MAX_NAME];
+    int absolute = 0;
+    if (cc__dns_normalize(host, host_len, name, &absolute) != 0) return CC_NET_INVALID_ADDRESS;
+
+    CCIpAddr literal;
+    if (cc__dns_parse_ip(name, &literal) == 0) {
+        if (!cc__dns_family_match(family, &literal)) return CC_NET_DNS_FAILURE;
+        out[0] = literal;
+        *out_count = 1;
+        return CC_NET_OK;
+    }
+
+    static int use_system = -1;
+    if (use_system < 0) use_system = cc__dns_env_flag("CC_DNS_SYSTEM");
+    if (use_system) return cc__dns_resolve_system(name, family, out, max, out_count);
+
+    pthread_mutex_lock(&g_cc_dns.mu);
+    cc__dns_ensure_config_locked();
+    size_t n = cc__dns_hosts_lookup_locked(name, family, out, max);
+    pthread_mutex_unlock(&g_cc_dns.mu);
+    if (n > 0) {
+        CC_DNS_TRACE("hosts hit %s count=%zu", name, n);
+        *out_count = n;
+        return CC_NET_OK;
+    }
+    return cc__dns_resolve_cached(name, absolute, family, out, max, out_count);
+}
+
+CCSlice cc_dns_lookup_family(CCArena* arena, const char* hostname, size_t hostname_len,
+                             CCDnsFamily family, CCNetError* out_err) {
+    CCSlice result = {0};
+    CCIpAddr found[CC_DNS_MAX_ADDRS * 2];
+    size_t count = 0;
+    *out_err = cc__dns_resolve_host(hostname, hostname_len, family, found,
+                                    sizeof(found) / sizeof(found[0]), &count);
+    if (*out_err != CC_NET_OK) return result;
+
+    CCIpAddr* addrs = cc_arena_alloc(arena, count * sizeof(CCIpAddr), _Alignof(CCIpAddr));
+    if (!addrs) {
+        *out_err = CC_NET_OTHER;
+        return result;
+    }
+    memcpy(addrs, found, count * sizeof(CCIpAddr));
+    result.ptr = (char*)addrs;
+    result.len = count;  /* Note: len is count of CCIpAddr, not bytes */
+    return result;
+}
+
+CCSlice cc_dns_lookup(CCArena* arena, const char* hostname, size_t hostname_len, CCNetError* out_err) {
+    return cc_dns_lookup_family(arena, hostname, hostname_len, CC_DNS_ANY, out_err);
+}
+
+CCSlice cc_dns_reverse(CCArena* arena, const CCIpAddr* addr, CCNetError* out_err) {
+    CCSlice result = {0};
+    *out_err = CC_NET_OK;
+    if (!addr || (addr->family != 4 && addr->family != 6)) {
+        *out_err = CC_NET_INVALID_ADDRESS;
+        return result;
+    }
+
+    char name[CC_DNS_MAX_NAME] = {0};
+    pthread_mutex_lock(&g_cc_dns.mu);
+    cc__dns_ensure_config_locked();
+    for (size_t i = 0; i < g_cc_dns.nhosts; ++i) {
+        const CCIpAddr* h = &g_cc_dns.hosts[i].addr;
+        if (h->family == addr->family &&
+            memcmp(&h->addr, &addr->addr, addr->family == 4 ? 4 : 16) == 0) {
+            snprintf(name, sizeof(name), "%s", g_cc_dns.hosts[i].name);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_cc_dns.mu);
+
+    if (!name[0]) {
+        char arpa[CC_DNS_MAX_NAME];
+        size_t off = 0;
+        if (addr->family == 4) {
+            off = (size_t)snprintf(arpa, sizeof(arpa), "%u.%u.%u.%u.in-addr.arpa",
+                                   addr->addr.v4[3], addr->addr.v4[2], addr->addr.v4[1], addr->addr.v4[0]);
+        } else {
+            static const char hex[] = "0123456789abcdef";
+            for (int i = 15; i >= 0; --i) {
+                arpa[off++] = hex[addr->addr.v6[i] & 0x0F];
+                arpa[off++] = '.';
+                arpa[off++] = hex[addr->addr.v6[i] >> 4];
+                arpa[off++] = '.';
+            }
+            memcpy(arpa + off, "ip6.arpa", sizeof("ip6.arpa"));
+        }
+        cc__dns_question q;
+        memset(&q, 0, sizeof(q));
+        q.name = arpa;
+        q.qtype = CC_DNS_TYPE_PTR;
+        q.qlen = cc__dns_build_query(q.query, sizeof(q.query), 0, arpa, q.qtype);
+        *out_err = cc__dns_exchange(&q, 1);
+        if (*out_err != CC_NET_OK) return result;
+        if (!q.answer.ptr_name[0]) {
+            *out_err = CC_NET_DNS_FAILURE;
+            return result;
+        }
+        memcpy(name, q.answer.ptr_name, sizeof(name));
+    }
+
+    size_t len = strlen(name);
+    char* copy = cc_arena_alloc(arena, len, 1);
+    if (!copy) {
+        *out_err = CC_NET_OTHER;
+        return result;
+    }
+    memcpy(copy, name, len);
+    result.ptr = copy;
+    result.len = len;
+    return result;
+}
+
+void cc_dns_reload_config(void) {
+    pthread_mutex_lock(&g_cc_dns.mu);
+    g_cc_dns.loaded = 0;
+    cc__dns_ensure_config_locked();
+    pthread_mutex_unlock(&g_cc_dns.mu);
+}
+
+void cc_dns_cache_flush(void) {
+    pthread_mutex_lock(&g_cc_dns.mu);
+    for (size_t b = 0; b < CC_DNS_CACHE_BUCKETS; ++b) {
+        cc__dns_entry** link = &g_cc_dns.buckets[b];
+        while (*link) {
+            /* In-flight entries stay linked so their waiters still coalesce. */
+            if ((*link)->pending) link = &(*link)->next;
+            else cc__dns_unlink_locked(link);
+        }
+    }
+    pthread_mutex_unlock(&g_cc_dns.mu);
+}
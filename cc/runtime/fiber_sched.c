@@ -670,10 +670,19 @@ int cc__sched_current_worker_id(void) {
     return sched_v2_current_worker_id();
 }
 
+int cc_sched_set_worker_affinity(const char* spec) {
+    return sched_v2_set_affinity(spec);
+}
+
+int cc_sched_worker_numa_node(void) {
+    return sched_v2_worker_node();
+}
+
 /* V1 retired: cc__fiber_set_worker_affinity used to pin the current fiber
  * to a specific V1 worker for the duration of the next park.  V2 has no
  * equivalent — sysmon's orphan-and-replace can move work between threads at
- * any time, and we deliberately don't expose a pinning API to user code.
+ * any time, and we deliberately don't expose fiber-to-worker pinning to user
+ * code (workers themselves can be pinned to CPUs: cc_sched_set_worker_affinity).
  *
  * This stub keeps perf/channel_wake_wave.ccs link-clean.  That test calls
  * the affinity API as a diagnostic hint to measure wake-to-run latency on
@@ -1153,6 +1162,70 @@ void cc_yield(void) {
     cc__fiber_yield();
 }
 
+/* Safe-point slow path behind cc_preempt_point(): yields if sysmon has
+* asked the fiber running on this worker to give up its time slice. */
+void cc__fiber_preempt_point_slow(void) {
+    sched_v2_preempt_point();
+}
+
+/* Public API: bracket a call that blocks the OS thread (a raw syscall, a
+* blocking C library). On a fiber, enter hands the worker over to a fresh
+* thread so other fibers keep running, and exit moves the fiber back onto
+* a pool worker. Nestable; no-ops outside a fiber context. */
+void cc_blocking_enter(void) {
+    sched_v2_blocking_enter();
+}
+
+void cc_blocking_exit(void) {
+    sched_v2_blocking_exit();
+}
+
+CCPriority cc_current_priority(void) {
+    return (CCPriority)sched_v2_current_priority();
+}
+
+/* Fiber-local storage: thin shims over the inline slot rows in sched_v2. */
+_Static_assert(CC_FLS_KEYS == SCHED_V2_FLS_KEYS, "CC_FLS_KEYS out of sync with sched_v2");
+
+int cc_fls_key_create(CCFlsKey* out) {
+    if (!out) return EINVAL;
+    int k = sched_v2_fls_key_create();
+    if (k < 0) return EAGAIN;
+    *out = k;
+    return 0;
+}
+
+void* cc_fls_get(CCFlsKey key) {
+    if ((unsigned)key >= CC_FLS_KEYS) return NULL;
+    return sched_v2_fls_slots()[key];
+}
+
+int cc_fls_set(CCFlsKey key, void* value) {
+    if (key < 0 || key >= sched_v2_fls_key_count()) return EINVAL;
+    sched_v2_fls_slots()[key] = value;
+    return 0;
+}
+
+static pthread_mutex_t g_cc_fls_var_mu = PTHREAD_MUTEX_INITIALIZER;
+
+void** cc_fls_var_ref(CCFlsVar* var) {
+    int k = atomic_load_explicit(&var->key, memory_order_acquire);
+    if (k == 0) {
+        pthread_mutex_lock(&g_cc_fls_var_mu);
+        k = atomic_load_explicit(&var->key, memory_order_relaxed);
+        if (k == 0) {
+            k = sched_v2_fls_key_create() + 1;
+            if (k == 0) {
+                fprintf(stderr, "cc: @fiber_local: all %d fiber-local keys are in use\n", CC_FLS_KEYS);
+                abort();
+            }
+            atomic_store_explicit(&var->key, k, memory_order_release);
+        }
+        pthread_mutex_unlock(&g_cc_fls_var_mu);
+    }
+    return &sched_v2_fls_slots()[k - 1];
+}
+
 /* Yield to the GLOBAL run queue.
 * Unlike cc__fiber_yield which pushes to the local queue (where the same
 * worker immediately re-pops it), this puts the fiber in the global queue.
@@ -2,11 +2,17 @@
 #include <ccc/cc_arena.cch>
 #include <ccc/cc_slice.cch>
 #include <ccc/std/io.cch>
+#include <ccc/cc_nursery.cch>
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 int cc_file_open(CCFile *file, const char *path, const char *mode) {
     if (!file) return -1;
@@ -55,6 +61,148 @@ CCResult_CCSlice_CCIoError cc_file_read_all(CCFile *file, CCArena *arena) {
     return cc_ok_CCResult_CCSlice_CCIoError(slice);
 }
 
+CCResult_size_t_CCIoError cc_file_map(const char *path, CCSlice *out) {
+    if (!path || !out) {
+        return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(EINVAL));
+    }
+    *out = cc_slice_empty();
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(err));
+    }
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(S_ISDIR(st.st_mode) ? EISDIR : EINVAL));
+    }
+    size_t len = (size_t)st.st_size;
+    if (len == 0) {
+        close(fd);
+        return cc_ok_CCResult_size_t_CCIoError(0);
+    }
+    void *base = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);  /* the mapping keeps its own reference */
+    if (base == MAP_FAILED) {
+        return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(err));
+    }
+    (void)madvise(base, len, MADV_SEQUENTIAL);
+    *out = cc_slice_from_parts(base, len, CC_SLICE_ID_UNTRACKED, len);
+    return cc_ok_CCResult_size_t_CCIoError(len);
+}
+
+void cc_file_unmap(CCSlice *map) {
+    if (!map) return;
+    if (map->ptr && map->len) munmap(map->ptr, map->len);
+    *map = cc_slice_empty();
+}
+
+int cc_file_map_advise(CCSlice range, CCFileMapAdvice advice) {
+    if (!range.ptr || range.len == 0) return 0;
+    int how;
+    switch (advice) {
+        case CC_FILE_MAP_NORMAL: how = MADV_NORMAL; break;
+        case CC_FILE_MAP_SEQUENTIAL: how = MADV_SEQUENTIAL; break;
+        case CC_FILE_MAP_RANDOM: how = MADV_RANDOM; break;
+        case CC_FILE_MAP_WILLNEED: how = MADV_WILLNEED; break;
+        case CC_FILE_MAP_DONTNEED: how = MADV_DONTNEED; break;
+        default: return EINVAL;
+    }
+    /* madvise wants a page-aligned start; widen the range down to one. */
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)range.ptr;
+    uintptr_t aligned = start & ~(page - 1);
+    if (madvise((void *)aligned, range.len + (start - aligned), how) != 0) return errno;
+    return 0;
+}
+
+/* Chunked scan: chunk i nominally covers [i*size, (i+1)*size). Its real start
+ * is just past the first '\n' at or after the nominal start (0 for chunk 0),
+ * and its end is the next chunk's real start, so neighbouring workers agree
+ * on every boundary without talking to each other. */
+#define CC_FILE_SCAN_MIN_CHUNK ((size_t)1 << 20)
+#define CC_FILE_SCAN_MAX_CHUNK ((size_t)64 << 20)
+
+typedef struct {
+    const char *base;
+    size_t len;
+    size_t chunk_size;
+    size_t nchunks;
+    CCFileChunkFn fn;
+    void *arg;
+    _Atomic size_t next;
+    _Atomic int rc;
+} cc__file_scan;
+
+static size_t cc__file_scan_boundary(const cc__file_scan *s, size_t i) {
+    if (i == 0) return 0;
+    size_t at = i * s->chunk_size;
+    if (at >= s->len) return s->len;
+    const char *nl = (const char *)memchr(s->base + at, '\n', s->len - at);
+    return nl ? (size_t)(nl - s->base) + 1 : s->len;
+}
+
+static void *cc__file_scan_worker(void *arg) {
+    cc__file_scan *s = (cc__file_scan *)arg;
+    while (atomic_load_explicit(&s->rc, memory_order_relaxed) == 0) {
+        size_t i = atomic_fetch_add_explicit(&s->next, 1, memory_order_relaxed);
+        if (i >= s->nchunks) break;
+        size_t start = cc__file_scan_boundary(s, i);
+        size_t end = cc__file_scan_boundary(s, i + 1);
+        if (end <= start) continue;  /* a line longer than a chunk swallowed it */
+        CCSlice chunk = cc_slice_from_parts((void *)(s->base + start), end - start, CC_SLICE_ID_UNTRACKED, end - start);
+        (void)cc_file_map_advise(chunk, CC_FILE_MAP_WILLNEED);
+        int rc = s->fn(chunk, i, s->arg);
+        if (rc != 0) {
+            int expected = 0;
+            atomic_compare_exchange_strong(&s->rc, &expected, rc);
+        }
+    }
+    return NULL;
+}
+
+int cc_file_map_scan(CCSlice data, size_t chunk_size, CCFileChunkFn fn, void *arg) {
+    if (!fn || (!data.ptr && data.len)) return EINVAL;
+    if (data.len == 0) return 0;
+    /* Same count the fiber scheduler starts (CC_V2_THREADS / CC_WORKERS / CPUs). */
+    size_t workers = (size_t)sched_v2_detect_num_threads();
+    if (chunk_size == 0) {
+        /* ~4 chunks per worker evens out skew; stay within [1 MiB, 64 MiB]. */
+        chunk_size = data.len / (workers * 4);
+        if (chunk_size < CC_FILE_SCAN_MIN_CHUNK) chunk_size = CC_FILE_SCAN_MIN_CHUNK;
+        if (chunk_size > CC_FILE_SCAN_MAX_CHUNK) chunk_size = CC_FILE_SCAN_MAX_CHUNK;
+    }
+    cc__file_scan s = {
+        .base = (const char *)data.ptr,
+        .len = data.len,
+        .chunk_size = chunk_size,
+        .nchunks = (data.len + chunk_size - 1) / chunk_size,
+        .fn = fn,
+        .arg = arg,
+    };
+    atomic_init(&s.next, 0);
+    atomic_init(&s.rc, 0);
+    size_t fibers = workers < s.nchunks ? workers : s.nchunks;
+    CCNursery *n = fibers > 1 ? cc_nursery_create(NULL) : NULL;
+    if (!n) {
+        (void)cc__file_scan_worker(&s);
+        return atomic_load(&s.rc);
+    }
+    for (size_t i = 0; i < fibers; ++i) {
+        if (cc_nursery_spawn(n, cc__file_scan_worker, &s) != 0) break;
+    }
+    /* If every spawn failed the caller still drains the queue. */
+    (void)cc__file_scan_worker(&s);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    return atomic_load(&s.rc);
+}
+
 CCResult_size_t_CCIoError cc_file_write(CCFile *file, CCSlice data) {
     if (!file || !file->handle) {
         return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(EINVAL));
@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
 #include <pthread.h>
 #include <stdatomic.h>
@@ -9,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__DragonFly__)
 #include <sys/event.h>
@@ -128,6 +130,22 @@ static int cc__io_wait_stats_enabled(void) {
     return atomic_load_explicit(&g_cc_io_wait_stats.enabled, memory_order_acquire);
 }
 
+/* Fibers waiting on fd readiness, always counted (cc_runtime_metrics_snapshot);
+ * the CC_IO_WAIT_STATS counters above are the opt-in breakdown. */
+static _Atomic uint64_t g_cc_io_wait_registrations = 0;
+static _Atomic int64_t g_cc_io_wait_registered = 0;
+
+static inline void cc__io_wait_note_registration(int delta) {
+    if (delta > 0) atomic_fetch_add_explicit(&g_cc_io_wait_registrations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_cc_io_wait_registered, delta, memory_order_relaxed);
+}
+
+void cc__io_wait_metrics(uint64_t* registered, uint64_t* registrations_total) {
+    int64_t cur = atomic_load_explicit(&g_cc_io_wait_registered, memory_order_relaxed);
+    *registered = cur > 0 ? (uint64_t)cur : 0;
+    *registrations_total = atomic_load_explicit(&g_cc_io_wait_registrations, memory_order_relaxed);
+}
+
 static void cc__io_wait_stats_dump(void) {
     if (!cc__io_wait_stats_enabled()) return;
     fprintf(stderr,
@@ -779,6 +797,7 @@ int cc__io_watcher_wait(cc__io_owned_watcher* watcher, short events) {
         if (!slot) {
             return cc__io_wait_fd(watcher->fd, events);
         }
+        cc__io_wait_note_registration(1);
         if (cc__io_wait_stats_enabled()) {
             atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_adds, 1, memory_order_relaxed);
             cc__io_wait_stats_inc_current_waiters();
@@ -787,6 +806,7 @@ int cc__io_watcher_wait(cc__io_owned_watcher* watcher, short events) {
                                       : cc__io_wait_kqueue_arm(slot);
         if (arm_err != 0) {
             atomic_store_explicit(&slot->active, 0, memory_order_release);
+            cc__io_wait_note_registration(-1);
             if (cc__io_wait_stats_enabled()) {
                 atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
                 cc__io_wait_stats_dec_current_waiters();
@@ -796,6 +816,7 @@ int cc__io_watcher_wait(cc__io_owned_watcher* watcher, short events) {
         if (persistent_read && atomic_exchange_explicit(&slot->ready, 0, memory_order_acq_rel) != 0) {
             atomic_store_explicit(&slot->active, 0, memory_order_release);
             slot->fiber = NULL;
+            cc__io_wait_note_registration(-1);
             if (cc__io_wait_stats_enabled()) {
                 atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
                 cc__io_wait_stats_dec_current_waiters();
@@ -818,6 +839,7 @@ int cc__io_watcher_wait(cc__io_owned_watcher* watcher, short events) {
         }
         atomic_store_explicit(&slot->active, 0, memory_order_release);
         slot->fiber = NULL;
+        cc__io_wait_note_registration(-1);
         if (cc__io_wait_stats_enabled()) {
             atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
             cc__io_wait_stats_dec_current_waiters();
@@ -937,36 +959,79 @@ void cc__io_wait_select_finish(cc__io_wait_select_handle* handle) {
     }
 }
 
-int cc__io_wait_ready(int fd, short events) {
+/* Milliseconds until abs_deadline (CLOCK_REALTIME, matching
+ * cc__fiber_park_if_until), clamped to [0, INT_MAX].  -1 means no deadline. */
+static int cc__io_wait_deadline_ms(const struct timespec* abs_deadline) {
+    if (!abs_deadline) return -1;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    int64_t ms = (int64_t)(abs_deadline->tv_sec - now.tv_sec) * 1000 +
+                 (abs_deadline->tv_nsec - now.tv_nsec) / 1000000;
+    if (ms < 0) return 0;
+    if (ms > INT_MAX) return INT_MAX;
+    return (int)ms;
+}
+
+static int cc__io_wait_ready_until(int fd, short events, const struct timespec* abs_deadline) {
     struct pollfd pfd = {.fd = fd, .events = events};
     while (1) {
-        int rc = poll(&pfd, 1, -1);
+        int timeout_ms = cc__io_wait_deadline_ms(abs_deadline);
+        int rc = poll(&pfd, 1, timeout_ms);
         if (rc > 0) {
             if (pfd.revents & POLLNVAL) return EBADF;
             if (pfd.revents & (POLLERR | POLLHUP)) return EIO;
             return 0;
         }
-        if (rc == 0) continue;
+        if (rc == 0) {
+            if (abs_deadline && cc__io_wait_deadline_ms(abs_deadline) == 0) return ETIMEDOUT;
+            continue;
+        }
         if (errno == EINTR) continue;
         return errno;
     }
 }
 
+/* Park the current fiber until *ready flips.  With a deadline, sysmon's
+ * park_deadline expiry resumes us even if the poller never fires. */
+static int cc__io_wait_suspend(_Atomic int* ready, const struct timespec* abs_deadline) {
+    if (!abs_deadline) {
+        return CC_FIBER_SUSPEND_UNTIL_READY_OR_CANCEL(ready, 0, "io_ready");
+    }
+    int rc = 0;
+    cc_external_wait_enter();
+    while (atomic_load_explicit(ready, memory_order_acquire) == 0) {
+        if (CC_FIBER_PARK_IF_UNTIL(ready, 0, abs_deadline, "io_ready")) {
+            rc = ETIMEDOUT;
+            break;
+        }
+    }
+    cc_external_wait_leave();
+    return rc;
+}
+
+int cc__io_wait_ready(int fd, short events) {
+    return cc__io_wait_ready_until(fd, events, NULL);
+}
+
 int cc__io_wait_fd(int fd, short events) {
+    return cc__io_wait_fd_until(fd, events, NULL);
+}
+
+int cc__io_wait_fd_until(int fd, short events, const struct timespec* abs_deadline) {
     if (!cc__fiber_in_context()) {
         /* Direct thread waits here are driven by kernel I/O readiness, so mark
          * this call site as external to the scheduler dependency graph. */
         cc_external_wait_enter();
-        int rc = cc__io_wait_ready(fd, events);
+        int rc = cc__io_wait_ready_until(fd, events, abs_deadline);
         cc_external_wait_leave();
         return rc;
     }
     if (cc__io_wait_force_direct()) {
-        return cc__io_wait_ready(fd, events);
+        return cc__io_wait_ready_until(fd, events, abs_deadline);
     }
 
     int init_err = cc__io_wait_ensure_running();
-    if (init_err != 0) return cc__io_wait_ready(fd, events);
+    if (init_err != 0) return cc__io_wait_ready_until(fd, events, abs_deadline);
     if (cc__io_wait_stats_enabled()) {
         cc__io_wait_stats_init();
         atomic_fetch_add_explicit(&g_cc_io_wait_stats.wait_async_calls, 1, memory_order_relaxed);
@@ -978,8 +1043,9 @@ int cc__io_wait_fd(int fd, short events) {
         uint64_t wait_ticket = cc__fiber_publish_wait_ticket(fiber);
         cc_io_kqueue_slot* slot = cc__io_wait_kqueue_acquire_slot(fd, events, fiber, wait_ticket);
         if (!slot) {
-            return cc__io_wait_ready(fd, events);
+            return cc__io_wait_ready_until(fd, events, abs_deadline);
         }
+        cc__io_wait_note_registration(1);
         if (cc__io_wait_stats_enabled()) {
             atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_adds, 1, memory_order_relaxed);
             cc__io_wait_stats_inc_current_waiters();
@@ -987,6 +1053,7 @@ int cc__io_wait_fd(int fd, short events) {
         int arm_err = cc__io_wait_kqueue_arm(slot);
         if (arm_err != 0) {
             atomic_store_explicit(&slot->active, 0, memory_order_release);
+            cc__io_wait_note_registration(-1);
             if (cc__io_wait_stats_enabled()) {
                 atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
                 cc__io_wait_stats_dec_current_waiters();
@@ -1001,10 +1068,11 @@ int cc__io_wait_fd(int fd, short events) {
             }
         }
         cc__fiber_set_park_obj(slot);
-        int wait_err = CC_FIBER_SUSPEND_UNTIL_READY_OR_CANCEL(&slot->ready, 0, "io_ready");
+        int wait_err = cc__io_wait_suspend(&slot->ready, abs_deadline);
         cc__fiber_set_park_obj(NULL);
         atomic_store_explicit(&slot->active, 0, memory_order_release);
         slot->fiber = NULL;
+        cc__io_wait_note_registration(-1);
         if (cc__io_wait_stats_enabled()) {
             atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
             cc__io_wait_stats_dec_current_waiters();
@@ -1017,7 +1085,7 @@ int cc__io_wait_fd(int fd, short events) {
     }
 
     cc_io_waiter* waiter = (cc_io_waiter*)calloc(1, sizeof(*waiter));
-    if (!waiter) return cc__io_wait_ready(fd, events);
+    if (!waiter) return cc__io_wait_ready_until(fd, events, abs_deadline);
 
     waiter->fd = fd;
     waiter->events = events;
@@ -1034,6 +1102,7 @@ int cc__io_wait_fd(int fd, short events) {
     g_cc_io_wait_state.head = waiter;
     waiter->linked = 1;
     pthread_mutex_unlock(&g_cc_io_wait_state.mu);
+    cc__io_wait_note_registration(1);
     if (cc__io_wait_stats_enabled()) {
         atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_adds, 1, memory_order_relaxed);
         cc__io_wait_stats_inc_current_waiters();
@@ -1042,7 +1111,7 @@ int cc__io_wait_fd(int fd, short events) {
     cc__io_waiter_notify();
 
     cc__fiber_set_park_obj(waiter);
-    int wait_err = CC_FIBER_SUSPEND_UNTIL_READY_OR_CANCEL(&waiter->ready, 0, "io_ready");
+    int wait_err = cc__io_wait_suspend(&waiter->ready, abs_deadline);
     cc__fiber_set_park_obj(NULL);
 
     atomic_store_explicit(&waiter->cancelled, 1, memory_order_release);
@@ -1054,6 +1123,7 @@ int cc__io_wait_fd(int fd, short events) {
         waiter->linked = 0;
     }
     pthread_mutex_unlock(&g_cc_io_wait_state.mu);
+    cc__io_wait_note_registration(-1);
     if (cc__io_wait_stats_enabled()) {
         atomic_fetch_add_explicit(&g_cc_io_wait_stats.waiter_removes, 1, memory_order_relaxed);
         cc__io_wait_stats_dec_current_waiters();
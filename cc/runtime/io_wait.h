@@ -2,6 +2,8 @@
 #define CC_RUNTIME_IO_WAIT_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <time.h>
 
 typedef struct cc__io_owned_watcher cc__io_owned_watcher;
 typedef struct cc__wait_select_group cc__wait_select_group;
@@ -13,6 +15,9 @@ typedef struct cc__io_wait_select_handle {
 
 int cc__io_wait_ready(int fd, short events);
 int cc__io_wait_fd(int fd, short events);
+/* Like cc__io_wait_fd, but gives up with ETIMEDOUT once abs_deadline
+ * (CLOCK_REALTIME) passes.  NULL deadline waits forever. */
+int cc__io_wait_fd_until(int fd, short events, const struct timespec* abs_deadline);
 void cc__io_wait_forget_fd(int fd);
 cc__io_owned_watcher* cc__io_watcher_create(int fd);
 void cc__io_watcher_destroy(cc__io_owned_watcher* watcher);
@@ -24,5 +29,7 @@ int cc__io_wait_select_publish(cc__io_owned_watcher* watcher,
                                size_t select_index,
                                cc__io_wait_select_handle* out_handle);
 void cc__io_wait_select_finish(cc__io_wait_select_handle* handle);
+/* Fibers registered for readiness now, and registrations since start. */
+void cc__io_wait_metrics(uint64_t* registered, uint64_t* registrations_total);
 
 #endif /* CC_RUNTIME_IO_WAIT_H */
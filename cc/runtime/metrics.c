@@ -0,0 +1,346 @@
+/*
+ * Runtime metrics snapshot and Prometheus endpoint (cc_metrics.cch).
+ *
+ * The snapshot only gathers: the counters live with the code they count
+ * (per-worker shards in sched_v2.c, io_wait registrations, the arena heap
+ * byte count in cc_arena.cch, the cc_thread_spawn pool). The endpoint is an
+ * accept fiber on the CC net layer that hands each connection to its own
+ * fiber, which answers with the text format and closes it; the accept fiber
+ * joins those, and a runtime-owned nursery holds the accept fibers.
+ */
+
+#include <ccc/cc_metrics.cch>
+#include <ccc/cc_arena.cch>
+#include <ccc/cc_nursery.cch>
+#include <ccc/cc_runtime.cch>
+#include <ccc/std/net.cch>
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <time.h>
+
+#include "io_wait.h"
+#include "sched_v2.h"
+
+void cc__sched_exec_metrics(size_t* workers, size_t* queue_len);
+
+/* How long a client may take to send its request head. */
+#define CC_METRICS_READ_TIMEOUT_MS 5000
+
+int cc_runtime_metrics_snapshot(CCRuntimeMetrics* out) {
+    if (!out) return EINVAL;
+    memset(out, 0, sizeof(*out));
+
+    sched_v2_metrics s;
+    sched_v2_metrics_read(&s);
+    out->workers = s.workers;
+    out->idle_workers = s.idle_workers;
+    out->orphan_threads = s.orphan_threads;
+    out->run_queue_depth = s.run_queue_depth;
+    out->fibers_alive = s.fibers_alive;
+    out->fibers_spawned_total = s.spawns;
+    out->fibers_completed_total = s.completions;
+    out->dispatches_total = s.dispatches;
+    out->parks_total = s.parks;
+    out->unparks_total = s.unparks;
+    out->yields_total = s.yields;
+    out->evictions_total = s.evictions;
+    out->blocking_handoffs_total = s.blocking_handoffs;
+    out->chan_waiters = s.chan_waiters;
+
+    cc__io_wait_metrics(&out->io_wait_registered, &out->io_wait_registrations_total);
+    out->arena_heap_bytes = (uint64_t)CC_ATOMIC_LOAD(&cc_arena_heap_bytes);
+
+    size_t exec_workers = 0, exec_queue = 0;
+    cc__sched_exec_metrics(&exec_workers, &exec_queue);
+    out->exec_workers = exec_workers;
+    out->exec_queue_depth = exec_queue;
+    return 0;
+}
+
+/* ============================================================================
+ * Prometheus text format
+ * ============================================================================ */
+
+typedef struct {
+    const char* name;
+    const char* type;
+    const char* help;
+    size_t offset;
+} cc_metric_desc;
+
+#define CC_METRIC(field, name, type, help) { name, type, help, offsetof(CCRuntimeMetrics, field) }
+
+static const cc_metric_desc g_cc_metric_descs[] = {
+    CC_METRIC(workers, "cc_workers", "gauge", "Scheduler worker slots started."),
+    CC_METRIC(idle_workers, "cc_idle_workers", "gauge", "Workers parked waiting for work."),
+    CC_METRIC(orphan_threads, "cc_orphan_threads", "gauge", "Evicted or handed-off threads still running a blocking call."),
+    CC_METRIC(run_queue_depth, "cc_run_queue_depth", "gauge", "Fibers ready to run and not yet picked up."),
+    CC_METRIC(fibers_alive, "cc_fibers_alive", "gauge", "Fibers spawned and not yet returned."),
+    CC_METRIC(fibers_spawned_total, "cc_fibers_spawned_total", "counter", "Fibers spawned."),
+    CC_METRIC(fibers_completed_total, "cc_fibers_completed_total", "counter", "Fibers that returned."),
+    CC_METRIC(dispatches_total, "cc_fiber_dispatches_total", "counter", "Fiber resumes by a worker."),
+    CC_METRIC(parks_total, "cc_fiber_parks_total", "counter", "Fiber parks."),
+    CC_METRIC(unparks_total, "cc_fiber_unparks_total", "counter", "Fiber unparks."),
+    CC_METRIC(yields_total, "cc_fiber_yields_total", "counter", "Cooperative and preemption yields."),
+    CC_METRIC(evictions_total, "cc_worker_evictions_total", "counter", "Workers replaced by sysmon."),
+    CC_METRIC(blocking_handoffs_total, "cc_blocking_handoffs_total", "counter", "Worker slots handed off by cc_blocking_enter."),
+    CC_METRIC(chan_waiters, "cc_chan_waiters", "gauge", "Fibers parked in a channel send or receive."),
+    CC_METRIC(io_wait_registered, "cc_io_wait_registered", "gauge", "Fibers waiting on fd readiness."),
+    CC_METRIC(io_wait_registrations_total, "cc_io_wait_registrations_total", "counter", "Fd readiness waits started."),
+    CC_METRIC(arena_heap_bytes, "cc_arena_heap_bytes", "gauge", "Malloc-backed arena blocks and overflow, in bytes."),
+    CC_METRIC(exec_workers, "cc_exec_workers", "gauge", "cc_thread_spawn pool threads."),
+    CC_METRIC(exec_queue_depth, "cc_exec_queue_depth", "gauge", "Tasks queued on the cc_thread_spawn pool."),
+};
+
+#undef CC_METRIC
+
+static int cc__metrics_line(char* buf, size_t cap, const CCRuntimeMetrics* m, const cc_metric_desc* d) {
+    uint64_t v;
+    memcpy(&v, (const char*)m + d->offset, sizeof(v));
+    return snprintf(buf, cap, "# HELP %s %s\n# TYPE %s %s\n%s %llu\n",
+                    d->name, d->help, d->name, d->type, d->name, (unsigned long long)v);
+}
+
+size_t cc_runtime_metrics_format(char* buf, size_t cap) {
+    CCRuntimeMetrics m;
+    cc_runtime_metrics_snapshot(&m);
+    size_t len = 0;
+    for (size_t i = 0; i < sizeof(g_cc_metric_descs) / sizeof(g_cc_metric_descs[0]); i++) {
+        int n = cc__metrics_line(buf ? buf + (len < cap ? len : cap) : NULL, len < cap ? cap - len : 0,
+                                 &m, &g_cc_metric_descs[i]);
+        if (n > 0) len += (size_t)n;
+    }
+    return len;
+}
+
+/* One snapshot rendered into a malloc'd buffer that grows as needed, so the
+ * length sent is the length written (a size pass and a fill pass can see
+ * different counter values). Caller frees. */
+static char* cc__metrics_render(size_t* out_len) {
+    CCRuntimeMetrics m;
+    cc_runtime_metrics_snapshot(&m);
+    size_t cap = 4096, len = 0;
+    char* buf = (char*)malloc(cap);
+    if (!buf) return NULL;
+    for (size_t i = 0; i < sizeof(g_cc_metric_descs) / sizeof(g_cc_metric_descs[0]); i++) {
+        for (;;) {
+            int n = cc__metrics_line(buf + len, cap - len, &m, &g_cc_metric_descs[i]);
+            if (n < 0) {
+                free(buf);
+                return NULL;
+            }
+            if ((size_t)n < cap - len) {
+                len += (size_t)n;
+                break;
+            }
+            size_t nc = cap * 2 > len + (size_t)n + 1 ? cap * 2 : len + (size_t)n + 1;
+            char* nb = (char*)realloc(buf, nc);
+            if (!nb) {
+                free(buf);
+                return NULL;
+            }
+            buf = nb;
+            cap = nc;
+        }
+    }
+    *out_len = len;
+    return buf;
+}
+
+/* ============================================================================
+ * HTTP endpoint
+ * ============================================================================ */
+
+static int cc__metrics_net_errno(CCNetError e) {
+    switch (e) {
+        case CC_NET_ADDRESS_IN_USE: return EADDRINUSE;
+        case CC_NET_ADDRESS_NOT_AVAILABLE: return EADDRNOTAVAIL;
+        case CC_NET_INVALID_ADDRESS: return EINVAL;
+        default: return EIO;
+    }
+}
+
+static int cc__metrics_write_all(CCSocket* sock, const char* data, size_t len) {
+    while (len > 0) {
+        CCNetError err;
+        size_t n = cc_socket_write(sock, data, len, &err);
+        if (err != CC_NET_OK || n == 0) return -1;
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* io_wait deadlines are CLOCK_REALTIME (see cc__fiber_park_if_until). */
+static struct timespec cc__metrics_deadline_after_ms(int ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static void cc__metrics_answer(CCSocket* sock) {
+    /* Read until the end of the request head; the request itself is ignored.
+     * A client that stalls is dropped at the deadline. */
+    struct timespec deadline = cc__metrics_deadline_after_ms(CC_METRICS_READ_TIMEOUT_MS);
+    char req[2048];
+    size_t have = 0;
+    while (have < sizeof(req) - 1) {
+        CCNetError err;
+        bool would_block = false;
+        size_t n = cc_socket_try_read_into(sock, req + have, sizeof(req) - 1 - have, &err, &would_block);
+        if (err != CC_NET_OK) break;
+        if (would_block) {
+            if (cc__io_wait_fd_until(sock->fd, POLLIN, &deadline) != 0) {
+                /* The io_wait poller may still hold the fd, which keeps
+                 * the socket open past close(); end it now. */
+                (void)shutdown(sock->fd, SHUT_RDWR);
+                return;
+            }
+            continue;
+        }
+        if (n == 0) break;
+        have += n;
+        req[have] = '\0';
+        if (strstr(req, "\r\n\r\n") || strstr(req, "\n\n")) break;
+    }
+
+    size_t body_len = 0;
+    char* body = cc__metrics_render(&body_len);
+    if (!body) return;
+    char head[160];
+    int head_len = snprintf(head, sizeof(head),
+                            "HTTP/1.0 200 OK\r\n"
+                            "Content-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %zu\r\n"
+                            "Connection: close\r\n\r\n",
+                            body_len);
+    if (cc__metrics_write_all(sock, head, (size_t)head_len) == 0) {
+        (void)cc__metrics_write_all(sock, body, body_len);
+    }
+    free(body);
+}
+
+static void* cc__metrics_conn_main(void* arg) {
+    CCSocket* sock = (CCSocket*)arg;
+    cc_deadlock_suppress_enter();
+    cc__metrics_answer(sock);
+    cc_deadlock_suppress_leave();
+    cc_socket_close(sock);
+    free(sock);
+    return NULL;
+}
+
+/* Joins and releases the connection fibers that have finished (all of
+ * them when `all` is set) and returns how many are still live. */
+static size_t cc__metrics_reap(fiber_v2** conns, size_t count, int all) {
+    size_t live = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (all || sched_v2_fiber_done(conns[i])) {
+            (void)sched_v2_join(conns[i], NULL);
+            sched_v2_fiber_release(conns[i]);
+        } else {
+            conns[live++] = conns[i];
+        }
+    }
+    return live;
+}
+
+static void* cc__metrics_server_main(void* arg) {
+    CCListener* ln = (CCListener*)arg;
+    /* The server owns its connection fibers: each accept reaps the ones
+     * that have finished, so memory tracks live connections, not scrapes. */
+    fiber_v2** conns = NULL;
+    size_t conn_count = 0, conn_cap = 0;
+    /* Waits on clients forever; keep it out of deadlock analysis. */
+    cc_deadlock_suppress_enter();
+    while (1) {
+        CCNetError err;
+        CCSocket sock = cc_listener_accept(ln, &err);
+        if (err != CC_NET_OK) {
+            if (err == CC_NET_CONNECTION_RESET || err == CC_NET_CONNECTION_CLOSED) continue;
+            fprintf(stderr, "[cc metrics] accept failed (%d); endpoint stopped\n", (int)err);
+            break;
+        }
+        conn_count = cc__metrics_reap(conns, conn_count, 0);
+        if (conn_count == conn_cap) {
+            size_t cap = conn_cap ? conn_cap * 2 : 8;
+            fiber_v2** grown = (fiber_v2**)realloc(conns, cap * sizeof(*grown));
+            if (!grown) {
+                cc_socket_close(&sock);
+                continue;
+            }
+            conns = grown;
+            conn_cap = cap;
+        }
+        /* One fiber per connection, so a slow client holds up only itself. */
+        CCSocket* conn = (CCSocket*)malloc(sizeof(*conn));
+        fiber_v2* f = NULL;
+        if (conn) {
+            *conn = sock;
+            f = sched_v2_spawn(cc__metrics_conn_main, conn);
+        }
+        if (!f) {
+            free(conn);
+            cc_socket_close(&sock);
+            continue;
+        }
+        conns[conn_count++] = f;
+    }
+    (void)cc__metrics_reap(conns, conn_count, 1);
+    free(conns);
+    cc_deadlock_suppress_leave();
+    cc_listener_close(ln);
+    free(ln);
+    return NULL;
+}
+
+/* Listener fibers live in a process-lifetime nursery, which reclaims one
+ * whose endpoint stops instead of leaving it unjoined. */
+static CCNursery* g_cc_metrics_nursery;
+static pthread_once_t g_cc_metrics_nursery_once = PTHREAD_ONCE_INIT;
+
+static void cc__metrics_nursery_init(void) {
+    g_cc_metrics_nursery = cc_nursery_create(NULL);
+}
+
+int cc_metrics_serve(const char* addr, int* out_port) {
+    if (!addr || !*addr) return EINVAL;
+    CCListener* ln = (CCListener*)malloc(sizeof(*ln));
+    if (!ln) return ENOMEM;
+    CCNetError err;
+    *ln = cc_tcp_listen(addr, strlen(addr), &err);
+    if (err != CC_NET_OK || ln->fd < 0) {
+        free(ln);
+        return cc__metrics_net_errno(err);
+    }
+    if (out_port) {
+        struct sockaddr_storage sa;
+        socklen_t sa_len = sizeof(sa);
+        *out_port = 0;
+        if (getsockname(ln->fd, (struct sockaddr*)&sa, &sa_len) == 0) {
+            if (sa.ss_family == AF_INET) *out_port = ntohs(((struct sockaddr_in*)&sa)->sin_port);
+            else if (sa.ss_family == AF_INET6) *out_port = ntohs(((struct sockaddr_in6*)&sa)->sin6_port);
+        }
+    }
+    pthread_once(&g_cc_metrics_nursery_once, cc__metrics_nursery_init);
+    if (!g_cc_metrics_nursery || cc_nursery_spawn(g_cc_metrics_nursery, cc__metrics_server_main, ln) != 0) {
+        cc_listener_close(ln);
+        free(ln);
+        return ENOMEM;
+    }
+    return 0;
+}
@@ -6,6 +6,7 @@
  */
 
 #include <ccc/std/net.cch>
+#include <ccc/std/dns.cch>
 #include <ccc/cc_channel.cch>
 
 #include <errno.h>
@@ -21,7 +22,6 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
-#include <netdb.h>
 
 #include "fiber_internal.h"
 #include "fiber_sched_boundary.h"
@@ -31,6 +31,10 @@
 
 #define CC_NET_FLAG_NONBLOCK 0x01
 
+/* Defined in dns.c (same translation unit via concurrent_c.c). */
+static CCNetError cc__dns_resolve_host(const char* host, size_t host_len, CCDnsFamily family,
+                                       CCIpAddr* out, size_t max, size_t* out_count);
+
 static cc__io_owned_watcher* cc__net_ensure_socket_watcher(CCSocket* sock) {
     if (!sock || sock->fd < 0) return NULL;
     if (sock->watcher) return (cc__io_owned_watcher*)sock->watcher;
@@ -168,30 +172,30 @@ static int parse_addr(const char* addr, size_t addr_len,
         }
     }
 
-    /* Resolve hostname */
-    struct addrinfo hints = {0};
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-
-    struct addrinfo* result = NULL;
-    int gai_err = getaddrinfo(host_start, NULL, &hints, &result);
-    if (gai_err != 0) {
-        *out_err = CC_NET_DNS_FAILURE;
+    /* Resolve hostname (literals short-circuit inside the resolver) */
+    CCIpAddr ip;
+    size_t count = 0;
+    CCNetError dns_err = cc__dns_resolve_host(host_start, strlen(host_start), CC_DNS_ANY, &ip, 1, &count);
+    if (dns_err != CC_NET_OK || count == 0) {
+        *out_err = dns_err == CC_NET_INVALID_ADDRESS ? CC_NET_INVALID_ADDRESS : CC_NET_DNS_FAILURE;
         return -1;
     }
 
-    /* Copy first result */
-    memcpy(out_sa, result->ai_addr, result->ai_addrlen);
-    *out_sa_len = result->ai_addrlen;
-
-    /* Set port */
-    if (out_sa->ss_family == AF_INET) {
-        ((struct sockaddr_in*)out_sa)->sin_port = htons(port);
-    } else if (out_sa->ss_family == AF_INET6) {
-        ((struct sockaddr_in6*)out_sa)->sin6_port = htons(port);
+    memset(out_sa, 0, sizeof(*out_sa));
+    if (ip.family == 4) {
+        struct sockaddr_in* sin = (struct sockaddr_in*)out_sa;
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(port);
+        memcpy(&sin->sin_addr, ip.addr.v4, 4);
+        *out_sa_len = sizeof(*sin);
+    } else {
+        struct sockaddr_in6* sin6 = (struct sockaddr_in6*)out_sa;
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = htons(port);
+        memcpy(&sin6->sin6_addr, ip.addr.v6, 16);
+        *out_sa_len = sizeof(*sin6);
     }
 
-    freeaddrinfo(result);
     *out_err = CC_NET_OK;
     return 0;
 }
@@ -216,12 +220,32 @@ CCSocket cc_tcp_connect(const char* addr, size_t addr_len, CCNetError* out_err)
         return sock;
     }
 
-    if (connect(fd, (struct sockaddr*)&sa, sa_len) < 0) {
-        *out_err = errno_to_net_error(errno);
+    /* Inside a fiber, connect non-blocking and park on io_wait instead of
+     * holding the worker for the whole handshake. */
+    int prep_err = cc__net_prepare_fiber_fd(fd, &sock.flags);
+    if (prep_err != 0) {
+        *out_err = errno_to_net_error(prep_err);
         close(fd);
         return sock;
     }
 
+    if (connect(fd, (struct sockaddr*)&sa, sa_len) < 0) {
+        int conn_err = errno;
+        if (conn_err == EINPROGRESS && (sock.flags & CC_NET_FLAG_NONBLOCK)) {
+            int wait_err = cc__io_wait_fd(fd, POLLOUT);
+            socklen_t conn_err_len = sizeof(conn_err);
+            if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &conn_err, &conn_err_len) < 0) conn_err = errno;
+            if (conn_err == 0 && wait_err != 0 && wait_err != EIO) conn_err = wait_err;
+        }
+        if (conn_err != 0) {
+            *out_err = errno_to_net_error(conn_err);
+            cc__io_wait_forget_fd(fd);
+            close(fd);
+            sock.flags = 0;
+            return sock;
+        }
+    }
+
     cc__net_disable_sigpipe_best_effort(fd);
     sock.fd = fd;
     return sock;
@@ -672,78 +696,9 @@ void cc_udp_close(CCUdpSocket* sock) {
 }
 
 /* ============================================================================
- * DNS
+ * IP helpers (DNS resolution lives in dns.c)
  * ============================================================================ */
 
-CCSlice cc_dns_lookup(CCArena* arena, const char* hostname, size_t hostname_len, CCNetError* out_err) {
-    CCSlice result = {0};
-    *out_err = CC_NET_OK;
-
-    /* Null-terminate */
-    char buf[256];
-    if (hostname_len >= sizeof(buf)) {
-        *out_err = CC_NET_INVALID_ADDRESS;
-        return result;
-    }
-    memcpy(buf, hostname, hostname_len);
-    buf[hostname_len] = '\0';
-
-    struct addrinfo hints = {0};
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-
-    struct addrinfo* res = NULL;
-    int err = getaddrinfo(buf, NULL, &hints, &res);
-    if (err != 0) {
-        *out_err = CC_NET_DNS_FAILURE;
-        return result;
-    }
-
-    /* Count results */
-    size_t count = 0;
-    for (struct addrinfo* p = res; p; p = p->ai_next) {
-        if (p->ai_family == AF_INET || p->ai_family == AF_INET6) {
-            count++;
-        }
-    }
-
-    if (count == 0) {
-        freeaddrinfo(res);
-        *out_err = CC_NET_DNS_FAILURE;
-        return result;
-    }
-
-    /* Allocate array */
-    CCIpAddr* addrs = cc_arena_alloc(arena, count * sizeof(CCIpAddr), _Alignof(CCIpAddr));
-    if (!addrs) {
-        freeaddrinfo(res);
-        *out_err = CC_NET_OTHER;
-        return result;
-    }
-
-    /* Copy addresses */
-    size_t i = 0;
-    for (struct addrinfo* p = res; p && i < count; p = p->ai_next) {
-        if (p->ai_family == AF_INET) {
-            struct sockaddr_in* sin = (struct sockaddr_in*)p->ai_addr;
-            addrs[i].family = 4;
-            memcpy(addrs[i].addr.v4, &sin->sin_addr, 4);
-            i++;
-        } else if (p->ai_family == AF_INET6) {
-            struct sockaddr_in6* sin6 = (struct sockaddr_in6*)p->ai_addr;
-            addrs[i].family = 6;
-            memcpy(addrs[i].addr.v6, &sin6->sin6_addr, 16);
-            i++;
-        }
-    }
-
-    freeaddrinfo(res);
-
-    result.ptr = (char*)addrs;
-    result.len = count;  /* Note: len is count of CCIpAddr, not bytes */
-    return result;
-}
-
 CCSlice cc_ip_addr_to_string(CCIpAddr* addr, CCArena* arena) {
     CCSlice result = {0};
 
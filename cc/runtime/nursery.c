@@ -156,6 +156,7 @@ struct CCNursery {
     CCArena closure_env_arena;
     pthread_mutex_t mu;
     wake_primitive cancel_wake;  /* Broadcast on cancel for O(1) wake */
+    CCPriority priority;         /* Class for spawns without an explicit one */
 
     /* Worker-frees-on-DEAD path (default; CC_NURSERY_WORKER_FREES=0 opts
      * out). When the gate is off these fields are inert and the classic
@@ -201,6 +202,7 @@ static CCNursery* cc__nursery_alloc(void) {
     pthread_mutex_init(&n->mu, NULL);
     wake_primitive_init(&n->cancel_wake);
     wake_primitive_init(&n->alive_wake);
+    n->priority = CC_PRIORITY_NORMAL;
     atomic_store_explicit(&n->alive_count, 0, memory_order_relaxed);
     atomic_store_explicit(&n->alive_waiter, NULL, memory_order_relaxed);
     n->deadline.tv_sec = 0;
@@ -223,7 +225,11 @@ static CCNursery* cc__nursery_alloc(void) {
 CCNursery* cc_nursery_create(CCNursery* parent) {
     CCNursery* n = cc__nursery_alloc();
     if (!n) return NULL;
-    if (!parent) return n;
+    if (!parent) {
+        n->priority = (CCPriority)sched_v2_current_priority();
+        return n;
+    }
+    n->priority = parent->priority;
 
     /* Snapshot parent cancellation/deadline state at creation time.  No live
        parent pointer is retained, which keeps ownership ordering simple. */
@@ -333,6 +339,15 @@ const struct timespec* cc_nursery_deadline(const CCNursery* n, struct timespec*
     return out;
 }
 
+void cc_nursery_set_priority(CCNursery* n, CCPriority p) {
+    if (!n || p < CC_PRIORITY_INTERACTIVE || p > CC_PRIORITY_BATCH) return;
+    n->priority = p;
+}
+
+CCPriority cc_nursery_priority(const CCNursery* n) {
+    return n ? n->priority : CC_PRIORITY_NORMAL;
+}
+
 CCDeadline cc_nursery_as_deadline(const CCNursery* n) {
     CCDeadline d = cc_deadline_none();
     if (!n) { d.cancelled = 1; return d; }
@@ -352,8 +367,10 @@ bool cc_nursery_is_cancelled(const CCNursery* n) {
     return false;
 }
 
-/* Check if current fiber's nursery is cancelled (convenience for user code). */
+/* Check if current fiber's nursery is cancelled (convenience for user code).
+ * Hot loops poll this, so it doubles as a preemption safe point. */
 bool cc_cancelled(void) {
+    cc_preempt_point();
     return cc_nursery_is_cancelled(cc__runtime_current_nursery());
 }
 
@@ -444,13 +461,12 @@ static void* cc__nursery_async_runner(void* arg) {
     return NULL;
 }
 
-/* V2 is the default scheduler. spawn() routes through sched_v2; spawnhybrid()
- * is kept as an alias for source compatibility during the V1 retirement. */
-int cc_nursery_spawn(CCNursery* n, void* (*fn)(void*), void* arg) {
-    if (!n || !fn) return EINVAL;
-
-    int timing = nursery_timing_enabled();
-    uint64_t t0 = 0, t1, t2, t3;
+/* `timing` is a constant at every call site: cc_nursery_spawn (0) stays a
+ * few loads and two calls, small enough for `ccc build --lto` to inline
+ * into spawn loops; the CC_SPAWN_TIMING variant is kept out of line. */
+static inline __attribute__((always_inline))
+int cc__nursery_spawn_impl(CCNursery* n, void* (*fn)(void*), void* arg, int prio, int timing) {
+    uint64_t t0 = 0, t1 = 0, t2 = 0, t3;
     if (timing) t0 = nursery_rdtsc();
     if (timing) t1 = t0;
 
@@ -463,7 +479,7 @@ int cc_nursery_spawn(CCNursery* n, void* (*fn)(void*), void* arg) {
         atomic_fetch_add_explicit(&n->alive_count, 1, memory_order_relaxed);
     }
 
-    fiber_v2* t = sched_v2_spawn_in_nursery(fn, arg, n);
+    fiber_v2* t = sched_v2_spawn_in_nursery(fn, arg, n, prio);
     if (!t) {
         if (worker_frees) {
             atomic_fetch_sub_explicit(&n->alive_count, 1, memory_order_relaxed);
@@ -495,6 +511,25 @@ int cc_nursery_spawn(CCNursery* n, void* (*fn)(void*), void* arg) {
     return 0;
 }
 
+__attribute__((noinline))
+static int cc__nursery_spawn_timed(CCNursery* n, void* (*fn)(void*), void* arg, int prio) {
+    return cc__nursery_spawn_impl(n, fn, arg, prio, 1);
+}
+
+/* V2 is the default scheduler. spawn() routes through sched_v2; spawnhybrid()
+ * is kept as an alias for source compatibility during the V1 retirement. */
+int cc_nursery_spawn(CCNursery* n, void* (*fn)(void*), void* arg) {
+    if (!n || !fn) return EINVAL;
+    if (__builtin_expect(nursery_timing_enabled(), 0)) return cc__nursery_spawn_timed(n, fn, arg, n->priority);
+    return cc__nursery_spawn_impl(n, fn, arg, n->priority, 0);
+}
+
+int cc_nursery_spawn_prio(CCNursery* n, void* (*fn)(void*), void* arg, CCPriority p) {
+    if (!n || !fn || p < CC_PRIORITY_INTERACTIVE || p > CC_PRIORITY_BATCH) return EINVAL;
+    if (__builtin_expect(nursery_timing_enabled(), 0)) return cc__nursery_spawn_timed(n, fn, arg, p);
+    return cc__nursery_spawn_impl(n, fn, arg, p, 0);
+}
+
 int cc_nursery_spawnhybrid(CCNursery* n, void* (*fn)(void*), void* arg) {
     return cc_nursery_spawn(n, fn, arg);
 }
@@ -17,10 +17,19 @@
 #else
 #include <unistd.h>
 #include <signal.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <spawn.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434  /* same number on every architecture (5.3+) */
+#endif
+#endif
 #if defined(__APPLE__)
 #include <AvailabilityMacros.h>
 #endif
@@ -66,112 +75,379 @@ static int cc__append_process_output(CCArena* arena, CCSlice* dst, size_t* cap,
 }
 
 #ifndef _WIN32
-static CCResult_CCProcessOutput_CCIoError cc__process_capture_posix(CCArena* arena,
-                                                                    CCProcess* proc,
-                                                                    CCSlice input) {
-    CCProcessOutput output = {0};
-    size_t stdout_cap = 0;
-    size_t stderr_cap = 0;
-    size_t input_off = 0;
-    int stdin_open = proc->stdin_fd >= 0;
-    int stdout_open = proc->stdout_fd >= 0;
-    int stderr_open = proc->stderr_fd >= 0;
-
-    if (stdin_open && input.len == 0) {
-        cc_process_close_stdin(proc);
-        stdin_open = 0;
-    }
-
-    while (stdin_open || stdout_open || stderr_open) {
-        fd_set readfds;
-        fd_set writefds;
-        fd_set* read_ptr = NULL;
-        fd_set* write_ptr = NULL;
-        int maxfd = -1;
-        int ready;
-
-        FD_ZERO(&readfds);
-        FD_ZERO(&writefds);
-
-        if (stdout_open) {
-            FD_SET(proc->stdout_fd, &readfds);
-            read_ptr = &readfds;
-            if (proc->stdout_fd > maxfd) maxfd = proc->stdout_fd;
-        }
-        if (stderr_open) {
-            FD_SET(proc->stderr_fd, &readfds);
-            read_ptr = &readfds;
-            if (proc->stderr_fd > maxfd) maxfd = proc->stderr_fd;
-        }
-        if (stdin_open && input_off < input.len) {
-            FD_SET(proc->stdin_fd, &writefds);
-            write_ptr = &writefds;
-            if (proc->stdin_fd > maxfd) maxfd = proc->stdin_fd;
+/* ============================================================================
+ * Fiber-aware pipe I/O and exit waits - POSIX
+ * ============================================================================
+ *
+ * The parent's pipe ends are non-blocking. Reads and writes try the syscall
+ * first and, on EAGAIN, wait in cc__io_wait_fd(): a fiber parks on the
+ * io_wait poller, a plain thread polls the one fd. Nothing here is bounded by
+ * FD_SETSIZE.
+ *
+ * Exit waits never spin on waitpid(WNOHANG). On Linux each child gets a
+ * pidfd at spawn, which becomes readable when the child exits. Without pidfd
+ * (macOS, pre-5.3 kernels) a waiter registers the write end of a private
+ * self-pipe in g_cc_sigchld_slots; a chained SIGCHLD handler writes one byte
+ * to every registered pipe. Either way the waiter re-checks waitpid(WNOHANG)
+ * only after a wake.
+ */
+
+/* Close-on-exec pipes, so concurrent spawns do not inherit each other's
+ * ends and miss EOF. */
+static int cc__process_pipe(int fds[2]) {
+#if defined(__linux__) && defined(SYS_pipe2)
+    if (syscall(SYS_pipe2, fds, O_CLOEXEC) == 0) return 0;
+    if (errno != ENOSYS) return -1;
+#endif
+    if (pipe(fds) < 0) return -1;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return 0;
+}
+
+static void cc__process_set_nonblock(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/* EIO from cc__io_wait_fd means POLLHUP/POLLERR: the retried syscall reports
+ * EOF or the real error, so it counts as "ready". */
+static int cc__process_wait_ready(int fd, short events) {
+    int err = cc__io_wait_fd(fd, events);
+    return err == EIO ? 0 : err;
+}
+
+/* One read; waits while the pipe is empty. Returns bytes read (0 = EOF) or -1. */
+static ssize_t cc__process_fd_read(int fd, void* buf, size_t n) {
+    for (;;) {
+        ssize_t got = read(fd, buf, n);
+        if (got >= 0) return got;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+        int err = cc__process_wait_ready(fd, POLLIN);
+        if (err != 0) { errno = err; return -1; }
+    }
+}
+
+/* One write; waits while the pipe is full. Returns bytes written or -1. */
+static ssize_t cc__process_fd_write(int fd, const void* buf, size_t n) {
+    for (;;) {
+        ssize_t put = write(fd, buf, n);
+        if (put >= 0) return put;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+        int err = cc__process_wait_ready(fd, POLLOUT);
+        if (err != 0) { errno = err; return -1; }
+    }
+}
+
+static int cc__process_pidfd_open(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    /* pidfds are always close-on-exec. */
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+static CCProcessStatus cc__process_status_from_wait(int wstatus) {
+    CCProcessStatus status = {0};
+    if (WIFEXITED(wstatus)) {
+        status.exited = true;
+        status.exit_code = WEXITSTATUS(wstatus);
+    } else if (WIFSIGNALED(wstatus)) {
+        status.signaled = true;
+        status.exit_code = WTERMSIG(wstatus);
+    }
+    return status;
+}
+
+/* Mark as completed; the pidfd has nothing more to report. */
+static void cc__process_reaped(CCProcess* proc) {
+    proc->pid = -1;
+    if (proc->exit_fd >= 0) {
+        close(proc->exit_fd);
+        proc->exit_fd = -1;
+    }
+}
+
+#define CC_PROCESS_SIGCHLD_SLOTS 128
+
+/* fd holds write_end + 1 (0 = free) so the zeroed table is empty. busy counts
+ * handlers currently using the slot; unregister waits for it to drain before
+ * closing, so a handler never writes to a recycled fd. */
+typedef struct {
+    _Atomic int fd;
+    _Atomic int busy;
+} cc__sigchld_slot;
+
+static cc__sigchld_slot g_cc_sigchld_slots[CC_PROCESS_SIGCHLD_SLOTS];
+static struct sigaction g_cc_sigchld_prev;
+static pthread_once_t g_cc_sigchld_once = PTHREAD_ONCE_INIT;
+static int g_cc_sigchld_ok = 0;
+
+static void cc__sigchld_handler(int sig, siginfo_t* info, void* uctx) {
+    int saved_errno = errno;
+    for (int i = 0; i < CC_PROCESS_SIGCHLD_SLOTS; ++i) {
+        cc__sigchld_slot* slot = &g_cc_sigchld_slots[i];
+        if (atomic_load_explicit(&slot->fd, memory_order_relaxed) == 0) continue;
+        atomic_fetch_add_explicit(&slot->busy, 1, memory_order_seq_cst);
+        int wfd = atomic_load_explicit(&slot->fd, memory_order_seq_cst) - 1;
+        if (wfd >= 0) {
+            char byte = 0;
+            (void)!write(wfd, &byte, 1);
         }
+        atomic_fetch_sub_explicit(&slot->busy, 1, memory_order_release);
+    }
+    errno = saved_errno;
+    if (g_cc_sigchld_prev.sa_flags & SA_SIGINFO) {
+        if (g_cc_sigchld_prev.sa_sigaction) g_cc_sigchld_prev.sa_sigaction(sig, info, uctx);
+    } else if (g_cc_sigchld_prev.sa_handler != SIG_DFL && g_cc_sigchld_prev.sa_handler != SIG_IGN) {
+        g_cc_sigchld_prev.sa_handler(sig);
+    }
+}
 
-        ready = select(maxfd + 1, read_ptr, write_ptr, NULL, NULL);
-        if (ready < 0) {
-            if (errno == EINTR) continue;
-            return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(errno));
+static void cc__sigchld_install(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = cc__sigchld_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&sa.sa_mask);
+    g_cc_sigchld_ok = sigaction(SIGCHLD, &sa, &g_cc_sigchld_prev) == 0;
+}
+
+/* Returns the slot index and the pipe's read end, or -1 when the table is
+ * full or the handler could not be installed. */
+static int cc__sigchld_register(int* read_fd) {
+    pthread_once(&g_cc_sigchld_once, cc__sigchld_install);
+    if (!g_cc_sigchld_ok) return -1;
+    int fds[2];
+    if (cc__process_pipe(fds) < 0) return -1;
+    cc__process_set_nonblock(fds[0]);
+    cc__process_set_nonblock(fds[1]);
+    for (int i = 0; i < CC_PROCESS_SIGCHLD_SLOTS; ++i) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&g_cc_sigchld_slots[i].fd, &expected, fds[1] + 1)) {
+            *read_fd = fds[0];
+            return i;
         }
+    }
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+}
+
+static void cc__sigchld_unregister(int slot_index, int read_fd) {
+    cc__sigchld_slot* slot = &g_cc_sigchld_slots[slot_index];
+    int wfd = atomic_exchange(&slot->fd, 0) - 1;
+    while (atomic_load_explicit(&slot->busy, memory_order_acquire) != 0) {
+        sched_yield();
+    }
+    close(wfd);
+    close(read_fd);
+}
 
-        if (stdin_open && write_ptr && FD_ISSET(proc->stdin_fd, &writefds)) {
-            ssize_t n;
-            do {
-                n = write(proc->stdin_fd,
-                          (const char*)input.ptr + input_off,
-                          input.len - input_off);
-            } while (n < 0 && errno == EINTR);
-            if (n < 0) {
-                cc_process_close_stdin(proc);
-                return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(errno));
+static void cc__process_drain_fd(int fd) {
+    char buf[64];
+    while (read(fd, buf, sizeof(buf)) > 0) {}
+}
+
+/* Reap proc, waiting until it exits or abs_deadline (CLOCK_REALTIME, NULL =
+ * forever) passes. */
+static CCResult_CCProcessStatus_CCIoError cc__process_wait_until(CCProcess* proc,
+                                                                 const struct timespec* abs_deadline) {
+    int slot = -1;
+    int sig_fd = -1;
+    CCResult_CCProcessStatus_CCIoError res;
+    for (;;) {
+        int wstatus = 0;
+        pid_t result;
+        do {
+            result = waitpid(proc->pid, &wstatus, WNOHANG);
+        } while (result < 0 && errno == EINTR);  /* Retry on signal interruption */
+        if (result < 0) {
+            res = cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(errno));
+            break;
+        }
+        if (result > 0) {
+            cc__process_reaped(proc);
+            res = cc_ok_CCResult_CCProcessStatus_CCIoError(cc__process_status_from_wait(wstatus));
+            break;
+        }
+        int wait_fd = proc->exit_fd;
+        if (wait_fd < 0) {
+            if (slot < 0) {
+                /* Register, then re-check: a SIGCHLD before registration is
+                 * covered by the next waitpid. */
+                slot = cc__sigchld_register(&sig_fd);
+                if (slot >= 0) continue;
             }
-            input_off += (size_t)n;
-            if (input_off >= input.len) {
-                cc_process_close_stdin(proc);
-                stdin_open = 0;
+            wait_fd = sig_fd;
+        }
+        int err;
+        if (wait_fd >= 0) {
+            err = cc__io_wait_fd_until(wait_fd, POLLIN, abs_deadline);
+            if (err == EIO) err = 0;
+            if (wait_fd == sig_fd) cc__process_drain_fd(sig_fd);
+        } else {
+            /* No pidfd and no SIGCHLD slot left: fall back to a 1 ms poll. */
+            struct timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            err = 0;
+            if (abs_deadline && (now.tv_sec > abs_deadline->tv_sec ||
+                                 (now.tv_sec == abs_deadline->tv_sec && now.tv_nsec >= abs_deadline->tv_nsec))) {
+                err = ETIMEDOUT;
+            } else {
+                struct timespec sleep_ts = {.tv_sec = 0, .tv_nsec = 1000000L};
+                nanosleep(&sleep_ts, NULL);
             }
         }
+        if (err != 0) {
+            res = cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(err));
+            break;
+        }
+    }
+    if (slot >= 0) cc__sigchld_unregister(slot, sig_fd);
+    return res;
+}
 
-        if (stdout_open && read_ptr && FD_ISSET(proc->stdout_fd, &readfds)) {
-            char buf[4096];
-            ssize_t n;
-            do {
-                n = read(proc->stdout_fd, buf, sizeof(buf));
-            } while (n < 0 && errno == EINTR);
-            if (n < 0) {
-                close(proc->stdout_fd);
-                proc->stdout_fd = -1;
-                return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(errno));
-            }
-            if (n == 0) {
-                close(proc->stdout_fd);
-                proc->stdout_fd = -1;
-                stdout_open = 0;
-            } else if (cc__append_process_output(arena, &output.stdout_data, &stdout_cap, buf, (size_t)n) != 0) {
-                return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(ENOMEM));
+/* ============================================================================
+ * Run-and-capture - POSIX
+ * ============================================================================
+ *
+ * The caller drains one output pipe into the arena. A second output pipe and
+ * the stdin feed each get a helper fiber, so a child that fills stderr while
+ * we wait on stdout (or stops reading stdin until we read its output) cannot
+ * deadlock the capture. The stderr helper collects into a malloc'd buffer
+ * (arenas are not safe to grow from two fibers) that is copied into the
+ * arena once it finishes.
+ */
+
+typedef struct {
+    CCProcess* proc;
+    CCSlice input;
+    int fd;
+    char* buf;
+    size_t len;
+    size_t cap;
+    int err;
+} cc__process_pump;
+
+static void* cc__process_pump_stdin(void* arg) {
+    cc__process_pump* p = (cc__process_pump*)arg;
+    size_t off = 0;
+    while (off < p->input.len) {
+        ssize_t n = cc__process_fd_write(p->proc->stdin_fd, (const char*)p->input.ptr + off, p->input.len - off);
+        if (n < 0) {
+            p->err = errno;
+            break;
+        }
+        off += (size_t)n;
+    }
+    cc_process_close_stdin(p->proc);
+    return NULL;
+}
+
+static void* cc__process_pump_output(void* arg) {
+    cc__process_pump* p = (cc__process_pump*)arg;
+    for (;;) {
+        char chunk[4096];
+        ssize_t n = cc__process_fd_read(p->fd, chunk, sizeof(chunk));
+        if (n < 0) {
+            p->err = errno;
+            break;
+        }
+        if (n == 0) break;
+        if (p->len + (size_t)n > p->cap) {
+            size_t next_cap = p->cap ? p->cap * 2 : sizeof(chunk);
+            while (p->len + (size_t)n > next_cap) next_cap *= 2;
+            char* next = (char*)realloc(p->buf, next_cap);
+            if (!next) {
+                p->err = ENOMEM;
+                break;
             }
+            p->buf = next;
+            p->cap = next_cap;
         }
+        memcpy(p->buf + p->len, chunk, (size_t)n);
+        p->len += (size_t)n;
+    }
+    return NULL;
+}
+
+static int cc__process_drain_to_arena(int fd, CCArena* arena, CCSlice* dst) {
+    size_t cap = 0;
+    for (;;) {
+        char buf[4096];
+        ssize_t n = cc__process_fd_read(fd, buf, sizeof(buf));
+        if (n < 0) return errno;
+        if (n == 0) return 0;
+        if (cc__append_process_output(arena, dst, &cap, buf, (size_t)n) != 0) return ENOMEM;
+    }
+}
 
-        if (stderr_open && read_ptr && FD_ISSET(proc->stderr_fd, &readfds)) {
-            char buf[4096];
-            ssize_t n;
-            do {
-                n = read(proc->stderr_fd, buf, sizeof(buf));
-            } while (n < 0 && errno == EINTR);
-            if (n < 0) {
-                close(proc->stderr_fd);
-                proc->stderr_fd = -1;
-                return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(errno));
+static CCResult_CCProcessOutput_CCIoError cc__process_capture_posix(CCArena* arena,
+                                                                    CCProcess* proc,
+                                                                    CCSlice input) {
+    CCProcessOutput output = {0};
+    cc__process_pump in_pump = {.proc = proc, .input = input, .fd = -1};
+    cc__process_pump err_pump = {.proc = proc, .fd = -1};
+    int* primary_fd = NULL;
+    CCSlice* primary_dst = NULL;
+    int err = 0;
+
+    if (proc->stdin_fd >= 0 && input.len == 0) cc_process_close_stdin(proc);
+
+    if (proc->stdout_fd >= 0) {
+        primary_fd = &proc->stdout_fd;
+        primary_dst = &output.stdout_data;
+        if (proc->stderr_fd >= 0) err_pump.fd = proc->stderr_fd;
+    } else if (proc->stderr_fd >= 0) {
+        primary_fd = &proc->stderr_fd;
+        primary_dst = &output.stderr_data;
+    }
+
+    if (!primary_fd) {
+        if (proc->stdin_fd >= 0) cc__process_pump_stdin(&in_pump);
+        err = in_pump.err;
+    } else {
+        CCNursery* helpers = NULL;
+        if (proc->stdin_fd >= 0 || err_pump.fd >= 0) {
+            helpers = cc_nursery_create(NULL);
+            if (!helpers) err = ENOMEM;
+        }
+        if (helpers) {
+            if (proc->stdin_fd >= 0 && cc_nursery_spawn(helpers, cc__process_pump_stdin, &in_pump) != 0) {
+                cc__process_pump_stdin(&in_pump);  /* run inline rather than leave stdin open */
             }
-            if (n == 0) {
-                close(proc->stderr_fd);
-                proc->stderr_fd = -1;
-                stderr_open = 0;
-            } else if (cc__append_process_output(arena, &output.stderr_data, &stderr_cap, buf, (size_t)n) != 0) {
-                return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(ENOMEM));
+            if (err_pump.fd >= 0 && cc_nursery_spawn(helpers, cc__process_pump_output, &err_pump) != 0) {
+                err_pump.err = EAGAIN;
             }
         }
+        if (err == 0) err = cc__process_drain_to_arena(*primary_fd, arena, primary_dst);
+        close(*primary_fd);
+        *primary_fd = -1;
+        if (helpers) {
+            cc_nursery_wait(helpers);
+            cc_nursery_free(helpers);
+        }
+        if (err == 0) err = in_pump.err ? in_pump.err : err_pump.err;
+        if (err == 0 && err_pump.len > 0) {
+            size_t cap = 0;
+            if (cc__append_process_output(arena, &output.stderr_data, &cap, err_pump.buf, err_pump.len) != 0) {
+                err = ENOMEM;
+            }
+        }
+        free(err_pump.buf);
+        if (proc->stderr_fd >= 0) {
+            close(proc->stderr_fd);
+            proc->stderr_fd = -1;
+        }
+    }
+    cc_process_close_stdin(proc);
+    if (err != 0) {
+        return cc_err_CCResult_CCProcessOutput_CCIoError(cc_io_from_errno(err));
     }
 
     {
@@ -193,7 +469,7 @@ static CCResult_CCProcessOutput_CCIoError cc__process_capture_posix(CCArena* are
 #ifndef _WIN32
 
 CCResult_CCProcess_CCIoError cc_process_spawn(const CCProcessConfig* config) {
-    CCProcess proc = {.pid = -1, .stdin_fd = -1, .stdout_fd = -1, .stderr_fd = -1};
+    CCProcess proc = {.pid = -1, .stdin_fd = -1, .stdout_fd = -1, .stderr_fd = -1, .exit_fd = -1};
 
     if (!config || !config->program || !config->args) {
         return cc_err_CCResult_CCProcess_CCIoError(cc_io_from_errno(EINVAL));
@@ -205,18 +481,18 @@ CCResult_CCProcess_CCIoError cc_process_spawn(const CCProcessConfig* config) {
 
     /* Create pipes as needed */
     if (config->pipe_stdin) {
-        if (pipe(stdin_pipe) < 0) {
+        if (cc__process_pipe(stdin_pipe) < 0) {
             return cc_err_CCResult_CCProcess_CCIoError(cc_io_from_errno(errno));
         }
     }
     if (config->pipe_stdout) {
-        if (pipe(stdout_pipe) < 0) {
+        if (cc__process_pipe(stdout_pipe) < 0) {
             if (stdin_pipe[0] >= 0) { close(stdin_pipe[0]); close(stdin_pipe[1]); }
             return cc_err_CCResult_CCProcess_CCIoError(cc_io_from_errno(errno));
         }
     }
     if (config->pipe_stderr && !config->merge_stderr) {
-        if (pipe(stderr_pipe) < 0) {
+        if (cc__process_pipe(stderr_pipe) < 0) {
             if (stdin_pipe[0] >= 0) { close(stdin_pipe[0]); close(stdin_pipe[1]); }
             if (stdout_pipe[0] >= 0) { close(stdout_pipe[0]); close(stdout_pipe[1]); }
             return cc_err_CCResult_CCProcess_CCIoError(cc_io_from_errno(errno));
@@ -308,55 +584,35 @@ CCResult_CCProcess_CCIoError cc_process_spawn(const CCProcessConfig* config) {
 
     /* Parent: close unused pipe ends */
     proc.pid = pid;
+    proc.exit_fd = cc__process_pidfd_open(pid);
 
     if (config->pipe_stdin) {
         close(stdin_pipe[0]);  /* Close read end */
         proc.stdin_fd = stdin_pipe[1];
+        cc__process_set_nonblock(proc.stdin_fd);
     }
     if (config->pipe_stdout) {
         close(stdout_pipe[1]);  /* Close write end */
         proc.stdout_fd = stdout_pipe[0];
+        cc__process_set_nonblock(proc.stdout_fd);
     }
     if (config->pipe_stderr && !config->merge_stderr) {
         close(stderr_pipe[1]);  /* Close write end */
         proc.stderr_fd = stderr_pipe[0];
+        cc__process_set_nonblock(proc.stderr_fd);
     }
 
     return cc_ok_CCResult_CCProcess_CCIoError(proc);
 }
 
 CCResult_CCProcessStatus_CCIoError cc_process_wait(CCProcess* proc) {
-    CCProcessStatus status = {0};
-
     if (!proc || proc->pid <= 0) {
         return cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(EINVAL));
     }
-
-    int wstatus;
-    pid_t result;
-    do {
-        result = waitpid(proc->pid, &wstatus, 0);
-    } while (result < 0 && errno == EINTR);  /* Retry on signal interruption */
-    
-    if (result < 0) {
-        return cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(errno));
-    }
-
-    if (WIFEXITED(wstatus)) {
-        status.exited = true;
-        status.exit_code = WEXITSTATUS(wstatus);
-    } else if (WIFSIGNALED(wstatus)) {
-        status.signaled = true;
-        status.exit_code = WTERMSIG(wstatus);
-    }
-
-    proc->pid = -1;  /* Mark as completed */
-    return cc_ok_CCResult_CCProcessStatus_CCIoError(status);
+    return cc__process_wait_until(proc, NULL);
 }
 
 CCResult_CCProcessStatus_CCIoError cc_process_try_wait(CCProcess* proc) {
-    CCProcessStatus status = {0};
-
     if (!proc || proc->pid <= 0) {
         return cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(EINVAL));
     }
@@ -374,16 +630,8 @@ CCResult_CCProcessStatus_CCIoError cc_process_try_wait(CCProcess* proc) {
         return cc_err_CCResult_CCProcessStatus_CCIoError(busy);
     }
 
-    if (WIFEXITED(wstatus)) {
-        status.exited = true;
-        status.exit_code = WEXITSTATUS(wstatus);
-    } else if (WIFSIGNALED(wstatus)) {
-        status.signaled = true;
-        status.exit_code = WTERMSIG(wstatus);
-    }
-
-    proc->pid = -1;
-    return cc_ok_CCResult_CCProcessStatus_CCIoError(status);
+    cc__process_reaped(proc);
+    return cc_ok_CCResult_CCProcessStatus_CCIoError(cc__process_status_from_wait(wstatus));
 }
 
 CCResult_CCProcessStatus_CCIoError cc_process_wait_timeout_ms(CCProcess* proc, int64_t timeout_ms) {
@@ -397,39 +645,15 @@ CCResult_CCProcessStatus_CCIoError cc_process_wait_timeout_ms(CCProcess* proc, i
         return cc_process_try_wait(proc);
     }
 
-    struct timespec start;
-    clock_gettime(CLOCK_MONOTONIC, &start);
-
-    for (;;) {
-        int wstatus;
-        pid_t result = waitpid(proc->pid, &wstatus, WNOHANG);
-        if (result < 0) {
-            return cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(errno));
-        }
-        if (result > 0) {
-            CCProcessStatus status = {0};
-            if (WIFEXITED(wstatus)) {
-                status.exited = true;
-                status.exit_code = WEXITSTATUS(wstatus);
-            } else if (WIFSIGNALED(wstatus)) {
-                status.signaled = true;
-                status.exit_code = WTERMSIG(wstatus);
-            }
-            proc->pid = -1;
-            return cc_ok_CCResult_CCProcessStatus_CCIoError(status);
-        }
-
-        struct timespec now;
-        clock_gettime(CLOCK_MONOTONIC, &now);
-        int64_t elapsed_ms = (int64_t)(now.tv_sec - start.tv_sec) * 1000LL +
-                             (int64_t)(now.tv_nsec - start.tv_nsec) / 1000000LL;
-        if (elapsed_ms >= timeout_ms) {
-            return cc_err_CCResult_CCProcessStatus_CCIoError(cc_io_from_errno(ETIMEDOUT));
-        }
-
-        struct timespec sleep_ts = {.tv_sec = 0, .tv_nsec = 1000000L};
-        nanosleep(&sleep_ts, NULL);
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000);
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
     }
+    return cc__process_wait_until(proc, &deadline);
 }
 
 CCResult_CCProcessStatus_CCIoError cc_process_wait_timeout(CCProcess* proc, int timeout_sec) {
@@ -458,7 +682,7 @@ CCResult_bool_CCIoError cc_process_kill(CCProcess* proc, int sig) {
  * ============================================================================ */
 
 CCResult_CCProcess_CCIoError cc_process_spawn(const CCProcessConfig* config) {
-    CCProcess proc = {.handle = NULL, .pid = 0, .stdin_fd = -1, .stdout_fd = -1, .stderr_fd = -1};
+    CCProcess proc = {.handle = NULL, .pid = 0, .stdin_fd = -1, .stdout_fd = -1, .stderr_fd = -1, .exit_fd = -1};
 
     if (!config || !config->program || !config->args) {
         return cc_err_CCResult_CCProcess_CCIoError(cc_io_from_errno(EINVAL));
@@ -686,7 +910,7 @@ CCResult_size_t_CCIoError cc_process_write(CCProcess* proc, CCSlice data) {
     }
     return cc_ok_CCResult_size_t_CCIoError((size_t)written);
 #else
-    ssize_t n = write(proc->stdin_fd, data.ptr, data.len);
+    ssize_t n = cc__process_fd_write(proc->stdin_fd, data.ptr, data.len);
     if (n < 0) {
         return cc_err_CCResult_size_t_CCIoError(cc_io_from_errno(errno));
     }
@@ -714,7 +938,7 @@ CCResult_CCSlice_CCIoError cc_process_read(CCProcess* proc, CCArena* arena, size
         return cc_err_CCResult_CCSlice_CCIoError(e);
     }
 #else
-    ssize_t n = read(proc->stdout_fd, buf, max_bytes);
+    ssize_t n = cc__process_fd_read(proc->stdout_fd, buf, max_bytes);
     if (n < 0) {
         return cc_err_CCResult_CCSlice_CCIoError(cc_io_from_errno(errno));
     }
@@ -745,7 +969,7 @@ CCResult_CCSlice_CCIoError cc_process_read_stderr(CCProcess* proc, CCArena* aren
         return cc_err_CCResult_CCSlice_CCIoError(e);
     }
 #else
-    ssize_t n = read(proc->stderr_fd, buf, max_bytes);
+    ssize_t n = cc__process_fd_read(proc->stderr_fd, buf, max_bytes);
     if (n < 0) {
         return cc_err_CCResult_CCSlice_CCIoError(cc_io_from_errno(errno));
     }
@@ -790,10 +1014,7 @@ CCResult_CCSlice_CCIoError cc_process_read_all(CCProcess* proc, CCArena* arena)
         }
         if (n == 0) break;
 #else
-        ssize_t n;
-        do {
-            n = read(proc->stdout_fd, buf, sizeof(buf));
-        } while (n < 0 && errno == EINTR);  /* Retry on signal interruption */
+        ssize_t n = cc__process_fd_read(proc->stdout_fd, buf, sizeof(buf));
         if (n <= 0) break;  /* EOF or error */
 #endif
 
@@ -840,10 +1061,7 @@ CCResult_CCSlice_CCIoError cc_process_read_all_stderr(CCProcess* proc, CCArena*
         }
         if (n == 0) break;
 #else
-        ssize_t n;
-        do {
-            n = read(proc->stderr_fd, buf, sizeof(buf));
-        } while (n < 0 && errno == EINTR);  /* Retry on signal interruption */
+        ssize_t n = cc__process_fd_read(proc->stderr_fd, buf, sizeof(buf));
         if (n <= 0) break;  /* EOF or error */
 #endif
 
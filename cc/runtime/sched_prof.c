@@ -0,0 +1,416 @@
+/*
+ * Sampling CPU profiler: SIGPROF handler, stack walk and folded-stack
+ * dump. See sched_prof.h. Part of the runtime TU after fiber_sched.c: the
+ * handler reads fiber_v2 and minicoro's saved resume context directly.
+ */
+
+#include "sched_prof.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#if defined(__APPLE__)
+#include <sys/ucontext.h>
+#else
+#include <ucontext.h>
+#endif
+
+#if (defined(__linux__) || defined(__APPLE__)) && (defined(__x86_64__) || defined(__aarch64__))
+#define CC_PROF_SUPPORTED 1
+#else
+#define CC_PROF_SUPPORTED 0
+#endif
+
+#define CC_PROF_MAX_DEPTH 64
+#define CC_PROF_DEFAULT_HZ 99
+#define CC_PROF_DEFAULT_SAMPLES 16384
+/* Stored between a fiber's frames and the worker frames under its resume. */
+#define CC_PROF_RESUME_MARK ((uintptr_t)1)
+/* Return address minicoro plants at the top of every coroutine stack. */
+#define CC_PROF_MCO_DUMMY_RA ((uintptr_t)0xdeaddeaddeaddeadULL)
+
+enum { CC_PROF_ON_THREAD = 0, CC_PROF_ON_WORKER = 1, CC_PROF_ON_FIBER = 2 };
+
+/* Written only by the signal handler; `seq` is the ticket + 1 once the rest
+ * is complete, so the dump can skip samples torn by a ring wrap. */
+typedef struct {
+    _Atomic uint64_t seq;
+    uint64_t fiber;
+    uintptr_t site;
+    uintptr_t nursery;
+    uint32_t kind;
+    uint32_t depth;
+    uintptr_t pc[CC_PROF_MAX_DEPTH];   /* leaf first */
+} cc_prof_sample;
+
+static _Atomic int g_cc_prof_on = 0;
+static cc_prof_sample* g_cc_prof_buf = NULL;
+static size_t g_cc_prof_cap = 0;       /* power of two, fixed by the first start */
+static _Atomic uint64_t g_cc_prof_next = 0;
+static int g_cc_prof_handler_installed = 0;
+static int g_cc_prof_tag_fiber = 0;
+static int g_cc_prof_tag_nursery = 0;
+static char* g_cc_prof_exit_path = NULL;
+static pthread_mutex_t g_cc_prof_mu = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * Sampling (async-signal context)
+ * ============================================================================ */
+
+#if CC_PROF_SUPPORTED
+static void cc__prof_regs(void* ucv, uintptr_t* pc, uintptr_t* fp, uintptr_t* sp) {
+    ucontext_t* uc = (ucontext_t*)ucv;
+#if defined(__linux__) && defined(__x86_64__)
+    /* REG_RBP / REG_RSP / REG_RIP, which glibc only names under _GNU_SOURCE. */
+    *fp = (uintptr_t)uc->uc_mcontext.gregs[10];
+    *sp = (uintptr_t)uc->uc_mcontext.gregs[15];
+    *pc = (uintptr_t)uc->uc_mcontext.gregs[16];
+#elif defined(__linux__)
+    *fp = (uintptr_t)uc->uc_mcontext.regs[29];
+    *sp = (uintptr_t)uc->uc_mcontext.sp;
+    *pc = (uintptr_t)uc->uc_mcontext.pc;
+#elif defined(__x86_64__)
+    *fp = (uintptr_t)uc->uc_mcontext->__ss.__rbp;
+    *sp = (uintptr_t)uc->uc_mcontext->__ss.__rsp;
+    *pc = (uintptr_t)uc->uc_mcontext->__ss.__rip;
+#else
+    *fp = (uintptr_t)uc->uc_mcontext->__ss.__fp;
+    *sp = (uintptr_t)uc->uc_mcontext->__ss.__sp;
+    *pc = (uintptr_t)uc->uc_mcontext->__ss.__pc;
+#endif
+}
+#endif
+
+/* Worker context saved by the mco_resume that is running this coroutine. */
+static int cc__prof_resume_ctx(mco_coro* co, uintptr_t* pc, uintptr_t* fp, uintptr_t* sp) {
+#if defined(MCO_USE_ASM) && !defined(_WIN32) && defined(__x86_64__)
+    _mco_context* c = (_mco_context*)co->context;
+    *pc = (uintptr_t)c->back_ctx.rip;
+    *sp = (uintptr_t)c->back_ctx.rsp;
+    *fp = (uintptr_t)c->back_ctx.rbp;
+    return 1;
+#elif defined(MCO_USE_ASM) && defined(__aarch64__)
+    _mco_context* c = (_mco_context*)co->context;
+    *pc = (uintptr_t)c->back_ctx.lr;
+    *sp = (uintptr_t)c->back_ctx.sp;
+    *fp = (uintptr_t)c->back_ctx.x[10];   /* x29 */
+    return 1;
+#else
+    (void)co; (void)pc; (void)fp; (void)sp;
+    return 0;
+#endif
+}
+
+/* Follow frame records while they stay inside [lo, hi) and move toward hi. */
+static uint32_t cc__prof_walk(uintptr_t fp, uintptr_t lo, uintptr_t hi, uintptr_t* out, uint32_t n) {
+    while (n < CC_PROF_MAX_DEPTH && fp >= lo && fp + 2 * sizeof(uintptr_t) <= hi &&
+           (fp & (sizeof(uintptr_t) - 1)) == 0) {
+        uintptr_t next = ((uintptr_t*)fp)[0];
+        uintptr_t ret = ((uintptr_t*)fp)[1];
+        if (ret == 0 || ret == CC_PROF_MCO_DUMMY_RA) break;
+        out[n++] = ret;
+        if (next <= fp) break;
+        fp = next;
+    }
+    return n;
+}
+
+#if CC_PROF_SUPPORTED
+static void cc__prof_handler(int sig, siginfo_t* si, void* ucv) {
+    (void)sig;
+    (void)si;
+    if (!atomic_load_explicit(&g_cc_prof_on, memory_order_relaxed)) return;
+    int saved_errno = errno;
+    uintptr_t pc, fp, sp;
+    cc__prof_regs(ucv, &pc, &fp, &sp);
+
+    uint64_t ticket = atomic_fetch_add_explicit(&g_cc_prof_next, 1, memory_order_relaxed);
+    cc_prof_sample* s = &g_cc_prof_buf[ticket & (g_cc_prof_cap - 1)];
+    atomic_store_explicit(&s->seq, 0, memory_order_relaxed);
+    s->fiber = 0;
+    s->site = 0;
+    s->nursery = 0;
+    s->kind = CC_PROF_ON_THREAD;
+    uint32_t n = 0;
+    s->pc[n++] = pc;
+
+    uintptr_t worker_hi = tls_v2_stack_hi;
+    fiber_v2* f = tls_v2_current_fiber;
+    mco_coro* co = f ? f->coro : NULL;
+    uintptr_t lo = co ? (uintptr_t)co->stack_base : 0;
+    uintptr_t hi = co ? lo + co->stack_size : 0;
+    if (co && sp >= lo && sp < hi) {
+        s->kind = CC_PROF_ON_FIBER;
+        s->fiber = sched_v2_trace_id(f);
+        s->site = (uintptr_t)f->spawn_site;
+        s->nursery = (uintptr_t)f->saved_nursery;
+        n = cc__prof_walk(fp, sp, hi, s->pc, n);
+        if (worker_hi && n + 2 <= CC_PROF_MAX_DEPTH && cc__prof_resume_ctx(co, &pc, &fp, &sp)) {
+            s->pc[n++] = CC_PROF_RESUME_MARK;
+            s->pc[n++] = pc;
+            n = cc__prof_walk(fp, sp, worker_hi, s->pc, n);
+        }
+    } else if (worker_hi) {
+        s->kind = CC_PROF_ON_WORKER;
+        n = cc__prof_walk(fp, sp, worker_hi, s->pc, n);
+    }
+    s->depth = n;
+    atomic_store_explicit(&s->seq, ticket + 1, memory_order_release);
+    errno = saved_errno;
+}
+#endif
+
+/* ============================================================================
+ * Control
+ * ============================================================================ */
+
+static size_t cc__prof_env_size(const char* name, size_t dflt) {
+    const char* s = getenv(name);
+    if (!s || !*s) return dflt;
+    long v = strtol(s, NULL, 10);
+    return v > 0 ? (size_t)v : dflt;
+}
+
+int cc_prof_start(int hz) {
+#if !CC_PROF_SUPPORTED
+    (void)hz;
+    return ENOTSUP;
+#else
+    if (hz <= 0) hz = (int)cc__prof_env_size("CC_PROF_HZ", CC_PROF_DEFAULT_HZ);
+    if (hz > 10000) hz = 10000;
+    pthread_mutex_lock(&g_cc_prof_mu);
+    if (!g_cc_prof_buf) {
+        size_t want = cc__prof_env_size("CC_PROF_SAMPLES", CC_PROF_DEFAULT_SAMPLES);
+        size_t cap = 256;
+        while (cap < want && cap < ((size_t)1 << 24)) cap <<= 1;
+        g_cc_prof_buf = (cc_prof_sample*)calloc(cap, sizeof(cc_prof_sample));
+        if (!g_cc_prof_buf) {
+            pthread_mutex_unlock(&g_cc_prof_mu);
+            return ENOMEM;
+        }
+        g_cc_prof_cap = cap;
+        const char* tags = getenv("CC_PROF_TAGS");
+        g_cc_prof_tag_fiber = tags && strstr(tags, "fiber") != NULL;
+        g_cc_prof_tag_nursery = tags && strstr(tags, "nursery") != NULL;
+    }
+    if (!g_cc_prof_handler_installed) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = cc__prof_handler;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(SIGPROF, &sa, NULL) != 0) {
+            int rc = errno;
+            pthread_mutex_unlock(&g_cc_prof_mu);
+            return rc;
+        }
+        g_cc_prof_handler_installed = 1;
+    }
+    atomic_store_explicit(&g_cc_prof_on, 1, memory_order_release);
+    struct itimerval it;
+    memset(&it, 0, sizeof(it));
+    /* tv_usec must stay below 1000000, so hz=1 is a one-second tv_sec. */
+    it.it_interval.tv_sec = 1 / hz;
+    it.it_interval.tv_usec = (1000000 / hz) % 1000000;
+    it.it_value = it.it_interval;
+    int rc = setitimer(ITIMER_PROF, &it, NULL) != 0 ? errno : 0;
+    if (rc != 0) atomic_store_explicit(&g_cc_prof_on, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&g_cc_prof_mu);
+    return rc;
+#endif
+}
+
+void cc_prof_stop(void) {
+#if CC_PROF_SUPPORTED
+    struct itimerval it;
+    memset(&it, 0, sizeof(it));
+    (void)setitimer(ITIMER_PROF, &it, NULL);
+#endif
+    atomic_store_explicit(&g_cc_prof_on, 0, memory_order_release);
+}
+
+static void cc__prof_atexit(void) {
+    cc_prof_stop();
+    int rc = cc_prof_dump(g_cc_prof_exit_path);
+    if (rc != 0) {
+        fprintf(stderr, "[cc prof] could not write %s: %s\n", g_cc_prof_exit_path, strerror(rc));
+    }
+}
+
+void cc__prof_init_from_env(void) {
+    const char* path = getenv("CC_PROF");
+    if (!path || !*path || g_cc_prof_exit_path) return;
+    g_cc_prof_exit_path = strdup(path);
+    if (!g_cc_prof_exit_path) return;
+    int rc = cc_prof_start(0);
+    if (rc != 0) {
+        fprintf(stderr, "[cc prof] not started: %s\n", strerror(rc));
+        return;
+    }
+    atexit(cc__prof_atexit);
+}
+
+/* ============================================================================
+ * Dump
+ * ============================================================================ */
+
+typedef struct {
+    uintptr_t start, end, off;
+    int exec;              /* ET_EXEC: addresses are already link-time vaddrs */
+    char* path;
+} cc_prof_map;
+
+typedef struct {
+    cc_prof_map* m;
+    size_t n;
+} cc_prof_maps;
+
+static int cc__prof_elf_is_exec(const char* path) {
+    unsigned char h[18];
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t got = fread(h, 1, sizeof(h), f);
+    fclose(f);
+    if (got != sizeof(h) || memcmp(h, "\x7f" "ELF", 4) != 0) return 0;
+    unsigned type = h[5] == 2 ? ((unsigned)h[16] << 8 | h[17]) : ((unsigned)h[17] << 8 | h[16]);
+    return type == 2;
+}
+
+/* Executable mappings of this process (Linux); empty elsewhere. */
+static void cc__prof_load_maps(cc_prof_maps* maps) {
+    maps->m = NULL;
+    maps->n = 0;
+    FILE* f = fopen("/proc/self/maps", "r");
+    if (!f) return;
+    char line[4096];
+    size_t cap = 0;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long start, end, off;
+        char perms[8];
+        int path_at = 0;
+        if (sscanf(line, "%lx-%lx %7s %lx %*s %*s %n", &start, &end, perms, &off, &path_at) < 4) continue;
+        if (!strchr(perms, 'x') || path_at <= 0 || line[path_at] != '/') continue;
+        char* nl = strchr(line + path_at, '\n');
+        if (nl) *nl = '\0';
+        if (maps->n == cap) {
+            size_t nc = cap ? cap * 2 : 32;
+            cc_prof_map* nm = (cc_prof_map*)realloc(maps->m, nc * sizeof(*nm));
+            if (!nm) break;
+            maps->m = nm;
+            cap = nc;
+        }
+        cc_prof_map* e = &maps->m[maps->n];
+        e->path = strdup(line + path_at);
+        if (!e->path) break;
+        e->start = start;
+        e->end = end;
+        e->off = off;
+        e->exec = cc__prof_elf_is_exec(e->path);
+        maps->n++;
+    }
+    fclose(f);
+}
+
+static void cc__prof_free_maps(cc_prof_maps* maps) {
+    for (size_t i = 0; i < maps->n; i++) free(maps->m[i].path);
+    free(maps->m);
+}
+
+static void cc__prof_put_frame(FILE* out, const cc_prof_maps* maps, uintptr_t addr) {
+    for (size_t i = 0; i < maps->n; i++) {
+        const cc_prof_map* e = &maps->m[i];
+        if (addr >= e->start && addr < e->end) {
+            uintptr_t vaddr = e->exec ? addr : addr - e->start + e->off;
+            fprintf(out, "%s+0x%lx", e->path, (unsigned long)vaddr);
+            return;
+        }
+    }
+    fprintf(out, "0x%lx", (unsigned long)addr);
+}
+
+/* Orders samples by everything that ends up in their folded line. */
+static int cc__prof_sample_cmp(const void* a, const void* b) {
+    const cc_prof_sample* x = (const cc_prof_sample*)a;
+    const cc_prof_sample* y = (const cc_prof_sample*)b;
+    if (x->kind != y->kind) return x->kind < y->kind ? -1 : 1;
+    if (x->site != y->site) return x->site < y->site ? -1 : 1;
+    if (g_cc_prof_tag_fiber && x->fiber != y->fiber) return x->fiber < y->fiber ? -1 : 1;
+    if (g_cc_prof_tag_nursery && x->nursery != y->nursery) return x->nursery < y->nursery ? -1 : 1;
+    if (x->depth != y->depth) return x->depth < y->depth ? -1 : 1;
+    return memcmp(x->pc, y->pc, x->depth * sizeof(uintptr_t));
+}
+
+static void cc__prof_put_line(FILE* out, const cc_prof_maps* maps, const cc_prof_sample* s, size_t count) {
+    if (s->kind == CC_PROF_ON_FIBER) {
+        fputs("spawn:", out);
+        cc__prof_put_frame(out, maps, s->site);
+        if (g_cc_prof_tag_fiber) fprintf(out, ";fiber %llu", (unsigned long long)s->fiber);
+        if (g_cc_prof_tag_nursery) {
+            if (s->nursery) fprintf(out, ";nursery 0x%lx", (unsigned long)s->nursery);
+            else fputs(";nursery -", out);
+        }
+    } else {
+        fputs(s->kind == CC_PROF_ON_WORKER ? "[scheduler]" : "[thread]", out);
+    }
+    for (uint32_t i = s->depth; i-- > 0;) {
+        fputc(';', out);
+        if (s->pc[i] == CC_PROF_RESUME_MARK) {
+            fputs("[mco_resume]", out);
+            continue;
+        }
+        /* Return addresses point past the call; step back into it. */
+        cc__prof_put_frame(out, maps, i == 0 ? s->pc[i] : s->pc[i] - 1);
+    }
+    fprintf(out, " %zu\n", count);
+}
+
+int cc_prof_dump(const char* path) {
+    if (!path || !*path) return EINVAL;
+    pthread_mutex_lock(&g_cc_prof_mu);
+    size_t cap = g_cc_prof_cap;
+    uint64_t next = atomic_load_explicit(&g_cc_prof_next, memory_order_acquire);
+    size_t avail = next < cap ? (size_t)next : cap;
+    cc_prof_sample* copy = (cc_prof_sample*)malloc((avail ? avail : 1) * sizeof(cc_prof_sample));
+    if (!copy) {
+        pthread_mutex_unlock(&g_cc_prof_mu);
+        return ENOMEM;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < avail; i++) {
+        cc_prof_sample* s = &g_cc_prof_buf[i];
+        uint64_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        if (seq == 0) continue;
+        memcpy(&copy[n], s, sizeof(*s));
+        if (atomic_load_explicit(&s->seq, memory_order_acquire) != seq) continue;
+        if (copy[n].depth > CC_PROF_MAX_DEPTH) continue;
+        n++;
+    }
+    pthread_mutex_unlock(&g_cc_prof_mu);
+
+    qsort(copy, n, sizeof(*copy), cc__prof_sample_cmp);
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        int rc = errno;
+        free(copy);
+        return rc;
+    }
+    cc_prof_maps maps;
+    cc__prof_load_maps(&maps);
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && cc__prof_sample_cmp(&copy[i], &copy[j]) == 0) j++;
+        cc__prof_put_line(out, &maps, &copy[i], j - i);
+        i = j;
+    }
+    cc__prof_free_maps(&maps);
+    free(copy);
+    int rc = ferror(out) ? EIO : 0;
+    if (fclose(out) != 0 && rc == 0) rc = errno;
+    return rc;
+}
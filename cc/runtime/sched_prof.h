@@ -0,0 +1,39 @@
+/*
+ * Fiber-aware sampling CPU profiler
+ *
+ * SIGPROF (setitimer ITIMER_PROF, CC_PROF_HZ per second of process CPU)
+ * interrupts whichever thread is burning CPU. The handler walks frame
+ * pointers from the interrupted context. On a fiber it walks the fiber's
+ * own stack, then continues from the worker context minicoro saved in
+ * mco_resume, so one sample holds both the fiber's frames and the
+ * scheduler frames under it. Each sample is tagged with the fiber's id
+ * (the same id the tracer uses), its spawn site (entry function, or the
+ * closure body for closure spawns) and its nursery.
+ *
+ * Frames are only dereferenced inside a known stack: the fiber's minicoro
+ * stack or a worker's own stack up to thread_v2_main. Plain threads
+ * contribute their leaf PC only. Code built without frame pointers
+ * truncates the walk instead of crashing it; build with
+ * -fno-omit-frame-pointer for full stacks.
+ *
+ * cc_prof_dump writes folded stacks ("root;...;leaf count"), one line per
+ * distinct stack, rooted at "spawn:<site>". Frames are written unsymbolized
+ * as "<module>+0x<vaddr>" so nothing async-signal-unsafe or libdl-shaped
+ * runs in the process; `ccc prof FILE` resolves them with addr2line into
+ * input for flamegraph.pl or speedscope.
+ *
+ * Linux x86-64/arm64 and macOS x86-64/arm64. Elsewhere cc_prof_start
+ * returns ENOTSUP.
+ */
+
+#ifndef CC_SCHED_PROF_H
+#define CC_SCHED_PROF_H
+
+int cc_prof_start(int hz);
+void cc_prof_stop(void);
+int cc_prof_dump(const char* path);
+
+/* CC_PROF=path: start now, write `path` at exit. Called from scheduler init. */
+void cc__prof_init_from_env(void);
+
+#endif /* CC_SCHED_PROF_H */
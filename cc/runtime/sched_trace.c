@@ -0,0 +1,899 @@
+/*
+ * Scheduler event tracer: per-thread rings, trace writers and the
+ * `ccc trace` report. See sched_trace.h for the event model.
+ */
+
+#include "sched_trace.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+_Atomic int cc__trace_on = 0;
+
+#define CC_TRACE_DEFAULT_EVENTS 32768
+#define CC_TRACE_MIN_EVENTS 1024
+#define CC_TRACE_MAX_EVENTS (1u << 24)
+#define CC_TRACE_NO_STRING 0xffffffffu
+
+/* Ring slot: one event, or a whole context switch. An end slot (PARK,
+ * YIELD, DONE) may carry the worker's next dispatch (`run_fiber` != 0),
+ * and any RUN may carry the fiber that unparked it (`waker`);
+ * cc__trace_collect expands them, at the slot's stamp and in that order.
+ * Kept to one cache line. */
+typedef struct {
+    uint64_t ts;
+    uint64_t fiber;
+    uint64_t arg;
+    const char* reason;
+    uint64_t run_fiber;
+    const char* run_reason;
+    uint64_t waker;          /* of the slot's RUN, or of its folded RUN */
+    uint8_t kind;
+    uint8_t run_prio;
+    int16_t worker;
+    uint32_t track;
+} cc_trace_slot;
+
+/* Single producer (the owning thread); readers only snapshot it. Rings are
+ * never unlinked: a thread that exits clears `owned` and the next thread
+ * that starts recording takes the ring over, so the list is bounded by the
+ * peak number of recording threads, not by how many ever existed. */
+typedef struct cc_trace_ring {
+    struct cc_trace_ring* next;
+    _Atomic int owned;
+    uint32_t track;
+    _Atomic uint64_t head;          /* slots ever written; slot = head & mask */
+    cc_trace_slot ev[];
+} cc_trace_ring;
+
+static cc_trace_ring* _Atomic g_cc_trace_rings = NULL;
+static size_t g_cc_trace_cap = 0;   /* power of two, fixed by the first start */
+static pthread_once_t g_cc_trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_cc_trace_key;
+
+/* Guards start, track naming and collection. */
+static pthread_mutex_t g_cc_trace_mu = PTHREAD_MUTEX_INITIALIZER;
+static char** g_cc_trace_track_names = NULL;
+static uint32_t g_cc_trace_ntracks = 0;
+static uint32_t g_cc_trace_tracks_cap = 0;
+static uint64_t g_cc_trace_t0_tick = 0;
+static uint64_t g_cc_trace_t0_ns = 0;
+static char* g_cc_trace_exit_path = NULL;
+
+static __thread cc_trace_ring* tls_cc_trace_ring = NULL;
+static __thread const char* tls_cc_trace_name = NULL;
+
+/* Tick of this thread's last event, valid while tls_cc_trace_last_session
+ * matches g_cc_trace_session (bumped by every cc_trace_start), so a chained
+ * RUN never borrows a stamp, or folds into a slot, from before a
+ * stop/start. */
+static _Atomic uint32_t g_cc_trace_session = 0;
+static __thread uint64_t tls_cc_trace_last_tick = 0;
+static __thread uint32_t tls_cc_trace_last_session = 0;
+
+static uint64_t cc__trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Invariant TSC on x86-64 and the generic timer on arm64 are synchronized
+ * across cores, so per-thread ticks merge into one timeline. */
+static inline uint64_t cc__trace_ticks(void) {
+#if defined(__x86_64__)
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__) && !defined(__TINYC__)
+    uint64_t v;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return cc__trace_now_ns();
+#endif
+}
+
+/* ============================================================================
+ * Recording
+ * ============================================================================ */
+
+static void cc__trace_release_ring(void* p) {
+    cc_trace_ring* r = (cc_trace_ring*)p;
+    atomic_store_explicit(&r->owned, 0, memory_order_release);
+}
+
+static void cc__trace_key_init(void) {
+    (void)pthread_key_create(&g_cc_trace_key, cc__trace_release_ring);
+}
+
+void cc__trace_set_thread_name(const char* name) {
+    tls_cc_trace_name = name;
+}
+
+/* Track for a newly claimed ring. A reused ring (`reuse`) keeps its track,
+ * renamed if the new owner's name differs, so tracks stay bounded by rings
+ * like everything else here. */
+static uint32_t cc__trace_track(const cc_trace_ring* reuse, int worker) {
+    char buf[48];
+    if (tls_cc_trace_name) snprintf(buf, sizeof(buf), "%s", tls_cc_trace_name);
+    else if (worker >= 0) snprintf(buf, sizeof(buf), "worker %d", worker);
+    else snprintf(buf, sizeof(buf), "thread");
+    pthread_mutex_lock(&g_cc_trace_mu);
+    if (reuse && reuse->track < g_cc_trace_ntracks) {
+        uint32_t id = reuse->track;
+        char* old = g_cc_trace_track_names[id];
+        if (!old || strcmp(old, buf) != 0) {
+            char* name = strdup(buf);
+            if (name) {
+                free(old);
+                g_cc_trace_track_names[id] = name;
+            }
+        }
+        pthread_mutex_unlock(&g_cc_trace_mu);
+        return id;
+    }
+    if (g_cc_trace_ntracks == g_cc_trace_tracks_cap) {
+        uint32_t nc = g_cc_trace_tracks_cap ? g_cc_trace_tracks_cap * 2 : 32;
+        char** nn = (char**)realloc(g_cc_trace_track_names, nc * sizeof(*nn));
+        if (nn) {
+            g_cc_trace_track_names = nn;
+            g_cc_trace_tracks_cap = nc;
+        }
+    }
+    uint32_t id = g_cc_trace_ntracks;
+    if (id < g_cc_trace_tracks_cap) {
+        g_cc_trace_track_names[id] = strdup(buf);
+        g_cc_trace_ntracks++;
+    }
+    pthread_mutex_unlock(&g_cc_trace_mu);
+    return id;
+}
+
+static cc_trace_ring* cc__trace_claim(int worker) {
+    if (!atomic_load_explicit(&cc__trace_on, memory_order_acquire)) return NULL;
+    pthread_once(&g_cc_trace_once, cc__trace_key_init);
+    cc_trace_ring* r = atomic_load_explicit(&g_cc_trace_rings, memory_order_acquire);
+    cc_trace_ring* reuse = NULL;
+    for (; r; r = r->next) {
+        int expected = 0;
+        if (!atomic_load_explicit(&r->owned, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&r->owned, &expected, 1,
+                    memory_order_acquire, memory_order_relaxed)) {
+            reuse = r;
+            break;
+        }
+    }
+    if (!r) {
+        r = (cc_trace_ring*)calloc(1, sizeof(*r) + g_cc_trace_cap * sizeof(cc_trace_slot));
+        if (!r) return NULL;
+        atomic_store_explicit(&r->owned, 1, memory_order_relaxed);
+        cc_trace_ring* head = atomic_load_explicit(&g_cc_trace_rings, memory_order_relaxed);
+        do {
+            r->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&g_cc_trace_rings, &head, r,
+                memory_order_release, memory_order_relaxed));
+    }
+    /* A reused ring keeps its old events and its track. */
+    r->track = cc__trace_track(reuse, worker);
+    (void)pthread_setspecific(g_cc_trace_key, r);
+    return r;
+}
+
+static inline cc_trace_ring* cc__trace_ring(int worker) {
+    cc_trace_ring* r = tls_cc_trace_ring;
+    if (!r) {
+        r = cc__trace_claim(worker);
+        if (r) tls_cc_trace_ring = r;
+    }
+    return r;
+}
+
+/* Stamp for a new slot: a fresh clock read, or with `chained` this thread's
+ * last stamp from the current session. */
+static inline uint64_t cc__trace_stamp(int chained) {
+    uint32_t session = atomic_load_explicit(&g_cc_trace_session, memory_order_relaxed);
+    if (chained && tls_cc_trace_last_session == session && tls_cc_trace_last_tick != 0) {
+        return tls_cc_trace_last_tick;
+    }
+    uint64_t ts = cc__trace_ticks();
+    tls_cc_trace_last_tick = ts;
+    tls_cc_trace_last_session = session;
+    return ts;
+}
+
+void cc__trace_emit(int kind, int worker, uint64_t fiber, uint64_t arg, const char* reason) {
+    cc_trace_ring* r = cc__trace_ring(worker);
+    if (!r) return;
+    uint64_t ts = cc__trace_stamp(0);
+    uint64_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    cc_trace_slot* e = &r->ev[h & (g_cc_trace_cap - 1)];
+    e->ts = ts;
+    e->fiber = fiber;
+    e->arg = arg;
+    e->reason = reason;
+    e->run_fiber = 0;
+    e->waker = 0;
+    e->kind = (uint8_t)kind;
+    e->worker = (int16_t)worker;
+    e->track = r->track;
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+}
+
+void cc__trace_run(int worker, uint64_t fiber, uint64_t prio, const char* from,
+                   uint64_t waker, int back_to_back) {
+    cc_trace_ring* r = cc__trace_ring(worker);
+    if (!r) return;
+    uint64_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t session = atomic_load_explicit(&g_cc_trace_session, memory_order_relaxed);
+    if (back_to_back && h != 0 && tls_cc_trace_last_session == session) {
+        /* Fold into the previous slot if it is this session's end of the
+         * dispatch we follow and holds no RUN yet. Already published, so a
+         * collector running now may see it half written (see collect). */
+        cc_trace_slot* prev = &r->ev[(h - 1) & (g_cc_trace_cap - 1)];
+        if ((prev->kind == CC_TRACE_PARK || prev->kind == CC_TRACE_YIELD ||
+             prev->kind == CC_TRACE_DONE) && prev->run_fiber == 0) {
+            prev->run_reason = from;
+            prev->run_prio = (uint8_t)prio;
+            prev->waker = waker;
+            prev->run_fiber = fiber;
+            return;
+        }
+    }
+    uint64_t ts = cc__trace_stamp(back_to_back);
+    cc_trace_slot* e = &r->ev[h & (g_cc_trace_cap - 1)];
+    e->ts = ts;
+    e->fiber = fiber;
+    e->arg = prio;
+    e->reason = from;
+    e->run_fiber = 0;
+    e->waker = waker;
+    e->kind = CC_TRACE_RUN;
+    e->worker = (int16_t)worker;
+    e->track = r->track;
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+}
+
+/* ============================================================================
+ * Control
+ * ============================================================================ */
+
+int cc_trace_start(void) {
+    pthread_mutex_lock(&g_cc_trace_mu);
+    if (g_cc_trace_cap == 0) {
+        size_t want = CC_TRACE_DEFAULT_EVENTS;
+        const char* s = getenv("CC_TRACE_EVENTS");
+        if (s && *s) {
+            long v = strtol(s, NULL, 10);
+            if (v > 0) want = (size_t)v;
+        }
+        if (want < CC_TRACE_MIN_EVENTS) want = CC_TRACE_MIN_EVENTS;
+        if (want > CC_TRACE_MAX_EVENTS) want = CC_TRACE_MAX_EVENTS;
+        size_t cap = CC_TRACE_MIN_EVENTS;
+        while (cap < want) cap <<= 1;
+        g_cc_trace_cap = cap;
+        g_cc_trace_t0_ns = cc__trace_now_ns();
+        g_cc_trace_t0_tick = cc__trace_ticks();
+    }
+    atomic_fetch_add_explicit(&g_cc_trace_session, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&g_cc_trace_mu);
+    atomic_store_explicit(&cc__trace_on, 1, memory_order_release);
+    return 0;
+}
+
+void cc_trace_stop(void) {
+    atomic_store_explicit(&cc__trace_on, 0, memory_order_release);
+}
+
+static void cc__trace_atexit(void) {
+    cc_trace_stop();
+    int rc = cc_trace_dump(g_cc_trace_exit_path);
+    if (rc != 0) {
+        fprintf(stderr, "[cc trace] could not write %s: %s\n", g_cc_trace_exit_path, strerror(rc));
+    }
+}
+
+void cc__trace_init_from_env(void) {
+    const char* path = getenv("CC_TRACE");
+    if (!path || !*path || g_cc_trace_exit_path) return;
+    g_cc_trace_exit_path = strdup(path);
+    if (!g_cc_trace_exit_path) return;
+    cc_trace_start();
+    atexit(cc__trace_atexit);
+}
+
+/* ============================================================================
+ * Collection
+ * ============================================================================ */
+
+static int cc__trace_event_before(const cc_trace_event* x, const cc_trace_event* y) {
+    if (x->ts != y->ts) return x->ts < y->ts;
+    return x->track < y->track;
+}
+
+/* Stable merge sort on (ts, track). Chained events share their stamp with
+ * the event before them on the same track, so ties must keep ring order. */
+static int cc__trace_sort(cc_trace_event* ev, size_t n) {
+    if (n < 2) return 0;
+    cc_trace_event* tmp = (cc_trace_event*)malloc(n * sizeof(cc_trace_event));
+    if (!tmp) return ENOMEM;
+    cc_trace_event* src = ev;
+    cc_trace_event* dst = tmp;
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = lo + width < n ? lo + width : n;
+            size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) dst[k++] = cc__trace_event_before(&src[j], &src[i]) ? src[j++] : src[i++];
+            while (i < mid) dst[k++] = src[i++];
+            while (j < hi) dst[k++] = src[j++];
+        }
+        cc_trace_event* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != ev) memcpy(ev, src, n * sizeof(cc_trace_event));
+    free(tmp);
+    return 0;
+}
+
+static void cc__trace_set_free(cc_trace_set* s) {
+    free(s->ev);
+    free(s->track_names);
+    free(s->strings);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Snapshot every ring into `s`, oldest first, timestamps in ns. Events a
+ * thread is writing while we copy may come out torn; stop first for an
+ * exact snapshot. */
+static int cc__trace_collect(cc_trace_set* s) {
+    memset(s, 0, sizeof(*s));
+    pthread_mutex_lock(&g_cc_trace_mu);
+    size_t cap = g_cc_trace_cap;
+    uint64_t t1_ns = cc__trace_now_ns();
+    uint64_t t1_tick = cc__trace_ticks();
+    double ns_per_tick = 1.0;
+    if (t1_tick > g_cc_trace_t0_tick && t1_ns > g_cc_trace_t0_ns) {
+        ns_per_tick = (double)(t1_ns - g_cc_trace_t0_ns) / (double)(t1_tick - g_cc_trace_t0_tick);
+    }
+    /* A slot expands to at most three events: end, UNPARK, RUN. */
+    size_t total = 0;
+    cc_trace_ring* head = atomic_load_explicit(&g_cc_trace_rings, memory_order_acquire);
+    for (cc_trace_ring* r = head; r; r = r->next) {
+        uint64_t h = atomic_load_explicit(&r->head, memory_order_acquire);
+        total += 3 * (h < cap ? (size_t)h : cap);
+    }
+    s->ntracks = g_cc_trace_ntracks;
+    /* Copy the names: a ring taken over later renames its track. */
+    size_t name_bytes = 0;
+    for (uint32_t i = 0; i < s->ntracks; i++) {
+        if (g_cc_trace_track_names[i]) name_bytes += strlen(g_cc_trace_track_names[i]) + 1;
+    }
+    s->track_names = (const char**)calloc(s->ntracks ? s->ntracks : 1, sizeof(char*));
+    s->strings = (char*)malloc(name_bytes ? name_bytes : 1);
+    s->ev = (cc_trace_event*)malloc((total ? total : 1) * sizeof(cc_trace_event));
+    if (!s->track_names || !s->strings || !s->ev) {
+        pthread_mutex_unlock(&g_cc_trace_mu);
+        cc__trace_set_free(s);
+        return ENOMEM;
+    }
+    size_t w = 0;
+    for (uint32_t i = 0; i < s->ntracks; i++) {
+        if (!g_cc_trace_track_names[i]) continue;
+        size_t len = strlen(g_cc_trace_track_names[i]) + 1;
+        memcpy(s->strings + w, g_cc_trace_track_names[i], len);
+        s->track_names[i] = s->strings + w;
+        w += len;
+    }
+    for (cc_trace_ring* r = head; r && s->n < total; r = r->next) {
+        uint64_t h = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint64_t first = h > cap ? h - cap : 0;
+        for (uint64_t i = first; i < h && s->n + 3 <= total; i++) {
+            cc_trace_slot sl = r->ev[i & (cap - 1)];
+            if (sl.kind == 0 || sl.kind >= CC_TRACE_KIND_COUNT || sl.track >= s->ntracks) continue;
+            cc_trace_event e;
+            e.ts = g_cc_trace_t0_ns +
+                   (uint64_t)((double)(int64_t)(sl.ts - g_cc_trace_t0_tick) * ns_per_tick);
+            e.worker = sl.worker;
+            e.track = sl.track;
+            uint64_t run_fiber = sl.kind == CC_TRACE_RUN ? sl.fiber : sl.run_fiber;
+            if (sl.kind != CC_TRACE_RUN) {
+                e.kind = sl.kind;
+                e.fiber = sl.fiber;
+                e.arg = sl.arg;
+                e.reason = sl.reason;
+                s->ev[s->n++] = e;
+            }
+            if (run_fiber == 0) continue;
+            if (sl.waker) {
+                e.kind = CC_TRACE_UNPARK;
+                e.fiber = run_fiber;
+                e.arg = sl.waker;
+                e.reason = NULL;
+                s->ev[s->n++] = e;
+            }
+            e.kind = CC_TRACE_RUN;
+            e.fiber = run_fiber;
+            e.arg = sl.kind == CC_TRACE_RUN ? sl.arg : sl.run_prio;
+            e.reason = sl.kind == CC_TRACE_RUN ? sl.reason : sl.run_reason;
+            s->ev[s->n++] = e;
+        }
+    }
+    pthread_mutex_unlock(&g_cc_trace_mu);
+    if (cc__trace_sort(s->ev, s->n) != 0) {
+        cc__trace_set_free(s);
+        return ENOMEM;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Writers
+ * ============================================================================ */
+
+static const char* const k_cc_trace_kind_names[CC_TRACE_KIND_COUNT] = {
+    "?", "spawn", "run", "park", "yield", "done", "unpark", "preempt", "evict", "handoff", "rescue",
+};
+
+static void cc__trace_json_str(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(f, "\\%c", c);
+        else if (c < 0x20) fprintf(f, "\\u%04x", c);
+        else fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+/* Chrome trace-event JSON. A RUN opens a slice on its thread's track; the
+ * same fiber's next PARK/YIELD/DONE on that track closes it. Ends whose RUN
+ * was overwritten come out as instant events instead. */
+static int cc__trace_write_json(const cc_trace_set* s, FILE* f) {
+    size_t* open = (size_t*)malloc((s->ntracks ? s->ntracks : 1) * sizeof(size_t));
+    if (!open) return ENOMEM;
+    for (uint32_t i = 0; i < s->ntracks; i++) open[i] = (size_t)-1;
+    uint64_t base = s->n ? s->ev[0].ts : 0;
+
+    fprintf(f, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"concurrent-c\"}}");
+    for (uint32_t i = 0; i < s->ntracks; i++) {
+        fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i + 1);
+        cc__trace_json_str(f, s->track_names[i] ? s->track_names[i] : "thread");
+        fprintf(f, "}}");
+    }
+    for (size_t i = 0; i < s->n; i++) {
+        const cc_trace_event* e = &s->ev[i];
+        double ts = (double)(e->ts - base) / 1000.0;
+        if (e->kind == CC_TRACE_RUN) {
+            open[e->track] = i;
+            continue;
+        }
+        if (e->kind == CC_TRACE_PARK || e->kind == CC_TRACE_YIELD || e->kind == CC_TRACE_DONE) {
+            size_t o = open[e->track];
+            if (o != (size_t)-1 && s->ev[o].fiber == e->fiber) {
+                const cc_trace_event* run = &s->ev[o];
+                open[e->track] = (size_t)-1;
+                fprintf(f, ",\n{\"name\":\"fiber %llu\",\"cat\":\"fiber\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                           "\"pid\":1,\"tid\":%u,\"args\":{\"fiber\":%llu,\"worker\":%d,\"prio\":%llu,\"from\":",
+                        (unsigned long long)e->fiber, (double)(run->ts - base) / 1000.0,
+                        (double)(e->ts - run->ts) / 1000.0, e->track + 1,
+                        (unsigned long long)e->fiber, run->worker, (unsigned long long)run->arg);
+                cc__trace_json_str(f, run->reason ? run->reason : "queue");
+                fprintf(f, ",\"end\":\"%s\"", k_cc_trace_kind_names[e->kind]);
+                if (e->kind == CC_TRACE_PARK) {
+                    fprintf(f, ",\"reason\":");
+                    cc__trace_json_str(f, e->reason ? e->reason : "-");
+                    fprintf(f, ",\"obj\":\"0x%llx\"", (unsigned long long)e->arg);
+                }
+                fprintf(f, "}}");
+                continue;
+            }
+        }
+        fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                   "\"pid\":1,\"tid\":%u,\"args\":{\"fiber\":%llu,\"worker\":%d",
+                k_cc_trace_kind_names[e->kind], ts, e->track + 1,
+                (unsigned long long)e->fiber, e->worker);
+        if (e->kind == CC_TRACE_SPAWN) fprintf(f, ",\"parent\":%llu", (unsigned long long)e->arg);
+        if (e->kind == CC_TRACE_UNPARK) fprintf(f, ",\"by\":%llu", (unsigned long long)e->arg);
+        if (e->kind == CC_TRACE_PARK) fprintf(f, ",\"obj\":\"0x%llx\"", (unsigned long long)e->arg);
+        if (e->reason) {
+            fprintf(f, ",\"reason\":");
+            cc__trace_json_str(f, e->reason);
+        }
+        fprintf(f, "}}");
+    }
+    fprintf(f, "\n]\n");
+    free(open);
+    return ferror(f) ? EIO : 0;
+}
+
+static int cc__trace_ptr_cmp(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t)*(const char* const*)a;
+    uintptr_t y = (uintptr_t)*(const char* const*)b;
+    return x < y ? -1 : (x > y);
+}
+
+static void cc__trace_put32(FILE* f, uint32_t v) { fwrite(&v, sizeof(v), 1, f); }
+static void cc__trace_put64(FILE* f, uint64_t v) { fwrite(&v, sizeof(v), 1, f); }
+
+/* Binary layout (native endian):
+ *   magic[8] u32 version u32 nstrings u32 ntracks u32 0 u64 nevents
+ *   nstrings x { u32 len, bytes }
+ *   ntracks  x { u32 name string }
+ *   nevents  x { u64 ts_ns, u64 fiber, u64 arg, u32 reason string (~0 none),
+ *                u16 kind, i16 worker, u32 track, u32 0 }
+ * Reason strings are deduplicated by address (they are literals). */
+static int cc__trace_write_binary(const cc_trace_set* s, FILE* f) {
+    size_t nptr = 0;
+    const char** strs = (const char**)malloc((s->n + s->ntracks + 1) * sizeof(char*));
+    if (!strs) return ENOMEM;
+    for (size_t i = 0; i < s->n; i++) {
+        if (s->ev[i].reason) strs[nptr++] = s->ev[i].reason;
+    }
+    for (uint32_t i = 0; i < s->ntracks; i++) {
+        if (s->track_names[i]) strs[nptr++] = s->track_names[i];
+    }
+    qsort(strs, nptr, sizeof(char*), cc__trace_ptr_cmp);
+    size_t nstr = 0;
+    for (size_t i = 0; i < nptr; i++) {
+        if (nstr == 0 || strs[nstr - 1] != strs[i]) strs[nstr++] = strs[i];
+    }
+    fwrite(CC_TRACE_FILE_MAGIC, 1, 8, f);
+    cc__trace_put32(f, 1);
+    cc__trace_put32(f, (uint32_t)nstr);
+    cc__trace_put32(f, s->ntracks);
+    cc__trace_put32(f, 0);
+    cc__trace_put64(f, (uint64_t)s->n);
+    for (size_t i = 0; i < nstr; i++) {
+        uint32_t len = (uint32_t)strlen(strs[i]);
+        cc__trace_put32(f, len);
+        fwrite(strs[i], 1, len, f);
+    }
+    for (uint32_t i = 0; i < s->ntracks; i++) {
+        const char* key = s->track_names[i];
+        const char** hit = key ? (const char**)bsearch(&key, strs, nstr, sizeof(char*), cc__trace_ptr_cmp) : NULL;
+        cc__trace_put32(f, hit ? (uint32_t)(hit - strs) : CC_TRACE_NO_STRING);
+    }
+    for (size_t i = 0; i < s->n; i++) {
+        const cc_trace_event* e = &s->ev[i];
+        const char** hit = e->reason
+            ? (const char**)bsearch(&e->reason, strs, nstr, sizeof(char*), cc__trace_ptr_cmp)
+            : NULL;
+        uint16_t kind = e->kind;
+        int16_t worker = e->worker;
+        cc__trace_put64(f, e->ts);
+        cc__trace_put64(f, e->fiber);
+        cc__trace_put64(f, e->arg);
+        cc__trace_put32(f, hit ? (uint32_t)(hit - strs) : CC_TRACE_NO_STRING);
+        fwrite(&kind, sizeof(kind), 1, f);
+        fwrite(&worker, sizeof(worker), 1, f);
+        cc__trace_put32(f, e->track);
+        cc__trace_put32(f, 0);
+    }
+    free(strs);
+    return ferror(f) ? EIO : 0;
+}
+
+static int cc__trace_has_suffix(const char* s, const char* suf) {
+    size_t n = strlen(s), m = strlen(suf);
+    return n >= m && strcmp(s + n - m, suf) == 0;
+}
+
+int cc_trace_dump(const char* path) {
+    if (!path || !*path) return EINVAL;
+    cc_trace_set s;
+    int rc = cc__trace_collect(&s);
+    if (rc != 0) return rc;
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        rc = errno;
+        cc__trace_set_free(&s);
+        return rc;
+    }
+    rc = cc__trace_has_suffix(path, ".json") ? cc__trace_write_json(&s, f)
+                                             : cc__trace_write_binary(&s, f);
+    if (fclose(f) != 0 && rc == 0) rc = errno;
+    cc__trace_set_free(&s);
+    return rc;
+}
+
+/* ============================================================================
+ * Reader and `ccc trace` report
+ * ============================================================================ */
+
+typedef struct {
+    const unsigned char* p;
+    size_t left;
+} cc_trace_cursor;
+
+static int cc__trace_take(cc_trace_cursor* c, void* out, size_t n) {
+    if (c->left < n) return 0;
+    memcpy(out, c->p, n);
+    c->p += n;
+    c->left -= n;
+    return 1;
+}
+
+static int cc__trace_load(const char* path, cc_trace_set* s) {
+    memset(s, 0, sizeof(*s));
+    FILE* f = fopen(path, "rb");
+    if (!f) return errno;
+    unsigned char* buf = NULL;
+    size_t len = 0, cap = 0;
+    for (;;) {
+        if (len == cap) {
+            size_t nc = cap ? cap * 2 : 1 << 20;
+            unsigned char* nb = (unsigned char*)realloc(buf, nc);
+            if (!nb) { free(buf); fclose(f); return ENOMEM; }
+            buf = nb;
+            cap = nc;
+        }
+        size_t got = fread(buf + len, 1, cap - len, f);
+        len += got;
+        if (got == 0) break;
+    }
+    fclose(f);
+
+    int rc = EINVAL;
+    cc_trace_cursor c = { buf, len };
+    char magic[8];
+    uint32_t version, nstr, ntracks, reserved;
+    uint64_t nev;
+    const char** strs = NULL;
+    if (!cc__trace_take(&c, magic, 8) || memcmp(magic, CC_TRACE_FILE_MAGIC, 8) != 0 ||
+        !cc__trace_take(&c, &version, 4) || version != 1 ||
+        !cc__trace_take(&c, &nstr, 4) || !cc__trace_take(&c, &ntracks, 4) ||
+        !cc__trace_take(&c, &reserved, 4) || !cc__trace_take(&c, &nev, 8) ||
+        nev > c.left / 40) {
+        goto out;
+    }
+    /* Strings land NUL-terminated in one block; each needs <= len+1 bytes
+     * and the file spent len+4 on it, so the file size bounds the block. */
+    s->strings = (char*)malloc(c.left + 1);
+    strs = (const char**)calloc(nstr ? nstr : 1, sizeof(char*));
+    s->track_names = (const char**)calloc(ntracks ? ntracks : 1, sizeof(char*));
+    s->ev = (cc_trace_event*)malloc((nev ? nev : 1) * sizeof(cc_trace_event));
+    if (!s->strings || !strs || !s->track_names || !s->ev) { rc = ENOMEM; goto out; }
+    size_t w = 0;
+    for (uint32_t i = 0; i < nstr; i++) {
+        uint32_t n;
+        if (!cc__trace_take(&c, &n, 4) || n > c.left) goto out;
+        strs[i] = s->strings + w;
+        cc__trace_take(&c, s->strings + w, n);
+        w += n;
+        s->strings[w++] = '\0';
+    }
+    s->ntracks = ntracks;
+    for (uint32_t i = 0; i < ntracks; i++) {
+        uint32_t idx;
+        if (!cc__trace_take(&c, &idx, 4)) goto out;
+        s->track_names[i] = idx < nstr ? strs[idx] : NULL;
+    }
+    for (uint64_t i = 0; i < nev; i++) {
+        cc_trace_event* e = &s->ev[i];
+        uint32_t idx, pad;
+        if (!cc__trace_take(&c, &e->ts, 8) || !cc__trace_take(&c, &e->fiber, 8) ||
+            !cc__trace_take(&c, &e->arg, 8) || !cc__trace_take(&c, &idx, 4) ||
+            !cc__trace_take(&c, &e->kind, 2) || !cc__trace_take(&c, &e->worker, 2) ||
+            !cc__trace_take(&c, &e->track, 4) || !cc__trace_take(&c, &pad, 4)) {
+            goto out;
+        }
+        if (e->kind == 0 || e->kind >= CC_TRACE_KIND_COUNT || e->track >= ntracks) goto out;
+        e->reason = idx < nstr ? strs[idx] : NULL;
+    }
+    s->n = (size_t)nev;
+    rc = 0;
+out:
+    free(strs);
+    free(buf);
+    if (rc != 0) cc__trace_set_free(s);
+    return rc;
+}
+
+typedef struct {
+    uint64_t start, end;
+    uint64_t fiber, obj, waker;
+    const char* reason;
+    int worker;
+    int woken;           /* closed by an UNPARK (waker known) vs the next RUN */
+} cc_trace_park;
+
+static int cc__trace_park_by_dur(const void* a, const void* b) {
+    const cc_trace_park* x = (const cc_trace_park*)a;
+    const cc_trace_park* y = (const cc_trace_park*)b;
+    uint64_t dx = x->end - x->start, dy = y->end - y->start;
+    return dx == dy ? 0 : (dx > dy ? -1 : 1);
+}
+
+static int cc__trace_park_by_site(const void* a, const void* b) {
+    const cc_trace_park* x = (const cc_trace_park*)a;
+    const cc_trace_park* y = (const cc_trace_park*)b;
+    int c = strcmp(x->reason ? x->reason : "-", y->reason ? y->reason : "-");
+    if (c != 0) return c;
+    return x->obj == y->obj ? 0 : (x->obj < y->obj ? -1 : 1);
+}
+
+typedef struct {
+    uint64_t total;
+    size_t count;
+    const cc_trace_park* first;
+} cc_trace_site;
+
+static int cc__trace_site_by_total(const void* a, const void* b) {
+    const cc_trace_site* x = (const cc_trace_site*)a;
+    const cc_trace_site* y = (const cc_trace_site*)b;
+    return x->total == y->total ? 0 : (x->total > y->total ? -1 : 1);
+}
+
+/* fiber id -> index of its open PARK in `ev`, or SIZE_MAX. Only PARK
+ * inserts (so at most one key per park); keys are never removed, closing a
+ * park just resets the value. */
+typedef struct {
+    uint64_t* key;
+    size_t* val;
+    size_t mask;
+} cc_trace_open_map;
+
+static size_t* cc__trace_open_slot(cc_trace_open_map* m, uint64_t fiber, int insert) {
+    size_t i = (size_t)(fiber * 0x9E3779B97F4A7C15ull) & m->mask;
+    while (m->key[i] != 0 && m->key[i] != fiber) i = (i + 1) & m->mask;
+    if (m->key[i] == 0) {
+        if (!insert) return NULL;
+        m->key[i] = fiber;
+        m->val[i] = (size_t)-1;
+    }
+    return &m->val[i];
+}
+
+static void cc__trace_ms_line(FILE* out, uint64_t ns) {
+    fprintf(out, "  %12.1f us", (double)ns / 1e3);
+}
+
+int cc__trace_report(const char* path, const char* json_out, int top, FILE* out) {
+    cc_trace_set s;
+    int rc = cc__trace_load(path, &s);
+    if (rc != 0) return rc;
+    if (top <= 0) top = 10;
+    if (json_out) {
+        FILE* jf = fopen(json_out, "w");
+        if (!jf) {
+            rc = errno;
+            cc__trace_set_free(&s);
+            return rc;
+        }
+        rc = cc__trace_write_json(&s, jf);
+        if (fclose(jf) != 0 && rc == 0) rc = errno;
+        if (rc != 0) {
+            cc__trace_set_free(&s);
+            return rc;
+        }
+    }
+
+    uint64_t span = s.n ? s.ev[s.n - 1].ts - s.ev[0].ts : 0;
+    fprintf(out, "%s: %zu events, %u threads, %.3f ms\n", path, s.n, s.ntracks, (double)span / 1e6);
+    size_t counts[CC_TRACE_KIND_COUNT] = {0};
+    size_t nparks = 0;
+    for (size_t i = 0; i < s.n; i++) {
+        counts[s.ev[i].kind]++;
+        if (s.ev[i].kind == CC_TRACE_PARK) nparks++;
+    }
+    fprintf(out, " ");
+    for (int k = 1; k < CC_TRACE_KIND_COUNT; k++) {
+        if (counts[k]) fprintf(out, " %s=%zu", k_cc_trace_kind_names[k], counts[k]);
+    }
+    fprintf(out, "\n");
+
+    /* Pair each PARK with the fiber's next RUN. An UNPARK only names the
+     * waker: it borrows its stamp from the waker's dispatch, so it may sort
+     * before the PARK it answers, and is remembered until that RUN. */
+    cc_trace_open_map m = {0}, wake = {0};
+    size_t mcap = 16, wcap = 16;
+    while (mcap < nparks * 2) mcap <<= 1;
+    while (wcap < counts[CC_TRACE_UNPARK] * 2) wcap <<= 1;
+    m.key = (uint64_t*)calloc(mcap, sizeof(uint64_t));
+    m.val = (size_t*)malloc(mcap * sizeof(size_t));
+    m.mask = mcap - 1;
+    wake.key = (uint64_t*)calloc(wcap, sizeof(uint64_t));
+    wake.val = (size_t*)malloc(wcap * sizeof(size_t));
+    wake.mask = wcap - 1;
+    cc_trace_park* parks = (cc_trace_park*)malloc((nparks ? nparks : 1) * sizeof(cc_trace_park));
+    if (!m.key || !m.val || !wake.key || !wake.val || !parks) {
+        free(m.key);
+        free(m.val);
+        free(wake.key);
+        free(wake.val);
+        free(parks);
+        cc__trace_set_free(&s);
+        return ENOMEM;
+    }
+    size_t np = 0;
+    for (size_t i = 0; i < s.n; i++) {
+        const cc_trace_event* e = &s.ev[i];
+        if (e->fiber == 0) continue;
+        if (e->kind == CC_TRACE_PARK) {
+            *cc__trace_open_slot(&m, e->fiber, 1) = i;
+        } else if (e->kind == CC_TRACE_UNPARK) {
+            *cc__trace_open_slot(&wake, e->fiber, 1) = i;
+        } else if (e->kind == CC_TRACE_RUN) {
+            size_t* slot = cc__trace_open_slot(&m, e->fiber, 0);
+            if (!slot || *slot == (size_t)-1) continue;
+            size_t* w = cc__trace_open_slot(&wake, e->fiber, 0);
+            const cc_trace_event* p = &s.ev[*slot];
+            cc_trace_park* pk = &parks[np++];
+            pk->start = p->ts;
+            pk->end = e->ts;
+            pk->fiber = p->fiber;
+            pk->obj = p->arg;
+            pk->reason = p->reason;
+            pk->worker = p->worker;
+            pk->woken = w && *w != (size_t)-1;
+            pk->waker = pk->woken ? s.ev[*w].arg : 0;
+            *slot = (size_t)-1;
+            if (w) *w = (size_t)-1;
+        }
+    }
+    free(wake.key);
+    free(wake.val);
+
+    qsort(parks, np, sizeof(*parks), cc__trace_park_by_dur);
+    fprintf(out, "longest parks:\n");
+    for (size_t i = 0; i < np && i < (size_t)top; i++) {
+        const cc_trace_park* pk = &parks[i];
+        cc__trace_ms_line(out, pk->end - pk->start);
+        fprintf(out, "  fiber %llu on %s obj=0x%llx (worker %d)",
+                (unsigned long long)pk->fiber, pk->reason ? pk->reason : "-",
+                (unsigned long long)pk->obj, pk->worker);
+        if (!pk->woken) fprintf(out, ", unpark not recorded\n");
+        else if (pk->waker) fprintf(out, ", woken by fiber %llu\n", (unsigned long long)pk->waker);
+        else fprintf(out, ", woken by a thread\n");
+    }
+
+    qsort(parks, np, sizeof(*parks), cc__trace_park_by_site);
+    cc_trace_site* sites = (cc_trace_site*)malloc((np ? np : 1) * sizeof(cc_trace_site));
+    size_t nsites = 0;
+    for (size_t i = 0; sites && i < np; i++) {
+        if (nsites == 0 || cc__trace_park_by_site(sites[nsites - 1].first, &parks[i]) != 0) {
+            sites[nsites].total = 0;
+            sites[nsites].count = 0;
+            sites[nsites].first = &parks[i];
+            nsites++;
+        }
+        sites[nsites - 1].total += parks[i].end - parks[i].start;
+        sites[nsites - 1].count++;
+    }
+    if (sites) {
+        qsort(sites, nsites, sizeof(*sites), cc__trace_site_by_total);
+        fprintf(out, "blocked time by wait site:\n");
+        for (size_t i = 0; i < nsites && i < (size_t)top; i++) {
+            cc__trace_ms_line(out, sites[i].total);
+            fprintf(out, "  %zu parks on %s obj=0x%llx\n", sites[i].count,
+                    sites[i].first->reason ? sites[i].first->reason : "-",
+                    (unsigned long long)sites[i].first->obj);
+        }
+    }
+
+    /* Fibers whose last recorded event is a park: what a hang is waiting on. */
+    size_t still = 0;
+    uint64_t end = s.n ? s.ev[s.n - 1].ts : 0;
+    for (size_t i = 0; i <= m.mask; i++) {
+        if (m.key[i] == 0 || m.val[i] == (size_t)-1) continue;
+        const cc_trace_event* p = &s.ev[m.val[i]];
+        if (still++ == 0) fprintf(out, "parked at end of trace:\n");
+        if (still > (size_t)top) continue;
+        cc__trace_ms_line(out, end - p->ts);
+        fprintf(out, "  fiber %llu on %s obj=0x%llx (worker %d)\n",
+                (unsigned long long)p->fiber, p->reason ? p->reason : "-",
+                (unsigned long long)p->arg, p->worker);
+    }
+    if (still > (size_t)top) fprintf(out, "  ... %zu more\n", still - (size_t)top);
+
+    free(sites);
+    free(parks);
+    free(m.key);
+    free(m.val);
+    cc__trace_set_free(&s);
+    return 0;
+}
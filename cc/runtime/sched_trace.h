@@ -0,0 +1,105 @@
+/*
+ * Scheduler event tracer
+ *
+ * Always compiled in, off until CC_TRACE=path or cc_trace_start(). Each
+ * thread that records gets its own single-producer ring (CC_TRACE_EVENTS
+ * entries, flight-recorder overwrite), claimed lazily on its first event and
+ * handed back for reuse, track included, when the thread exits, so eviction
+ * and blocking handoff orphans do not grow memory without bound. Recording
+ * is a TLS load, a timestamp read and a few stores into one 64-byte slot;
+ * with tracing off every hook is one relaxed load of cc__trace_on.
+ *
+ * A context switch fills one slot and reads the clock once. A RUN that
+ * follows the worker's previous dispatch back to back is folded into that
+ * dispatch's end slot (cc__trace_run), and an unpark from inside a fiber
+ * is left on the wakee (sched_v2) and recorded with its RUN. Collection
+ * expands slots back into cc_trace_event records, so the file formats and
+ * the report see separate events. See "Tracing cost" in
+ * spec/concurrent-c-scheduler.md.
+ *
+ * Timestamps are raw TSC (x86-64) or CNTVCT (arm64) ticks, converted to
+ * nanoseconds against CLOCK_MONOTONIC when the trace is written. Elsewhere
+ * (and under TCC on arm64) the tick is the monotonic clock itself.
+ *
+ * Output (cc_trace_dump):
+ *   *.json  Chrome trace-event JSON for Perfetto / chrome://tracing: one
+ *           track per thread, a slice per fiber dispatch (ended by its park,
+ *           yield or exit; parks carry park_reason and park_obj), instant
+ *           events for spawn, unpark, preempt, evict, handoff and rescue.
+ *   other   compact binary (CC_TRACE_FILE_MAGIC below), read back by
+ *           `ccc trace FILE` for a blocked-on summary or JSON conversion.
+ */
+
+#ifndef CC_SCHED_TRACE_H
+#define CC_SCHED_TRACE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+enum {
+    CC_TRACE_SPAWN = 1,  /* fiber: child; arg: spawning fiber (0 = thread) */
+    CC_TRACE_RUN,        /* dispatch; arg: priority; reason: "queue"/"runnext" */
+    CC_TRACE_PARK,       /* reason: park_reason; arg: park_obj */
+    CC_TRACE_YIELD,      /* cooperative yield or preemption; back on the queue */
+    CC_TRACE_DONE,       /* fiber returned */
+    CC_TRACE_UNPARK,     /* fiber: wakee; arg: waking fiber (0 = thread) */
+    CC_TRACE_PREEMPT,    /* fiber yields at a safe point the scheduler asked for */
+    CC_TRACE_EVICT,      /* sysmon replaced a stuck worker; worker: the slot */
+    CC_TRACE_HANDOFF,    /* cc_blocking_enter gave the worker slot away */
+    CC_TRACE_RESCUE,     /* sysmon moved a stale runnext fiber to the queue */
+    CC_TRACE_KIND_COUNT
+};
+
+/* One event, as collected (ts in ns) or loaded from a trace file. */
+typedef struct {
+    uint64_t ts;
+    uint64_t fiber;
+    uint64_t arg;
+    const char* reason;
+    uint16_t kind;
+    int16_t worker;      /* scheduler worker slot, -1 off-worker */
+    uint32_t track;      /* recording thread (see cc_trace_set.track_names) */
+} cc_trace_event;
+
+/* A collected or loaded trace: events sorted by time. */
+typedef struct {
+    cc_trace_event* ev;
+    size_t n;
+    const char** track_names;
+    uint32_t ntracks;
+    char* strings;       /* owns reason/name storage for loaded traces */
+} cc_trace_set;
+
+#define CC_TRACE_FILE_MAGIC "CCTRACE1"
+
+extern _Atomic int cc__trace_on;
+
+static inline int cc_trace_on(void) {
+    return atomic_load_explicit(&cc__trace_on, memory_order_relaxed) != 0;
+}
+
+/* Record one event from the calling thread. */
+void cc__trace_emit(int kind, int worker, uint64_t fiber, uint64_t arg, const char* reason);
+/* Record a RUN (arg: priority, reason: where it came from). `waker` is the
+ * fiber whose unpark made it runnable, 0 if none was left on it; it comes
+ * out as an UNPARK just before the RUN. With `back_to_back` (the dispatch
+ * starts right where this worker's last one ended, no spin or wait in
+ * between) the RUN shares the previous event's stamp, and goes into that
+ * event's slot when it is the dispatch's end. */
+void cc__trace_run(int worker, uint64_t fiber, uint64_t prio, const char* from,
+                   uint64_t waker, int back_to_back);
+/* Track name for the calling thread's ring (before its first event). */
+void cc__trace_set_thread_name(const char* name);
+/* CC_TRACE=path: start now, write `path` at exit. Called from scheduler init. */
+void cc__trace_init_from_env(void);
+
+int cc_trace_start(void);
+void cc_trace_stop(void);
+int cc_trace_dump(const char* path);
+
+/* `ccc trace`: summarize a binary trace on `out`; with json_out, also
+ * convert it. Returns 0, or an errno value (EINVAL: not a trace file). */
+int cc__trace_report(const char* path, const char* json_out, int top, FILE* out);
+
+#endif /* CC_SCHED_TRACE_H */
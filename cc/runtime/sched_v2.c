@@ -18,6 +18,9 @@
 
 #include "sched_v2.h"
 #include "wake_primitive.h"
+#include "cpu_topology.h"
+#include "sched_prof.h"
+#include "sched_trace.h"
 #include "fiber_internal.h"
 #include "minicoro.h"
 
@@ -95,10 +98,9 @@ static inline void v2_slock_unlock(v2_slock* l) {
  *
  * At steady state we run at CC_V2_THREADS (~= CPU count). Sysmon's
  * syscall-age eviction replaces aged workers in place — the orphaned
- * thread leaves the pool (pthread_detach) while a fresh worker takes
- * over the same slot — so this cap bounds active pool size, not total
- * threads ever alive. Orphans are off-books and bounded only by
- * V2_ORPHAN_SAFETY_CAP (see below). */
+ * thread leaves the pool while a spare takes over the same slot — so
+ * this cap bounds active pool size, not total threads ever alive. Orphans
+ * are off-books and bounded only by V2_ORPHAN_SAFETY_CAP (see below). */
 #define V2_MAX_THREADS     256
 #define V2_GLOBAL_QUEUE_SIZE 4096
 #if defined(__OPTIMIZE__)
@@ -133,6 +135,26 @@ static inline void v2_slock_unlock(v2_slock* l) {
  * eviction for that tick and queued work waits a little longer. */
 #define V2_ORPHAN_SAFETY_CAP 4096
 
+/* Fairness bound on the per-worker runnext slot (see sched_v2_signal): a
+ * worker takes at most this many consecutive fibers from runnext before it
+ * pops the global ready queue once. Two fibers ping-ponging over a channel
+ * would otherwise hand the worker back and forth forever while everything
+ * queued behind them starves. */
+#define V2_RUNNEXT_MAX_STREAK 32
+
+/* How long a worker that found no other work gives a busy owner to take
+ * its own runnext fiber before stealing it (Go's runqgrab waits ~3 us).
+ * A ping-pong waker parks well inside this, so the pair stays put; a
+ * waker that keeps computing loses its wakee to the idle worker. */
+#define V2_RUNNEXT_STEAL_DELAY_NS 3000
+
+/* Starvation guard for the priority lanes (see v2_queue_pop): a non-empty
+ * lane passed over this many times in a row by pops from higher lanes gets
+ * the next pop. With every lane backed up, interactive : normal : batch
+ * pops run about 8 : 1 : 1. CC_V2_PRIO_STARVE overrides; 0 is strict
+ * priority. */
+#define V2_PRIO_STARVE_LIMIT 8
+
 /* ============================================================================
  * Fiber
  * ============================================================================ */
@@ -169,11 +191,18 @@ struct fiber_v2 {
     char       result_buf[48] __attribute__((aligned(8)));
     _Atomic uint64_t wait_ticket;
     int        yield_kind;      /* V2_YIELD_PARK or V2_YIELD_YIELD */
+    int        prio;            /* SCHED_V2_PRIO_*: ready-queue lane, fixed at spawn */
     const char* park_reason;
+    int        chan_waiting;    /* metrics: parked on a channel op since last dispatch */
+    _Atomic uint64_t trace_id;  /* tracer's fiber id, assigned on first event */
+    _Atomic uint64_t trace_waker; /* trace id of the fiber that unparked it, for its RUN */
+    void*      spawn_site;      /* profiler tag: entry fn, or the closure body */
+    void*      fls[SCHED_V2_FLS_KEYS]; /* cc_fls_* slots, copied from the spawner */
 
     /* Deadlock-detector metadata. All four are written from V2 fiber context
      * via the cc__fiber_* / cc_deadlock_suppress / cc_external_wait shims so
-     * the detector can walk g_v2.all_fibers and classify each parked fiber.
+     * the detector can classify each parked fiber (counted at park commit,
+     * confirmed by a g_v2.all_fibers walk).
      *   park_obj              — what we're parked on (CCChan*, V2 fiber for
      *                            sched_v2_join, etc).
      *   deadlock_suppress_depth — mirror of tls_deadlock_suppress_depth,
@@ -186,6 +215,11 @@ struct fiber_v2 {
     void*      park_obj;
     uint32_t   deadlock_suppress_depth;
     uint32_t   external_wait_depth;
+    int        park_class;      /* V2_PARK_* counted at the last park commit */
+    /* cc_blocking_enter/exit nesting. Only the outermost enter hands the
+     * worker slot off and only the matching exit gives the fiber back to
+     * the pool (see sched_v2_blocking_enter). */
+    uint32_t   blocking_depth;
 
     /* Deadline-aware park.  When a caller parks with an absolute deadline
      * (e.g. @with_deadline wrapping a cc_chan_send that finds the channel
@@ -225,17 +259,32 @@ struct fiber_v2 {
  * uncontended mutex cost alone was a noticeable fraction of total time.
  * ============================================================================ */
 
+/* One FIFO lane per priority class under the same lock. `count` is the
+ * total across lanes (what wake/park/sysmon reason about); `lane_count` lets
+ * lock-free readers see which classes are waiting. `passed_over` and
+ * `guard_pops` (pops taken by the starvation guard, for the stats dump)
+ * are only touched under the lock. */
 typedef struct {
     v2_slock mu;
-    fiber_v2* head;
-    fiber_v2* tail;
+    fiber_v2* head[SCHED_V2_PRIO_COUNT];
+    fiber_v2* tail[SCHED_V2_PRIO_COUNT];
+    uint32_t passed_over[SCHED_V2_PRIO_COUNT];
+    uint64_t guard_pops;
+    _Atomic size_t lane_count[SCHED_V2_PRIO_COUNT];
     _Atomic size_t count;
 } v2_queue;
 
+static int g_v2_prio_starve_limit = V2_PRIO_STARVE_LIMIT;
+
 static void v2_queue_init(v2_queue* q) {
     v2_slock_init(&q->mu);
-    q->head = NULL;
-    q->tail = NULL;
+    for (int l = 0; l < SCHED_V2_PRIO_COUNT; l++) {
+        q->head[l] = NULL;
+        q->tail[l] = NULL;
+        q->passed_over[l] = 0;
+        atomic_store_explicit(&q->lane_count[l], 0, memory_order_relaxed);
+    }
+    q->guard_pops = 0;
     atomic_store_explicit(&q->count, 0, memory_order_relaxed);
 }
 
@@ -243,27 +292,50 @@ static void v2_queue_init(v2_queue* q) {
  * Used by sched_v2_enqueue_runnable to skip the wake syscall when the
  * queue is already deep enough that a drainer is known to be on it. */
 static int v2_queue_push(v2_queue* q, fiber_v2* f) {
+    int l = f->prio;
     f->next = NULL;
     v2_slock_lock(&q->mu);
-    if (q->tail) {
-        q->tail->next = f;
+    if (q->tail[l]) {
+        q->tail[l]->next = f;
     } else {
-        q->head = f;
+        q->head[l] = f;
     }
-    q->tail = f;
+    q->tail[l] = f;
+    atomic_fetch_add_explicit(&q->lane_count[l], 1, memory_order_relaxed);
     int prev = atomic_fetch_add_explicit(&q->count, 1, memory_order_relaxed);
     v2_slock_unlock(&q->mu);
     return prev;
 }
 
+/* Highest-priority non-empty lane, unless a lower lane has been passed over
+ * g_v2_prio_starve_limit times while waiting; then the highest such lane.
+ * Every pop passes over the non-empty lanes below the one it takes. */
 static fiber_v2* v2_queue_pop(v2_queue* q) {
     if (atomic_load_explicit(&q->count, memory_order_relaxed) == 0) return NULL;
     v2_slock_lock(&q->mu);
-    fiber_v2* f = q->head;
-    if (f) {
-        q->head = f->next;
-        if (!q->head) q->tail = NULL;
+    int lane = -1;
+    for (int l = 0; l < SCHED_V2_PRIO_COUNT; l++) {
+        if (!q->head[l]) continue;
+        if (lane < 0) {
+            lane = l;
+        } else if (g_v2_prio_starve_limit > 0 &&
+                   q->passed_over[l] >= (uint32_t)g_v2_prio_starve_limit) {
+            lane = l;
+            q->guard_pops++;
+            break;
+        }
+    }
+    fiber_v2* f = NULL;
+    if (lane >= 0) {
+        f = q->head[lane];
+        q->head[lane] = f->next;
+        if (!q->head[lane]) q->tail[lane] = NULL;
         f->next = NULL;
+        q->passed_over[lane] = 0;
+        for (int l = lane + 1; l < SCHED_V2_PRIO_COUNT; l++) {
+            if (q->head[l]) q->passed_over[l]++;
+        }
+        atomic_fetch_sub_explicit(&q->lane_count[lane], 1, memory_order_relaxed);
         atomic_fetch_sub_explicit(&q->count, 1, memory_order_relaxed);
     }
     v2_slock_unlock(&q->mu);
@@ -303,6 +375,28 @@ typedef struct {
      * "detached" flag is needed. */
     _Atomic uint64_t generation;
     wake_primitive wake;
+    /* Direct-handoff slot: a fiber woken by a fiber running on this worker
+     * is stashed here instead of the global ready queue, and runs next on
+     * this worker while the waker's data is still in cache. Written by the
+     * owning worker (exchange) and drained by it; sysmon may CAS a stale
+     * entry out and push it to the ready queue. Any holder of the pointer
+     * owns the QUEUED fiber, so every take is an exchange/CAS. */
+    fiber_v2* _Atomic runnext;
+    /* Preemption request: the dispatch_epoch sysmon wants switched out, 0
+     * when none is outstanding. The running fiber honours it at its next
+     * safe point (cc_preempt_point, cc_cancelled) by yielding, provided
+     * it is still on that dispatch. Set by sysmon, cleared by whoever
+     * wins the CAS back to 0 (the fiber, or sysmon once stale). */
+    _Atomic uint64_t preempt_epoch;
+    /* Priority class of the fiber on the current dispatch (meaningful only
+     * while dispatch_epoch != 0). Read by an enqueuer of an interactive
+     * fiber looking for a worker to preempt. */
+    _Atomic int running_prio;
+    /* Placement (see Worker placement): the CPU set index this slot's
+     * workers are pinned to, and that CPU's NUMA node. -1 when unpinned.
+     * Fixed for the life of the process; set before the first thread. */
+    int place_idx;
+    int node;
 } thread_v2;
 
 /* ============================================================================
@@ -323,8 +417,10 @@ struct sched_v2_state {
 
     /* Fiber free list (lock-free CAS stack) */
     fiber_v2* _Atomic free_list;
-    pthread_mutex_t all_fibers_mu;
-    fiber_v2* all_fibers;
+    /* Every fiber ever allocated. Push-only (CAS) and never unlinked before
+     * shutdown, since freed fibers go to the pool, so readers walk it with
+     * one acquire load and no lock. */
+    fiber_v2* _Atomic all_fibers;
     _Atomic size_t fiber_count;
 
     /* Sysmon */
@@ -340,6 +436,10 @@ static struct sched_v2_state g_v2 = {
     .init_once = PTHREAD_ONCE_INIT,
 };
 
+static inline fiber_v2* v2_all_fibers_head(void) {
+    return atomic_load_explicit(&g_v2.all_fibers, memory_order_acquire);
+}
+
 static _Atomic uint64_t g_v2_sysmon_stall_detect = 0;
 extern void cc__io_wait_dump_kq_diag(void);
 extern void cc__fiber_dump_unpark_reason_stats(void);
@@ -393,6 +493,28 @@ static _Atomic uint64_t g_v2_worker_self_drain = 0;
  *                      through to the park path (mark idle + ulock_wait). */
 static _Atomic uint64_t g_v2_worker_spin_hit = 0;
 static _Atomic uint64_t g_v2_worker_spin_miss = 0;
+/* Runnext (same-worker direct handoff) outcomes.
+ *   runnext_stash:   signal from a worker stashed the woken fiber in the
+ *                    worker's runnext slot instead of the ready queue.
+ *   runnext_kicked:  a stash displaced an earlier runnext fiber, which
+ *                    went to the ready queue.
+ *   runnext_hit:     self-drain ran a fiber from runnext.
+ *   runnext_woke:    a stash woke an idle worker to come looking for it.
+ *   runnext_stolen:  a worker with nothing else to run took another
+ *                    worker's runnext fiber after the steal delay.
+ *   runnext_rescued: sysmon found a runnext entry stuck for a whole tick
+ *                    (waker kept running) and moved it to the ready queue. */
+static _Atomic uint64_t g_v2_runnext_stash = 0;
+static _Atomic uint64_t g_v2_runnext_kicked = 0;
+static _Atomic uint64_t g_v2_runnext_hit = 0;
+static _Atomic uint64_t g_v2_runnext_woke = 0;
+static _Atomic uint64_t g_v2_runnext_stolen = 0;
+static _Atomic uint64_t g_v2_runnext_rescued = 0;
+/* 1 while a worker woken for a stash has not yet looked at the runnext
+ * slots (Go's nmspinning gate on wakep): one searcher at a time, so a
+ * ping-pong pair does not pay a wake syscall per message. Cleared by the
+ * searcher, on a failed wake, and every sysmon tick. */
+static _Atomic int g_v2_runnext_searching = 0;
 /* Admission-control (CC_V2_TARGET_ACTIVE) instrumentation.
  *   admit_ok:           try_admit_running CAS succeeded — this worker
  *                       is now counted toward g_v2_running_workers.
@@ -425,7 +547,7 @@ static _Atomic uint64_t g_v2_join_park_thread = 0;
  * only touched by sysmon and by the orphan exit path, both low-frequency.
  *   evicted_total : monotonic count of slot-in-place replacements.
  *   orphans_alive : live orphans right now (sysmon increments on evict,
- *                   orphan decrements when its thread_v2_main returns).
+ *                   orphan decrements when it leaves the worker loop).
  *   orphans_cap_hit : sysmon skipped an eviction because safety cap was
  *                     reached. Non-zero = pathological workload. */
 static _Atomic uint64_t g_v2_sysmon_evicted_total = 0;
@@ -436,6 +558,118 @@ static _Atomic uint64_t g_v2_orphans_cap_hit = 0;
  * (pool becomes hard-capped at CC_V2_THREADS as before). Default: enabled. */
 static _Atomic int g_v2_sysmon_detach_enabled = 1;
 
+/* Time-slicing of long-running fibers (see sched_v2_sysmon_evict_aged_workers).
+ * Sysmon first asks an aged fiber to yield at its next safe point; only a
+ * fiber that is still on the same dispatch a tick later (blocked in a
+ * syscall, or in code without safe points) costs an eviction and a new
+ * thread. Asking is skipped until a TU built with --preempt-points has
+ * registered (cc__preempt_points_register): without loop polls almost
+ * nothing answers, and the extra tick would only delay the eviction.
+ * CC_V2_PREEMPT=0 restores immediate eviction unconditionally.
+ *   preempt_requested : requests issued by sysmon.
+ *   preempt_yields    : fibers that yielded at a safe point on request.
+ *   preempt_escalated : requests unanswered for a tick; worker evicted
+ *                       (or, with detach off, left running). */
+static int g_v2_preempt_enabled = 1;
+static _Atomic uint64_t g_v2_preempt_requested = 0;
+static _Atomic uint64_t g_v2_preempt_yields = 0;
+static _Atomic uint64_t g_v2_preempt_escalated = 0;
+
+/* Number of worker slots with an outstanding preemption request. Exported
+ * (cc_sched.cch) so cc_preempt_point() costs one relaxed load of a rarely-
+ * written global while nothing is being preempted. */
+_Atomic int cc__preempt_requested = 0;
+
+/* TUs built with --preempt-points; each bumps this once from a load-time
+ * constructor emitted by the compiler. */
+static _Atomic int g_v2_preempt_points_tus = 0;
+
+void cc__preempt_points_register(void) {
+    atomic_fetch_add_explicit(&g_v2_preempt_points_tus, 1, memory_order_relaxed);
+}
+
+/* Explicit blocking regions (cc_blocking_enter/exit, `@blocking` function
+ * bodies). The outermost enter hands the caller's worker slot to a spare
+ * thread right away instead of holding it until sysmon ages the dispatch
+ * out 20-40 ms later; the calling thread carries on as an orphan for the
+ * duration of the call, and the matching exit requeues the fiber so a pool
+ * worker resumes it. CC_V2_BLOCKING_HANDOFF=0 keeps the slot with the
+ * caller (sysmon's eviction still applies).
+ *   blocking_handoffs : slots handed over on entry (always counted; it is
+ *                       a metrics field).
+ *   blocking_returns  : fibers requeued from an orphan on exit. */
+static int g_v2_blocking_handoff_enabled = 1;
+static _Atomic uint64_t g_v2_blocking_handoffs = 0;
+static _Atomic uint64_t g_v2_blocking_returns = 0;
+
+/* Spare worker threads, like Go's idle M list. A slot handed over by
+ * cc_blocking_enter or sysmon eviction goes to a parked spare when there is
+ * one, and a fresh thread is created only when there is not. An orphan
+ * whose blocking call returned parks here instead of exiting, up to
+ * V2_SPARE_MAX; the rest exit. Spares are never detached while they may
+ * still own a slot: sched_v2_shutdown joins slot.handle and every parked
+ * spare, and a thread detaches itself only when it leaves for good.
+ *   spare_reuses      : slots given to a parked spare.
+ *   spare_creates     : slots that needed a new thread.
+ *   spare_create_fail : handovers skipped because pthread_create failed
+ *                       (the slot stays with its current thread). */
+#ifndef V2_SPARE_MAX
+#define V2_SPARE_MAX 4
+#endif
+#define V2_SPARE_PARKED (-1)
+#define V2_SPARE_EXIT (-2)
+typedef struct v2_spare {
+    struct v2_spare* next;
+    pthread_t handle;
+    int slot;                   /* V2_SPARE_PARKED until handed a slot */
+    pthread_cond_t cv;
+} v2_spare;
+static pthread_mutex_t g_v2_spare_mu = PTHREAD_MUTEX_INITIALIZER;
+static v2_spare* g_v2_spares = NULL;
+static int g_v2_nspares = 0;
+static _Atomic uint64_t g_v2_spare_reuses = 0;
+static _Atomic uint64_t g_v2_spare_creates = 0;
+static _Atomic uint64_t g_v2_spare_create_fail = 0;
+
+/* Priority lanes (CC_V2_PRIO_STARVE sets g_v2_prio_starve_limit).
+ *   prio_preempts : preemption requests issued on enqueue of an interactive
+ *                   fiber with no idle worker (see sched_v2_prio_preempt). */
+static _Atomic uint64_t g_v2_prio_preempts = 0;
+
+/* Worker placement (CC_V2_AFFINITY, cc_sched_set_worker_affinity).
+ *   none     : workers float (default).
+ *   compact  : one CPU per worker, filling NUMA node 0 first.
+ *   scatter  : one CPU per worker, alternating nodes.
+ *   node     : each worker pinned to all CPUs of its compact-order node.
+ *   <list>   : one CPU per worker from an explicit list ("0-3,8-11").
+ * Worker i uses entry i % g_v2_place_n of g_v2_place_cpu. With more than one
+ * node and pinned workers, an external wake prefers an idle worker on the
+ * waker's node (CC_V2_NUMA_WAKE=0 turns that off).
+ *   pinned / pin_fail       : worker starts that did / didn't get their mask.
+ *   wake_same / other_node  : node-aware wakes that found a local / remote
+ *                             idle worker. */
+enum {
+    V2_AFFINITY_NONE = 0,
+    V2_AFFINITY_COMPACT,
+    V2_AFFINITY_SCATTER,
+    V2_AFFINITY_NODE,
+    V2_AFFINITY_LIST,
+};
+static int g_v2_affinity_mode = V2_AFFINITY_NONE;
+static char g_v2_affinity_spec[256];     /* from cc_sched_set_worker_affinity */
+static cc_cpu_topology g_v2_topo;
+static int g_v2_place_cpu[CC_TOPO_MAX_CPUS];
+static int g_v2_place_n = 0;
+static int g_v2_numa_wake = 0;
+static _Atomic uint64_t g_v2_pinned = 0;
+static _Atomic uint64_t g_v2_pin_fail = 0;
+static _Atomic uint64_t g_v2_wake_same_node = 0;
+static _Atomic uint64_t g_v2_wake_other_node = 0;
+
+/* Serialises slot replacement (sched_v2_replace_worker_in_place) between
+ * sysmon and fibers handing their own slot off. */
+static pthread_mutex_t g_v2_replace_mu = PTHREAD_MUTEX_INITIALIZER;
+
 /* Fast wall-clock tick for the worker hot path. On Apple Silicon,
  * mach_absolute_time() returns nanoseconds directly (timebase 1/1) and
  * compiles down to a single `mrs CNTVCT_EL0` (~6 cycles). On x86 macs and
@@ -472,6 +706,17 @@ static inline uint64_t v2_now_ns(void) {
 }
 #endif
 
+/* Busy-wait hint for the spin-before-park, join and runnext-steal loops. */
+static inline void v2_spin_hint(void) {
+#if defined(__aarch64__) || defined(__arm__)
+    __asm__ volatile("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __asm__ volatile("pause" ::: "memory");
+#else
+    __asm__ volatile("" ::: "memory");
+#endif
+}
+
 /* Diagnostic-counter gate.  Writes to the g_v2_* stat counters on the hot
  * signal/wake/park/resume paths used to be unconditional -- at multi-million
  * ops/sec this became ~10-20M contended RMWs/s on cold globals across worker
@@ -519,6 +764,16 @@ static int g_v2_join_spin = 0;
  * tick (~20ms). */
 static int g_v2_wake_skip_depth = 4;
 
+/* Tunable via CC_V2_RUNNEXT=0 (default on). When on, a fiber made runnable
+ * by a fiber running on worker W goes into W's runnext slot and is the
+ * next fiber W runs, instead of joining the tail of the global ready
+ * queue behind every other runnable fiber and (usually) being popped by
+ * a different, freshly-woken worker. This is the request/reply shape of
+ * channel code: the sender is about to park on the reply, so the receiver
+ * runs on the same core with the message still hot, and no idle worker
+ * is woken for it. */
+static int g_v2_runnext_enabled = 1;
+
 /* ---------------------------------------------------------------------------
  * Worker-pool shaping knobs
  * ---------------------------------------------------------------------------
@@ -721,8 +976,7 @@ static void sched_v2_diag_scan_fibers(uint64_t state_counts[FIBER_V2_STATE_COUNT
     }
     if (reason_bucket_count) *reason_bucket_count = 0;
 
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         int state = fiber_v2_state_base(atomic_load_explicit(&f->state, memory_order_acquire));
         if (state >= 0 && state < FIBER_V2_STATE_COUNT) {
             state_counts[state]++;
@@ -765,21 +1019,195 @@ static void sched_v2_diag_scan_fibers(uint64_t state_counts[FIBER_V2_STATE_COUNT
             }
         }
     }
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
 }
 
 /* Per-thread state */
 static __thread int tls_v2_thread_id = -1;
 static __thread uint64_t tls_v2_my_generation = 0;
 static __thread fiber_v2* tls_v2_current_fiber = NULL;
+/* cc_fls_* slots for code running off-fiber (main, cc_thread_spawn). */
+static __thread void* tls_v2_fls[SCHED_V2_FLS_KEYS];
+/* Top of this worker's own stack (thread_v2_main's frame); bounds the
+ * profiler's frame walk. 0 on threads that are not V2 workers. */
+static __thread uintptr_t tls_v2_stack_hi = 0;
 /* Per-worker monotonic dispatch counter, incremented before each fiber
  * run. Published to slot.dispatch_epoch so sysmon can detect "same fiber
  * still running after one tick" without any wall-clock read on the hot
  * path. Starts at 1 so that 0 unambiguously means "no fiber running". */
 static __thread uint64_t tls_v2_dispatch_seq = 0;
+/* Consecutive fibers this worker has taken from its runnext slot without
+ * popping the ready queue; capped at V2_RUNNEXT_MAX_STREAK. */
+static __thread uint32_t tls_v2_runnext_streak = 0;
+/* Set once this worker gave up its admission slot early, on a blocking
+ * handoff; its exit path must not deadmit a second time. */
+static __thread int tls_v2_admission_released = 0;
+
+/* Scheduler tracing (sched_trace.h). Fiber ids are handed out on a fiber's
+ * first traced event, so nothing is paid per spawn while tracing is off;
+ * pooled fibers get a fresh id per spawn. */
+static _Atomic uint64_t g_v2_trace_next_id = 0;
+
+static uint64_t sched_v2_trace_id(fiber_v2* f) {
+    if (!f) return 0;
+    uint64_t id = atomic_load_explicit(&f->trace_id, memory_order_relaxed);
+    if (id) return id;
+    uint64_t mine = atomic_fetch_add_explicit(&g_v2_trace_next_id, 1, memory_order_relaxed) + 1;
+    if (atomic_compare_exchange_strong_explicit(&f->trace_id, &id, mine,
+            memory_order_relaxed, memory_order_relaxed)) {
+        return mine;
+    }
+    return id;
+}
+
+static void sched_v2_trace(int kind, int worker, fiber_v2* f, uint64_t arg, const char* reason) {
+    cc__trace_emit(kind, worker, sched_v2_trace_id(f), arg, reason);
+}
+
+#define V2_TRACE(kind, f, arg, reason) \
+    do { \
+        if (cc_trace_on()) \
+            sched_v2_trace((kind), tls_v2_thread_id, (f), (uint64_t)(arg), (reason)); \
+    } while (0)
+
+/* UNPARK from inside a fiber of a parked fiber is not recorded here: the
+ * waker is left on the wakee and recorded with its RUN, in the same ring
+ * slot (cc__trace_run), so a switch costs one slot. A wake that only sets
+ * the pending signal (`queued` == 0), or one from a plain thread, is an
+ * event of its own. */
+static void sched_v2_trace_unpark(fiber_v2* f, int queued) {
+    uint64_t waker = sched_v2_trace_id(tls_v2_current_fiber);
+    if (queued && waker)
+        atomic_store_explicit(&f->trace_waker, waker, memory_order_relaxed);
+    else
+        cc__trace_emit(CC_TRACE_UNPARK, tls_v2_thread_id, sched_v2_trace_id(f), waker, NULL);
+}
+
+/* RUN for `f`, with the waker it was left. */
+static void sched_v2_trace_run(fiber_v2* f, const char* from, int back_to_back) {
+    uint64_t waker = atomic_load_explicit(&f->trace_waker, memory_order_relaxed);
+    if (waker) atomic_store_explicit(&f->trace_waker, 0, memory_order_relaxed);
+    cc__trace_run(tls_v2_thread_id, sched_v2_trace_id(f), (uint64_t)f->prio, from, waker,
+                  back_to_back);
+}
 bool cc_nursery_is_cancelled(const CCNursery* n);
 void cc_nursery_notify_child_done(CCNursery* n);
 
+/* Production metrics (cc_runtime_metrics_snapshot). Always on, unlike the
+ * V2_STAT_INC diagnostics, so the hot path must stay lock-free and
+ * uncontended: every worker thread owns a cache line of counters that only it
+ * writes (plain load+store, no locked RMW), published once on a list the
+ * reader walks. The shard belongs to the thread, not the slot, so an orphan
+ * and its replacement never share one. Threads that are not workers share one
+ * shard with atomic increments. A worker releases its shard when it exits and
+ * the next worker to start claims it (counts are cumulative, so it just keeps
+ * adding), so the list never grows past the most worker threads alive at
+ * once. Shards stay on the list for lock-free readers and are never freed. */
+enum {
+    V2_M_SPAWNS,
+    V2_M_DISPATCHES,
+    V2_M_PARKS,
+    V2_M_UNPARKS,
+    V2_M_YIELDS,
+    V2_M_COMPLETIONS,
+    V2_M_CHAN_PARKS,      /* parks with a chan_* park reason ... */
+    V2_M_CHAN_RESUMES,    /* ... and their next dispatch */
+    V2_M_PARKED_IN,       /* committed PARKED, per V2_PARK_* class ... */
+    V2_M_PARKED_OUT = V2_M_PARKED_IN + 4,  /* ... and unparked from PARKED */
+    V2_M_COUNT = V2_M_PARKED_OUT + 4
+};
+
+/* Deadlock-detector class of a parked fiber, fixed at park commit: the
+ * depths only change while the fiber runs and park_reason only at park. */
+enum {
+    V2_PARK_INTERNAL,
+    V2_PARK_RECV,         /* chan_recv_wait_*: exempt if external progress exists */
+    V2_PARK_EXTERNAL,     /* inside cc_external_wait */
+    V2_PARK_SUPPRESSED,   /* inside cc_deadlock_suppress */
+    V2_PARK_CLASSES
+};
+_Static_assert(V2_PARK_CLASSES == 4, "V2_M_PARKED_* reserve 4 slots");
+
+typedef struct v2_metrics_shard {
+    _Atomic uint64_t n[V2_M_COUNT];
+    struct v2_metrics_shard* next;
+    _Atomic int owned;    /* a live worker thread is writing n[] */
+} __attribute__((aligned(64))) v2_metrics_shard;
+
+static v2_metrics_shard g_v2_metrics_shared;
+static _Atomic(v2_metrics_shard*) g_v2_metrics_shards = NULL;
+static __thread v2_metrics_shard* tls_v2_metrics = NULL;
+
+static void v2_metrics_attach_thread(void) {
+    if (tls_v2_metrics) return;
+    /* Reuse a shard an exited worker released. The acquire CAS pairs with
+     * the release in v2_metrics_detach_thread, so its last counts are
+     * visible before this thread's plain load+store increments. */
+    for (v2_metrics_shard* sh = atomic_load_explicit(&g_v2_metrics_shards, memory_order_acquire);
+         sh; sh = sh->next) {
+        int free_shard = 0;
+        if (atomic_load_explicit(&sh->owned, memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong_explicit(&sh->owned, &free_shard, 1,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            tls_v2_metrics = sh;
+            return;
+        }
+    }
+    v2_metrics_shard* sh = NULL;
+    if (posix_memalign((void**)&sh, 64, sizeof(*sh)) != 0) return;
+    memset(sh, 0, sizeof(*sh));
+    atomic_store_explicit(&sh->owned, 1, memory_order_relaxed);
+    v2_metrics_shard* head = atomic_load_explicit(&g_v2_metrics_shards, memory_order_relaxed);
+    do {
+        sh->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_v2_metrics_shards, &head, sh,
+                                                    memory_order_release, memory_order_relaxed));
+    tls_v2_metrics = sh;
+}
+
+/* Hand this thread's shard back for the next worker; anything the thread
+ * counts after this goes to the shared shard. */
+static void v2_metrics_detach_thread(void) {
+    v2_metrics_shard* sh = tls_v2_metrics;
+    if (!sh) return;
+    tls_v2_metrics = NULL;
+    atomic_store_explicit(&sh->owned, 0, memory_order_release);
+}
+
+static inline void v2_metric_inc(int which) {
+    v2_metrics_shard* sh = tls_v2_metrics;
+    if (__builtin_expect(sh != NULL, 1)) {
+        uint64_t v = atomic_load_explicit(&sh->n[which], memory_order_relaxed);
+        atomic_store_explicit(&sh->n[which], v + 1, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&g_v2_metrics_shared.n[which], 1, memory_order_relaxed);
+    }
+}
+
+/* sum[k] for k in [first, first + count): one pass over the shard list,
+ * which recycling keeps at the most worker threads alive at once. */
+static void v2_metrics_sum_range(uint64_t* sum, int first, int count) {
+    for (int k = first; k < first + count; k++) {
+        sum[k] = atomic_load_explicit(&g_v2_metrics_shared.n[k], memory_order_relaxed);
+    }
+    for (v2_metrics_shard* sh = atomic_load_explicit(&g_v2_metrics_shards, memory_order_acquire);
+         sh; sh = sh->next) {
+        for (int k = first; k < first + count; k++) {
+            sum[k] += atomic_load_explicit(&sh->n[k], memory_order_relaxed);
+        }
+    }
+}
+
+static void v2_metrics_sum(uint64_t sum[V2_M_COUNT]) {
+    v2_metrics_sum_range(sum, 0, V2_M_COUNT);
+}
+
+static inline int v2_park_class_of(const fiber_v2* f) {
+    if (f->external_wait_depth > 0) return V2_PARK_EXTERNAL;
+    if (f->deadlock_suppress_depth > 0) return V2_PARK_SUPPRESSED;
+    if (f->park_reason && strncmp(f->park_reason, "chan_recv_wait_", 15) == 0) return V2_PARK_RECV;
+    return V2_PARK_INTERNAL;
+}
+
 /* Mirror of nursery.c's CC_NURSERY_WORKER_FREES gate.  Latched on first
  * read so we never branch on a changing env var in the hot MCO_DEAD
  * path. Default-on; CC_NURSERY_WORKER_FREES=0 opts out. */
@@ -838,9 +1266,14 @@ static fiber_v2* fiber_v2_alloc(void) {
             f->current_deadline_scope = NULL;
             f->yield_kind = V2_YIELD_PARK;
             f->park_reason = NULL;
+            f->chan_waiting = 0;
             f->park_obj = NULL;
             f->deadlock_suppress_depth = 0;
             f->external_wait_depth = 0;
+            f->blocking_depth = 0;
+            f->prio = SCHED_V2_PRIO_NORMAL;
+            atomic_store_explicit(&f->trace_id, 0, memory_order_relaxed);
+            atomic_store_explicit(&f->trace_waker, 0, memory_order_relaxed);
             atomic_store_explicit(&f->has_park_deadline, 0, memory_order_relaxed);
             atomic_store_explicit(&f->state, FIBER_V2_IDLE, memory_order_relaxed);
             V2_STAT_INC(g_v2_fibers_alive);
@@ -851,6 +1284,7 @@ static fiber_v2* fiber_v2_alloc(void) {
     f = (fiber_v2*)calloc(1, sizeof(fiber_v2));
     if (!f) return NULL;
     f->coro = NULL;
+    f->prio = SCHED_V2_PRIO_NORMAL;
     f->last_thread_id = -1;
     f->park_reason = NULL;
     f->current_deadline_scope = NULL;
@@ -861,10 +1295,11 @@ static fiber_v2* fiber_v2_alloc(void) {
 
     atomic_fetch_add_explicit(&g_v2.fiber_count, 1, memory_order_relaxed);
     V2_STAT_INC(g_v2_fibers_alive);
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
-    f->all_next = g_v2.all_fibers;
-    g_v2.all_fibers = f;
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
+    fiber_v2* head = atomic_load_explicit(&g_v2.all_fibers, memory_order_relaxed);
+    do {
+        f->all_next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_v2.all_fibers, &head, f,
+            memory_order_release, memory_order_relaxed));
     return f;
 }
 
@@ -883,6 +1318,7 @@ static void fiber_v2_free(fiber_v2* f) {
     f->park_obj = NULL;
     f->deadlock_suppress_depth = 0;
     f->external_wait_depth = 0;
+    f->blocking_depth = 0;
     atomic_store_explicit(&f->has_park_deadline, 0, memory_order_relaxed);
     /* Pool the coroutine memory (including its stack): mco_uninit just marks
      * the coro DEAD and runs platform teardown (a no-op on ucontext), while
@@ -905,6 +1341,7 @@ static void fiber_v2_free(fiber_v2* f) {
 
 static void* thread_v2_main(void* arg);
 static void sched_v2_wake(int worker_hint);
+static void sched_v2_pin_worker(int tid);
 
 static void sched_v2_init_worker_slot(int id) {
     g_v2.threads[id].id = id;
@@ -917,6 +1354,18 @@ static void sched_v2_init_worker_slot(int id) {
      * stays at 0 and the mismatch triggers exit. */
     atomic_store_explicit(&g_v2.threads[id].generation, 0,
                           memory_order_release);
+    atomic_store_explicit(&g_v2.threads[id].runnext, NULL,
+                          memory_order_relaxed);
+    atomic_store_explicit(&g_v2.threads[id].preempt_epoch, 0,
+                          memory_order_relaxed);
+    g_v2.threads[id].place_idx = -1;
+    g_v2.threads[id].node = -1;
+    if (g_v2_place_n > 0) {
+        int k = id % g_v2_place_n;
+        g_v2.threads[id].place_idx = k;
+        int nd = cc_cpu_topology_node_of(&g_v2_topo, g_v2_place_cpu[k]);
+        g_v2.threads[id].node = nd < 0 ? 0 : nd;
+    }
     wake_primitive_init(&g_v2.threads[id].wake);
 }
 
@@ -931,14 +1380,28 @@ static int sched_v2_try_wake_one(void) {
         return 0;
     }
     int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
-    for (int i = 0; i < n; i++) {
-        int exp = 1;
-        if (atomic_compare_exchange_strong_explicit(&g_v2.threads[i].is_idle, &exp, 0,
-                memory_order_acq_rel, memory_order_relaxed)) {
-            atomic_fetch_sub_explicit(&g_v2.idle_workers, 1, memory_order_acq_rel);
-            V2_STAT_INC(g_v2_wake_issued);
-            wake_primitive_wake_one(&g_v2.threads[i].wake);
-            return 1;
+    /* Node-aware: first pass only considers workers on the waker's node,
+     * so the woken fiber's channel partner stays in the same socket. */
+    int want = -1;
+    if (g_v2_numa_wake) {
+        int tid = tls_v2_thread_id;
+        want = tid >= 0 ? g_v2.threads[tid].node : cc_current_cpu_node();
+    }
+    for (int pass = want >= 0 ? 0 : 1; pass < 2; pass++) {
+        for (int i = 0; i < n; i++) {
+            if (pass == 0 && g_v2.threads[i].node != want) continue;
+            int exp = 1;
+            if (atomic_compare_exchange_strong_explicit(&g_v2.threads[i].is_idle, &exp, 0,
+                    memory_order_acq_rel, memory_order_relaxed)) {
+                atomic_fetch_sub_explicit(&g_v2.idle_workers, 1, memory_order_acq_rel);
+                V2_STAT_INC(g_v2_wake_issued);
+                if (want >= 0) {
+                    if (pass == 0) V2_STAT_INC(g_v2_wake_same_node);
+                    else V2_STAT_INC(g_v2_wake_other_node);
+                }
+                wake_primitive_wake_one(&g_v2.threads[i].wake);
+                return 1;
+            }
         }
     }
     V2_STAT_INC(g_v2_wake_scan_miss);
@@ -968,8 +1431,53 @@ static int sched_v2_try_expand_pool(void) {
 
 static void thread_v2_run_fiber(int tid, fiber_v2* f);
 
+/* 1 if any lane above `prio` (numerically below it) has fibers waiting. */
+static inline int sched_v2_lane_waiting_above(int prio) {
+    for (int l = 0; l < prio; l++) {
+        if (atomic_load_explicit(&g_v2.ready_queue.lane_count[l],
+                                 memory_order_relaxed) > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline int sched_v2_lane_waiting(int prio) {
+    return atomic_load_explicit(&g_v2.ready_queue.lane_count[prio],
+                                memory_order_relaxed) > 0;
+}
+
+/* An interactive fiber was queued and no worker is idle: ask one worker
+ * running a lower class to yield at its next safe point, through the same
+ * preempt_epoch channel sysmon uses. Only workers on a live dispatch with
+ * no request outstanding are candidates; one request per enqueue. */
+static void sched_v2_prio_preempt(int prio) {
+    int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        thread_v2* t = &g_v2.threads[i];
+        uint64_t cur = atomic_load_explicit(&t->dispatch_epoch, memory_order_relaxed);
+        if (cur == 0 ||
+            atomic_load_explicit(&t->running_prio, memory_order_relaxed) <= prio ||
+            atomic_load_explicit(&t->preempt_epoch, memory_order_relaxed) != 0) {
+            continue;
+        }
+        uint64_t none = 0;
+        if (!atomic_compare_exchange_strong_explicit(&t->preempt_epoch, &none, cur,
+                memory_order_acq_rel, memory_order_relaxed)) {
+            continue;
+        }
+        atomic_fetch_add_explicit(&cc__preempt_requested, 1, memory_order_relaxed);
+        V2_STAT_INC(g_v2_prio_preempts);
+        return;
+    }
+}
+
 static void sched_v2_enqueue_runnable(fiber_v2* f) {
     int prev = v2_queue_push(&g_v2.ready_queue, f);
+    if (f->prio == SCHED_V2_PRIO_INTERACTIVE && g_v2_preempt_enabled &&
+        atomic_load_explicit(&g_v2.idle_workers, memory_order_relaxed) <= 0) {
+        sched_v2_prio_preempt(f->prio);
+    }
     /* If the queue was already deep, a drainer is on it (or a previous
      * push just woke one) and will self-drain to our item. Skip the
      * seq_cst fence + idle-worker scan on this push. Correctness is
@@ -987,6 +1495,82 @@ static void sched_v2_enqueue_runnable(fiber_v2* f) {
     sched_v2_wake(-1);
 }
 
+/* Take the fiber in `tid`'s runnext slot, if any. */
+static inline fiber_v2* sched_v2_take_runnext(int tid) {
+    if (!atomic_load_explicit(&g_v2.threads[tid].runnext, memory_order_relaxed)) {
+        return NULL;
+    }
+    return atomic_exchange_explicit(&g_v2.threads[tid].runnext, NULL,
+                                     memory_order_acquire);
+}
+
+/* A worker with nothing else to run looks at the other workers' runnext
+ * slots. An entry whose owner is between fibers is left alone (the owner
+ * takes it next); one whose owner is still on the same dispatch after
+ * V2_RUNNEXT_STEAL_DELAY_NS is taken, since that waker kept running. */
+static fiber_v2* sched_v2_steal_runnext(int self) {
+    atomic_store_explicit(&g_v2_runnext_searching, 0, memory_order_relaxed);
+    int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        if (i == self) continue;
+        thread_v2* t = &g_v2.threads[i];
+        if (!atomic_load_explicit(&t->runnext, memory_order_relaxed)) continue;
+        uint64_t seq = atomic_load_explicit(&t->dispatch_epoch, memory_order_relaxed);
+        if (seq == 0) continue;
+        uint64_t t0 = v2_now_ns();
+        while (v2_now_ns() - t0 < V2_RUNNEXT_STEAL_DELAY_NS &&
+               atomic_load_explicit(&t->runnext, memory_order_relaxed) &&
+               atomic_load_explicit(&t->dispatch_epoch, memory_order_relaxed) == seq) {
+            v2_spin_hint();
+        }
+        if (atomic_load_explicit(&t->dispatch_epoch, memory_order_relaxed) != seq) continue;
+        fiber_v2* f = sched_v2_take_runnext(i);
+        if (f) {
+            V2_STAT_INC(g_v2_runnext_stolen);
+            return f;
+        }
+    }
+    return NULL;
+}
+
+/* Make a freshly-signalled (QUEUED) fiber runnable. From a worker that
+ * still owns its slot, hand it off through runnext; anywhere else (kqueue
+ * thread, sysmon, plain threads, an evicted orphan) it goes to the ready
+ * queue, as it does when a higher priority class is waiting there. The
+ * stashing worker drains runnext before it can park, but it may keep
+ * computing first; like Go's ready() -> wakep(), a stash with a worker
+ * idle wakes one, which steals the fiber if the waker is still busy
+ * (sched_v2_steal_runnext). */
+static void sched_v2_make_runnable(fiber_v2* f) {
+    int tid = tls_v2_thread_id;
+    if (!g_v2_runnext_enabled || tid < 0 ||
+        atomic_load_explicit(&g_v2.threads[tid].generation, memory_order_relaxed)
+            != tls_v2_my_generation ||
+        sched_v2_lane_waiting_above(f->prio)) {
+        sched_v2_enqueue_runnable(f);
+        return;
+    }
+    V2_STAT_INC(g_v2_runnext_stash);
+    fiber_v2* prev = atomic_exchange_explicit(&g_v2.threads[tid].runnext, f,
+                                              memory_order_release);
+    if (prev) {
+        /* Last-woken wins (it is the one whose data is hottest); the
+         * displaced fiber keeps its place in FIFO order behind the queue. */
+        V2_STAT_INC(g_v2_runnext_kicked);
+        sched_v2_enqueue_runnable(prev);
+        return;
+    }
+    if (atomic_load_explicit(&g_v2.idle_workers, memory_order_relaxed) > 0 &&
+        !atomic_load_explicit(&g_v2_runnext_searching, memory_order_relaxed) &&
+        !atomic_exchange_explicit(&g_v2_runnext_searching, 1, memory_order_acq_rel)) {
+        if (sched_v2_try_wake_one()) {
+            V2_STAT_INC(g_v2_runnext_woke);
+        } else {
+            atomic_store_explicit(&g_v2_runnext_searching, 0, memory_order_relaxed);
+        }
+    }
+}
+
 /*
  * Central wake primitive.
  *
@@ -1000,8 +1584,32 @@ static void sched_v2_enqueue_runnable(fiber_v2* f) {
  */
 static void sched_v2_wake(int worker_hint) {
     if (worker_hint >= 0 && worker_hint == tls_v2_thread_id) {
+        /* Set once a dispatch in this loop has returned: the next RUN can
+         * share its end stamp and slot (cc__trace_run) unless we spun. */
+        int back_to_back = 0;
         while (atomic_load_explicit(&g_v2.running, memory_order_acquire)) {
-            fiber_v2* f = v2_queue_pop(&g_v2.ready_queue);
+            /* Runnext first, but never more than V2_RUNNEXT_MAX_STREAK in a
+             * row: a ping-pong pair must not starve the ready queue. */
+            fiber_v2* f = NULL;
+            const char* from = "runnext";
+            if (tls_v2_runnext_streak < V2_RUNNEXT_MAX_STREAK &&
+                !sched_v2_lane_waiting(SCHED_V2_PRIO_INTERACTIVE)) {
+                f = sched_v2_take_runnext(worker_hint);
+            }
+            if (f) {
+                tls_v2_runnext_streak++;
+                V2_STAT_INC(g_v2_runnext_hit);
+            } else {
+                tls_v2_runnext_streak = 0;
+                f = v2_queue_pop(&g_v2.ready_queue);
+                if (f) {
+                    from = "queue";
+                } else {
+                    f = sched_v2_take_runnext(worker_hint);
+                    if (f) V2_STAT_INC(g_v2_runnext_hit);
+                    else f = sched_v2_steal_runnext(worker_hint);
+                }
+            }
             if (!f) {
                 /* Spin-before-park: rather than immediately return and
                  * commit to __ulock_wait, stay BUSY for a bounded budget
@@ -1015,15 +1623,10 @@ static void sched_v2_wake(int worker_hint) {
                  * (it was reset at the end of the previous fiber), so we
                  * are not a candidate during the spin. Generation check
                  * runs in the outer thread_v2_main loop on return. */
+                back_to_back = 0;
                 int spin = g_v2_spin_before_park;
                 while (spin-- > 0) {
-#if defined(__aarch64__) || defined(__arm__)
-                    __asm__ volatile("yield" ::: "memory");
-#elif defined(__x86_64__) || defined(__i386__)
-                    __asm__ volatile("pause" ::: "memory");
-#else
-                    __asm__ volatile("" ::: "memory");
-#endif
+                    v2_spin_hint();
                     if (atomic_load_explicit(&g_v2.ready_queue.count,
                                              memory_order_acquire) > 0) {
                         f = v2_queue_pop(&g_v2.ready_queue);
@@ -1035,6 +1638,7 @@ static void sched_v2_wake(int worker_hint) {
                     V2_STAT_INC(g_v2_worker_spin_miss);
                     return;
                 }
+                from = "queue";
                 V2_STAT_INC(g_v2_worker_spin_hit);
             }
             V2_STAT_INC(g_v2_worker_self_drain);
@@ -1047,20 +1651,30 @@ static void sched_v2_wake(int worker_hint) {
             uint64_t seq = ++tls_v2_dispatch_seq;
             atomic_store_explicit(&g_v2.threads[worker_hint].dispatch_epoch,
                                   seq, memory_order_relaxed);
+            atomic_store_explicit(&g_v2.threads[worker_hint].running_prio,
+                                  f->prio, memory_order_relaxed);
+            if (cc_trace_on()) sched_v2_trace_run(f, from, back_to_back);
             thread_v2_run_fiber(worker_hint, f);
-            atomic_store_explicit(&g_v2.threads[worker_hint].dispatch_epoch,
-                                  0, memory_order_relaxed);
             /* Identity check: sysmon may have evicted us in place while
-             * the fiber was running (see sched_v2_sysmon_evict_aged_workers).
+             * the fiber was running (see sched_v2_sysmon_evict_aged_workers),
+             * or the fiber handed the slot off itself (blocking region).
              * If slot.generation has moved beyond our cached value, a new
-             * worker now owns this slot — we must not touch slot.wake or
-             * slot.is_idle again. Abandon the self-drain; the outer loop
-             * will catch the same mismatch and exit cleanly. */
+             * worker now owns this slot — we must not touch slot.wake,
+             * slot.is_idle or slot.dispatch_epoch again. Abandon the
+             * self-drain; the outer loop will catch the same mismatch and
+             * exit cleanly. */
             if (atomic_load_explicit(&g_v2.threads[worker_hint].generation,
                                      memory_order_acquire)
                 != tls_v2_my_generation) {
+                /* The fiber may have stashed a wakee in the slot before
+                 * the eviction landed; hand it to the pool. */
+                fiber_v2* stranded = sched_v2_take_runnext(worker_hint);
+                if (stranded) sched_v2_enqueue_runnable(stranded);
                 return;
             }
+            atomic_store_explicit(&g_v2.threads[worker_hint].dispatch_epoch,
+                                  0, memory_order_relaxed);
+            back_to_back = 1;
         }
         return;
     }
@@ -1122,6 +1736,11 @@ static void thread_v2_run_fiber(int tid, fiber_v2* f) {
     atomic_store_explicit(&f->state, FIBER_V2_RUNNING, memory_order_release);
     f->last_thread_id = tid;
     tls_v2_current_fiber = f;
+    v2_metric_inc(V2_M_DISPATCHES);
+    if (f->chan_waiting) {
+        f->chan_waiting = 0;
+        v2_metric_inc(V2_M_CHAN_RESUMES);
+    }
     f->park_reason = NULL;
     /* park_obj is intentionally NOT cleared here: cc__fiber_set_park_obj
      * writes it just before the park handshake, and the detector only
@@ -1171,6 +1790,29 @@ static void thread_v2_run_fiber(int tid, fiber_v2* f) {
         abort();
     }
 
+    /* Before any state publish: once the fiber is PARKED or QUEUED another
+     * worker may already be running it (or, DEAD, recycling it). */
+    if (mco_status(f->coro) == MCO_DEAD) {
+        v2_metric_inc(V2_M_COMPLETIONS);
+    } else if (f->yield_kind == V2_YIELD_YIELD) {
+        v2_metric_inc(V2_M_YIELDS);
+    } else {
+        v2_metric_inc(V2_M_PARKS);
+        if (f->park_reason && strncmp(f->park_reason, "chan_", 5) == 0) {
+            f->chan_waiting = 1;
+            v2_metric_inc(V2_M_CHAN_PARKS);
+        }
+    }
+    if (cc_trace_on()) {
+        if (mco_status(f->coro) == MCO_DEAD) {
+            V2_TRACE(CC_TRACE_DONE, f, 0, NULL);
+        } else if (f->yield_kind == V2_YIELD_YIELD) {
+            V2_TRACE(CC_TRACE_YIELD, f, 0, NULL);
+        } else {
+            V2_TRACE(CC_TRACE_PARK, f, (uintptr_t)f->park_obj, f->park_reason);
+        }
+    }
+
     if (mco_status(f->coro) == MCO_DEAD) {
         atomic_store_explicit(&f->state, FIBER_V2_DEAD, memory_order_release);
         atomic_store_explicit(&f->done, 1, memory_order_release);
@@ -1227,6 +1869,8 @@ static void thread_v2_run_fiber(int tid, fiber_v2* f) {
     }
 
     expected = FIBER_V2_RUNNING;
+    int park_class = v2_park_class_of(f);
+    f->park_class = park_class;
     if (!atomic_compare_exchange_strong_explicit(&f->state, &expected, FIBER_V2_PARKED,
             memory_order_acq_rel, memory_order_relaxed)) {
         int fail_state = fiber_v2_state_base(expected);
@@ -1238,6 +1882,7 @@ static void thread_v2_run_fiber(int tid, fiber_v2* f) {
         V2_STAT_INC(g_v2_run_pending_requeue);
         return;
     }
+    v2_metric_inc(V2_M_PARKED_IN + park_class);
     V2_STAT_INC(g_v2_run_commit_parked);
 }
 
@@ -1266,6 +1911,8 @@ void sched_v2_signal(fiber_v2* f) {
             }
             V2_STAT_INC(g_v2_signal_running_pending_set);
             V2_STAT_INC(g_v2_signal_pending);
+            v2_metric_inc(V2_M_UNPARKS);
+            if (cc_trace_on()) sched_v2_trace_unpark(f, 0);
             return;
         }
         if (base_state == FIBER_V2_PARKED) {
@@ -1275,7 +1922,10 @@ void sched_v2_signal(fiber_v2* f) {
                 continue;
             }
             V2_STAT_INC(g_v2_signal_ok);
-            sched_v2_enqueue_runnable(f);
+            v2_metric_inc(V2_M_UNPARKS);
+            v2_metric_inc(V2_M_PARKED_OUT + f->park_class);
+            if (cc_trace_on()) sched_v2_trace_unpark(f, 1);
+            sched_v2_make_runnable(f);
             return;
         }
         V2_STAT_INC(g_v2_signal_dropped);
@@ -1393,16 +2043,16 @@ void sched_v2_set_park_reason(const char* reason) {
  *
  * Writes happen from a V2 worker thread while the fiber is RUNNING (i.e.
  * the scope-enter/leave call itself executes on the fiber's stack); reads
- * happen from the sysmon thread while the fiber is PARKED. We serialize
- * via g_v2.all_fibers_mu in the reader (sched_v2_check_deadlock), and the
- * writes on this side are plain stores to fields the writer owns. A
- * relaxed atomic isn't required here: the scope enter/leave always
- * precedes the park handshake, whose own release/acquire publishes the
- * new depth alongside state=FIBER_V2_PARKED. sysmon acquires
- * all_fibers_mu, which synchronizes-with the fiber pool-add release in
- * fiber_v2_alloc, and re-reads state with memory_order_acquire, which
- * pairs with the park-commit release. The depth therefore lands in the
- * reader's view before it treats the fiber as parked.
+ * happen from the sysmon thread while the fiber is PARKED. The writes are
+ * plain stores to fields the writer owns. A relaxed atomic isn't required
+ * here: the scope enter/leave always precedes the park handshake, whose own
+ * release/acquire publishes the new depth alongside state=FIBER_V2_PARKED.
+ * sysmon loads the all_fibers head with acquire, which synchronizes-with
+ * the list-push release in fiber_v2_alloc, and re-reads state with
+ * memory_order_acquire, which pairs with the park-commit release. The depth
+ * therefore lands in the reader's view before it treats the fiber as
+ * parked. The same handshake makes park_class, written by the worker just
+ * before the commit CAS, visible to whoever wins the unpark CAS.
  * ============================================================================ */
 
 void sched_v2_fiber_set_park_obj(fiber_v2* f, void* obj) {
@@ -1444,6 +2094,34 @@ void sched_v2_fiber_clear_park_deadline(fiber_v2* f) {
     if (was) atomic_fetch_sub_explicit(&g_v2_park_deadlines, 1, memory_order_relaxed);
 }
 
+/* Move runnext fibers that have sat in their slot for a whole tick to the
+ * ready queue. A stash waits for the waker to park or yield; a waker that
+ * keeps computing (or is kidnapped by a syscall) would otherwise hold its
+ * wakee hostage while other workers idle. Sysmon-private snapshot, same
+ * pattern as the dispatch-epoch aging scan. Seeing the same pointer twice
+ * may also mean the fiber ran and was re-stashed in between; moving it to
+ * the queue is harmless either way. */
+static void sched_v2_sysmon_rescue_runnext(void) {
+    static fiber_v2* last_seen[V2_MAX_THREADS];
+    /* A searcher that was woken but never reached the slots (admission
+     * gate, shutdown) must not block the next stash's wake. */
+    atomic_store_explicit(&g_v2_runnext_searching, 0, memory_order_relaxed);
+    int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
+    for (int i = 0; i < n && i < V2_MAX_THREADS; i++) {
+        fiber_v2* f = atomic_load_explicit(&g_v2.threads[i].runnext,
+                                           memory_order_acquire);
+        if (f && f == last_seen[i] &&
+            atomic_compare_exchange_strong_explicit(&g_v2.threads[i].runnext, &f, NULL,
+                    memory_order_acq_rel, memory_order_relaxed)) {
+            V2_STAT_INC(g_v2_runnext_rescued);
+            if (cc_trace_on()) sched_v2_trace(CC_TRACE_RESCUE, i, f, 0, NULL);
+            sched_v2_enqueue_runnable(f);
+            f = NULL;
+        }
+        last_seen[i] = f;
+    }
+}
+
 /* Walk the all_fibers list and signal any parked fiber whose deadline
  * has passed.  Cheap when no deadlines are in flight: the global counter
  * short-circuits the walk on the first load.
@@ -1459,8 +2137,7 @@ static void sched_v2_wake_expired_parkers(void) {
     }
     struct timespec now;
     clock_gettime(CLOCK_REALTIME, &now);
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         if (!atomic_load_explicit(&f->has_park_deadline, memory_order_acquire)) continue;
         int base = fiber_v2_state_base(
             atomic_load_explicit(&f->state, memory_order_acquire));
@@ -1478,7 +2155,6 @@ static void sched_v2_wake_expired_parkers(void) {
          * accounting on a single owner. */
         sched_v2_signal(f);
     }
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
 }
 
 void sched_v2_fiber_inc_deadlock_suppress(fiber_v2* f) {
@@ -1528,6 +2204,40 @@ fiber_v2* sched_v2_current_fiber(void) {
     return tls_v2_current_fiber;
 }
 
+/* ============================================================================
+ * Fiber-local storage
+ *
+ * Keys are indices into a fixed row of SCHED_V2_FLS_KEYS pointers carried
+ * inline by every fiber (and by every thread, for code running off-fiber),
+ * so a lookup is the current-fiber TLS load plus one indexed load and
+ * survives migration across workers. A spawn copies the spawner's first
+ * g_v2_fls_keys slots into the child. Slots at or past the key count are
+ * never written (cc_fls_set checks), so a pooled fiber only needs those
+ * copied slots overwritten to shed its previous owner's values.
+ * ============================================================================ */
+
+static _Atomic int g_v2_fls_keys = 0;
+
+int sched_v2_fls_key_create(void) {
+    int k = atomic_load_explicit(&g_v2_fls_keys, memory_order_relaxed);
+    while (k < SCHED_V2_FLS_KEYS) {
+        if (atomic_compare_exchange_weak_explicit(&g_v2_fls_keys, &k, k + 1,
+                memory_order_release, memory_order_relaxed)) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+int sched_v2_fls_key_count(void) {
+    return atomic_load_explicit(&g_v2_fls_keys, memory_order_acquire);
+}
+
+void** sched_v2_fls_slots(void) {
+    fiber_v2* f = tls_v2_current_fiber;
+    return f ? f->fls : tls_v2_fls;
+}
+
 CCNursery* sched_v2_current_nursery(void) {
     fiber_v2* f = sched_v2_current_fiber();
     return f ? f->saved_nursery : NULL;
@@ -1556,21 +2266,57 @@ int sched_v2_current_worker_id(void) {
     return tls_v2_thread_id;
 }
 
+/* Clear slot `i`'s preemption request if it still names `epoch`. Returns 1
+ * if this call retired the request. */
+static int sched_v2_preempt_clear(int i, uint64_t epoch) {
+    if (!atomic_compare_exchange_strong_explicit(&g_v2.threads[i].preempt_epoch,
+            &epoch, 0, memory_order_acq_rel, memory_order_relaxed)) {
+        return 0;
+    }
+    atomic_fetch_sub_explicit(&cc__preempt_requested, 1, memory_order_relaxed);
+    return 1;
+}
+
+/* Safe-point slow path, reached when cc__preempt_requested is non-zero.
+ * Yields only if sysmon asked to preempt exactly the dispatch this worker
+ * is running; every other caller (a different worker, a plain thread, a
+ * fiber dispatched after the request) returns at once. */
+void sched_v2_preempt_point(void) {
+    int tid = tls_v2_thread_id;
+    if (tid < 0 || !tls_v2_current_fiber) return;
+    thread_v2* t = &g_v2.threads[tid];
+    uint64_t want = atomic_load_explicit(&t->preempt_epoch, memory_order_relaxed);
+    if (want == 0 ||
+        want != atomic_load_explicit(&t->dispatch_epoch, memory_order_relaxed) ||
+        atomic_load_explicit(&t->generation, memory_order_relaxed) != tls_v2_my_generation) {
+        return;
+    }
+    if (!sched_v2_preempt_clear(tid, want)) return;
+    V2_STAT_INC(g_v2_preempt_yields);
+    V2_TRACE(CC_TRACE_PREEMPT, tls_v2_current_fiber, 0, NULL);
+    sched_v2_yield();
+}
+
 /* ============================================================================
  * Thread main loop
  * ============================================================================ */
 
-static void* thread_v2_main(void* arg) {
-    int tid = (int)(intptr_t)arg;
+/* Run slot `tid` until shutdown (returns 0) or until the slot is handed to
+ * another thread (returns 1: this thread is an orphan). */
+static int thread_v2_run_slot(int tid) {
     tls_v2_thread_id = tid;
+    tls_v2_admission_released = 0;
+    tls_v2_stack_hi = (uintptr_t)__builtin_frame_address(0);
+    v2_metrics_attach_thread();
     /* Cache our slot generation once at entry. Any future mismatch means
      * sysmon has evicted us and installed a replacement — we exit without
      * touching slot.wake or slot.is_idle (those now belong to the new
-     * worker). See pthread_create synchronize-with guarantee: anything
-     * sysmon wrote before pthread_create is visible to us here. */
+     * worker). pthread_create, or g_v2_spare_mu for a spare, makes
+     * everything the replacer wrote before the handover visible here. */
     tls_v2_my_generation = atomic_load_explicit(&g_v2.threads[tid].generation,
                                                 memory_order_acquire);
     atomic_store_explicit(&g_v2.threads[tid].alive, 1, memory_order_release);
+    sched_v2_pin_worker(tid);
 
     /* Startup-park for extras (see CC_V2_PARK_EXTRAS_AT_STARTUP). Non-primary
      * workers (tid != 0) skip the initial self-drain and park immediately.
@@ -1624,18 +2370,19 @@ static void* thread_v2_main(void* arg) {
         sched_v2_wake(tid);
 
         if (!atomic_load_explicit(&g_v2.running, memory_order_acquire)) {
-            deadmit_running();
+            if (!tls_v2_admission_released) deadmit_running();
             break;
         }
 
         /* End-of-loop identity check: if slot.generation has moved, we are
          * an orphan. Exit before re-parking on slot.wake (which now belongs
          * to the replacement worker). Our kidnapped fiber has already
-         * returned by now; the OS thread simply dies. */
+         * returned by now; the thread parks as a spare or exits
+         * (thread_v2_main). */
         if (atomic_load_explicit(&g_v2.threads[tid].generation,
                                  memory_order_acquire)
             != tls_v2_my_generation) {
-            deadmit_running();
+            if (!tls_v2_admission_released) deadmit_running();
             break;
         }
 
@@ -1659,8 +2406,11 @@ static void* thread_v2_main(void* arg) {
         uint32_t val = atomic_load_explicit(&g_v2.threads[tid].wake.value,
                                             memory_order_acquire);
 
-        /* Recheck: work appeared after we marked ourselves idle. */
-        if (atomic_load_explicit(&g_v2.ready_queue.count, memory_order_acquire) > 0) {
+        /* Recheck: work appeared after we marked ourselves idle. Runnext
+         * is normally empty here (the drain takes it before returning);
+         * checking it too keeps a stash from ever sleeping with us. */
+        if (atomic_load_explicit(&g_v2.ready_queue.count, memory_order_acquire) > 0 ||
+            atomic_load_explicit(&g_v2.threads[tid].runnext, memory_order_relaxed)) {
             if (atomic_exchange_explicit(&g_v2.threads[tid].is_idle, 0, memory_order_acq_rel)) {
                 atomic_fetch_sub_explicit(&g_v2.idle_workers, 1, memory_order_acq_rel);
             }
@@ -1693,9 +2443,300 @@ static void* thread_v2_main(void* arg) {
     } else {
         atomic_store_explicit(&g_v2.threads[tid].alive, 0, memory_order_release);
     }
+    v2_metrics_detach_thread();
+    return orphaned;
+}
+
+/* Park `s` on the spare list. 0 if the list is full or the scheduler is
+ * stopping: the caller exits instead. */
+static int sched_v2_spare_park(v2_spare* s) {
+    pthread_mutex_lock(&g_v2_spare_mu);
+    if (!atomic_load_explicit(&g_v2.running, memory_order_acquire) ||
+        g_v2_nspares >= V2_SPARE_MAX) {
+        pthread_mutex_unlock(&g_v2_spare_mu);
+        return 0;
+    }
+    s->slot = V2_SPARE_PARKED;
+    s->next = g_v2_spares;
+    g_v2_spares = s;
+    g_v2_nspares++;
+    pthread_mutex_unlock(&g_v2_spare_mu);
+    return 1;
+}
+
+/* Spare thread: wait for a slot, run it, and park again each time the
+ * slot is handed on. Leaves when shutdown wakes it (joined there), when it
+ * exits a slot cleanly (joined as slot.handle), or when the list is full
+ * (detached: nobody holds its handle any more). */
+static void* thread_v2_spare_main(void* arg) {
+    v2_spare* s = (v2_spare*)arg;
+    for (;;) {
+        pthread_mutex_lock(&g_v2_spare_mu);
+        while (s->slot == V2_SPARE_PARKED) pthread_cond_wait(&s->cv, &g_v2_spare_mu);
+        int tid = s->slot;
+        pthread_mutex_unlock(&g_v2_spare_mu);
+        if (tid == V2_SPARE_EXIT || !thread_v2_run_slot(tid)) break;
+        if (!sched_v2_spare_park(s)) {
+            pthread_detach(pthread_self());
+            break;
+        }
+    }
+    pthread_cond_destroy(&s->cv);
+    free(s);
     return NULL;
 }
 
+static void* thread_v2_main(void* arg) {
+    if (!thread_v2_run_slot((int)(intptr_t)arg)) return NULL;
+    /* Orphaned: stay around as a spare for the next handover. */
+    v2_spare* s = (v2_spare*)calloc(1, sizeof(*s));
+    if (s && pthread_cond_init(&s->cv, NULL) == 0) {
+        s->handle = pthread_self();
+        if (sched_v2_spare_park(s)) return thread_v2_spare_main(s);
+        pthread_cond_destroy(&s->cv);
+    }
+    free(s);
+    pthread_detach(pthread_self());
+    return NULL;
+}
+
+/* A spare for a handover: a parked one, or a new thread that waits until
+ * sched_v2_spare_give. NULL if none could be created. */
+static v2_spare* sched_v2_spare_take(void) {
+    pthread_mutex_lock(&g_v2_spare_mu);
+    v2_spare* s = g_v2_spares;
+    if (s) {
+        g_v2_spares = s->next;
+        g_v2_nspares--;
+    }
+    pthread_mutex_unlock(&g_v2_spare_mu);
+    if (s) {
+        atomic_fetch_add_explicit(&g_v2_spare_reuses, 1, memory_order_relaxed);
+        return s;
+    }
+    s = (v2_spare*)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->slot = V2_SPARE_PARKED;
+    if (pthread_cond_init(&s->cv, NULL) != 0) {
+        free(s);
+        return NULL;
+    }
+    if (pthread_create(&s->handle, NULL, thread_v2_spare_main, s) != 0) {
+        pthread_cond_destroy(&s->cv);
+        free(s);
+        return NULL;
+    }
+    atomic_fetch_add_explicit(&g_v2_spare_creates, 1, memory_order_relaxed);
+    return s;
+}
+
+static void sched_v2_spare_give(v2_spare* s, int slot) {
+    pthread_mutex_lock(&g_v2_spare_mu);
+    s->slot = slot;
+    pthread_cond_signal(&s->cv);
+    pthread_mutex_unlock(&g_v2_spare_mu);
+}
+
+/* ============================================================================
+ * Slot replacement and blocking regions
+ * ============================================================================ */
+
+/* Hand slot `i` to a spare thread if it is still on generation `gen`,
+ * turning the current occupant into an orphan: it finishes the fiber it is
+ * running, sees the generation has moved, and parks as a spare (or exits).
+ * Used by sysmon to evict a worker kidnapped by a syscall and by a fiber
+ * handing its own slot off on cc_blocking_enter; the lock plus the
+ * generation check keep the two from replacing the same occupant twice.
+ * The spare is secured before the slot is touched, so a failed
+ * pthread_create leaves the occupant in place. Returns 1 if replaced. */
+static int sched_v2_replace_worker_in_place(int i, uint64_t gen) {
+    pthread_mutex_lock(&g_v2_replace_mu);
+    if (atomic_load_explicit(&g_v2.threads[i].generation, memory_order_acquire) != gen) {
+        pthread_mutex_unlock(&g_v2_replace_mu);
+        return 0;
+    }
+    v2_spare* spare = sched_v2_spare_take();
+    if (!spare) {
+        atomic_fetch_add_explicit(&g_v2_spare_create_fail, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&g_v2_replace_mu);
+        return 0;
+    }
+
+    /* The orphan is mid-fiber, not parked on slot.wake (a non-zero
+     * dispatch_epoch, or being the caller, is what got it here). Resetting
+     * wake is safe and gives the new worker a fresh counter. */
+    wake_primitive_init(&g_v2.threads[i].wake);
+    atomic_store_explicit(&g_v2.threads[i].is_idle, 0, memory_order_relaxed);
+    uint64_t asked = atomic_load_explicit(&g_v2.threads[i].preempt_epoch,
+                                          memory_order_relaxed);
+    if (asked) (void)sched_v2_preempt_clear(i, asked);
+    atomic_store_explicit(&g_v2.threads[i].dispatch_epoch, 0,
+                          memory_order_relaxed);
+    /* The new thread will set alive=1 at entry; leaving it at 1 here is
+     * intentional — the slot is never "not alive" across an eviction. */
+
+    atomic_fetch_add_explicit(&g_v2.threads[i].generation, 1,
+                              memory_order_release);
+
+    atomic_fetch_add_explicit(&g_v2_orphans_alive, 1, memory_order_relaxed);
+
+    g_v2.threads[i].handle = spare->handle;
+    sched_v2_spare_give(spare, i);
+    pthread_mutex_unlock(&g_v2_replace_mu);
+    return 1;
+}
+
+/* ============================================================================
+ * Worker placement
+ * ============================================================================ */
+
+/* Parse an affinity spec into a mode and, for explicit lists, the CPUs.
+ * Returns 0 or EINVAL. */
+static int sched_v2_parse_affinity(const char* spec, int* mode, int* cpus, int* ncpus) {
+    *ncpus = 0;
+    if (!spec || !*spec || strcmp(spec, "none") == 0) {
+        *mode = V2_AFFINITY_NONE;
+    } else if (strcmp(spec, "compact") == 0) {
+        *mode = V2_AFFINITY_COMPACT;
+    } else if (strcmp(spec, "scatter") == 0) {
+        *mode = V2_AFFINITY_SCATTER;
+    } else if (strcmp(spec, "node") == 0) {
+        *mode = V2_AFFINITY_NODE;
+    } else {
+        int n = cc_cpu_list_parse(spec, cpus, CC_TOPO_MAX_CPUS);
+        if (n <= 0) return EINVAL;
+        *mode = V2_AFFINITY_LIST;
+        *ncpus = n;
+    }
+    return 0;
+}
+
+static const char* sched_v2_affinity_name(void) {
+    switch (g_v2_affinity_mode) {
+    case V2_AFFINITY_COMPACT: return "compact";
+    case V2_AFFINITY_SCATTER: return "scatter";
+    case V2_AFFINITY_NODE:    return "node";
+    case V2_AFFINITY_LIST:    return "list";
+    default:                  return "none";
+    }
+}
+
+/* Called from sched_v2_init_impl: load the topology and lay out the CPU
+ * order workers are assigned from. An unusable spec leaves workers
+ * floating. */
+static void sched_v2_placement_init(void) {
+    const char* spec = g_v2_affinity_spec[0] ? g_v2_affinity_spec : getenv("CC_V2_AFFINITY");
+    int mode = V2_AFFINITY_NONE;
+    int n = 0;
+    if (sched_v2_parse_affinity(spec, &mode, g_v2_place_cpu, &n) != 0) {
+        fprintf(stderr, "[sched_v2] ignoring CC_V2_AFFINITY=%s\n", spec);
+        return;
+    }
+    if (mode == V2_AFFINITY_NONE) return;
+    cc_cpu_topology_load(&g_v2_topo);
+    if (mode == V2_AFFINITY_LIST) {
+        g_v2_place_n = n;
+    } else if (mode == V2_AFFINITY_SCATTER) {
+        /* Round-robin over nodes: k-th CPU of node 0, of node 1, ... */
+        int taken[CC_TOPO_MAX_CPUS] = {0};
+        while (g_v2_place_n < g_v2_topo.ncpu) {
+            for (int nd = 0; nd < CC_TOPO_MAX_NODES; nd++) {
+                for (int i = 0; i < g_v2_topo.ncpu; i++) {
+                    if (taken[i] || g_v2_topo.node[i] != nd) continue;
+                    taken[i] = 1;
+                    g_v2_place_cpu[g_v2_place_n++] = g_v2_topo.cpu[i];
+                    break;
+                }
+            }
+        }
+    } else {
+        memcpy(g_v2_place_cpu, g_v2_topo.cpu, (size_t)g_v2_topo.ncpu * sizeof(int));
+        g_v2_place_n = g_v2_topo.ncpu;
+    }
+    g_v2_affinity_mode = mode;
+    const char* nw = getenv("CC_V2_NUMA_WAKE");
+    g_v2_numa_wake = g_v2_topo.nnodes > 1 && !(nw && nw[0] == '0');
+}
+
+/* Worker entry: apply the slot's placement to the calling thread. */
+static void sched_v2_pin_worker(int tid) {
+    int k = g_v2.threads[tid].place_idx;
+    if (k < 0) return;
+    int rc;
+    if (g_v2_affinity_mode == V2_AFFINITY_NODE) {
+        int cpus[CC_TOPO_MAX_CPUS];
+        int n = 0;
+        for (int i = 0; i < g_v2_topo.ncpu; i++) {
+            if (g_v2_topo.node[i] == g_v2.threads[tid].node) cpus[n++] = g_v2_topo.cpu[i];
+        }
+        rc = cc_thread_pin_cpus(cpus, n);
+    } else {
+        rc = cc_thread_pin_cpus(&g_v2_place_cpu[k], 1);
+    }
+    if (rc == 0) V2_STAT_INC(g_v2_pinned);
+    else V2_STAT_INC(g_v2_pin_fail);
+}
+
+int sched_v2_set_affinity(const char* spec) {
+    int mode = 0, n = 0;
+    int cpus[CC_TOPO_MAX_CPUS];
+    if (!spec || strlen(spec) >= sizeof(g_v2_affinity_spec)) return EINVAL;
+    if (sched_v2_parse_affinity(spec, &mode, cpus, &n) != 0) return EINVAL;
+    if (g_v2.initialized) return EBUSY;
+    strcpy(g_v2_affinity_spec, spec[0] ? spec : "none");
+    return 0;
+}
+
+int sched_v2_worker_node(void) {
+    int tid = tls_v2_thread_id;
+    return tid >= 0 ? g_v2.threads[tid].node : -1;
+}
+
+/* Outermost enter from a fiber on a worker that still owns its slot: give
+ * the slot (and the admission count) to a replacement thread now, so the
+ * ready queue keeps draining while this thread sits in the blocking call.
+ * Nested enters, plain threads and orphans only count depth. */
+void sched_v2_blocking_enter(void) {
+    int tid = tls_v2_thread_id;
+    fiber_v2* f = tls_v2_current_fiber;
+    if (tid < 0 || !f) return;
+    if (f->blocking_depth++ > 0 || !g_v2_blocking_handoff_enabled) return;
+    if (atomic_load_explicit(&g_v2.threads[tid].generation, memory_order_relaxed)
+        != tls_v2_my_generation) {
+        return;
+    }
+    if (atomic_load_explicit(&g_v2_orphans_alive, memory_order_relaxed)
+        >= V2_ORPHAN_SAFETY_CAP) {
+        atomic_fetch_add_explicit(&g_v2_orphans_cap_hit, 1, memory_order_relaxed);
+        return;
+    }
+    if (!sched_v2_replace_worker_in_place(tid, tls_v2_my_generation)) return;
+    deadmit_running();
+    tls_v2_admission_released = 1;
+    /* The replacement is pinned where we were; don't share its CPU. */
+    if (g_v2.threads[tid].place_idx >= 0) {
+        (void)cc_thread_pin_cpus(g_v2_topo.cpu, g_v2_topo.ncpu);
+    }
+    atomic_fetch_add_explicit(&g_v2_blocking_handoffs, 1, memory_order_relaxed);
+    V2_TRACE(CC_TRACE_HANDOFF, f, 0, NULL);
+}
+
+/* Matching exit: if this thread no longer owns a slot (handed off on enter,
+ * or evicted by sysmon during the call), yield so the orphan requeues the
+ * fiber and a pool worker picks it up; the orphan then parks as a spare. */
+void sched_v2_blocking_exit(void) {
+    int tid = tls_v2_thread_id;
+    fiber_v2* f = tls_v2_current_fiber;
+    if (tid < 0 || !f || f->blocking_depth == 0) return;
+    if (--f->blocking_depth > 0) return;
+    if (atomic_load_explicit(&g_v2.threads[tid].generation, memory_order_relaxed)
+        == tls_v2_my_generation) {
+        return;
+    }
+    V2_STAT_INC(g_v2_blocking_returns);
+    sched_v2_yield();
+}
+
 /* ============================================================================
  * Sysmon
  * ============================================================================ */
@@ -1741,50 +2782,33 @@ static int sched_v2_count_idle_workers(void) {
     return idle;
 }
 
-/* Evict an aged worker from slot `i` and install a fresh replacement
- * thread into the same slot. The old worker becomes an orphan: it keeps
- * running its kidnapped fiber in the kernel syscall, then, on return to
- * the worker loop, observes that slot.generation has moved past its
- * cached value and exits. pthread_detach hands its stack to the OS for
- * self-reclaim at exit — nobody joins orphans.
+/* Evict an aged worker from slot `i` and hand the slot to a spare thread.
+ * The old worker becomes an orphan: it keeps running its kidnapped fiber
+ * in the kernel syscall, then, on return to the worker loop, observes that
+ * slot.generation has moved past its cached value and parks as a spare
+ * (see thread_v2_main), or detaches and exits if enough are parked.
  *
- * Ordering rationale (all observable by the new thread via the
- * pthread_create synchronize-with guarantee):
- *   1. detach old handle (once; handle field about to be overwritten).
+ * Ordering rationale (all observable by the spare via g_v2_spare_mu, or
+ * the pthread_create synchronize-with guarantee for a new one):
+ *   1. take a spare (parked, or newly created and waiting) before touching
+ *      the slot, so a failed pthread_create changes nothing.
  *   2. reset per-slot transient state (wake, is_idle, dispatch_epoch).
- *   3. bump slot.generation (the identity token the new thread will read
+ *   3. bump slot.generation (the identity token the spare will read
  *      at entry into tls_v2_my_generation).
- *   4. pthread_create(&slot.handle, ..., tid) — writes new handle AND
- *      releases all prior stores to the new thread.
+ *   4. store slot.handle, then give the spare the slot under
+ *      g_v2_spare_mu, which releases all prior stores to it.
  */
-static void sched_v2_sysmon_evict_worker_in_place(int i) {
-    pthread_t old_handle = g_v2.threads[i].handle;
-    pthread_detach(old_handle);
-
-    /* The orphan is mid-syscall, not parked on slot.wake (dispatch_epoch
-     * being nonzero is what qualified it for eviction). Resetting wake is
-     * safe and gives the new worker a fresh counter. */
-    wake_primitive_init(&g_v2.threads[i].wake);
-    atomic_store_explicit(&g_v2.threads[i].is_idle, 0, memory_order_relaxed);
-    atomic_store_explicit(&g_v2.threads[i].dispatch_epoch, 0,
-                          memory_order_relaxed);
-    /* The new thread will set alive=1 at entry; leaving it at 1 here is
-     * intentional — the slot is never "not alive" across an eviction. */
-
-    atomic_fetch_add_explicit(&g_v2.threads[i].generation, 1,
-                              memory_order_release);
-
-    atomic_fetch_add_explicit(&g_v2_orphans_alive, 1, memory_order_relaxed);
-    atomic_fetch_add_explicit(&g_v2_sysmon_evicted_total, 1,
-                              memory_order_relaxed);
-
-    pthread_create(&g_v2.threads[i].handle, NULL,
-                   thread_v2_main, (void*)(intptr_t)i);
-}
-
-/* Scan all active workers for ones stuck in a kidnapped fiber. Evict in
- * place — but only as many as we actually need to drain the current
- * ready-queue backlog.
+/* Scan all active workers for ones stuck on one fiber across a tick, and
+ * take back as many workers as the current ready-queue backlog needs.
+ *
+ * An aged worker is first asked to preempt: its fiber yields at the next
+ * safe point (cc_preempt_point() back-edge polls from `ccc --preempt-points`,
+ * cc_cancelled()) and goes to the back of the ready queue, so CPU-bound
+ * fibers are time-sliced on the existing workers. If the same dispatch is
+ * still running one tick after the request, the fiber is in a kidnapped
+ * syscall (or loops without safe points) and the worker is evicted in
+ * place as before. With CC_V2_PREEMPT=0, or when no TU was built with
+ * --preempt-points, eviction is immediate.
  *
  * The per-tick budget (= backlog) is critical: without it, sysmon would
  * repeatedly evict every aged worker on every tick (including freshly
@@ -1792,7 +2816,7 @@ static void sched_v2_sysmon_evict_worker_in_place(int i) {
  * cascading orphans without bound while no queued work actually runs. With
  * the budget: we only over-commit enough threads to make forward progress
  * on queued work. A long CPU-bound fiber with an empty queue is never
- * evicted (nobody is waiting on that worker anyway).
+ * preempted or evicted (nobody is waiting on that worker anyway).
  *
  * V2_ORPHAN_SAFETY_CAP is a pure safety net, not a policy knob. If the app
  * ever spawns enough simultaneous blocking fibers to bump against it, it
@@ -1802,25 +2826,53 @@ static void sched_v2_sysmon_evict_worker_in_place(int i) {
  * runs on the single sysmon thread — no atomics needed. A worker whose
  * current epoch equals the cached value AND is non-zero has been on the
  * same fiber across at least one full sysmon tick (>= 20 ms today) and
- * is flagged for in-place eviction.
+ * is asked to preempt (or, a tick later, evicted in place).
  *
- * Slot replacement (sched_v2_sysmon_evict_worker_in_place) resets
+ * Slot replacement (sched_v2_replace_worker_in_place) resets
  * dispatch_epoch to 0 and the replacement worker starts a fresh TLS
  * counter, so the stale cache entry naturally clears on the next tick. */
 static uint64_t g_v2_sysmon_last_epoch[V2_MAX_THREADS];
 
+/* The dispatch (epoch and slot generation) sysmon itself last asked to
+ * preempt, per worker. A request planted by sched_v2_prio_preempt carries
+ * the same epoch, so preempt_epoch alone cannot tell "sysmon asked a tick
+ * ago" from "a priority request landed just now"; only this can. Same
+ * single-thread ownership as the epoch cache. */
+static uint64_t g_v2_sysmon_asked_epoch[V2_MAX_THREADS];
+static uint64_t g_v2_sysmon_asked_gen[V2_MAX_THREADS];
+
 static void sched_v2_sysmon_evict_aged_workers(void) {
-    if (!atomic_load_explicit(&g_v2_sysmon_detach_enabled,
-                              memory_order_relaxed)) {
+    int detach = atomic_load_explicit(&g_v2_sysmon_detach_enabled,
+                                      memory_order_relaxed);
+    if (!detach && !g_v2_preempt_enabled) {
         return;
     }
     size_t backlog = atomic_load_explicit(&g_v2.ready_queue.count,
                                           memory_order_relaxed);
+    int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
+    /* Ask first only if something polls: an instrumented TU, or (with
+     * detach off) cc_cancelled() as the sole remaining option. */
+    int ask = g_v2_preempt_enabled &&
+              (!detach || atomic_load_explicit(&g_v2_preempt_points_tus,
+                                               memory_order_relaxed) > 0);
+
+    /* Retire requests whose dispatch ended without reaching a safe point
+     * (the fiber parked or finished): its worker has moved on. */
+    if (atomic_load_explicit(&cc__preempt_requested, memory_order_relaxed) > 0) {
+        for (int i = 0; i < n; i++) {
+            uint64_t asked = atomic_load_explicit(&g_v2.threads[i].preempt_epoch,
+                                                  memory_order_relaxed);
+            if (asked && asked != atomic_load_explicit(&g_v2.threads[i].dispatch_epoch,
+                                                       memory_order_relaxed)) {
+                (void)sched_v2_preempt_clear(i, asked);
+            }
+        }
+    }
+
     /* Zero backlog: still refresh the cache so we don't accidentally
      * flag a worker that happened to run a long fiber during a quiet
      * window and is now between dispatches. The scan is essentially
      * free (N loads from a contiguous array). */
-    int n = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
     if (backlog == 0) {
         for (int i = 0; i < n; i++) {
             g_v2_sysmon_last_epoch[i] = atomic_load_explicit(
@@ -1831,6 +2883,10 @@ static void sched_v2_sysmon_evict_aged_workers(void) {
 
     size_t budget = backlog;
     for (int i = 0; i < n; i++) {
+        /* Generation first: if the slot changes hands after this load, the
+         * replacement below fails instead of evicting the new occupant. */
+        uint64_t gen = atomic_load_explicit(&g_v2.threads[i].generation,
+                                            memory_order_acquire);
         uint64_t cur = atomic_load_explicit(&g_v2.threads[i].dispatch_epoch,
                                             memory_order_relaxed);
         uint64_t prev = g_v2_sysmon_last_epoch[i];
@@ -1840,6 +2896,29 @@ static void sched_v2_sysmon_evict_aged_workers(void) {
         if (cur == 0) continue;              /* no fiber running */
         if (cur != prev) continue;           /* dispatched something new */
 
+        if (ask) {
+            uint64_t asked = atomic_exchange_explicit(&g_v2.threads[i].preempt_epoch,
+                                                      cur, memory_order_acq_rel);
+            if (g_v2_sysmon_asked_epoch[i] != cur || g_v2_sysmon_asked_gen[i] != gen) {
+                /* First tick on this dispatch: ask, and count the worker
+                 * against the budget as if it were already free. A
+                 * priority request already pending (asked == cur) gets
+                 * the same one-tick grace. */
+                g_v2_sysmon_asked_epoch[i] = cur;
+                g_v2_sysmon_asked_gen[i] = gen;
+                if (asked == 0) {
+                    atomic_fetch_add_explicit(&cc__preempt_requested, 1,
+                                              memory_order_relaxed);
+                }
+                V2_STAT_INC(g_v2_preempt_requested);
+                budget--;
+                continue;
+            }
+            /* Asked a tick ago and still on the same dispatch. */
+            V2_STAT_INC(g_v2_preempt_escalated);
+        }
+        if (!detach) continue;
+
         int64_t live_orphans = atomic_load_explicit(&g_v2_orphans_alive,
                                                     memory_order_relaxed);
         if (live_orphans >= V2_ORPHAN_SAFETY_CAP) {
@@ -1848,7 +2927,10 @@ static void sched_v2_sysmon_evict_aged_workers(void) {
             continue;
         }
 
-        sched_v2_sysmon_evict_worker_in_place(i);
+        if (!sched_v2_replace_worker_in_place(i, gen)) continue;
+        atomic_fetch_add_explicit(&g_v2_sysmon_evicted_total, 1,
+                                  memory_order_relaxed);
+        if (cc_trace_on()) sched_v2_trace(CC_TRACE_EVICT, i, NULL, 0, NULL);
         /* Eviction resets the slot's epoch to 0; clear our cache so the
          * replacement worker starts from a clean state. */
         g_v2_sysmon_last_epoch[i] = 0;
@@ -1858,6 +2940,7 @@ static void sched_v2_sysmon_evict_aged_workers(void) {
 
 static void* sched_v2_sysmon_main(void* arg) {
     (void)arg;
+    cc__trace_set_thread_name("sysmon");
     uint64_t last_run_count = 0;
     int stall_ticks = 0;
     /* Stall diagnostic cadence scaled to the (now faster) tick interval:
@@ -1877,10 +2960,14 @@ static void* sched_v2_sysmon_main(void* arg) {
          * relaxed load when no deadlines are in flight. */
         sched_v2_wake_expired_parkers();
 
-        /* Deadlock detector: runs every tick. Internal checks (idle
-         * count + ready queue depth + first-seen timestamp) short-circuit
-         * the all_fibers walk when the system is healthy, so the
-         * amortized cost on the hot path is just two atomic loads. */
+        /* Runnext fibers whose worker has been busy for a whole tick go
+         * to the ready queue where idle workers can take them. */
+        sched_v2_sysmon_rescue_runnext();
+
+        /* Deadlock detector: runs every tick. Idle count, ready queue
+         * depth and the per-class parked counters decide; the all_fibers
+         * walk only confirms a stall that has persisted, so a healthy
+         * system never pays for it. */
         sched_v2_check_deadlock();
 
         /* Unconditional every-tick safety net: if any work is queued AND
@@ -2017,6 +3104,41 @@ static void* sched_v2_sysmon_main(void* arg) {
     return NULL;
 }
 
+/* ============================================================================
+ * Metrics snapshot
+ * ============================================================================ */
+
+/* Sums the metric shards and reads the live gauges; no locks, so fields are
+ * each exact but not mutually consistent while the scheduler runs. */
+void sched_v2_metrics_read(sched_v2_metrics* out) {
+    uint64_t sum[V2_M_COUNT];
+    v2_metrics_sum(sum);
+    memset(out, 0, sizeof(*out));
+    out->spawns = sum[V2_M_SPAWNS];
+    out->dispatches = sum[V2_M_DISPATCHES];
+    out->parks = sum[V2_M_PARKS];
+    out->unparks = sum[V2_M_UNPARKS];
+    out->yields = sum[V2_M_YIELDS];
+    out->completions = sum[V2_M_COMPLETIONS];
+    out->chan_waiters = sum[V2_M_CHAN_PARKS] > sum[V2_M_CHAN_RESUMES]
+                            ? sum[V2_M_CHAN_PARKS] - sum[V2_M_CHAN_RESUMES] : 0;
+    out->fibers_alive = out->spawns > out->completions ? out->spawns - out->completions : 0;
+
+    int nthreads = atomic_load_explicit(&g_v2.num_threads, memory_order_acquire);
+    uint64_t queued = atomic_load_explicit(&g_v2.ready_queue.count, memory_order_relaxed);
+    for (int i = 0; i < nthreads && i < V2_MAX_THREADS; i++) {
+        if (atomic_load_explicit(&g_v2.threads[i].runnext, memory_order_relaxed)) queued++;
+    }
+    out->run_queue_depth = queued;
+    out->workers = nthreads > 0 ? (uint64_t)nthreads : 0;
+    int idle = atomic_load_explicit(&g_v2.idle_workers, memory_order_relaxed);
+    out->idle_workers = idle > 0 ? (uint64_t)idle : 0;
+    int64_t orphans = atomic_load_explicit(&g_v2_orphans_alive, memory_order_relaxed);
+    out->orphan_threads = orphans > 0 ? (uint64_t)orphans : 0;
+    out->evictions = atomic_load_explicit(&g_v2_sysmon_evicted_total, memory_order_relaxed);
+    out->blocking_handoffs = atomic_load_explicit(&g_v2_blocking_handoffs, memory_order_relaxed);
+}
+
 /* ============================================================================
  * Init / shutdown
  * ============================================================================ */
@@ -2052,6 +3174,14 @@ static void sched_v2_atexit_dump_stats(void) {
             g_v2_spin_before_park,
             (unsigned long long)atomic_load_explicit(&g_v2_worker_spin_hit, memory_order_relaxed),
             (unsigned long long)atomic_load_explicit(&g_v2_worker_spin_miss, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] runnext=%s: stash=%llu hit=%llu kicked=%llu woke=%llu stolen=%llu rescued=%llu\n",
+            g_v2_runnext_enabled ? "on" : "off",
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_stash, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_hit, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_kicked, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_woke, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_stolen, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_runnext_rescued, memory_order_relaxed));
     fprintf(stderr, "[sched_v2 stats] target_active=%d running=%d: "
                     "admit_ok=%llu admit_fail=%llu wake_gated=%llu\n",
             g_v2_target_active,
@@ -2059,6 +3189,32 @@ static void sched_v2_atexit_dump_stats(void) {
             (unsigned long long)atomic_load_explicit(&g_v2_worker_admit_ok, memory_order_relaxed),
             (unsigned long long)atomic_load_explicit(&g_v2_worker_admit_fail, memory_order_relaxed),
             (unsigned long long)atomic_load_explicit(&g_v2_wake_gated_target, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] preempt=%s: requested=%llu yields=%llu escalated=%llu\n",
+            g_v2_preempt_enabled ? "on" : "off",
+            (unsigned long long)atomic_load_explicit(&g_v2_preempt_requested, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_preempt_yields, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_preempt_escalated, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] blocking_handoff=%s: handoffs=%llu returns=%llu\n",
+            g_v2_blocking_handoff_enabled ? "on" : "off",
+            (unsigned long long)atomic_load_explicit(&g_v2_blocking_handoffs, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_blocking_returns, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] spares: parked=%d reuses=%llu creates=%llu create_fail=%llu\n",
+            g_v2_nspares,
+            (unsigned long long)atomic_load_explicit(&g_v2_spare_reuses, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_spare_creates, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_spare_create_fail, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] prio: starve_limit=%d guard_pops=%llu preempts=%llu\n",
+            g_v2_prio_starve_limit,
+            (unsigned long long)g_v2.ready_queue.guard_pops,
+            (unsigned long long)atomic_load_explicit(&g_v2_prio_preempts, memory_order_relaxed));
+    fprintf(stderr, "[sched_v2 stats] affinity=%s nodes=%d numa_wake=%s: pinned=%llu pin_fail=%llu "
+                    "wake_same_node=%llu wake_other_node=%llu\n",
+            sched_v2_affinity_name(), g_v2_topo.nnodes ? g_v2_topo.nnodes : 1,
+            g_v2_numa_wake ? "on" : "off",
+            (unsigned long long)atomic_load_explicit(&g_v2_pinned, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_pin_fail, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_wake_same_node, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&g_v2_wake_other_node, memory_order_relaxed));
     fprintf(stderr, "[sched_v2 stats] sysmon_evict: evicted_total=%llu orphans_alive=%lld cap_hit=%llu\n",
             (unsigned long long)atomic_load_explicit(&g_v2_sysmon_evicted_total, memory_order_relaxed),
             (long long)atomic_load_explicit(&g_v2_orphans_alive, memory_order_relaxed),
@@ -2073,8 +3229,7 @@ static void sched_v2_init_impl(void) {
     atomic_store_explicit(&g_v2.running, 1, memory_order_release);
     atomic_store_explicit(&g_v2.idle_workers, 0, memory_order_relaxed);
     v2_queue_init(&g_v2.ready_queue);
-    pthread_mutex_init(&g_v2.all_fibers_mu, NULL);
-    g_v2.all_fibers = NULL;
+    atomic_store_explicit(&g_v2.all_fibers, NULL, memory_order_relaxed);
     wake_primitive_init(&g_v2.sysmon_wake);
 
     const char* stats_env = getenv("CC_V2_STATS");
@@ -2082,6 +3237,8 @@ static void sched_v2_init_impl(void) {
         atomic_store_explicit(&g_v2_stats_enabled, 1, memory_order_relaxed);
         atexit(sched_v2_atexit_dump_stats);
     }
+    cc__trace_init_from_env();
+    cc__prof_init_from_env();
     const char* detach_env = getenv("CC_V2_SYSMON_DETACH");
     if (detach_env && detach_env[0] == '0') {
         atomic_store_explicit(&g_v2_sysmon_detach_enabled, 0,
@@ -2108,6 +3265,26 @@ static void sched_v2_init_impl(void) {
             g_v2_wake_skip_depth = (int)v;
         }
     }
+    const char* preempt_env = getenv("CC_V2_PREEMPT");
+    if (preempt_env && preempt_env[0] == '0') {
+        g_v2_preempt_enabled = 0;
+    }
+    const char* bh_env = getenv("CC_V2_BLOCKING_HANDOFF");
+    if (bh_env && bh_env[0] == '0') {
+        g_v2_blocking_handoff_enabled = 0;
+    }
+    const char* ps_env = getenv("CC_V2_PRIO_STARVE");
+    if (ps_env && *ps_env) {
+        char* end = NULL;
+        long v = strtol(ps_env, &end, 10);
+        if (end != ps_env && v >= 0 && v <= 65536) {
+            g_v2_prio_starve_limit = (int)v;
+        }
+    }
+    const char* rn_env = getenv("CC_V2_RUNNEXT");
+    if (rn_env && rn_env[0] == '0') {
+        g_v2_runnext_enabled = 0;
+    }
     const char* sbp_env = getenv("CC_V2_SPIN_BEFORE_PARK");
     if (sbp_env) {
         char* end = NULL;
@@ -2129,6 +3306,7 @@ static void sched_v2_init_impl(void) {
         }
     }
 
+    sched_v2_placement_init();
     g_v2.max_threads = sched_v2_detect_num_threads();
     atomic_store_explicit(&g_v2.num_threads, 0, memory_order_release);
     g_v2.allow_expand = 1;
@@ -2159,16 +3337,29 @@ void sched_v2_shutdown(void) {
 
     for (int i = 0; i < n; i++) {
         /* slot.handle always points to the CURRENT worker in this slot.
-         * Evicted orphans were pthread_detached at eviction time and are
-         * no longer reachable here — they self-reclaim when their
-         * kidnapped syscall eventually returns (or when the process
-         * exits, whichever comes first). */
+         * Orphans still in their kidnapped syscall are not reachable here:
+         * when it returns they see running == 0, detach and exit (or the
+         * process exits first). */
         pthread_join(g_v2.threads[i].handle, NULL);
     }
     pthread_join(g_v2.sysmon_handle, NULL);
+
+    /* Parked spares: running is 0, so none parks after this drain. */
+    pthread_t spares[V2_SPARE_MAX];
+    int nspares = 0;
+    pthread_mutex_lock(&g_v2_spare_mu);
+    for (v2_spare* s = g_v2_spares; s; s = s->next) {
+        spares[nspares++] = s->handle;
+        s->slot = V2_SPARE_EXIT;
+        pthread_cond_signal(&s->cv);
+    }
+    g_v2_spares = NULL;
+    g_v2_nspares = 0;
+    pthread_mutex_unlock(&g_v2_spare_mu);
+    for (int i = 0; i < nspares; i++) pthread_join(spares[i], NULL);
     pthread_mutex_destroy(&g_v2.start_mu);
 
-    fiber_v2* f = g_v2.all_fibers;
+    fiber_v2* f = v2_all_fibers_head();
     while (f) {
         fiber_v2* next = f->all_next;
         wake_primitive_destroy(&f->done_wake);
@@ -2180,7 +3371,7 @@ void sched_v2_shutdown(void) {
         f = next;
     }
     atomic_store_explicit(&g_v2.free_list, NULL, memory_order_relaxed);
-    g_v2.all_fibers = NULL;
+    atomic_store_explicit(&g_v2.all_fibers, NULL, memory_order_relaxed);
     g_v2.initialized = 0;
 }
 
@@ -2268,10 +3459,9 @@ void sched_v2_debug_dump_state(const char* prefix) {
             (unsigned long long)ready_ok2,
             (unsigned long long)(ready_ok2 - ready_ok));
     fflush(stderr);
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
     size_t count_by_state[FIBER_V2_STATE_COUNT] = {0};
     size_t total = 0;
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         int base = fiber_v2_state_base(atomic_load_explicit(&f->state, memory_order_acquire));
         if (base >= 0 && base < FIBER_V2_STATE_COUNT) count_by_state[base]++;
         total++;
@@ -2285,7 +3475,7 @@ void sched_v2_debug_dump_state(const char* prefix) {
             count_by_state[FIBER_V2_PARKED],
             count_by_state[FIBER_V2_DEAD]);
     size_t shown = 0;
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         int raw = atomic_load_explicit(&f->state, memory_order_acquire);
         int base = fiber_v2_state_base(raw);
         if (base == FIBER_V2_DEAD || base == FIBER_V2_IDLE) continue;
@@ -2297,7 +3487,6 @@ void sched_v2_debug_dump_state(const char* prefix) {
                 prefix, (void*)f, fiber_v2_state_name(base), (unsigned)raw, done,
                 (void*)waiter, f->last_thread_id, f->park_reason ? f->park_reason : "-");
     }
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
     fflush(stderr);
 }
 
@@ -2348,8 +3537,24 @@ static int sched_v2_fiber_is_open_chan_recv_wait(const fiber_v2* f) {
     return cc__chan_debug_is_open(f->park_obj);
 }
 
-/* Walk the fiber list once under the all_fibers_mu, classifying parked
- * fibers. Output counters:
+/* Read the parked-fiber population per V2_PARK_* class from the counters
+ * bumped at park commit and unpark. Exact once the scheduler is quiescent,
+ * which is the only time the detector acts on it; while fibers are moving,
+ * a shard read mid-transition can be off by the transitions in flight.
+ * Costs one pass over the live shards (at most slots + orphans), reading
+ * only the PARKED_IN/OUT counters, however many workers have come and gone. */
+static void sched_v2_parked_by_class(size_t parked[V2_PARK_CLASSES]) {
+    uint64_t sum[V2_M_COUNT];
+    v2_metrics_sum_range(sum, V2_M_PARKED_IN, 2 * V2_PARK_CLASSES);
+    for (int c = 0; c < V2_PARK_CLASSES; c++) {
+        uint64_t in = sum[V2_M_PARKED_IN + c];
+        uint64_t out = sum[V2_M_PARKED_OUT + c];
+        parked[c] = in > out ? (size_t)(in - out) : 0;
+    }
+}
+
+/* Walk the fiber list once, classifying parked fibers. The detector only
+ * calls this to confirm a stall the counters reported. Output counters:
  *   *internal_parked    — parked and NOT suppressed/external-wait
  *   *suppressed_parked  — parked and deadlock_suppress_depth > 0
  *   *external_parked    — parked and external_wait_depth > 0
@@ -2368,8 +3573,7 @@ static void sched_v2_classify_parked_fibers(size_t* internal_parked,
     *suppressed_parked = 0;
     *external_parked = 0;
     *saw_only_open_recv = 1;
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         int base = fiber_v2_state_base(
             atomic_load_explicit(&f->state, memory_order_acquire));
         if (base != FIBER_V2_PARKED) continue;
@@ -2378,7 +3582,6 @@ static void sched_v2_classify_parked_fibers(size_t* internal_parked,
         (*internal_parked)++;
         if (!sched_v2_fiber_is_open_chan_recv_wait(f)) *saw_only_open_recv = 0;
     }
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
 }
 
 /* Print the same "internal parked fibers" block the V1 detector emits,
@@ -2391,8 +3594,7 @@ static void sched_v2_dump_parked_fibers_for_verdict(void) {
     size_t parked_total = 0;
     size_t internal_total = 0;
     size_t skipped_total = 0;
-    pthread_mutex_lock(&g_v2.all_fibers_mu);
-    for (fiber_v2* f = g_v2.all_fibers; f; f = f->all_next) {
+    for (fiber_v2* f = v2_all_fibers_head(); f; f = f->all_next) {
         total++;
         int base = fiber_v2_state_base(
             atomic_load_explicit(&f->state, memory_order_acquire));
@@ -2424,7 +3626,6 @@ static void sched_v2_dump_parked_fibers_for_verdict(void) {
             shown++;
         }
     }
-    pthread_mutex_unlock(&g_v2.all_fibers_mu);
     fprintf(stderr,
             "  fiber totals: total=%zu parked=%zu internal_parked=%zu "
             "skipped_parked=%zu\n",
@@ -2454,10 +3655,14 @@ void sched_v2_check_deadlock(void) {
         return;
     }
 
-    size_t internal_parked = 0, suppressed_parked = 0, external_parked = 0;
-    int saw_only_open_recv = 1;
-    sched_v2_classify_parked_fibers(&internal_parked, &suppressed_parked,
-                                    &external_parked, &saw_only_open_recv);
+    /* Cheap gate: the per-class parked counters. In a real stall nothing
+     * parks or unparks, so they are exact and agree with a walk. */
+    size_t parked[V2_PARK_CLASSES];
+    sched_v2_parked_by_class(parked);
+    size_t internal_parked = parked[V2_PARK_INTERNAL] + parked[V2_PARK_RECV];
+    size_t suppressed_parked = parked[V2_PARK_SUPPRESSED];
+    size_t external_parked = parked[V2_PARK_EXTERNAL];
+    int saw_only_open_recv = parked[V2_PARK_INTERNAL] == 0;
 
     if (internal_parked == 0) {
         /* All parks are exempt (suppressed or external-wait) — not a
@@ -2476,7 +3681,10 @@ void sched_v2_check_deadlock(void) {
      *   if (external_waits > 0 && only_open_recv_waits) { reset; return; }
      * The open-channel check is the key: if any internal park is NOT on
      * an open-channel recv, the external source has no plausible way to
-     * unblock it, so we proceed to latch the deadlock verdict. */
+     * unblock it, so we proceed to latch the deadlock verdict. The
+     * counters only know a fiber parked in a recv; closing a channel
+     * wakes its receivers, so a counted recv park is on an open channel
+     * in a quiescent system, and the confirming walk re-checks it. */
     size_t external_threads = atomic_load_explicit(&g_external_wait_threads,
                                                    memory_order_relaxed);
     size_t external_waits = external_parked + external_threads;
@@ -2498,6 +3706,17 @@ void sched_v2_check_deadlock(void) {
     }
     if (now - first < SCHED_V2_DEADLOCK_PERSIST_MS) return;
 
+    /* Confirm with one walk before the verdict: the authoritative
+     * classification, including whether each recv's channel is open. */
+    sched_v2_classify_parked_fibers(&internal_parked, &suppressed_parked,
+                                    &external_parked, &saw_only_open_recv);
+    external_waits = external_parked + external_threads;
+    if (internal_parked == 0 || (external_waits > 0 && saw_only_open_recv)) {
+        atomic_store_explicit(&g_v2_deadlock_first_seen, 0,
+                              memory_order_relaxed);
+        return;
+    }
+
     /* Claim the report slot. */
     int expected = 0;
     if (!atomic_compare_exchange_strong_explicit(
@@ -2566,11 +3785,7 @@ int sched_v2_join(fiber_v2* f, void** out_result) {
             V2_STAT_INC(g_v2_join_spin_hit);
             return sched_v2_finish_join(f, out_result);
         }
-        #if defined(__aarch64__) || defined(__arm64__)
-        __asm__ volatile("yield");
-        #elif defined(__x86_64__)
-        __asm__ volatile("pause");
-        #endif
+        v2_spin_hint();
     }
 
     if (cc__fiber_in_context()) {
@@ -2608,20 +3823,35 @@ int sched_v2_join(fiber_v2* f, void** out_result) {
  * Spawn: allocate fiber + enqueue + wake
  * ============================================================================ */
 
+int sched_v2_current_priority(void) {
+    fiber_v2* f = tls_v2_current_fiber;
+    return f ? f->prio : SCHED_V2_PRIO_NORMAL;
+}
+
+void sched_v2_set_spawn_site(void* site) {
+    fiber_v2* f = tls_v2_current_fiber;
+    if (f && site) f->spawn_site = site;
+}
+
 fiber_v2* sched_v2_spawn(void* (*fn)(void*), void* arg) {
-    return sched_v2_spawn_in_nursery(fn, arg, NULL);
+    return sched_v2_spawn_in_nursery(fn, arg, NULL, sched_v2_current_priority());
 }
 
-fiber_v2* sched_v2_spawn_in_nursery(void* (*fn)(void*), void* arg, CCNursery* nursery) {
+fiber_v2* sched_v2_spawn_in_nursery(void* (*fn)(void*), void* arg, CCNursery* nursery, int prio) {
     sched_v2_ensure_init();
 
     fiber_v2* f = fiber_v2_alloc();
     if (!f) return NULL;
 
+    if (prio < 0 || prio >= SCHED_V2_PRIO_COUNT) prio = SCHED_V2_PRIO_NORMAL;
+    f->prio = prio;
     f->entry_fn = fn;
     f->entry_arg = arg;
     f->saved_nursery = nursery;
     f->admission_nursery = nursery;
+    f->spawn_site = (void*)fn;
+    int fls_keys = atomic_load_explicit(&g_v2_fls_keys, memory_order_acquire);
+    if (fls_keys > 0) memcpy(f->fls, sched_v2_fls_slots(), (size_t)fls_keys * sizeof(void*));
     /* Do NOT create/init the coroutine here.
      *
      * We park the task on the global run queue with only fn/arg attached;
@@ -2632,6 +3862,8 @@ fiber_v2* sched_v2_spawn_in_nursery(void* (*fn)(void*), void* arg, CCNursery* nu
      * so the number of fresh mco_create calls is bounded by the number of
      * workers that can ever be running concurrently, not by the shape of
      * the producer. */
+    v2_metric_inc(V2_M_SPAWNS);
+    V2_TRACE(CC_TRACE_SPAWN, f, sched_v2_trace_id(tls_v2_current_fiber), NULL);
     atomic_store_explicit(&f->state, FIBER_V2_QUEUED, memory_order_release);
 
     sched_v2_enqueue_runnable(f);
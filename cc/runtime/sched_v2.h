@@ -31,14 +31,31 @@ enum {
     FIBER_V2_DEAD    = 4,
 };
 
+/* Priority classes; the values match CCPriority (cc_sched.cch). Each class
+ * has its own lane in the ready queue. */
+enum {
+    SCHED_V2_PRIO_INTERACTIVE = 0,
+    SCHED_V2_PRIO_NORMAL      = 1,
+    SCHED_V2_PRIO_BATCH       = 2,
+    SCHED_V2_PRIO_COUNT       = 3,
+};
+
+/* Fiber-local storage slots per fiber; matches CC_FLS_KEYS (cc_sched.cch). */
+#define SCHED_V2_FLS_KEYS 16
+
 /* Public API */
 void   sched_v2_ensure_init(void);
-fiber_v2* sched_v2_spawn(void* (*fn)(void*), void* arg);
-fiber_v2* sched_v2_spawn_in_nursery(void* (*fn)(void*), void* arg, CCNursery* nursery);
+fiber_v2* sched_v2_spawn(void* (*fn)(void*), void* arg); /* inherits the caller's class */
+fiber_v2* sched_v2_spawn_in_nursery(void* (*fn)(void*), void* arg, CCNursery* nursery, int prio);
+int    sched_v2_current_priority(void); /* SCHED_V2_PRIO_NORMAL off-fiber */
+void   sched_v2_set_spawn_site(void* site); /* closure trampolines: profile under the body */
 int    sched_v2_join(fiber_v2* f, void** out_result);
 void   sched_v2_signal(fiber_v2* f);
 void   sched_v2_park(void);
 void   sched_v2_yield(void);
+void   sched_v2_preempt_point(void); /* yield if sysmon asked this dispatch to */
+void   sched_v2_blocking_enter(void); /* hand the worker slot off for a blocking call */
+void   sched_v2_blocking_exit(void);  /* ...and get back onto a pool worker */
 void   sched_v2_set_park_reason(const char* reason);
 int    sched_v2_in_context(void);
 fiber_v2* sched_v2_current_fiber(void);
@@ -46,9 +63,26 @@ CCNursery* sched_v2_current_nursery(void);
 void*  sched_v2_current_deadline_scope(void);
 void*  sched_v2_deadline_scope_push(void* d);
 void   sched_v2_deadline_scope_pop(void* prev);
+int    sched_v2_fls_key_create(void);  /* next slot index, -1 when all are taken */
+int    sched_v2_fls_key_count(void);
+void** sched_v2_fls_slots(void);       /* the current fiber's row, or this thread's */
 int    sched_v2_current_worker_id(void); /* -1 if not on a V2 worker thread */
+int    sched_v2_set_affinity(const char* spec); /* before init; 0, EINVAL or EBUSY */
+int    sched_v2_worker_node(void);        /* -1 off-worker or when unpinned */
 void   sched_v2_shutdown(void);
 
+/* Scheduler half of cc_runtime_metrics_snapshot (metrics.c). Counters are
+ * totals since start; the rest are gauges. */
+typedef struct {
+    uint64_t spawns, dispatches, parks, unparks, yields, completions;
+    uint64_t fibers_alive;      /* spawned and not yet returned */
+    uint64_t chan_waiters;      /* fibers parked in a channel operation */
+    uint64_t run_queue_depth;   /* ready queue plus occupied runnext slots */
+    uint64_t workers, idle_workers, orphan_threads;
+    uint64_t evictions, blocking_handoffs;
+} sched_v2_metrics;
+void   sched_v2_metrics_read(sched_v2_metrics* out);
+
 /* Accessors for task.c integration */
 int    sched_v2_fiber_done(fiber_v2* f);
 void*  sched_v2_fiber_result(fiber_v2* f);
@@ -71,8 +105,9 @@ void   sched_v2_debug_dump_state(const char* prefix);
  * can classify it correctly even if the fiber migrates workers between
  * park and resume. All setters are no-ops on NULL.
  *
- * Reads go through sched_v2_deadlock_snapshot (below), which walks
- * g_v2.all_fibers under the all_fibers_mu. */
+ * The detector counts parked fibers per class at park commit and unpark,
+ * and walks g_v2.all_fibers (lock-free, push-only) only to confirm a
+ * stall. */
 void   sched_v2_fiber_set_park_obj(fiber_v2* f, void* obj);
 void   sched_v2_fiber_inc_deadlock_suppress(fiber_v2* f);
 void   sched_v2_fiber_dec_deadlock_suppress(fiber_v2* f);
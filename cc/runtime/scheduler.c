@@ -102,6 +102,20 @@ int cc_scheduler_stats(CCSchedulerStats* out) {
     return 0;
 }
 
+/* Thread-pool half of cc_runtime_metrics_snapshot. Unlike cc_scheduler_stats
+ * it never creates the pool: zeros until the first cc_thread_spawn. */
+void cc__sched_exec_metrics(size_t* workers, size_t* queue_len) {
+    *workers = 0;
+    *queue_len = 0;
+    pthread_mutex_lock(&g_sched_mu);
+    CCExecStats stats;
+    if (g_sched_exec && cc_exec_stats(g_sched_exec, &stats) == 0) {
+        *workers = stats.workers;
+        *queue_len = stats.queue_len;
+    }
+    pthread_mutex_unlock(&g_sched_mu);
+}
+
 static void cc__spawn_task_free_internal(struct CCSpawnTask* task) {
     if (!task) return;
     pthread_mutex_destroy(&task->mu);
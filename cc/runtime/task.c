@@ -450,6 +450,7 @@ CCTask cc_fiber_spawn_task(void* (*fn)(void*), void* arg) {
 /* Helper function that unpacks and calls a closure for fibers */
 static void* cc__fiber_closure0_wrapper(void* arg) {
     CCClosure0* pc = (CCClosure0*)arg;
+    sched_v2_set_spawn_site((void*)pc->fn);
     void* result = pc->fn(pc->env);
     if (pc->drop) pc->drop(pc->env);
     free(pc);
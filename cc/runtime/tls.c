@@ -2,24 +2,43 @@
  * Concurrent-C TLS Runtime
  *
  * BearSSL integration for TLS client/server.
- * 
+ *
  * BearSSL characteristics that make it ideal for CC:
  * - No dynamic allocation (caller provides all buffers)
  * - Explicit state machine (no callbacks for I/O)
  * - Small code size (~30KB for full TLS 1.2)
  * - MIT license
+ *
+ * Engine I/O goes through br_sslio with callbacks that read/write the
+ * engine's own record buffer via cc_socket_read_into/cc_socket_write, so a
+ * handshake or record never allocates and parks the calling fiber (not the
+ * worker) while the socket is not ready.
+ *
+ * Session resumption (BearSSL resumes by session ID; it has no tickets):
+ *   client  per-peer cache keyed by "<peer ip:port>/<server name>", used
+ *           when CCTlsClientConfig.resume_session is set.
+ *   server  one process-wide LRU shared by every cc_tls_accept.
+ *           CC_TLS_SERVER_SESSION_CACHE=<bytes> sizes it (0 disables;
+ *           default 256 KiB, roughly 2500 sessions).
  */
 
 #include <ccc/std/tls.cch>
 #include <ccc/std/net.cch>
+#include "io_wait.h"
 
 /* BearSSL includes */
 #ifdef CC_HAS_BEARSSL
 #include <bearssl.h>
 #endif
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/socket.h>
 
 /* ============================================================================
  * Internal Helpers
@@ -27,32 +46,695 @@
 
 #ifdef CC_HAS_BEARSSL
 
-/* Low-level I/O: read from socket into BearSSL engine */
+#define CC__TLS_CACHE_KEY_MAX 320
+#define CC__TLS_CLIENT_CACHE_SLOTS 64
+#define CC__TLS_SERVER_CACHE_DEFAULT (256u * 1024u)
+
+struct CCTlsCertChain {
+    br_x509_certificate* certs;
+    size_t count;
+};
+
+struct CCTlsPrivateKey {
+    unsigned key_type;  /* BR_KEYTYPE_RSA or BR_KEYTYPE_EC */
+    br_rsa_private_key rsa;
+    br_ec_private_key ec;
+};
+
+struct CCTlsTrustAnchors {
+    br_x509_trust_anchor* anchors;
+    size_t count;
+};
+
+/* Per-connection state behind CCTlsConn.ctx. The engine union must stay the
+ * first member: the server session cache hooks only receive the
+ * br_ssl_server_context* and recover the connection from it. */
+typedef struct cc__tls_state {
+    union {
+        br_ssl_client_context client;
+        br_ssl_server_context server;
+    } u;
+    br_x509_minimal_context x509;
+    br_sslio_context io;
+    CCSocket sock;
+    CCNetError io_err;  /* Last socket error seen by br_low_read/br_low_write */
+    int is_server;
+    int resumed;
+    char server_name[256];
+    char cache_key[CC__TLS_CACHE_KEY_MAX];
+    CCTlsInfo info;
+} cc__tls_state;
+
+static br_ssl_engine_context* cc__tls_engine(cc__tls_state* st) {
+    return st->is_server ? &st->u.server.eng : &st->u.client.eng;
+}
+
+/* Low-level I/O: read from socket straight into the BearSSL engine buffer.
+ * cc_socket_read_into parks the fiber on EAGAIN. EOF is reported as -1:
+ * br_sslio treats a 0 return as "try again". */
 static int br_low_read(void* ctx, unsigned char* buf, size_t len) {
-    CCSocket* sock = (CCSocket*)ctx;
-    CCNetError err;
-    CCSlice data = cc_socket_read(sock, NULL, len, &err);  /* TODO: need temp arena */
-    if (err != CC_NET_OK) {
+    cc__tls_state* st = (cc__tls_state*)ctx;
+    CCNetError err = CC_NET_OK;
+    size_t n = cc_socket_read_into(&st->sock, (char*)buf, len, &err);
+    if (err != CC_NET_OK || n == 0) {
+        st->io_err = err != CC_NET_OK ? err : CC_NET_CONNECTION_CLOSED;
         return -1;
     }
-    if (data.len == 0) {
-        return 0;  /* EOF */
-    }
-    memcpy(buf, data.ptr, data.len);
-    return (int)data.len;
+    return (int)n;
 }
 
 /* Low-level I/O: write from BearSSL engine to socket */
 static int br_low_write(void* ctx, const unsigned char* buf, size_t len) {
-    CCSocket* sock = (CCSocket*)ctx;
-    CCNetError err;
-    size_t written = cc_socket_write(sock, (const char*)buf, len, &err);
-    if (err != CC_NET_OK) {
+    cc__tls_state* st = (cc__tls_state*)ctx;
+    CCNetError err = CC_NET_OK;
+    size_t written = cc_socket_write(&st->sock, (const char*)buf, len, &err);
+    if (err != CC_NET_OK || written == 0) {
+        st->io_err = err != CC_NET_OK ? err : CC_NET_OTHER;
         return -1;
     }
     return (int)written;
 }
 
+/* Map the engine's last error onto CCNetError. I/O failures surface the
+ * socket error the callbacks recorded (timeouts, cancellation, resets). */
+static CCNetError cc__tls_engine_error(cc__tls_state* st, int in_handshake) {
+    int err = br_ssl_engine_last_error(cc__tls_engine(st));
+    if (err == BR_ERR_OK) return CC_NET_CONNECTION_CLOSED;
+    if (err == BR_ERR_IO) return st->io_err != CC_NET_OK ? st->io_err : CC_NET_OTHER;
+    if (err > BR_ERR_X509_OK && err < BR_ERR_RECV_FATAL_ALERT) return CC_NET_TLS_CERTIFICATE_ERROR;
+    return in_handshake ? CC_NET_TLS_HANDSHAKE_FAILED : CC_NET_OTHER;
+}
+
+/* ============================================================================
+ * Session Caches
+ * ============================================================================ */
+
+typedef struct {
+    char key[CC__TLS_CACHE_KEY_MAX];
+    br_ssl_session_parameters params;
+    uint64_t stamp;  /* 0 = empty slot */
+} cc__tls_client_session;
+
+static struct {
+    pthread_mutex_t mu;
+    uint64_t clock;
+    cc__tls_client_session slots[CC__TLS_CLIENT_CACHE_SLOTS];
+} g_cc_tls_client_cache = { .mu = PTHREAD_MUTEX_INITIALIZER };
+
+static int cc__tls_client_cache_get(const char* key, br_ssl_session_parameters* out) {
+    int found = 0;
+    pthread_mutex_lock(&g_cc_tls_client_cache.mu);
+    for (size_t i = 0; i < CC__TLS_CLIENT_CACHE_SLOTS; ++i) {
+        cc__tls_client_session* s = &g_cc_tls_client_cache.slots[i];
+        if (s->stamp && strcmp(s->key, key) == 0) {
+            s->stamp = ++g_cc_tls_client_cache.clock;
+            *out = s->params;
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_cc_tls_client_cache.mu);
+    return found;
+}
+
+/* Insert or refresh; evicts the least recently used slot when full. A NULL
+ * params drops the entry (failed resumption, so don't offer it again). */
+static void cc__tls_client_cache_put(const char* key, const br_ssl_session_parameters* params) {
+    pthread_mutex_lock(&g_cc_tls_client_cache.mu);
+    cc__tls_client_session* victim = NULL;
+    for (size_t i = 0; i < CC__TLS_CLIENT_CACHE_SLOTS; ++i) {
+        cc__tls_client_session* s = &g_cc_tls_client_cache.slots[i];
+        if (s->stamp && strcmp(s->key, key) == 0) {
+            victim = s;
+            break;
+        }
+        if (!victim || s->stamp < victim->stamp) victim = s;
+    }
+    if (!params) {
+        if (victim && victim->stamp && strcmp(victim->key, key) == 0) victim->stamp = 0;
+    } else if (victim && params->session_id_len > 0) {
+        snprintf(victim->key, sizeof(victim->key), "%s", key);
+        victim->params = *params;
+        victim->stamp = ++g_cc_tls_client_cache.clock;
+    }
+    pthread_mutex_unlock(&g_cc_tls_client_cache.mu);
+}
+
+/* Server side: BearSSL's LRU cache is not thread-safe, so every accept goes
+ * through this locking wrapper around one shared instance. */
+static struct {
+    const br_ssl_session_cache_class* vtable;  /* Must be first */
+    pthread_mutex_t mu;
+    pthread_once_t once;
+    br_ssl_session_cache_lru lru;
+    unsigned char* store;
+    size_t store_len;
+} g_cc_tls_server_cache = { .mu = PTHREAD_MUTEX_INITIALIZER, .once = PTHREAD_ONCE_INIT };
+
+static void cc__tls_server_cache_save(const br_ssl_session_cache_class** ctx,
+                                      br_ssl_server_context* server_ctx,
+                                      const br_ssl_session_parameters* params) {
+    (void)ctx;
+    pthread_mutex_lock(&g_cc_tls_server_cache.mu);
+    g_cc_tls_server_cache.lru.vtable->save(&g_cc_tls_server_cache.lru.vtable, server_ctx, params);
+    pthread_mutex_unlock(&g_cc_tls_server_cache.mu);
+}
+
+static int cc__tls_server_cache_load(const br_ssl_session_cache_class** ctx,
+                                     br_ssl_server_context* server_ctx,
+                                     br_ssl_session_parameters* params) {
+    (void)ctx;
+    pthread_mutex_lock(&g_cc_tls_server_cache.mu);
+    int hit = g_cc_tls_server_cache.lru.vtable->load(&g_cc_tls_server_cache.lru.vtable, server_ctx, params);
+    pthread_mutex_unlock(&g_cc_tls_server_cache.mu);
+    if (hit) ((cc__tls_state*)(void*)server_ctx)->resumed = 1;
+    return hit;
+}
+
+static const br_ssl_session_cache_class cc__tls_server_cache_class = {
+    sizeof(g_cc_tls_server_cache),
+    cc__tls_server_cache_save,
+    cc__tls_server_cache_load,
+};
+
+static void cc__tls_server_cache_init(void) {
+    size_t bytes = CC__TLS_SERVER_CACHE_DEFAULT;
+    const char* v = getenv("CC_TLS_SERVER_SESSION_CACHE");
+    if (v && v[0]) bytes = (size_t)strtoull(v, NULL, 10);
+    if (bytes == 0) return;
+    g_cc_tls_server_cache.store = (unsigned char*)malloc(bytes);
+    if (!g_cc_tls_server_cache.store) return;
+    g_cc_tls_server_cache.store_len = bytes;
+    br_ssl_session_cache_lru_init(&g_cc_tls_server_cache.lru, g_cc_tls_server_cache.store, bytes);
+    g_cc_tls_server_cache.vtable = &cc__tls_server_cache_class;
+}
+
+static const br_ssl_session_cache_class** cc__tls_server_cache(void) {
+    pthread_once(&g_cc_tls_server_cache.once, cc__tls_server_cache_init);
+    return g_cc_tls_server_cache.vtable ? &g_cc_tls_server_cache.vtable : NULL;
+}
+
+/* "<peer ip:port>/<server name>": the same name behind a different address
+ * is a different server as far as session IDs are concerned. */
+static void cc__tls_client_cache_key(cc__tls_state* st) {
+    struct sockaddr_storage sa;
+    socklen_t sa_len = sizeof(sa);
+    char ip[INET6_ADDRSTRLEN] = "?";
+    int port = 0;
+    if (getpeername(st->sock.fd, (struct sockaddr*)&sa, &sa_len) == 0) {
+        if (sa.ss_family == AF_INET) {
+            struct sockaddr_in* in = (struct sockaddr_in*)&sa;
+            inet_ntop(AF_INET, &in->sin_addr, ip, sizeof(ip));
+            port = ntohs(in->sin_port);
+        } else if (sa.ss_family == AF_INET6) {
+            struct sockaddr_in6* in6 = (struct sockaddr_in6*)&sa;
+            inet_ntop(AF_INET6, &in6->sin6_addr, ip, sizeof(ip));
+            port = ntohs(in6->sin6_port);
+        }
+    }
+    snprintf(st->cache_key, sizeof(st->cache_key), "%s:%d/%s", ip, port, st->server_name);
+}
+
+/* ============================================================================
+ * Credential Decoding
+ * ============================================================================ */
+
+typedef struct {
+    unsigned char* data;
+    size_t len;
+    size_t cap;
+    int failed;
+} cc__tls_blob;
+
+static void cc__tls_blob_append(void* ctx, const void* src, size_t len) {
+    cc__tls_blob* b = (cc__tls_blob*)ctx;
+    if (b->failed || len == 0) return;
+    if (b->len + len > b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 1024;
+        while (cap < b->len + len) cap *= 2;
+        unsigned char* p = (unsigned char*)realloc(b->data, cap);
+        if (!p) {
+            b->failed = 1;
+            return;
+        }
+        b->data = p;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, src, len);
+    b->len += len;
+}
+
+static void cc__tls_discard(void* ctx, const void* src, size_t len) {
+    (void)ctx;
+    (void)src;
+    (void)len;
+}
+
+static void* cc__tls_arena_dup(CCArena* arena, const void* src, size_t len) {
+    if (len == 0) return NULL;
+    void* p = cc_arena_alloc(arena, len, 1);
+    if (p) memcpy(p, src, len);
+    return p;
+}
+
+static int cc__tls_read_file(const char* path, size_t path_len, cc__tls_blob* out) {
+    char buf[4096];
+    if (!path || path_len == 0 || path_len >= sizeof(buf)) return -1;
+    memcpy(buf, path, path_len);
+    buf[path_len] = '\0';
+    FILE* f = fopen(buf, "rb");
+    if (!f) return -1;
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) cc__tls_blob_append(out, buf, n);
+    fclose(f);
+    return out->failed || out->len == 0 ? -1 : 0;
+}
+
+/* Call fn for every DER object in a PEM file (name = PEM label), or once with
+ * name NULL when the input is raw DER. Returns -1 on malformed input or when
+ * fn fails. */
+typedef int (*cc__tls_der_fn)(void* ud, const char* name, const unsigned char* der, size_t len);
+
+static int cc__tls_decode_objects(const unsigned char* buf, size_t len, cc__tls_der_fn fn, void* ud) {
+    int is_pem = 0;
+    for (size_t i = 0; i + 10 <= len; ++i) {
+        if (memcmp(buf + i, "-----BEGIN", 10) == 0) {
+            is_pem = 1;
+            break;
+        }
+    }
+    if (!is_pem) return fn(ud, NULL, buf, len);
+
+    br_pem_decoder_context pc;
+    br_pem_decoder_init(&pc);
+    cc__tls_blob obj = {0};
+    char name[128] = "";
+    int in_obj = 0, rc = 0, tail = 0;
+    while (rc == 0) {
+        if (len == 0) {
+            /* Feed a final newline so a file without one still closes its object. */
+            if (tail++) break;
+            buf = (const unsigned char*)"\n";
+            len = 1;
+        }
+        size_t used = br_pem_decoder_push(&pc, buf, len);
+        buf += used;
+        len -= used;
+        switch (br_pem_decoder_event(&pc)) {
+            case BR_PEM_BEGIN_OBJ:
+                snprintf(name, sizeof(name), "%s", br_pem_decoder_name(&pc));
+                obj.len = 0;
+                in_obj = 1;
+                br_pem_decoder_setdest(&pc, cc__tls_blob_append, &obj);
+                break;
+            case BR_PEM_END_OBJ:
+                if (in_obj) {
+                    rc = obj.failed ? -1 : fn(ud, name, obj.data, obj.len);
+                    in_obj = 0;
+                }
+                break;
+            case BR_PEM_ERROR:
+                rc = -1;
+                break;
+            default:
+                break;
+        }
+    }
+    free(obj.data);
+    return in_obj ? -1 : rc;
+}
+
+typedef struct {
+    CCArena* arena;
+    br_x509_certificate* certs;
+    size_t count;
+    size_t cap;
+} cc__tls_cert_list;
+
+static int cc__tls_collect_cert(void* ud, const char* name, const unsigned char* der, size_t len) {
+    cc__tls_cert_list* l = (cc__tls_cert_list*)ud;
+    if (name && strcmp(name, "CERTIFICATE") != 0 && strcmp(name, "X509 CERTIFICATE") != 0) return 0;
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 4;
+        br_x509_certificate* p = (br_x509_certificate*)realloc(l->certs, cap * sizeof(*p));
+        if (!p) return -1;
+        l->certs = p;
+        l->cap = cap;
+    }
+    unsigned char* data = (unsigned char*)cc__tls_arena_dup(l->arena, der, len);
+    if (!data) return -1;
+    l->certs[l->count].data = data;
+    l->certs[l->count].data_len = len;
+    l->count++;
+    return 0;
+}
+
+static int cc__tls_load_certs(CCArena* arena, const char* path, size_t path_len, cc__tls_cert_list* out) {
+    cc__tls_blob file = {0};
+    memset(out, 0, sizeof(*out));
+    out->arena = arena;
+    int rc = cc__tls_read_file(path, path_len, &file);
+    if (rc == 0) rc = cc__tls_decode_objects(file.data, file.len, cc__tls_collect_cert, out);
+    free(file.data);
+    if (rc == 0 && out->count == 0) rc = -1;
+    if (rc != 0) {
+        free(out->certs);
+        out->certs = NULL;
+        out->count = 0;
+    }
+    return rc;
+}
+
+typedef struct {
+    CCArena* arena;
+    CCTlsPrivateKey* key;
+} cc__tls_key_slot;
+
+static int cc__tls_collect_key(void* ud, const char* name, const unsigned char* der, size_t len) {
+    cc__tls_key_slot* slot = (cc__tls_key_slot*)ud;
+    if (slot->key) return 0;  /* First key wins */
+    if (name && strcmp(name, "RSA PRIVATE KEY") != 0 && strcmp(name, "EC PRIVATE KEY") != 0 &&
+        strcmp(name, "PRIVATE KEY") != 0) {
+        return 0;
+    }
+    br_skey_decoder_context dc;
+    br_skey_decoder_init(&dc);
+    br_skey_decoder_push(&dc, der, len);
+    if (br_skey_decoder_last_error(&dc) != 0) return -1;
+
+    CCTlsPrivateKey* k = (CCTlsPrivateKey*)cc_arena_alloc(slot->arena, sizeof(*k), _Alignof(CCTlsPrivateKey));
+    if (!k) return -1;
+    memset(k, 0, sizeof(*k));
+    k->key_type = (unsigned)br_skey_decoder_key_type(&dc);
+    if (k->key_type == BR_KEYTYPE_RSA) {
+        const br_rsa_private_key* rk = br_skey_decoder_get_rsa(&dc);
+        k->rsa.n_bitlen = rk->n_bitlen;
+        k->rsa.p = cc__tls_arena_dup(slot->arena, rk->p, rk->plen);
+        k->rsa.plen = rk->plen;
+        k->rsa.q = cc__tls_arena_dup(slot->arena, rk->q, rk->qlen);
+        k->rsa.qlen = rk->qlen;
+        k->rsa.dp = cc__tls_arena_dup(slot->arena, rk->dp, rk->dplen);
+        k->rsa.dplen = rk->dplen;
+        k->rsa.dq = cc__tls_arena_dup(slot->arena, rk->dq, rk->dqlen);
+        k->rsa.dqlen = rk->dqlen;
+        k->rsa.iq = cc__tls_arena_dup(slot->arena, rk->iq, rk->iqlen);
+        k->rsa.iqlen = rk->iqlen;
+        if (!k->rsa.p || !k->rsa.q || !k->rsa.dp || !k->rsa.dq || !k->rsa.iq) return -1;
+    } else if (k->key_type == BR_KEYTYPE_EC) {
+        const br_ec_private_key* ek = br_skey_decoder_get_ec(&dc);
+        k->ec.curve = ek->curve;
+        k->ec.x = cc__tls_arena_dup(slot->arena, ek->x, ek->xlen);
+        k->ec.xlen = ek->xlen;
+        if (!k->ec.x) return -1;
+    } else {
+        return -1;
+    }
+    slot->key = k;
+    return 0;
+}
+
+typedef struct {
+    CCArena* arena;
+    br_x509_trust_anchor* anchors;
+    size_t count;
+    size_t cap;
+} cc__tls_anchor_list;
+
+static int cc__tls_collect_anchor(void* ud, const char* name, const unsigned char* der, size_t len) {
+    cc__tls_anchor_list* l = (cc__tls_anchor_list*)ud;
+    if (name && strcmp(name, "CERTIFICATE") != 0 && strcmp(name, "X509 CERTIFICATE") != 0) return 0;
+
+    cc__tls_blob dn = {0};
+    br_x509_decoder_context dc;
+    br_x509_decoder_init(&dc, cc__tls_blob_append, &dn);
+    br_x509_decoder_push(&dc, der, len);
+    const br_x509_pkey* pk = br_x509_decoder_get_pkey(&dc);
+    if (!pk || dn.failed) {
+        /* Skip certificates BearSSL cannot use rather than failing the bundle. */
+        free(dn.data);
+        return 0;
+    }
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 64;
+        br_x509_trust_anchor* p = (br_x509_trust_anchor*)realloc(l->anchors, cap * sizeof(*p));
+        if (!p) {
+            free(dn.data);
+            return -1;
+        }
+        l->anchors = p;
+        l->cap = cap;
+    }
+    br_x509_trust_anchor* ta = &l->anchors[l->count];
+    memset(ta, 0, sizeof(*ta));
+    ta->dn.data = (unsigned char*)cc__tls_arena_dup(l->arena, dn.data, dn.len);
+    ta->dn.len = dn.len;
+    free(dn.data);
+    ta->flags = br_x509_decoder_isCA(&dc) ? BR_X509_TA_CA : 0;
+    ta->pkey.key_type = pk->key_type;
+    if (pk->key_type == BR_KEYTYPE_RSA) {
+        ta->pkey.key.rsa.n = (unsigned char*)cc__tls_arena_dup(l->arena, pk->key.rsa.n, pk->key.rsa.nlen);
+        ta->pkey.key.rsa.nlen = pk->key.rsa.nlen;
+        ta->pkey.key.rsa.e = (unsigned char*)cc__tls_arena_dup(l->arena, pk->key.rsa.e, pk->key.rsa.elen);
+        ta->pkey.key.rsa.elen = pk->key.rsa.elen;
+        if (!ta->pkey.key.rsa.n || !ta->pkey.key.rsa.e) return -1;
+    } else {
+        ta->pkey.key.ec.curve = pk->key.ec.curve;
+        ta->pkey.key.ec.q = (unsigned char*)cc__tls_arena_dup(l->arena, pk->key.ec.q, pk->key.ec.qlen);
+        ta->pkey.key.ec.qlen = pk->key.ec.qlen;
+        if (!ta->pkey.key.ec.q) return -1;
+    }
+    if (!ta->dn.data && dn.len) return -1;
+    l->count++;
+    return 0;
+}
+
+static CCTlsTrustAnchors* cc__tls_anchors_finish(CCArena* arena, cc__tls_anchor_list* l) {
+    CCTlsTrustAnchors* tas = (CCTlsTrustAnchors*)cc_arena_alloc(arena, sizeof(*tas), _Alignof(CCTlsTrustAnchors));
+    if (tas) {
+        tas->count = l->count;
+        tas->anchors = l->count ? (br_x509_trust_anchor*)cc_arena_alloc(arena, l->count * sizeof(br_x509_trust_anchor),
+                                                                     _Alignof(br_x509_trust_anchor))
+                                : NULL;
+        if (l->count && !tas->anchors) tas = NULL;
+        else if (l->count) memcpy(tas->anchors, l->anchors, l->count * sizeof(br_x509_trust_anchor));
+    }
+    free(l->anchors);
+    l->anchors = NULL;
+    return tas;
+}
+
+/* ============================================================================
+ * Credential Cache
+ * ============================================================================ */
+
+/* Parsed credentials are kept for the life of the process so accept/connect
+ * do not re-read and re-decode PEM files per connection. */
+typedef struct cc__tls_cred_entry {
+    struct cc__tls_cred_entry* next;
+    char* cert_path;  /* CA path for client anchors ("" = system roots) */
+    char* key_path;   /* NULL for client anchors */
+    CCTlsCertChain* chain;
+    CCTlsPrivateKey* key;
+    unsigned issuer_key_type;
+    CCTlsTrustAnchors* anchors;
+} cc__tls_cred_entry;
+
+static pthread_mutex_t g_cc_tls_cred_mu = PTHREAD_MUTEX_INITIALIZER;
+static CCArena g_cc_tls_cred_arena;
+static cc__tls_cred_entry* g_cc_tls_creds = NULL;
+
+static const char* const cc__tls_system_ca_paths[] = {
+    "/etc/ssl/certs/ca-certificates.crt",
+    "/etc/pki/tls/certs/ca-bundle.crt",
+    "/etc/ssl/ca-bundle.pem",
+    "/etc/ssl/cert.pem",
+    NULL,
+};
+
+static int cc__tls_path_eq(const char* stored, const char* path, size_t path_len) {
+    if (!stored) return path == NULL;
+    return path && strlen(stored) == path_len && memcmp(stored, path, path_len) == 0;
+}
+
+static char* cc__tls_cred_strdup(const char* s, size_t len) {
+    char* out = (char*)cc_arena_alloc(&g_cc_tls_cred_arena, len + 1, 1);
+    if (out) {
+        if (len) memcpy(out, s, len);
+        out[len] = '\0';
+    }
+    return out;
+}
+
+/* Callers hold g_cc_tls_cred_mu. */
+static cc__tls_cred_entry* cc__tls_cred_lookup(const char* cert_path, size_t cert_len,
+                                               const char* key_path, size_t key_len) {
+    if (!g_cc_tls_cred_arena.base) g_cc_tls_cred_arena = cc_arena_heap(64 * 1024);
+    if (!g_cc_tls_cred_arena.base) return NULL;
+    for (cc__tls_cred_entry* e = g_cc_tls_creds; e; e = e->next) {
+        if (cc__tls_path_eq(e->cert_path, cert_path, cert_len) && cc__tls_path_eq(e->key_path, key_path, key_len)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static cc__tls_cred_entry* cc__tls_cred_insert(const char* cert_path, size_t cert_len,
+                                               const char* key_path, size_t key_len) {
+    cc__tls_cred_entry* e = (cc__tls_cred_entry*)cc_arena_alloc(&g_cc_tls_cred_arena, sizeof(*e),
+                                                                _Alignof(cc__tls_cred_entry));
+    if (!e) return NULL;
+    memset(e, 0, sizeof(*e));
+    e->cert_path = cc__tls_cred_strdup(cert_path ? cert_path : "", cert_path ? cert_len : 0);
+    e->key_path = key_path ? cc__tls_cred_strdup(key_path, key_len) : NULL;
+    return e;
+}
+
+static const CCTlsTrustAnchors* cc__tls_client_anchors(const char* ca_path, size_t ca_len, CCNetError* out_err) {
+    if (!ca_path) ca_len = 0;
+    if (ca_len == 0) ca_path = "";
+    pthread_mutex_lock(&g_cc_tls_cred_mu);
+    cc__tls_cred_entry* e = cc__tls_cred_lookup(ca_path, ca_len, NULL, 0);
+    if (!e) {
+        CCTlsTrustAnchors* tas = NULL;
+        CCNetError err = CC_NET_OK;
+        if (ca_len > 0) {
+            tas = cc_tls_load_trust_anchors(&g_cc_tls_cred_arena, ca_path, ca_len, &err);
+        } else {
+            /* System roots: first bundle that parses. An empty set still lets
+             * the handshake run and fail with a certificate error. */
+            for (size_t i = 0; cc__tls_system_ca_paths[i] && !tas; ++i) {
+                const char* p = cc__tls_system_ca_paths[i];
+                tas = cc_tls_load_trust_anchors(&g_cc_tls_cred_arena, p, strlen(p), &err);
+            }
+            if (!tas) {
+                cc__tls_anchor_list none = { &g_cc_tls_cred_arena, NULL, 0, 0 };
+                tas = cc__tls_anchors_finish(&g_cc_tls_cred_arena, &none);
+            }
+        }
+        if (tas) {
+            e = cc__tls_cred_insert(ca_path, ca_len, NULL, 0);
+            if (e) {
+                e->anchors = tas;
+                e->next = g_cc_tls_creds;
+                g_cc_tls_creds = e;
+            }
+        }
+        if (!e) *out_err = err != CC_NET_OK ? err : CC_NET_OTHER;
+    }
+    pthread_mutex_unlock(&g_cc_tls_cred_mu);
+    return e ? e->anchors : NULL;
+}
+
+static const cc__tls_cred_entry* cc__tls_server_creds(const CCTlsServerConfig* cfg, CCNetError* out_err) {
+    pthread_mutex_lock(&g_cc_tls_cred_mu);
+    cc__tls_cred_entry* e = cc__tls_cred_lookup(cfg->cert_path, cfg->cert_path_len, cfg->key_path, cfg->key_path_len);
+    if (!e) {
+        CCNetError err = CC_NET_OK;
+        CCTlsCertChain* chain = cc_tls_load_cert_chain(&g_cc_tls_cred_arena, cfg->cert_path, cfg->cert_path_len, &err);
+        CCTlsPrivateKey* key = chain ? cc_tls_load_private_key(&g_cc_tls_cred_arena, cfg->key_path,
+                                                               cfg->key_path_len, &err)
+                                     : NULL;
+        if (key) e = cc__tls_cred_insert(cfg->cert_path, cfg->cert_path_len, cfg->key_path, cfg->key_path_len);
+        if (e) {
+            br_x509_decoder_context dc;
+            br_x509_decoder_init(&dc, cc__tls_discard, NULL);
+            br_x509_decoder_push(&dc, chain->certs[0].data, chain->certs[0].data_len);
+            e->chain = chain;
+            e->key = key;
+            e->issuer_key_type = (unsigned)br_x509_decoder_get_signer_key_type(&dc);
+            e->next = g_cc_tls_creds;
+            g_cc_tls_creds = e;
+        } else {
+            *out_err = err != CC_NET_OK ? err : CC_NET_OTHER;
+        }
+    }
+    pthread_mutex_unlock(&g_cc_tls_cred_mu);
+    return e;
+}
+
+/* ============================================================================
+ * Handshake
+ * ============================================================================ */
+
+static CCSlice cc__tls_info_str(CCArena* arena, const char* s) {
+    size_t len = s ? strlen(s) : 0;
+    if (len == 0) return cc_slice_from_buffer(NULL, 0);
+    char* p = arena ? (char*)cc__tls_arena_dup(arena, s, len) : NULL;
+    return p ? cc_slice_from_buffer(p, len) : cc_slice_from_buffer(NULL, 0);
+}
+
+static const char* cc__tls_suite_name(uint16_t suite) {
+    switch (suite) {
+        case BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256: return "TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256";
+        case BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384: return "TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384";
+        case BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256: return "TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256";
+        case BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256: return "TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256";
+        case BR_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384: return "TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384";
+        case BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256: return "TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256";
+        case BR_TLS_RSA_WITH_AES_128_GCM_SHA256: return "TLS_RSA_WITH_AES_128_GCM_SHA256";
+        case BR_TLS_RSA_WITH_AES_256_GCM_SHA384: return "TLS_RSA_WITH_AES_256_GCM_SHA384";
+        default: return NULL;
+    }
+}
+
+static void cc__tls_fill_info(cc__tls_state* st, CCArena* arena) {
+    br_ssl_engine_context* eng = cc__tls_engine(st);
+    br_ssl_session_parameters sp;
+    br_ssl_engine_get_session_parameters(eng, &sp);
+    const char* version = NULL;
+    switch (br_ssl_engine_get_version(eng)) {
+        case BR_TLS12: version = "TLSv1.2"; break;
+        case BR_TLS11: version = "TLSv1.1"; break;
+        case BR_TLS10: version = "TLSv1.0"; break;
+        default: break;
+    }
+    char hex[8];
+    const char* suite = cc__tls_suite_name(sp.cipher_suite);
+    if (!suite) {
+        snprintf(hex, sizeof(hex), "0x%04X", (unsigned)sp.cipher_suite);
+        suite = hex;
+    }
+    st->info.protocol_version = cc__tls_info_str(arena, version);
+    st->info.cipher_suite = cc__tls_info_str(arena, suite);
+    st->info.peer_cert_subject = cc_slice_from_buffer(NULL, 0);
+    st->info.sni_hostname = cc__tls_info_str(arena, st->is_server ? br_ssl_engine_get_server_name(eng)
+                                                                  : st->server_name);
+    st->info.session_resumed = st->resumed != 0;
+}
+
+/* br_sslio_flush drives the engine until application data can be sent,
+ * which is exactly "handshake complete" (or the engine closed on error). */
+static int cc__tls_handshake(cc__tls_state* st, CCNetError* out_err) {
+    br_sslio_init(&st->io, cc__tls_engine(st), br_low_read, st, br_low_write, st);
+    if (br_sslio_flush(&st->io) != 0 || br_ssl_engine_current_state(cc__tls_engine(st)) == BR_SSL_CLOSED) {
+        *out_err = cc__tls_engine_error(st, 1);
+        return -1;
+    }
+    return 0;
+}
+
+/* Failed handshake: the caller still owns the socket, but a watcher created
+ * on our copy of it would otherwise leak. */
+static void cc__tls_state_free(cc__tls_state* st) {
+    if (st->sock.watcher) {
+        cc__io_watcher_destroy((cc__io_owned_watcher*)st->sock.watcher);
+        st->sock.watcher = NULL;
+    }
+    free(st);
+}
+
+static CCTlsConn cc__tls_conn_from_state(cc__tls_state* st, void* iobuf, size_t iobuf_len, CCArena* info_arena) {
+    CCTlsConn conn = {0};
+    cc__tls_fill_info(st, info_arena);
+    conn.ctx = st;
+    conn.iobuf = iobuf;
+    conn.iobuf_len = iobuf_len;
+    conn.underlying = st->sock;
+    conn.info_arena = info_arena;
+    conn.flags = st->is_server ? 2 : 1;  /* 1 = client, 2 = server */
+    return conn;
+}
+
 #endif /* CC_HAS_BEARSSL */
 
 /* ============================================================================
@@ -66,51 +748,66 @@ CCTlsConn cc_tls_connect(CCSocket sock, CCTlsClientConfig cfg,
     *out_err = CC_NET_OK;
 
 #ifdef CC_HAS_BEARSSL
+    if (!iobuf || iobuf_len < BR_SSL_BUFSIZE_MONO) {
+        *out_err = CC_NET_OTHER;
+        return conn;
+    }
+    const CCTlsTrustAnchors* tas = cc__tls_client_anchors(cfg.ca_cert_path, cfg.ca_cert_path_len, out_err);
+    if (!tas) return conn;
+
     /* Allocate BearSSL context */
-    br_ssl_client_context* cc = malloc(sizeof(br_ssl_client_context));
-    if (!cc) {
+    cc__tls_state* st = (cc__tls_state*)calloc(1, sizeof(cc__tls_state));
+    if (!st) {
         *out_err = CC_NET_OTHER;
         return conn;
     }
+    st->sock = sock;
 
     /* Initialize client context with default profiles */
-    br_ssl_client_init_full(cc, NULL, NULL, 0);  /* TODO: load trust anchors */
-
-    /* Set I/O buffer */
-    br_ssl_engine_set_buffer(&cc->eng, iobuf, iobuf_len, 1);  /* bidirectional */
+    br_ssl_client_init_full(&st->u.client, &st->x509, tas->anchors, tas->count);
+    br_ssl_engine_set_buffer(&st->u.client.eng, iobuf, iobuf_len, iobuf_len >= BR_SSL_BUFSIZE_BIDI);
 
-    /* Set SNI hostname */
     if (cfg.sni_hostname && cfg.sni_hostname_len > 0) {
-        char sni_buf[256];
-        size_t sni_len = cfg.sni_hostname_len < sizeof(sni_buf) - 1 
-                         ? cfg.sni_hostname_len : sizeof(sni_buf) - 1;
-        memcpy(sni_buf, cfg.sni_hostname, sni_len);
-        sni_buf[sni_len] = '\0';
-        br_ssl_client_reset(cc, sni_buf, 0);
-    } else {
-        br_ssl_client_reset(cc, NULL, 0);
+        size_t sni_len = cfg.sni_hostname_len < sizeof(st->server_name) - 1
+                         ? cfg.sni_hostname_len : sizeof(st->server_name) - 1;
+        memcpy(st->server_name, cfg.sni_hostname, sni_len);
+        st->server_name[sni_len] = '\0';
     }
 
-    /* Run handshake */
-    /* TODO: This needs to be async-aware; for now, blocking */
-    while (br_ssl_engine_current_state(&cc->eng) == BR_SSL_HANDSHAKE) {
-        /* ... run engine state machine ... */
-        /* This is a simplification; real impl needs proper I/O loop */
+    /* Offer the cached session for this peer, if any */
+    br_ssl_session_parameters offered;
+    int resume = 0;
+    if (cfg.resume_session) {
+        cc__tls_client_cache_key(st);
+        resume = cc__tls_client_cache_get(st->cache_key, &offered);
+        if (resume) br_ssl_engine_set_session_parameters(&st->u.client.eng, &offered);
     }
 
-    if (br_ssl_engine_current_state(&cc->eng) == BR_SSL_CLOSED) {
-        int err = br_ssl_engine_last_error(&cc->eng);
+    /* BearSSL checks the certificate name against the SNI name, so without
+     * hostname verification no name is sent at all. */
+    const char* name = cfg.verify_hostname && st->server_name[0] ? st->server_name : NULL;
+    if (!br_ssl_client_reset(&st->u.client, name, resume)) {
         *out_err = CC_NET_TLS_HANDSHAKE_FAILED;
-        free(cc);
+        cc__tls_state_free(st);
         return conn;
     }
 
-    conn.ctx = cc;
-    conn.iobuf = iobuf;
-    conn.iobuf_len = iobuf_len;
-    conn.underlying = sock;
-    conn.info_arena = info_arena;
-    conn.flags = 1;  /* client mode */
+    /* Run handshake (parks the fiber while the socket is not ready) */
+    if (cc__tls_handshake(st, out_err) != 0) {
+        if (resume) cc__tls_client_cache_put(st->cache_key, NULL);
+        cc__tls_state_free(st);
+        return conn;
+    }
+
+    if (cfg.resume_session) {
+        br_ssl_session_parameters sp;
+        br_ssl_engine_get_session_parameters(&st->u.client.eng, &sp);
+        st->resumed = resume && sp.session_id_len == offered.session_id_len &&
+                      memcmp(sp.session_id, offered.session_id, sp.session_id_len) == 0;
+        cc__tls_client_cache_put(st->cache_key, &sp);
+    }
+
+    conn = cc__tls_conn_from_state(st, iobuf, iobuf_len, info_arena);
 
 #else
     /* No BearSSL: return error */
@@ -137,8 +834,28 @@ CCTlsConn cc_tls_connect_addr(const char* addr, size_t addr_len,
         return conn;
     }
 
+    /* Default SNI to the host part of "host:port" unless it is an IP literal */
+    if (!cfg.sni_hostname || cfg.sni_hostname_len == 0) {
+        const char* host = addr;
+        size_t host_len = addr_len;
+        for (size_t i = addr_len; i > 0; --i) {
+            if (addr[i - 1] == ':') {
+                host_len = i - 1;
+                break;
+            }
+        }
+        if (host_len > 0 && host[0] != '[') {
+            CCNetError ip_err = CC_NET_OK;
+            (void)cc_ip_parse(host, host_len, &ip_err);
+            if (ip_err != CC_NET_OK) {
+                cfg.sni_hostname = host;
+                cfg.sni_hostname_len = host_len;
+            }
+        }
+    }
+
     /* Allocate I/O buffer from arena */
-    void* iobuf = cc_arena_alloc(conn_arena, CC_TLS_IOBUF_SIZE);
+    void* iobuf = cc_arena_alloc(conn_arena, CC_TLS_IOBUF_SIZE, 16);
     if (!iobuf) {
         cc_socket_close(&sock);
         *out_err = CC_NET_OTHER;
@@ -165,14 +882,45 @@ CCTlsConn cc_tls_accept(CCSocket sock, CCTlsServerConfig cfg,
     *out_err = CC_NET_OK;
 
 #ifdef CC_HAS_BEARSSL
-    /* TODO: Implement server-side TLS */
-    /* Similar to client but uses br_ssl_server_context */
-    (void)sock;
-    (void)cfg;
-    (void)iobuf;
-    (void)iobuf_len;
-    (void)info_arena;
-    *out_err = CC_NET_TLS_HANDSHAKE_FAILED;
+    if (!iobuf || iobuf_len < BR_SSL_BUFSIZE_MONO) {
+        *out_err = CC_NET_OTHER;
+        return conn;
+    }
+    if (cfg.client_ca_path && cfg.client_ca_path_len > 0) {
+        /* Client certificates are not verified: refuse before touching the
+         * socket rather than running a handshake that cannot enforce it. */
+        *out_err = CC_NET_TLS_UNSUPPORTED;
+        return conn;
+    }
+    const cc__tls_cred_entry* creds = cc__tls_server_creds(&cfg, out_err);
+    if (!creds) return conn;
+
+    cc__tls_state* st = (cc__tls_state*)calloc(1, sizeof(cc__tls_state));
+    if (!st) {
+        *out_err = CC_NET_OTHER;
+        return conn;
+    }
+    st->sock = sock;
+    st->is_server = 1;
+
+    if (creds->key->key_type == BR_KEYTYPE_RSA) {
+        br_ssl_server_init_full_rsa(&st->u.server, creds->chain->certs, creds->chain->count, &creds->key->rsa);
+    } else {
+        br_ssl_server_init_full_ec(&st->u.server, creds->chain->certs, creds->chain->count,
+                                   creds->issuer_key_type, &creds->key->ec);
+    }
+    br_ssl_engine_set_buffer(&st->u.server.eng, iobuf, iobuf_len, iobuf_len >= BR_SSL_BUFSIZE_BIDI);
+
+    const br_ssl_session_cache_class** cache = cc__tls_server_cache();
+    if (cache) br_ssl_server_set_cache(&st->u.server, cache);
+
+    if (!br_ssl_server_reset(&st->u.server) || cc__tls_handshake(st, out_err) != 0) {
+        if (*out_err == CC_NET_OK) *out_err = CC_NET_TLS_HANDSHAKE_FAILED;
+        cc__tls_state_free(st);
+        return conn;
+    }
+
+    conn = cc__tls_conn_from_state(st, iobuf, iobuf_len, info_arena);
 #else
     (void)sock;
     (void)cfg;
@@ -189,39 +937,61 @@ CCTlsConn cc_tls_accept(CCSocket sock, CCTlsServerConfig cfg,
  * TLS I/O
  * ============================================================================ */
 
-CCSlice cc_tls_read(CCTlsConn* conn, CCArena* arena, size_t max_bytes, CCNetError* out_err) {
-    CCSlice result = {0};
+size_t cc_tls_read_into(CCTlsConn* conn, char* buf, size_t max_bytes, CCNetError* out_err) {
     *out_err = CC_NET_OK;
 
 #ifdef CC_HAS_BEARSSL
-    br_ssl_client_context* cc = (br_ssl_client_context*)conn->ctx;
-    if (!cc) {
+    cc__tls_state* st = (cc__tls_state*)conn->ctx;
+    if (!st) {
         *out_err = CC_NET_CONNECTION_CLOSED;
-        return result;
+        return 0;
     }
+    if (max_bytes == 0) return 0;
+    if (max_bytes > INT32_MAX) max_bytes = INT32_MAX;
 
-    /* Get application data from engine */
-    size_t avail;
-    unsigned char* buf = br_ssl_engine_recvapp_buf(&cc->eng, &avail);
-    if (!buf || avail == 0) {
-        /* Need to run engine to get more data */
-        /* TODO: proper async I/O loop */
+    int n = br_sslio_read(&st->io, buf, max_bytes);
+    if (n <= 0) {
+        *out_err = cc__tls_engine_error(st, 0);
+        return 0;
+    }
+    return (size_t)n;
+#else
+    (void)conn;
+    (void)buf;
+    (void)max_bytes;
+    *out_err = CC_NET_TLS_HANDSHAKE_FAILED;
+    return 0;
+#endif
+}
+
+CCSlice cc_tls_read(CCTlsConn* conn, CCArena* arena, size_t max_bytes, CCNetError* out_err) {
+    CCSlice result = {0};
+    *out_err = CC_NET_OK;
+
+#ifdef CC_HAS_BEARSSL
+    cc__tls_state* st = (cc__tls_state*)conn->ctx;
+    if (!st) {
         *out_err = CC_NET_CONNECTION_CLOSED;
         return result;
     }
 
-    size_t to_read = avail < max_bytes ? avail : max_bytes;
-    char* out = cc_arena_alloc(arena, to_read);
+    /* Size the allocation to already-decrypted data when there is some */
+    size_t avail = 0;
+    size_t want = max_bytes;
+    if (br_ssl_engine_recvapp_buf(cc__tls_engine(st), &avail) && avail < want) want = avail;
+    if (want == 0) return result;
+
+    char* out = cc_arena_alloc(arena, want, 1);
     if (!out) {
         *out_err = CC_NET_OTHER;
         return result;
     }
 
-    memcpy(out, buf, to_read);
-    br_ssl_engine_recvapp_ack(&cc->eng, to_read);
-
-    result.ptr = out;
-    result.len = to_read;
+    size_t n = cc_tls_read_into(conn, out, want, out_err);
+    if (*out_err == CC_NET_OK && n > 0) {
+        result.ptr = out;
+        result.len = n;
+    }
 #else
     (void)conn;
     (void)arena;
@@ -236,30 +1006,19 @@ size_t cc_tls_write(CCTlsConn* conn, const char* data, size_t len, CCNetError* o
     *out_err = CC_NET_OK;
 
 #ifdef CC_HAS_BEARSSL
-    br_ssl_client_context* cc = (br_ssl_client_context*)conn->ctx;
-    if (!cc) {
+    cc__tls_state* st = (cc__tls_state*)conn->ctx;
+    if (!st) {
         *out_err = CC_NET_CONNECTION_CLOSED;
         return 0;
     }
+    if (len == 0) return 0;
 
-    /* Get send buffer from engine */
-    size_t avail;
-    unsigned char* buf = br_ssl_engine_sendapp_buf(&cc->eng, &avail);
-    if (!buf || avail == 0) {
-        /* Buffer full, need to flush */
-        /* TODO: proper async I/O loop */
-        *out_err = CC_NET_OTHER;
+    /* Copy into the engine record by record, then push it to the socket */
+    if (br_sslio_write_all(&st->io, data, len) != 0 || br_sslio_flush(&st->io) != 0) {
+        *out_err = cc__tls_engine_error(st, 0);
         return 0;
     }
-
-    size_t to_write = len < avail ? len : avail;
-    memcpy(buf, data, to_write);
-    br_ssl_engine_sendapp_ack(&cc->eng, to_write);
-    br_ssl_engine_flush(&cc->eng, 0);
-
-    /* TODO: actually send data to socket */
-
-    return to_write;
+    return len;
 #else
     (void)conn;
     (void)data;
@@ -273,10 +1032,14 @@ void cc_tls_shutdown(CCTlsConn* conn, CCShutdownMode mode, CCNetError* out_err)
     *out_err = CC_NET_OK;
 
 #ifdef CC_HAS_BEARSSL
-    br_ssl_client_context* cc = (br_ssl_client_context*)conn->ctx;
-    if (cc) {
-        br_ssl_engine_close(&cc->eng);
-        /* TODO: send close_notify and wait for response */
+    cc__tls_state* st = (cc__tls_state*)conn->ctx;
+    if (st && mode != CC_SHUTDOWN_READ) {
+        /* Send close_notify and wait for the peer's */
+        (void)br_sslio_close(&st->io);
+    }
+    if (st) {
+        cc_socket_shutdown(&st->sock, mode, out_err);
+        return;
     }
 #endif
 
@@ -287,46 +1050,121 @@ void cc_tls_shutdown(CCTlsConn* conn, CCShutdownMode mode, CCNetError* out_err)
 void cc_tls_close(CCTlsConn* conn) {
 #ifdef CC_HAS_BEARSSL
     if (conn->ctx) {
-        free(conn->ctx);
+        cc__tls_state* st = (cc__tls_state*)conn->ctx;
+        /* The state's socket copy owns the lazily created I/O watcher */
+        cc_socket_close(&st->sock);
+        free(st);
         conn->ctx = NULL;
+        conn->underlying.fd = -1;
+        conn->underlying.watcher = NULL;
+        return;
     }
 #endif
     cc_socket_close(&conn->underlying);
 }
 
 const CCTlsInfo* cc_tls_info(const CCTlsConn* conn) {
-    /* TODO: Extract TLS info from BearSSL context */
+#ifdef CC_HAS_BEARSSL
+    const cc__tls_state* st = (const cc__tls_state*)conn->ctx;
+    return st ? &st->info : NULL;
+#else
     (void)conn;
     return NULL;
+#endif
+}
+
+void cc_tls_session_cache_flush(void) {
+#ifdef CC_HAS_BEARSSL
+    pthread_mutex_lock(&g_cc_tls_client_cache.mu);
+    for (size_t i = 0; i < CC__TLS_CLIENT_CACHE_SLOTS; ++i) g_cc_tls_client_cache.slots[i].stamp = 0;
+    pthread_mutex_unlock(&g_cc_tls_client_cache.mu);
+
+    if (cc__tls_server_cache()) {
+        pthread_mutex_lock(&g_cc_tls_server_cache.mu);
+        br_ssl_session_cache_lru_init(&g_cc_tls_server_cache.lru, g_cc_tls_server_cache.store,
+                                      g_cc_tls_server_cache.store_len);
+        pthread_mutex_unlock(&g_cc_tls_server_cache.mu);
+    }
+#endif
 }
 
 /* ============================================================================
- * Certificate Loading (stubs)
+ * Certificate Loading
  * ============================================================================ */
 
 CCTlsCertChain* cc_tls_load_cert_chain(CCArena* arena, const char* path, size_t path_len, CCNetError* out_err) {
-    /* TODO: Implement PEM parsing */
+    *out_err = CC_NET_OK;
+#ifdef CC_HAS_BEARSSL
+    cc__tls_cert_list l;
+    if (cc__tls_load_certs(arena, path, path_len, &l) != 0) {
+        *out_err = CC_NET_TLS_CERTIFICATE_ERROR;
+        return NULL;
+    }
+    CCTlsCertChain* chain = (CCTlsCertChain*)cc_arena_alloc(arena, sizeof(*chain), _Alignof(CCTlsCertChain));
+    br_x509_certificate* certs = (br_x509_certificate*)cc_arena_alloc(arena, l.count * sizeof(br_x509_certificate),
+                                                                      _Alignof(br_x509_certificate));
+    if (!chain || !certs) {
+        free(l.certs);
+        *out_err = CC_NET_OTHER;
+        return NULL;
+    }
+    memcpy(certs, l.certs, l.count * sizeof(br_x509_certificate));
+    free(l.certs);
+    chain->certs = certs;
+    chain->count = l.count;
+    return chain;
+#else
     (void)arena;
     (void)path;
     (void)path_len;
     *out_err = CC_NET_OTHER;
     return NULL;
+#endif
 }
 
 CCTlsPrivateKey* cc_tls_load_private_key(CCArena* arena, const char* path, size_t path_len, CCNetError* out_err) {
-    /* TODO: Implement PEM parsing */
+    *out_err = CC_NET_OK;
+#ifdef CC_HAS_BEARSSL
+    cc__tls_blob file = {0};
+    cc__tls_key_slot slot = { arena, NULL };
+    int rc = cc__tls_read_file(path, path_len, &file);
+    if (rc == 0) rc = cc__tls_decode_objects(file.data, file.len, cc__tls_collect_key, &slot);
+    free(file.data);
+    if (rc != 0 || !slot.key) {
+        *out_err = CC_NET_TLS_CERTIFICATE_ERROR;
+        return NULL;
+    }
+    return slot.key;
+#else
     (void)arena;
     (void)path;
     (void)path_len;
     *out_err = CC_NET_OTHER;
     return NULL;
+#endif
 }
 
 CCTlsTrustAnchors* cc_tls_load_trust_anchors(CCArena* arena, const char* path, size_t path_len, CCNetError* out_err) {
-    /* TODO: Implement PEM parsing for CA certs */
+    *out_err = CC_NET_OK;
+#ifdef CC_HAS_BEARSSL
+    cc__tls_blob file = {0};
+    cc__tls_anchor_list l = { arena, NULL, 0, 0 };
+    int rc = cc__tls_read_file(path, path_len, &file);
+    if (rc == 0) rc = cc__tls_decode_objects(file.data, file.len, cc__tls_collect_anchor, &l);
+    free(file.data);
+    if (rc != 0 || l.count == 0) {
+        free(l.anchors);
+        *out_err = CC_NET_TLS_CERTIFICATE_ERROR;
+        return NULL;
+    }
+    CCTlsTrustAnchors* tas = cc__tls_anchors_finish(arena, &l);
+    if (!tas) *out_err = CC_NET_OTHER;
+    return tas;
+#else
     (void)arena;
     (void)path;
     (void)path_len;
     *out_err = CC_NET_OTHER;
     return NULL;
+#endif
 }
@@ -8,13 +8,21 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <signal.h>
 
 #include "build/build.h"
 #include <ccc/cc_build_helpers.cch>
 #include "driver.h"
+#include "ir/verifier.h"
 #include "preprocess/preprocess.h"
+#include "server/compile_server.h"
+#include "util/pass_profile.h"
+#include "util/prof_symbolize.h"
+
+/* From the bundled runtime (runtime/sched_trace.c), which ccc links in. */
+int cc__trace_report(const char* path, const char* json_out, int top, FILE* out);
 
 // Forward decls for helpers used by multiple modes.
 static int file_exists(const char* path);
@@ -484,6 +492,10 @@ static void usage(const char *prog) {
     fprintf(stderr, "  %s build [options] <input.ccs> <output>\n", prog);
     fprintf(stderr, "  %s build run [options] <input.ccs> [-o out/<stem>] [-- <args...>]\n", prog);
     fprintf(stderr, "  %s clean [--out-dir DIR] [--bin-dir DIR] [--all]\n", prog);
+    fprintf(stderr, "  %s trace <file.cctrace> [--top N] [--json OUT]\n", prog);
+    fprintf(stderr, "                      Summarize a CC_TRACE scheduler trace: longest parks, wait sites\n");
+    fprintf(stderr, "  %s prof <file.folded> [-o OUT]\n", prog);
+    fprintf(stderr, "                      Symbolize a CC_PROF profile into flamegraph folded stacks\n");
     fprintf(stderr, "Modes:\n");
     fprintf(stderr, "  --emit-c-only       Stop after emitting C (output defaults to out/<stem>.c)\n");
     fprintf(stderr, "  --compile           Emit C and compile to object (output defaults to out/<stem>.o)\n");
@@ -513,8 +525,17 @@ static void usage(const char *prog) {
     fprintf(stderr, "  --no-cache          Disable incremental cache (also: CC_NO_CACHE=1)\n");
     fprintf(stderr, "  --strict-deadlock   Force deadlock heuristics to errors (default; also: CC_STRICT_DEADLOCK=1)\n");
     fprintf(stderr, "  --no-strict-deadlock  Downgrade deadlock heuristics to warnings for this run\n");
+    fprintf(stderr, "  --preempt-points    Poll for scheduler preemption at loop back-edges (also: CC_PREEMPT_POINTS=1)\n");
     fprintf(stderr, "  --timeout SECONDS   Kill run/test step after timeout\n");
     fprintf(stderr, "  --verbose           Print invoked commands\n");
+    fprintf(stderr, "  --time-passes       Print per-pass lowering time/bytes/reparses per TU (also: CC_TIME_PASSES=1)\n");
+    fprintf(stderr, "  --trace-passes PATH Write lowering passes as Chrome trace JSON (also: CC_TRACE_PASSES=PATH)\n");
+    fprintf(stderr, "Compile server:\n");
+    fprintf(stderr, "  %s --server [--socket PATH] [--idle-timeout SECONDS]\n", prog);
+    fprintf(stderr, "                      Serve ccc invocations from one warm process (default socket: <repo>/out/ccc-server.sock)\n");
+    fprintf(stderr, "  CCC_SERVER=1 / CCC_SERVER_SOCKET=PATH\n");
+    fprintf(stderr, "                      Route this ccc through a running server (local when none is reachable or it\n");
+    fprintf(stderr, "                      belongs to another user; an error when it runs a different ccc build)\n");
 }
 
 
@@ -567,6 +588,10 @@ static void usage_build(const char* prog) {
     fprintf(stderr, "Build flavors:\n");
     fprintf(stderr, "  -g, --debug     Add -O0 -g (and disable release dead-stripping)\n");
     fprintf(stderr, "  -O, --release   Add -O2 -DNDEBUG and enable dead-stripping (smaller binaries)\n");
+    fprintf(stderr, "  --lto           Release build with -flto across user code and the runtime\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Parallelism:\n");
+    fprintf(stderr, "  -j N, --jobs N  Lower/compile up to N build.cc target units at once (default: CPU count)\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Options: same as main help (use `%s --help` for full list)\n", prog);
     fprintf(stderr, "\n");
@@ -707,6 +732,21 @@ static const char* pick_cc_bin(const char* override) {
     return "cc";
 }
 
+/* --lto is dropped (with a note) where it cannot apply: debug builds win,
+   and TCC has no LTO. */
+static int cc__resolve_lto(int opt_lto, int opt_debug, const char* cc_bin_override) {
+    if (!opt_lto) return 0;
+    if (opt_debug) {
+        fprintf(stderr, "cc: --lto ignored in debug builds\n");
+        return 0;
+    }
+    if (cc__is_tcc(pick_cc_bin(cc_bin_override))) {
+        fprintf(stderr, "cc: --lto ignored (tcc has no LTO)\n");
+        return 0;
+    }
+    return 1;
+}
+
 static const char* pick_cxx_bin(void) {
     const char* env = getenv("CXX");
     if (env && *env) return env;
@@ -879,6 +919,7 @@ typedef struct {
     const char* target_flag;  // target triple (forwarded as: --target <triple>)
     const char* sysroot_flag; // sysroot path (forwarded as: --sysroot <path>)
     int opt_release; // enable size/perf oriented defaults (dead-strip, -DNDEBUG)
+    int opt_lto;     // whole-program: -flto on user TUs, the runtime and the link (implies release)
     int opt_debug;   // enable debug oriented defaults (-g, lower opt)
     int no_runtime;
     int keep_c;
@@ -1501,6 +1542,185 @@ static void cc__make_cross_parts(const CCBuildTargetDecl* t,
     if (sys && sys[0]) snprintf(sysroot_part, sysroot_part_cap, "--sysroot %s", sys);
 }
 
+// One source unit of a target: paths, cache keys, and what it needs rebuilt.
+typedef struct {
+    const CCBuildOptions* base_cli_opt;
+    const CCCompileConfig* cfg;
+    int cache_ok;
+    const char* cc_flags;      // merged target + CLI compile flags
+    const char* target_part;
+    const char* sysroot_part;
+    int is_raw_c;
+    char src_abs[PATH_MAX];
+    char src_dir[PATH_MAX];
+    char c_out[PATH_MAX];
+    char o_out[PATH_MAX];
+    char d_out[PATH_MAX];
+    char log_path[PATH_MAX];
+    char meta_path[PATH_MAX];
+    char obj_meta_path[PATH_MAX];
+    uint64_t emit_key;
+    uint64_t obj_key;
+    int need_emit;
+} CCBuildUnit;
+
+static int cc__build_unit_obj_fresh(const CCBuildUnit* u) {
+    uint64_t prev = 0;
+    return u->cache_ok && file_exists(u->o_out) && cc__read_u64_file(u->obj_meta_path, &prev) == 0 &&
+           prev == u->obj_key && !cc__deps_require_rebuild(u->d_out, u->o_out);
+}
+
+// Nothing to do: emitted C and object (if any) are both cached.
+static int cc__build_unit_up_to_date(const CCBuildUnit* u) {
+    if (u->need_emit) return 0;
+    if (u->base_cli_opt && u->base_cli_opt->mode == CC_MODE_EMIT_C) return 1;
+    return cc__build_unit_obj_fresh(u);
+}
+
+// Lower (if needed) and compile one unit. Runs inline for -j1, otherwise in a
+// forked child: lowering keeps process-global state, so units never share a
+// process.
+static int cc__build_unit_run(const CCBuildUnit* u) {
+    if (u->need_emit) {
+        int err = cc__compile_with_env(u->base_cli_opt, u->src_abs, u->c_out, u->cfg);
+        if (err != 0) return err;
+        if (u->cache_ok) (void)cc__write_u64_file(u->meta_path, u->emit_key);
+    }
+    if (u->base_cli_opt && u->base_cli_opt->mode != CC_MODE_EMIT_C && !cc__build_unit_obj_fresh(u)) {
+        CCBuildOptions opt = *u->base_cli_opt;
+        opt.in_path = u->src_abs;
+        opt.cc_flags = u->cc_flags[0] ? u->cc_flags : u->base_cli_opt->cc_flags;
+        const char* c_for_compile = u->is_raw_c ? u->src_abs : u->c_out;
+        if (cc__compile_c_to_obj(&opt, c_for_compile, u->o_out, u->d_out, u->src_dir, u->target_part, u->sysroot_part) != 0) return -1;
+        if (u->cache_ok) (void)cc__write_u64_file(u->obj_meta_path, u->obj_key);
+    }
+    return 0;
+}
+
+/* Build job server (`ccc build -j N`).
+ *
+ * Stale units run as forked children, at most max_jobs at a time. Each child
+ * writes its stdout/stderr to <unit>.log next to the object; the parent
+ * replays logs strictly in submission order, so output is the same for any
+ * -j. A target's units are submitted only after every unit of its dep
+ * targets has finished. After the first failure nothing new is submitted;
+ * running jobs are drained and their logs replayed. */
+typedef struct {
+    pid_t pid;
+    int target;
+    int rc;      // -1 while running
+    char log_path[PATH_MAX];
+} CCBuildJob;
+
+typedef struct {
+    int max_jobs;
+    int running;
+    int failed;
+    CCBuildJob* jobs;
+    size_t count;
+    size_t cap;
+    size_t next_report;
+    int* target_pending;   // per target: jobs submitted but not reaped
+} CCBuildJobServer;
+
+static int cc__build_default_jobs(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+static void cc__build_jobs_report(CCBuildJobServer* js) {
+    while (js->next_report < js->count && js->jobs[js->next_report].rc >= 0) {
+        CCBuildJob* j = &js->jobs[js->next_report++];
+        FILE* f = fopen(j->log_path, "rb");
+        if (f) {
+            char buf[4096];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), f)) > 0) fwrite(buf, 1, n, stderr);
+            fclose(f);
+        }
+        unlink(j->log_path);
+    }
+    fflush(stderr);
+}
+
+// Reap one finished job (blocking). Returns -1 if nothing is running.
+static int cc__build_jobs_reap_one(CCBuildJobServer* js) {
+    if (js->running == 0) return -1;
+    for (;;) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            perror("waitpid");
+            js->running = 0;
+            js->failed = 1;
+            return -1;
+        }
+        for (size_t i = 0; i < js->count; ++i) {
+            CCBuildJob* j = &js->jobs[i];
+            if (j->pid != pid || j->rc >= 0) continue;
+            if (WIFEXITED(status)) j->rc = WEXITSTATUS(status);
+            else j->rc = 128 + (WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+            if (j->rc != 0) js->failed = 1;
+            js->running--;
+            js->target_pending[j->target]--;
+            cc__build_jobs_report(js);
+            return 0;
+        }
+    }
+}
+
+static int cc__build_jobs_wait_all(CCBuildJobServer* js) {
+    while (js->running > 0) (void)cc__build_jobs_reap_one(js);
+    cc__build_jobs_report(js);
+    return js->failed ? -1 : 0;
+}
+
+// Wait until target `idx` has no unfinished jobs.
+static int cc__build_jobs_wait_target(CCBuildJobServer* js, int idx) {
+    while (js->target_pending[idx] > 0 && js->running > 0) (void)cc__build_jobs_reap_one(js);
+    return js->failed ? -1 : 0;
+}
+
+static int cc__build_jobs_submit(CCBuildJobServer* js, int target, const CCBuildUnit* u) {
+    while (js->running >= js->max_jobs && !js->failed) (void)cc__build_jobs_reap_one(js);
+    if (js->failed) return -1;
+    if (js->count == js->cap) {
+        size_t cap = js->cap ? js->cap * 2 : 64;
+        CCBuildJob* jobs = (CCBuildJob*)realloc(js->jobs, cap * sizeof(*jobs));
+        if (!jobs) return -1;
+        js->jobs = jobs;
+        js->cap = cap;
+    }
+    CCBuildJob* j = &js->jobs[js->count];
+    memset(j, 0, sizeof(*j));
+    j->target = target;
+    j->rc = -1;
+    snprintf(j->log_path, sizeof(j->log_path), "%s", u->log_path);
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        int fd = open(u->log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        int rc = cc__build_unit_run(u);
+        fflush(NULL);
+        _exit(rc == 0 ? 0 : 1);
+    }
+    j->pid = pid;
+    js->count++;
+    js->running++;
+    js->target_pending[target]++;
+    return 0;
+}
+
 static int cc__build_target_objs_rec(int idx,
                                      const CCBuildTargetDecl* targets,
                                      size_t target_count,
@@ -1513,6 +1733,7 @@ static int cc__build_target_objs_rec(int idx,
                                      const CCFileSig* cc_sig_for_key,
                                      int cache_ok,
                                      CCTargetObjCache* caches,
+                                     CCBuildJobServer* js,
                                      char chain[][128],
                                      size_t chain_len) {
     if (idx < 0 || (size_t)idx >= target_count) return -1;
@@ -1532,9 +1753,16 @@ static int cc__build_target_objs_rec(int idx,
         if (d < 0) return -3;
         if (chain_len < 64) strncpy(chain[chain_len], t->deps[di], sizeof(chain[chain_len]) - 1);
         int r = cc__build_target_objs_rec(d, targets, target_count, build_dir, cfg, base_cli_opt, cli_target, cli_sysroot,
-                                          build_sig_for_key, cc_sig_for_key, cache_ok, caches, chain, chain_len + 1);
+                                          build_sig_for_key, cc_sig_for_key, cache_ok, caches, js, chain, chain_len + 1);
         if (r != 0) return r;
     }
+    // Dep targets may still be compiling under -j; this target starts after them.
+    if (js) {
+        for (size_t di = 0; di < t->dep_count; ++di) {
+            int d = cc__find_target_idx(targets, target_count, t->deps[di]);
+            if (cc__build_jobs_wait_target(js, d) != 0) return -1;
+        }
+    }
 
     // Build compile flags for this target (compile props + CLI cc_flags).
     char t_cc_flags[2048];
@@ -1567,50 +1795,51 @@ static int cc__build_target_objs_rec(int idx,
 
     for (size_t si = 0; si < t->src_count; ++si) {
         if (caches[idx].obj_count >= 128) return -1;
-        char src_abs[PATH_MAX];
-        cc__join_path(build_dir, t->srcs[si], src_abs, sizeof(src_abs));
+        CCBuildUnit u;
+        memset(&u, 0, sizeof(u));
+        u.base_cli_opt = base_cli_opt;
+        u.cfg = cfg;
+        u.cache_ok = cache_ok;
+        u.cc_flags = t_cc_flags;
+        u.target_part = t_target_part;
+        u.sysroot_part = t_sysroot_part;
+        cc__join_path(build_dir, t->srcs[si], u.src_abs, sizeof(u.src_abs));
 
         // Collision-proof, stable unit name:
         //   <basename_without_ext>__<hash(rel_or_abs_path)>
         char stem0[128];
-        cc__stem_from_path(src_abs, stem0, sizeof(stem0));
-        uint64_t src_id_u64 = cc__hash_src_path_u64(build_dir, src_abs);
+        cc__stem_from_path(u.src_abs, stem0, sizeof(stem0));
+        uint64_t src_id_u64 = cc__hash_src_path_u64(build_dir, u.src_abs);
         char src_id_hex[32];
         cc__format_u64_hex(src_id_hex, sizeof(src_id_hex), src_id_u64);
         char unit[256];
         snprintf(unit, sizeof(unit), "%s__%s", stem0, src_id_hex);
 
-        char c_out[PATH_MAX];
-        char o_out[PATH_MAX];
-        char d_out[PATH_MAX];
-        if (snprintf(c_out, sizeof(c_out), "%s/%s.c", c_dir, unit) <= 0) return -1;
-        if (snprintf(o_out, sizeof(o_out), "%s/%s.o", o_dir, unit) <= 0) return -1;
-        if (snprintf(d_out, sizeof(d_out), "%s/%s.d", o_dir, unit) <= 0) return -1;
+        if (snprintf(u.c_out, sizeof(u.c_out), "%s/%s.c", c_dir, unit) <= 0) return -1;
+        if (snprintf(u.o_out, sizeof(u.o_out), "%s/%s.o", o_dir, unit) <= 0) return -1;
+        if (snprintf(u.d_out, sizeof(u.d_out), "%s/%s.d", o_dir, unit) <= 0) return -1;
+        if (snprintf(u.log_path, sizeof(u.log_path), "%s/%s.log", o_dir, unit) <= 0) return -1;
 
-        char src_dir[PATH_MAX];
-        cc__dir_of_path(src_abs, src_dir, sizeof(src_dir));
+        cc__dir_of_path(u.src_abs, u.src_dir, sizeof(u.src_dir));
 
-        const int is_raw_c = cc__is_raw_c(src_abs);
-        const char* c_for_compile = is_raw_c ? src_abs : c_out;
+        u.is_raw_c = cc__is_raw_c(u.src_abs);
 
         // Use a cache stem that is unique per target.
         char cache_stem[256];
         // Also include build_id so caches are safe when sharing --out-dir across multiple projects.
         snprintf(cache_stem, sizeof(cache_stem), "%s__%s__%s", build_id_hex, t->name, unit);
-        char meta_path[PATH_MAX];
-        char obj_meta_path[PATH_MAX];
-        snprintf(meta_path, sizeof(meta_path), "%s/%s.meta", g_cache_root, cache_stem);
-        snprintf(obj_meta_path, sizeof(obj_meta_path), "%s/%s.obj", g_cache_root, cache_stem);
+        snprintf(u.meta_path, sizeof(u.meta_path), "%s/%s.meta", g_cache_root, cache_stem);
+        snprintf(u.obj_meta_path, sizeof(u.obj_meta_path), "%s/%s.obj", g_cache_root, cache_stem);
 
-        uint64_t emit_key = 0;
-        if (!is_raw_c) {
+        if (!u.is_raw_c) {
+            u.need_emit = 1;
             if (cache_ok) {
                 CCFileSig in_sig;
                 in_sig.mtime_sec = 0;
                 in_sig.size = 0;
-                (void)cc__stat_sig(src_abs, &in_sig);
+                (void)cc__stat_sig(u.src_abs, &in_sig);
                 uint64_t h = 1469598103934665603ULL;
-                h = cc__fnv1a64_str(h, src_abs);
+                h = cc__fnv1a64_str(h, u.src_abs);
                 h = cc__fnv1a64_i64(h, in_sig.mtime_sec);
                 h = cc__fnv1a64_i64(h, in_sig.size);
                 h = cc__fnv1a64_i64(h, build_sig_for_key ? build_sig_for_key->mtime_sec : 0);
@@ -1630,62 +1859,48 @@ static int cc__build_target_objs_rec(int idx,
                         h = cc__fnv1a64_i64(h, cfg->consts[bi].value);
                     }
                 }
-                emit_key = h;
+                u.emit_key = h;
                 uint64_t prev = 0;
-                if (file_exists(c_out) && cc__read_u64_file(meta_path, &prev) == 0 && prev == emit_key) {
-                    // reuse
-                } else {
-                    int err = cc__compile_with_env(base_cli_opt, src_abs, c_out, cfg);
-                    if (err != 0) return err;
-                    (void)cc__write_u64_file(meta_path, emit_key);
+                if (file_exists(u.c_out) && cc__read_u64_file(u.meta_path, &prev) == 0 && prev == u.emit_key) {
+                    u.need_emit = 0; // reuse
                 }
+            }
+        }
+
+        // Object key (depfile-based invalidation happens in cc__build_unit_obj_fresh).
+        if (base_cli_opt && base_cli_opt->mode != CC_MODE_EMIT_C && cache_ok) {
+            uint64_t h = 1469598103934665603ULL;
+            if (u.is_raw_c) {
+                CCFileSig in_sig;
+                in_sig.mtime_sec = 0;
+                in_sig.size = 0;
+                (void)cc__stat_sig(u.src_abs, &in_sig);
+                h = cc__fnv1a64_str(h, u.src_abs);
+                h = cc__fnv1a64_i64(h, in_sig.mtime_sec);
+                h = cc__fnv1a64_i64(h, in_sig.size);
             } else {
-                int err = cc__compile_with_env(base_cli_opt, src_abs, c_out, cfg);
-                if (err != 0) return err;
+                h = cc__fnv1a64_i64(h, (long long)u.emit_key);
             }
+            h = cc__fnv1a64_str(h, t_target_part);
+            h = cc__fnv1a64_str(h, t_sysroot_part);
+            h = cc__fnv1a64_str(h, t_cc_flags);
+            h = cc__fnv1a64_str(h, getenv("CFLAGS"));
+            h = cc__fnv1a64_str(h, getenv("CPPFLAGS"));
+            u.obj_key = h;
         }
 
-        // Compile object (with depfile-based invalidation).
-        if (base_cli_opt && base_cli_opt->mode != CC_MODE_EMIT_C) {
-            uint64_t obj_key = 0;
-            if (cache_ok) {
-                uint64_t h = 1469598103934665603ULL;
-                if (is_raw_c) {
-                    CCFileSig in_sig;
-                    in_sig.mtime_sec = 0;
-                    in_sig.size = 0;
-                    (void)cc__stat_sig(src_abs, &in_sig);
-                    h = cc__fnv1a64_str(h, src_abs);
-                    h = cc__fnv1a64_i64(h, in_sig.mtime_sec);
-                    h = cc__fnv1a64_i64(h, in_sig.size);
-                } else {
-                    h = cc__fnv1a64_i64(h, (long long)emit_key);
-                }
-                h = cc__fnv1a64_str(h, t_target_part);
-                h = cc__fnv1a64_str(h, t_sysroot_part);
-                h = cc__fnv1a64_str(h, t_cc_flags);
-                h = cc__fnv1a64_str(h, getenv("CFLAGS"));
-                h = cc__fnv1a64_str(h, getenv("CPPFLAGS"));
-                obj_key = h;
-                uint64_t prev = 0;
-                if (file_exists(o_out) && cc__read_u64_file(obj_meta_path, &prev) == 0 && prev == obj_key && !cc__deps_require_rebuild(d_out, o_out)) {
-                    // reuse
-                } else {
-                    CCBuildOptions opt = *base_cli_opt;
-                    opt.in_path = src_abs;
-                    opt.cc_flags = t_cc_flags[0] ? t_cc_flags : base_cli_opt->cc_flags;
-                    if (cc__compile_c_to_obj(&opt, c_for_compile, o_out, d_out, src_dir, t_target_part, t_sysroot_part) != 0) return -1;
-                    (void)cc__write_u64_file(obj_meta_path, obj_key);
-                }
+        if (!cc__build_unit_up_to_date(&u)) {
+            if (js) {
+                if (cc__build_jobs_submit(js, idx, &u) != 0) return -1;
             } else {
-                CCBuildOptions opt = *base_cli_opt;
-                opt.in_path = src_abs;
-                opt.cc_flags = t_cc_flags[0] ? t_cc_flags : base_cli_opt->cc_flags;
-                if (cc__compile_c_to_obj(&opt, c_for_compile, o_out, d_out, src_dir, t_target_part, t_sysroot_part) != 0) return -1;
+                int err = cc__build_unit_run(&u);
+                if (err != 0) return err;
             }
+        }
 
-            caches[idx].obj_paths[caches[idx].obj_count] = strdup(o_out);
-            caches[idx].obj_keys[caches[idx].obj_count] = obj_key;
+        if (base_cli_opt && base_cli_opt->mode != CC_MODE_EMIT_C) {
+            caches[idx].obj_paths[caches[idx].obj_count] = strdup(u.o_out);
+            caches[idx].obj_keys[caches[idx].obj_count] = u.obj_key;
             caches[idx].obj_count++;
         }
     }
@@ -1817,6 +2032,7 @@ static int compile_with_build(const CCBuildOptions* opt, CCBuildSummary* summary
         h = cc__fnv1a64_str(h, opt->cc_flags);
         h = cc__fnv1a64_str(h, getenv("CFLAGS"));
         h = cc__fnv1a64_str(h, getenv("CPPFLAGS"));
+        h = cc__fnv1a64_str(h, getenv("CC_PREEMPT_POINTS"));
         h = cc__fnv1a64_i64(h, (long long)opt->no_build);
         h = cc__fnv1a64_i64(h, (long long)opt->cli_count);
         for (size_t i = 0; i < opt->cli_count; ++i) {
@@ -2341,11 +2557,14 @@ static int cc__ensure_runtime_obj(const CCBuildOptions* opt,
         }
         strncat(cmd, " -ffunction-sections -fdata-sections", sizeof(cmd) - strlen(cmd) - 1);
         if (run_cmd(cmd, opt->verbose) != 0) return -1;
-        snprintf(cmd, sizeof(cmd), "%s %s %s %s -nostdlib -r %s %s -o %s",
+        // Both halves carry LTO IR under --lto; the partial link keeps it so
+        // the final link can still inline runtime code into user TUs.
+        snprintf(cmd, sizeof(cmd), "%s %s %s %s -nostdlib -r%s %s %s -o %s",
                  cc_bin,
                  target_part ? target_part : "",
                  sysroot_part ? sysroot_part : "",
                  cppflags_env ? cppflags_env : "",
+                 opt->opt_lto ? " -flto" : "",
                  runtime_core_obj,
                  runtime_xjb_obj,
                  runtime_obj);
@@ -2381,6 +2600,7 @@ static int cc__link_many(const CCBuildOptions* opt,
 #elif defined(__linux__)
         strncat(cmd, " -Wl,--gc-sections", sizeof(cmd) - strlen(cmd) - 1);
 #endif
+        if (opt->opt_lto) strncat(cmd, " -flto", sizeof(cmd) - strlen(cmd) - 1);
     }
     for (size_t i = 0; i < obj_count; ++i) {
         strncat(cmd, " ", sizeof(cmd) - strlen(cmd) - 1);
@@ -2464,6 +2684,7 @@ static int run_build_mode(int argc, char** argv) {
     const char* bin_dir = NULL;
     const char* graph_out = NULL;
     int opt_release = 0;
+    int opt_lto = 0;
     int opt_debug = 0;
     int help = 0;
     int dump_consts = 0;
@@ -2478,6 +2699,7 @@ static int run_build_mode(int argc, char** argv) {
     int no_cache = 0;
     int strict_deadlock = 0;
     int strict_deadlock_set = 0;
+    int jobs = 0; // 0 = one per online CPU
 
     enum {
         CC_BUILD_STEP_DEFAULT = 0,
@@ -2539,9 +2761,21 @@ static int run_build_mode(int argc, char** argv) {
             continue;
         }
         if (strcmp(argv[i], "--release") == 0 || strcmp(argv[i], "-O") == 0) { opt_release = 1; continue; }
+        if (strcmp(argv[i], "--lto") == 0) { opt_lto = 1; continue; }
         if (strcmp(argv[i], "--debug") == 0 || strcmp(argv[i], "-g") == 0) { opt_debug = 1; continue; }
         if (strcmp(argv[i], "--summary") == 0) { summary = 1; continue; }
         if (strcmp(argv[i], "--no-cache") == 0) { no_cache = 1; continue; }
+        if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "cc: %s requires a job count\n", argv[i]); goto parse_fail; }
+            jobs = atoi(argv[++i]);
+            if (jobs < 1) { fprintf(stderr, "cc: job count must be >= 1\n"); goto parse_fail; }
+            continue;
+        }
+        if (strncmp(argv[i], "-j", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '9') {
+            jobs = atoi(argv[i] + 2);
+            if (jobs < 1) { fprintf(stderr, "cc: job count must be >= 1\n"); goto parse_fail; }
+            continue;
+        }
         if (strcmp(argv[i], "--strict-deadlock") == 0) { strict_deadlock = 1; strict_deadlock_set = 1; continue; }
         if (strcmp(argv[i], "--no-strict-deadlock") == 0) { strict_deadlock = 0; strict_deadlock_set = 1; continue; }
         if (strcmp(argv[i], "--out-dir") == 0) {
@@ -2589,6 +2823,14 @@ static int run_build_mode(int argc, char** argv) {
         if (strcmp(argv[i], "--no-runtime") == 0) { no_runtime = 1; continue; }
         if (strcmp(argv[i], "--keep-c") == 0) { keep_c = 1; continue; }
         if (strcmp(argv[i], "--verbose") == 0) { verbose = 1; continue; }
+        if (strcmp(argv[i], "--time-passes") == 0) { setenv("CC_TIME_PASSES", "1", 1); continue; }
+        if (strcmp(argv[i], "--preempt-points") == 0) { setenv("CC_PREEMPT_POINTS", "1", 1); continue; }
+        if (strcmp(argv[i], "--trace-passes") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "cc: --trace-passes requires a path\n"); goto parse_fail; }
+            setenv("CC_TRACE_PASSES", argv[++i], 1);
+            cc_pass_profile_trace_reset(argv[i]);
+            continue;
+        }
         if (strcmp(argv[i], "--cc-bin") == 0) {
             if (i + 1 >= argc) { fprintf(stderr, "cc: --cc-bin requires a path\n"); goto parse_fail; }
             cc_bin = argv[++i];
@@ -2641,12 +2883,16 @@ static int run_build_mode(int argc, char** argv) {
 
     // If both are provided, debug wins (safe default).
     if (opt_release && opt_debug) opt_release = 0;
+    opt_lto = cc__resolve_lto(opt_lto, opt_debug, cc_bin);
+    if (opt_lto) opt_release = 1;
 
     // Inject flavor defaults early (before we fold cc_flags + -D defines).
     // - release: size-friendly dead-stripping (link) + NDEBUG (compile)
+    // - lto:     release + -flto, so runtime fast paths inline into user code
     // - debug:   easy debugging
     const char* flavor_cc = NULL;
     if (opt_debug) flavor_cc = "-O0 -g";
+    else if (opt_lto) flavor_cc = "-O2 -DNDEBUG -flto";
     else if (opt_release) flavor_cc = "-O2 -DNDEBUG";
 
     // Build combined cc_flags that includes both --cc-flags and -D defines
@@ -3172,6 +3418,7 @@ static int run_build_mode(int argc, char** argv) {
                 .target_flag = target_flag ? target_flag : "",
                 .sysroot_flag = sysroot_flag ? sysroot_flag : "",
                 .opt_release = opt_release,
+                .opt_lto = opt_lto,
                 .opt_debug = opt_debug,
                 .no_runtime = no_runtime,
                 .keep_c = keep_c,
@@ -3218,9 +3465,14 @@ static int run_build_mode(int argc, char** argv) {
             memset(caches, 0, sizeof(caches));
             char chain[64][128];
             memset(chain, 0, sizeof(chain));
+            int target_pending[64];
+            memset(target_pending, 0, sizeof(target_pending));
+            CCBuildJobServer js = {.max_jobs = jobs > 0 ? jobs : cc__build_default_jobs(), .target_pending = target_pending};
             int r = cc__build_target_objs_rec(chosen_idx, targets, target_count, build_dir, &cfg, &base_opt,
                                               target_flag ? target_flag : "", sysroot_flag ? sysroot_flag : "",
-                                              &build_sig, &cc_sig, cache_ok, caches, chain, 0);
+                                              &build_sig, &cc_sig, cache_ok, caches, js.max_jobs > 1 ? &js : NULL, chain, 0);
+            if (cc__build_jobs_wait_all(&js) != 0 && r == 0) r = -1;
+            free(js.jobs);
             if (r == -2) {
                 fprintf(stderr, "cc: cycle in CC_TARGET_DEPS\n");
                 cc_build_free_targets(targets, target_count, def_name);
@@ -3418,6 +3670,7 @@ static int run_build_mode(int argc, char** argv) {
             .target_flag = target_flag ? target_flag : "",
             .sysroot_flag = sysroot_flag ? sysroot_flag : "",
             .opt_release = opt_release,
+            .opt_lto = opt_lto,
             .opt_debug = opt_debug,
             .no_runtime = no_runtime,
             .keep_c = keep_c,
@@ -3735,6 +3988,7 @@ static int run_build_mode(int argc, char** argv) {
         .target_flag = target_flag ? target_flag : "",
         .sysroot_flag = sysroot_flag ? sysroot_flag : "",
         .opt_release = opt_release,
+        .opt_lto = opt_lto,
         .opt_debug = opt_debug,
         .no_runtime = no_runtime,
         .keep_c = keep_c,
@@ -3783,7 +4037,7 @@ parse_fail:
     return -1;
 }
 
-int main(int argc, char **argv) {
+static int cc__main(int argc, char **argv) {
     cc_init_paths(argv[0]);
     if (argc >= 2 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)) {
         usage(argv[0]);
@@ -3830,6 +4084,47 @@ int main(int argc, char **argv) {
     if (argc >= 2 && strcmp(argv[1], "build") == 0) {
         return run_build_mode(argc, argv) == 0 ? 0 : 1;
     }
+    if (argc >= 2 && strcmp(argv[1], "trace") == 0) {
+        const char* file = NULL;
+        const char* json_out = NULL;
+        int top = 10;
+        for (int i = 2; i < argc; ++i) {
+            if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) { json_out = argv[++i]; continue; }
+            if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) { top = atoi(argv[++i]); continue; }
+            if (!file && argv[i][0] != '-') { file = argv[i]; continue; }
+            usage(argv[0]);
+            return 1;
+        }
+        if (!file) { fprintf(stderr, "cc: trace requires a trace file\n"); usage(argv[0]); return 1; }
+        int rc = cc__trace_report(file, json_out, top, stdout);
+        if (rc != 0) {
+            fprintf(stderr, "cc: trace %s: %s\n", file,
+                    rc == EINVAL ? "not a scheduler trace (CC_TRACE=... without .json)" : strerror(rc));
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "prof") == 0) {
+        const char* file = NULL;
+        const char* out_path = NULL;
+        for (int i = 2; i < argc; ++i) {
+            if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) { out_path = argv[++i]; continue; }
+            if (!file && argv[i][0] != '-') { file = argv[i]; continue; }
+            usage(argv[0]);
+            return 1;
+        }
+        if (!file) { fprintf(stderr, "cc: prof requires a profile file\n"); usage(argv[0]); return 1; }
+        FILE* out = out_path ? fopen(out_path, "w") : stdout;
+        if (!out) { fprintf(stderr, "cc: prof: cannot write %s: %s\n", out_path, strerror(errno)); return 1; }
+        int rc = cc_prof_symbolize(file, out);
+        if (out != stdout) fclose(out);
+        if (rc != 0) {
+            fprintf(stderr, "cc: prof %s: %s\n", file, strerror(rc));
+            return 1;
+        }
+        return 0;
+    }
 
     /* `ccc run <file>` is shorthand for `ccc build run <file>` */
     if (argc >= 2 && strcmp(argv[1], "run") == 0) {
@@ -3862,6 +4157,7 @@ int main(int argc, char **argv) {
     const char* out_dir = NULL;
     const char* bin_dir = NULL;
     int opt_release = 0;
+    int opt_lto = 0;
     int opt_debug = 0;
     int no_build = 0;
     int no_runtime = 0;
@@ -3882,6 +4178,7 @@ int main(int argc, char **argv) {
         if (strcmp(argv[i], "--compile") == 0) { mode = CC_MODE_COMPILE; continue; }
         if (strcmp(argv[i], "--link") == 0) { mode = CC_MODE_LINK; continue; }
         if (strcmp(argv[i], "--release") == 0 || strcmp(argv[i], "-O") == 0) { opt_release = 1; continue; }
+        if (strcmp(argv[i], "--lto") == 0) { opt_lto = 1; continue; }
         if (strcmp(argv[i], "--debug") == 0 || strcmp(argv[i], "-g") == 0) { opt_debug = 1; continue; }
         if (strcmp(argv[i], "--build-file") == 0) {
             if (i + 1 >= argc) { fprintf(stderr, "cc: --build-file requires a path\n"); usage(argv[0]); return 1; }
@@ -3907,6 +4204,14 @@ int main(int argc, char **argv) {
         if (strcmp(argv[i], "--no-runtime") == 0) { no_runtime = 1; continue; }
         if (strcmp(argv[i], "--keep-c") == 0) { keep_c = 1; continue; }
         if (strcmp(argv[i], "--verbose") == 0) { verbose = 1; continue; }
+        if (strcmp(argv[i], "--time-passes") == 0) { setenv("CC_TIME_PASSES", "1", 1); continue; }
+        if (strcmp(argv[i], "--preempt-points") == 0) { setenv("CC_PREEMPT_POINTS", "1", 1); continue; }
+        if (strcmp(argv[i], "--trace-passes") == 0) {
+            if (i + 1 >= argc) { fprintf(stderr, "cc: --trace-passes requires a path\n"); usage(argv[0]); return 1; }
+            setenv("CC_TRACE_PASSES", argv[++i], 1);
+            cc_pass_profile_trace_reset(argv[i]);
+            continue;
+        }
         if (strcmp(argv[i], "--no-cache") == 0) { no_cache = 1; continue; }
         if (strcmp(argv[i], "--strict-deadlock") == 0) { strict_deadlock = 1; strict_deadlock_set = 1; continue; }
         if (strcmp(argv[i], "--no-strict-deadlock") == 0) { strict_deadlock = 0; strict_deadlock_set = 1; continue; }
@@ -3971,6 +4276,8 @@ int main(int argc, char **argv) {
 
     // If both are provided, debug wins (safe default).
     if (opt_release && opt_debug) opt_release = 0;
+    opt_lto = cc__resolve_lto(opt_lto, opt_debug, cc_bin);
+    if (opt_lto) opt_release = 1;
 
     if (pos_count == 0) {
         usage(argv[0]);
@@ -3980,6 +4287,7 @@ int main(int argc, char **argv) {
     // Flavor defaults (non-build mode): apply before any user-provided --cc-flags so users can override.
     const char* flavor_cc = NULL;
     if (opt_debug) flavor_cc = "-O0 -g";
+    else if (opt_lto) flavor_cc = "-O2 -DNDEBUG -flto";
     else if (opt_release) flavor_cc = "-O2 -DNDEBUG";
     static char combined_cc_flags_main[2048];
     combined_cc_flags_main[0] = '\0';
@@ -4034,6 +4342,7 @@ int main(int argc, char **argv) {
             .target_flag = target_flag ? target_flag : "",
             .sysroot_flag = sysroot_flag ? sysroot_flag : "",
             .opt_release = opt_release,
+            .opt_lto = opt_lto,
             .opt_debug = opt_debug,
             .no_runtime = no_runtime,
             .keep_c = keep_c,
@@ -4196,6 +4505,7 @@ int main(int argc, char **argv) {
         .target_flag = target_flag ? target_flag : "",
         .sysroot_flag = sysroot_flag ? sysroot_flag : "",
         .opt_release = opt_release,
+        .opt_lto = opt_lto,
         .opt_debug = opt_debug,
         .no_runtime = no_runtime,
         .keep_c = keep_c,
@@ -4220,3 +4530,94 @@ int main(int argc, char **argv) {
     return err == 0 ? 0 : 1;
 }
 
+/* Worker side of `ccc --server`: the client's cwd and environment are
+   already installed, so redo path discovery against them and drop the
+   env switches the warm-up compile latched from the server's environment. */
+static int cc__server_worker_main(int argc, char** argv) {
+    g_paths_inited = 0;
+    cc_init_paths(argv[0]);
+    cc_pass_profile_reset();
+    cc_ir_verify_reset();
+    return cc__main(argc, argv);
+}
+
+/* Lower a prelude-only TU in the server itself before serving. Besides
+   filling the lowered-header and comptime dylib caches on disk, this leaves
+   the parsed prelude's process state behind -- the global type registry and
+   result-fn tables at their grown capacity, the lowered-header memo, paths,
+   the page cache -- and every worker inherits it copy-on-write. A multi-file
+   `ccc build` already compiles every TU in one process, so a worker starts
+   exactly where the second TU of such a build would. */
+static void cc__server_warm(void) {
+    char src[] = "/tmp/ccc-server-warm-XXXXXX";
+    int fd = mkstemp(src);
+    if (fd < 0) return;
+    static const char probe[] = "#include <ccc/std/prelude.cch>\nint main(void) { return 0; }\n";
+    ssize_t w = write(fd, probe, sizeof(probe) - 1);
+    close(fd);
+    char in_path[sizeof(src) + 4];
+    char out_path[sizeof(src) + 4];
+    snprintf(in_path, sizeof(in_path), "%s.ccs", src);
+    snprintf(out_path, sizeof(out_path), "%s.c", src);
+    if (w != (ssize_t)(sizeof(probe) - 1) || rename(src, in_path) != 0) {
+        unlink(src);
+        return;
+    }
+    /* Keep the probe's diagnostics off the server's terminal. */
+    fflush(stdout);
+    fflush(stderr);
+    int saved_out = dup(STDOUT_FILENO);
+    int saved_err = dup(STDERR_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+    (void)cc_compile(in_path, out_path);
+    fflush(stdout);
+    fflush(stderr);
+    if (saved_out >= 0) { dup2(saved_out, STDOUT_FILENO); close(saved_out); }
+    if (saved_err >= 0) { dup2(saved_err, STDERR_FILENO); close(saved_err); }
+    unlink(in_path);
+    unlink(out_path);
+}
+
+static int cc__server_mode(int argc, char** argv) {
+    char sock[PATH_MAX];
+    int idle_sec = 0;
+    if (cc_server_default_socket(g_repo_root, sock, sizeof(sock)) != 0) sock[0] = '\0';
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            strncpy(sock, argv[++i], sizeof(sock) - 1);
+            sock[sizeof(sock) - 1] = '\0';
+            continue;
+        }
+        if (strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc) {
+            idle_sec = atoi(argv[++i]);
+            if (idle_sec < 0) idle_sec = 0;
+            continue;
+        }
+        usage(argv[0]);
+        return 1;
+    }
+    return cc_server_run(sock, idle_sec, cc__server_warm, cc__server_worker_main);
+}
+
+int main(int argc, char **argv) {
+    cc_init_paths(argv[0]);
+    if (argc >= 2 && strcmp(argv[1], "--server") == 0) {
+        return cc__server_mode(argc, argv);
+    }
+    char sock[PATH_MAX];
+    if (cc_server_client_socket(g_repo_root, sock, sizeof(sock))) {
+        /* `ccc run` reading a terminal stays local: the server's workers
+           are not in the terminal's foreground process group. */
+        int interactive_run = isatty(STDIN_FILENO) && argc >= 2 &&
+                              (strcmp(argv[1], "run") == 0 ||
+                               (strcmp(argv[1], "build") == 0 && argc >= 3 && strcmp(argv[2], "run") == 0));
+        int rc = 0;
+        if (!interactive_run && cc_server_forward(sock, argc, argv, &rc) == 0) return rc;
+    }
+    return cc__main(argc, argv);
+}
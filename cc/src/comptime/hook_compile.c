@@ -3,6 +3,7 @@
 #include <ctype.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <limits.h>
 #include <spawn.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -581,15 +582,17 @@ static int cc__cache_dir(char* out, size_t out_sz) {
     return cc__mkdir_p(out);
 }
 
-/* Toolchain fingerprint: cc binary mtime+size, computed once.  Ensures the
-   cache invalidates when the host compiler changes underneath us. */
+/* Toolchain fingerprint: cc binary mtime+size, computed once per $CC.
+   Ensures the cache invalidates when the host compiler changes underneath
+   us; keyed on the name because a compile-server worker inherits this from
+   the server's warm-up but runs with the client's environment. */
 static uint64_t cc__toolchain_fingerprint(void) {
     static uint64_t cached = 0;
-    static int      computed = 0;
-    if (computed) return cached;
-    computed = 1;
+    static char     cached_bin[PATH_MAX];
     const char* cc_bin = getenv("CC");
     if (!cc_bin || !cc_bin[0]) cc_bin = "/usr/bin/cc";
+    if (cached_bin[0] && strcmp(cached_bin, cc_bin) == 0) return cached;
+    snprintf(cached_bin, sizeof(cached_bin), "%s", cc_bin);
     struct stat st;
     if (stat(cc_bin, &st) == 0) {
         cached = cc__hash64_fnv(&st.st_mtime, sizeof(st.st_mtime), 0);
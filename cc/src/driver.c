@@ -6,13 +6,11 @@
 #include <string.h>
 
 #include "comptime/symbols.h"
+#include "util/pass_profile.h"
 #include "visitor/pass.h"
 
 // Stub pipeline: const pass then main pass (currently copies input->output).
-int cc_compile_with_config(const char *input_path, const char *output_path, const CCCompileConfig* config) {
-    if (!input_path || !output_path) {
-        return -1;
-    }
+static int cc__compile_tu(const char *input_path, const char *output_path, const CCCompileConfig* config) {
 
     CCSymbolTable* symbols = cc_symbols_new();
     if (!symbols) {
@@ -29,14 +27,18 @@ int cc_compile_with_config(const char *input_path, const char *output_path, cons
         }
     }
 
+    cc_pass_begin("const_pass");
     int err = cc_run_const_pass(input_path, symbols);
+    cc_pass_end(0);
     if (err != 0) {
         fprintf(stderr, "cc: const pass failed for %s (err=%d)\n", input_path, err);
         cc_symbols_free(symbols);
         return err;
     }
 
+    cc_pass_begin("main_pass");
     err = cc_run_main_pass(input_path, symbols, output_path);
+    cc_pass_end(0);
     if (err != 0) {
         if (err > 0) {
             fprintf(stderr, "cc: main pass failed for %s: %s (err=%d)\n",
@@ -50,6 +52,16 @@ int cc_compile_with_config(const char *input_path, const char *output_path, cons
     return err;
 }
 
+int cc_compile_with_config(const char *input_path, const char *output_path, const CCCompileConfig* config) {
+    if (!input_path || !output_path) {
+        return -1;
+    }
+    cc_pass_profile_tu_begin(input_path);
+    int err = cc__compile_tu(input_path, output_path, config);
+    cc_pass_profile_tu_end();
+    return err;
+}
+
 int cc_compile(const char *input_path, const char *output_path) {
     return cc_compile_with_config(input_path, output_path, NULL);
 }
@@ -0,0 +1,190 @@
+/*
+ * cc/src/header/header_cache.c
+ *
+ * See header_cache.h for the rationale. Same layout as the comptime dylib
+ * cache: FNV-1a 64-bit key, one file per entry, atomic rename on install.
+ */
+
+#include "header_cache.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "header/lower_header.h"
+#include "util/path.h"
+
+/* Bump when the cache entry format changes. */
+#define CC_HC_FORMAT "cc-lowered-header-v1"
+
+/* ------------------------------------------------------------------------- */
+/* Local helpers (FNV-1a hash, mkdir -p, whole-file read).                   */
+/* ------------------------------------------------------------------------- */
+
+static uint64_t cc__hc_fnv1a64_update(uint64_t h, const void* data, size_t n) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= (uint64_t)p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static int cc__hc_mkdir_p(const char* path) {
+    char tmp[1024];
+    size_t n = path ? strlen(path) : 0;
+    if (n == 0 || n >= sizeof(tmp)) return -1;
+    memcpy(tmp, path, n + 1);
+    for (char* p = tmp + 1; *p; ++p) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(tmp, 0777) == -1 && errno != EEXIST) return -1;
+        *p = '/';
+    }
+    if (mkdir(tmp, 0777) == -1 && errno != EEXIST) return -1;
+    return 0;
+}
+
+static char* cc__hc_read_file(const char* path, size_t* out_len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    if (fseek(f, 0, SEEK_END) != 0) { fclose(f); return NULL; }
+    long len = ftell(f);
+    if (len < 0 || fseek(f, 0, SEEK_SET) != 0) { fclose(f); return NULL; }
+    char* buf = (char*)malloc((size_t)len + 1);
+    if (!buf) { fclose(f); return NULL; }
+    size_t got = fread(buf, 1, (size_t)len, f);
+    fclose(f);
+    if (got != (size_t)len) { free(buf); return NULL; }
+    buf[got] = '\0';
+    if (out_len) *out_len = got;
+    return buf;
+}
+
+/* Write to `<path>.tmp.<pid>` and rename over `path`. */
+static int cc__hc_write_atomic(const char* path, const char* text, size_t len) {
+    char tmp[1024];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp.%ld", path, (long)getpid()) >= (int)sizeof(tmp)) {
+        return ENAMETOOLONG;
+    }
+    FILE* f = fopen(tmp, "wb");
+    if (!f) return errno ? errno : -1;
+    size_t put = fwrite(text, 1, len, f);
+    if (fclose(f) != 0 || put != len) {
+        unlink(tmp);
+        return EIO;
+    }
+    if (rename(tmp, path) != 0) {
+        int err = errno;
+        unlink(tmp);
+        return err ? err : -1;
+    }
+    return 0;
+}
+
+/* Size + mtime of the running binary, computed once. The lowering code is
+   linked into it, so rebuilding ccc (or lower_headers) changes the key. */
+static uint64_t cc__hc_binary_fingerprint(void) {
+    static uint64_t cached = 0;
+    static int computed = 0;
+    if (computed) return cached;
+    computed = 1;
+    char exe[1024];
+    if (!cc_path_self_exe(exe, sizeof(exe))) exe[0] = '\0';
+    struct stat st;
+    uint64_t h = 1469598103934665603ULL;
+    if (exe[0] && stat(exe, &st) == 0) {
+        h = cc__hc_fnv1a64_update(h, &st.st_size, sizeof(st.st_size));
+        h = cc__hc_fnv1a64_update(h, &st.st_mtime, sizeof(st.st_mtime));
+    } else {
+        /* No executable path: fall back to the build time of this file. */
+        h = cc__hc_fnv1a64_update(h, __DATE__ " " __TIME__, sizeof(__DATE__ " " __TIME__));
+    }
+    cached = h;
+    return cached;
+}
+
+static int cc__hc_cache_dir(const char* input_path, char* out, size_t out_sz) {
+    char repo_root[1024];
+    repo_root[0] = '\0';
+    if (input_path && cc_path_find_repo_root(input_path, repo_root, sizeof(repo_root)) && repo_root[0]) {
+        if (snprintf(out, out_sz, "%s/out/ccc-cache/headers", repo_root) >= (int)out_sz) return -1;
+    } else {
+        if (snprintf(out, out_sz, "/tmp/ccc-cache-headers-%ld", (long)getuid()) >= (int)out_sz) return -1;
+    }
+    return cc__hc_mkdir_p(out);
+}
+
+/* Cache file for this header text at this path (creates the directory). */
+static int cc__hc_entry_path(const char* input, size_t input_len, const char* input_path,
+                             char* out, size_t out_sz) {
+    char cache_dir[1024];
+    if (cc__hc_cache_dir(input_path, cache_dir, sizeof(cache_dir)) != 0) return -1;
+
+    uint64_t fp = cc__hc_binary_fingerprint();
+    uint64_t h = 1469598103934665603ULL;
+    h = cc__hc_fnv1a64_update(h, CC_HC_FORMAT, sizeof(CC_HC_FORMAT));
+    h = cc__hc_fnv1a64_update(h, &fp, sizeof(fp));
+    if (input_path) h = cc__hc_fnv1a64_update(h, input_path, strlen(input_path) + 1);
+    h = cc__hc_fnv1a64_update(h, input, input_len);
+
+    if (snprintf(out, out_sz, "%s/%016llx.h", cache_dir, (unsigned long long)h) >= (int)out_sz) return -1;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+static char* cc__hc_lower_uncached(const char* input, size_t input_len, const char* input_path) {
+    char* lowered = cc_lower_header_string(input, input_len, input_path);
+    if (lowered) return lowered;
+    char* copy = (char*)malloc(input_len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, input, input_len);
+    copy[input_len] = '\0';
+    return copy;
+}
+
+char* cc_lower_header_cached(const char* input, size_t input_len, const char* input_path) {
+    if (!input) return NULL;
+
+    const char* opt_out = getenv("CCC_NO_HEADER_CACHE");
+    if (opt_out && opt_out[0] && opt_out[0] != '0') {
+        return cc__hc_lower_uncached(input, input_len, input_path);
+    }
+
+    char entry[1200];
+    if (cc__hc_entry_path(input, input_len, input_path, entry, sizeof(entry)) != 0) {
+        return cc__hc_lower_uncached(input, input_len, input_path);
+    }
+
+    /* Hit: entries are only ever installed whole, so presence is enough. */
+    char* hit = cc__hc_read_file(entry, NULL);
+    if (hit) return hit;
+
+    char* lowered = cc__hc_lower_uncached(input, input_len, input_path);
+    if (!lowered) return NULL;
+    /* A failed install (read-only tree, racing rename) just means the next
+       invocation lowers again. */
+    (void)cc__hc_write_atomic(entry, lowered, strlen(lowered));
+    return lowered;
+}
+
+int cc_lower_header_install(const char* path, const char* text, size_t len) {
+    if (!path || !text) return EINVAL;
+    struct stat st;
+    if (stat(path, &st) == 0 && (size_t)st.st_size == len) {
+        size_t have_len = 0;
+        char* have = cc__hc_read_file(path, &have_len);
+        int same = have && have_len == len && memcmp(have, text, len) == 0;
+        free(have);
+        if (same) return 0;
+    }
+    return cc__hc_write_atomic(path, text, len);
+}
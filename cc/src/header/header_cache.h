@@ -0,0 +1,63 @@
+/*
+ * cc/src/header/header_cache.h
+ *
+ * Content-addressed cache for lowered .cch headers.
+ *
+ * Header lowering (cc_lower_header_string) runs in two places:
+ *
+ *     1. The lower_headers tool, which the ccc wrapper re-runs over every
+ *        `<ccc/...>` header whenever any .cch or runtime source is newer
+ *        than the stamp -- so touching one runtime .c re-lowers all of
+ *        cc_containers.cch, cc_channel.cch, ...
+ *     2. cc__lower_local_cch_header, which lowers each project-local
+ *        `#include "foo.cch"` once per ccc invocation and rewrites
+ *        out/include/<rel>.h every time.
+ *
+ * Both now go through this cache, so an unchanged header is lowered once
+ * per machine and its .h is only rewritten when the bytes differ (keeping
+ * the mtime stable for downstream make rules).
+ *
+ * Correctness / staleness:
+ *   - The key is an FNV-1a 64-bit hash of the header text (after local
+ *     include rewriting), its path, and a fingerprint of the running
+ *     binary (size + mtime of the ccc / lower_headers executable). Any
+ *     change to the header or to the lowering code produces a new key.
+ *   - Entries are installed by write-to-tmp + rename, so concurrent ccc
+ *     invocations never observe a partial file.
+ *   - `CCC_NO_HEADER_CACHE=1` disables the cache; lowering then runs every
+ *     time, exactly as before.
+ */
+
+#ifndef CC_HEADER_CACHE_H
+#define CC_HEADER_CACHE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lower `input` (the text of the .cch at `input_path`) through the cache.
+ *
+ * Returns the header text to install: the lowered output, or a copy of
+ * `input` when lowering made no change. NULL only on allocation failure.
+ * Caller frees. The cache lives at `<repo_root>/out/ccc-cache/headers/`
+ * (repo root found from `input_path`), falling back to a per-user tmp
+ * directory; an unwritable cache is silently skipped.
+ */
+char* cc_lower_header_cached(const char* input, size_t input_len, const char* input_path);
+
+/*
+ * Install `text` at `path` unless the file already holds exactly these
+ * bytes. Writes go to a tmp file renamed over `path`.
+ *
+ * Returns 0 on success (including "already up to date"), errno otherwise.
+ */
+int cc_lower_header_install(const char* path, const char* text, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CC_HEADER_CACHE_H */
@@ -6,6 +6,7 @@
  */
 
 #include "lower_header.h"
+#include "header_cache.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -527,26 +528,12 @@ int cc_lower_header(const char* cch_path, const char* h_path) {
     fclose(in);
     input[read_len] = '\0';
     
-    /* Lower the content */
-    char* output = cc_lower_header_string(input, read_len, cch_path);
-    
-    /* If no changes, copy input directly */
-    const char* to_write = output ? output : input;
-    size_t to_write_len = output ? strlen(output) : read_len;
-    
-    /* Write output file */
-    FILE* out = fopen(h_path, "w");
-    if (!out) {
-        int err = errno;
-        free(input);
-        free(output);
-        return err ? err : -1;
-    }
-    
-    fwrite(to_write, 1, to_write_len, out);
-    fclose(out);
-    
+    /* Lower the content (through the lowered-header cache), and leave the
+       .h untouched when it already holds the same bytes. */
+    char* output = cc_lower_header_cached(input, read_len, cch_path);
     free(input);
+    if (!output) return ENOMEM;
+    int err = cc_lower_header_install(h_path, output, strlen(output));
     free(output);
-    return 0;
+    return err;
 }
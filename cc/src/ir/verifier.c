@@ -6,8 +6,8 @@
 #include <string.h>
 
 /* Cache of the env-var lookup.  -1 = uninitialised, 0 = inactive,
- * 1 = active.  We never recompute; the env var is read at most once
- * per process. */
+ * 1 = active.  Only cc_ir_verify_reset() (a compile-server worker taking
+ * over a client's environment) makes us read the env var again. */
 static int cc_ir_verify_cache = -1;
 
 int cc_ir_verify_active(void) {
@@ -18,6 +18,10 @@ int cc_ir_verify_active(void) {
     return cc_ir_verify_cache;
 }
 
+void cc_ir_verify_reset(void) {
+    cc_ir_verify_cache = -1;
+}
+
 /* Locate the first differing byte; -1 if equal.  Length mismatch is
  * reported at min(a_len, b_len). */
 static long cc_ir_verify_first_diff(const char* a, size_t a_len,
@@ -31,6 +31,9 @@ extern "C" {
  * after the first call so passes can call this freely. */
 int cc_ir_verify_active(void);
 
+/* Drop that cache; the next cc_ir_verify_active() rereads CC_VERIFY_IR. */
+void cc_ir_verify_reset(void);
+
 /* Compare two pass outputs byte-for-byte.  `pass_name` is used in the
  * diagnostic (e.g. "result_unwrap").  `a` / `b` are the two candidate
  * outputs, `a_len` / `b_len` their lengths.
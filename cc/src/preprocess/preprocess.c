@@ -13,15 +13,18 @@
 #include <ccc/cc_slice.cch>
 
 #include "header/lower_header.h"
+#include "header/header_cache.h"
 #include "comptime/symbols.h"
 #include "preprocess/type_registry.h"
 #include "result_spec.h"
+#include "util/pass_profile.h"
 #include "util/path.h"
 #include "util/result_fn_registry.h"
 #include "util/text.h"
 #include "visitor/ufcs.h"
 #include "visitor/visitor.h"
 #include "visitor/pass_err_syntax.h"
+#include "visitor/pass_fiber_local.h"
 #include "visitor/pass_result_unwrap.h"
 #include "visitor/pass_unwrap_destroy.h"
 
@@ -199,6 +202,9 @@ static inline void cc_pass_chain_free(CCPassChain* c) {
 #define CC_CHAIN(c, call) \
     do { if (cc_pass_chain_apply(&(c), call) < 0) goto chain_cleanup; } while(0)
 
+/* Apply `fn(...)` to the chain, timed as pass `fn` under --time-passes. */
+#define CC_CHAIN_PASS(c, fn, ...) cc_pass_chain_apply((c), CC_PASS_TEXT(fn, __VA_ARGS__))
+
 /* ========================================================================== */
 /* End pass chain helper                                                      */
 /* ========================================================================== */
@@ -6632,7 +6638,7 @@ static char* cc__rewrite_cc_concurrent(const char* src, size_t n) {
 
     return NULL;
 }
-int cc_preprocess_file(const char* input_path, char* out_path, size_t out_path_sz) {
+static int cc__preprocess_file_impl(const char* input_path, char* out_path, size_t out_path_sz) {
     if (!input_path || !out_path || out_path_sz == 0) return -1;
     char tmp_path[] = "/tmp/cc_pp_XXXXXX.c";
     int fd = mkstemps(tmp_path, 2); /* keep .c suffix */
@@ -6811,9 +6817,16 @@ chain_cleanup:
     return -1;
 }
 
+int cc_preprocess_file(const char* input_path, char* out_path, size_t out_path_sz) {
+    cc_pass_begin("preprocess_file");
+    int rc = cc__preprocess_file_impl(input_path, out_path, out_path_sz);
+    cc_pass_end(0);
+    return rc;
+}
+
 // Preprocess source string to output string (no temp files).
 // skip_checks: if true, skip validation checks (use for reparse passes).
-char* cc_preprocess_to_string_ex(const char* input, size_t input_len, const char* input_path, int skip_checks) {
+static char* cc__preprocess_to_string_impl(const char* input, size_t input_len, const char* input_path, int skip_checks) {
     if (!input || input_len == 0) return NULL;
 
     /* Create type registry for this file (or reuse existing global) */
@@ -7364,6 +7377,11 @@ chain_cleanup:
     return NULL;
 }
 
+char* cc_preprocess_to_string_ex(const char* input, size_t input_len, const char* input_path, int skip_checks) {
+    cc_pass_begin("preprocess");
+    return cc_pass_end_text(cc__preprocess_to_string_impl(input, input_len, input_path, skip_checks));
+}
+
 // Wrapper that runs all checks (default behavior for initial parse).
 char* cc_preprocess_to_string(const char* input, size_t input_len, const char* input_path) {
     return cc_preprocess_to_string_ex(input, input_len, input_path, 0);
@@ -7455,16 +7473,6 @@ static int cc__read_file_text(const char* path, char** out_buf, size_t* out_len)
     return 0;
 }
 
-static int cc__write_file_text(const char* path, const char* buf, size_t len) {
-    FILE* f = NULL;
-    if (!path || !buf) return -1;
-    f = fopen(path, "w");
-    if (!f) return -1;
-    fwrite(buf, 1, len, f);
-    fclose(f);
-    return 0;
-}
-
 static int cc__build_stable_lowered_header_path(const char* abs_src,
                                                 char* out_path,
                                                 size_t out_path_sz) {
@@ -7533,12 +7541,13 @@ static const char* cc__lower_local_cch_header(const char* source_path) {
     if (cc__mkpath_local(lowered_dir) != 0) return NULL;
     if (cc__read_file_text(abs_src, &input, &input_len) != 0) return NULL;
     rewritten = cc__rewrite_local_cch_includes_impl(input, input_len, abs_src);
-    lowered = cc_lower_header_string(rewritten ? rewritten : input,
+    /* Unchanged headers come from the lowered-header cache, and the .h is
+       only rewritten when its bytes differ so its mtime stays stable. */
+    lowered = cc_lower_header_cached(rewritten ? rewritten : input,
                                      rewritten ? strlen(rewritten) : input_len,
                                      abs_src);
-    if (!lowered) lowered = strdup(rewritten ? rewritten : input);
     if (!lowered) return NULL;
-    if (cc__write_file_text(lowered_path, lowered, strlen(lowered)) != 0) return NULL;
+    if (cc_lower_header_install(lowered_path, lowered, strlen(lowered)) != 0) return NULL;
     if (cc__ensure_lowered_local_header_capacity(g_lowered_local_header_count + 1) != 0) return NULL;
     lowered_idx = g_lowered_local_header_count++;
     memset(&g_lowered_local_headers[lowered_idx], 0, sizeof(g_lowered_local_headers[lowered_idx]));
@@ -7673,10 +7682,10 @@ char* cc_rewrite_header_type_syntax_shared(const char* src,
     cc_type_registry_clear(reg);
 
     cc_pass_chain_init(&chain, src, input_len);
-    if (cc_pass_chain_apply(&chain, cc__rewrite_string_templates(chain.src, chain.len, input_path)) < 0) goto chain_cleanup;
-    if (cc_pass_chain_apply(&chain, cc__rewrite_chan_handle_types(chain.src, chain.len, input_path)) < 0) goto chain_cleanup;
-    if (cc_pass_chain_apply(&chain, cc__rewrite_slice_types(chain.src, chain.len, input_path)) < 0) goto chain_cleanup;
-    if (cc_pass_chain_apply(&chain, cc_rewrite_generic_containers(chain.src, chain.len, input_path)) < 0) goto chain_cleanup;
+    if (CC_CHAIN_PASS(&chain, cc__rewrite_string_templates, chain.src, chain.len, input_path) < 0) goto chain_cleanup;
+    if (CC_CHAIN_PASS(&chain, cc__rewrite_chan_handle_types, chain.src, chain.len, input_path) < 0) goto chain_cleanup;
+    if (CC_CHAIN_PASS(&chain, cc__rewrite_slice_types, chain.src, chain.len, input_path) < 0) goto chain_cleanup;
+    if (CC_CHAIN_PASS(&chain, cc_rewrite_generic_containers, chain.src, chain.len, input_path) < 0) goto chain_cleanup;
 
     if (chain.src != src) out = strdup(chain.src);
 
@@ -7741,28 +7750,28 @@ static int cc__apply_phase1_canonical_passes(CCPassChain* chain,
     if (!chain) return -1;
     /* Shared phase-1 bucket: normalize CC surface syntax into more canonical
        CC, but do not introduce parser stubs or host-C survival/lowering. */
-    if (cc_pass_chain_apply(chain, cc__canonicalize_with_deadline_syntax(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_string_templates(chain->src, chain->len, input_path)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_chan_handle_types(chain->src, chain->len, input_path)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_slice_types(chain->src, chain->len, input_path)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc_rewrite_generic_containers(chain->src, chain->len, input_path)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_optional_types(chain->src, chain->len, input_path)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_inferred_result_ctors(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_result_types(chain->src, chain->len, input_path)) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__canonicalize_with_deadline_syntax, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_string_templates, chain->src, chain->len, input_path) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_chan_handle_types, chain->src, chain->len, input_path) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_slice_types, chain->src, chain->len, input_path) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc_rewrite_generic_containers, chain->src, chain->len, input_path) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_optional_types, chain->src, chain->len, input_path) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_inferred_result_ctors, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_result_types, chain->src, chain->len, input_path) < 0) return -1;
     /* Rewrite `@async void fn(...)` -> `@async CCAsyncVoidRet fn(...)` so
      * that phase-3 reparse sees a task-returning signature (required for
      * spawn-site lowerings such as `n->spawn_async(fn(args))` to type-check).
      * async_ast recognises CCAsyncVoidRet as an originally-void declaration. */
-    if (cc_pass_chain_apply(chain, cc__rewrite_async_void_ret(chain->src, chain->len)) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_async_void_ret, chain->src, chain->len) < 0) return -1;
     /* Call-site `@blocking f(...)` / `@noblock f(...)` annotations
      * (spec §8.2.2 rule 1).  Runs before @await so an `@await`-wrapping
      * is not accidentally treated as a call-site mode host. */
-    if (cc_pass_chain_apply(chain, cc__rewrite_at_call_site_mode(chain->src, chain->len)) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_at_call_site_mode, chain->src, chain->len) < 0) return -1;
     /* @await fname(...) -> cc_block_on(ReturnType, fname(...)).  Runs after
      * result-type rewriting so the return types are already in canonical form. */
-    if (cc_pass_chain_apply(chain, cc__rewrite_at_await(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__normalize_if_try_syntax(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_try_binding(chain->src, chain->len)) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_at_await, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__normalize_if_try_syntax, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_try_binding, chain->src, chain->len) < 0) return -1;
     return 0;
 }
 
@@ -7801,9 +7810,10 @@ static int cc__apply_phase3_host_lowering_passes(CCPassChain* chain,
             if (cc_contains_token_top_level(chain->src, chain->len, "@destroy")) {
                 char* ud_out = NULL;
                 size_t ud_out_len = 0;
+                cc_pass_begin("cc__rewrite_unwrap_destroy_suffix");
                 int ud_r = cc__rewrite_unwrap_destroy_suffix(
                     chain->src, chain->len, input_path, &ud_out, &ud_out_len);
-                (void)ud_out_len;
+                cc_pass_end(ud_r > 0 ? ud_out_len : 0);
                 if (ud_r < 0) return -1;
                 if (ud_r > 0 && ud_out && cc_pass_chain_apply(chain, ud_out) < 0) return -1;
             }
@@ -7819,8 +7829,9 @@ static int cc__apply_phase3_host_lowering_passes(CCPassChain* chain,
             char* ru_out = NULL;
             size_t ru_out_len = 0;
             CCVisitorCtx ru_ctx = {.symbols = NULL, .input_path = input_path};
+            cc_pass_begin("cc__rewrite_result_unwrap");
             int ru_r = cc__rewrite_result_unwrap(&ru_ctx, chain->src, chain->len, &ru_out, &ru_out_len);
-            (void)ru_out_len;
+            cc_pass_end(ru_r > 0 ? ru_out_len : 0);
             if (ru_r < 0) return -1;
             if (ru_r > 0 && ru_out && cc_pass_chain_apply(chain, ru_out) < 0) return -1;
         }
@@ -7833,13 +7844,26 @@ static int cc__apply_phase3_host_lowering_passes(CCPassChain* chain,
         char* err_out = NULL;
         size_t err_out_len = 0;
         CCVisitorCtx err_ctx = {.symbols = NULL, .input_path = input_path};
+        cc_pass_begin("cc__rewrite_err_syntax");
         int err_r = cc__rewrite_err_syntax(&err_ctx, chain->src, chain->len, &err_out, &err_out_len);
-        (void)err_out_len;
+        cc_pass_end(err_r > 0 ? err_out_len : 0);
         if (err_r < 0) return -1;
         if (err_r > 0 && err_out && cc_pass_chain_apply(chain, err_out) < 0) return -1;
     }
-    if (cc_pass_chain_apply(chain, cc__lower_with_deadline_syntax(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_match_syntax(chain->src, chain->len, input_path)) < 0) return -1;
+    if (chain->src && chain->len > 0 &&
+        cc_contains_token_top_level(chain->src, chain->len, "@fiber_local")) {
+        /* `@fiber_local` is not a TCC decl attribute; lower it before the parse. */
+        char* fl_out = NULL;
+        size_t fl_out_len = 0;
+        CCVisitorCtx fl_ctx = {.symbols = NULL, .input_path = input_path};
+        cc_pass_begin("cc__lower_fiber_locals");
+        int fl_r = cc__lower_fiber_locals(&fl_ctx, chain->src, chain->len, &fl_out, &fl_out_len);
+        cc_pass_end(fl_r > 0 ? fl_out_len : 0);
+        if (fl_r < 0) return -1;
+        if (fl_r > 0 && fl_out && cc_pass_chain_apply(chain, fl_out) < 0) return -1;
+    }
+    if (CC_CHAIN_PASS(chain, cc__lower_with_deadline_syntax, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_match_syntax, chain->src, chain->len, input_path) < 0) return -1;
     /* (retired) cc__rewrite_optional_constructors used to run here. */
     cc__seed_ufcs_receiver_types(chain->src, chain->len);
     /* (retired) cc__rewrite_result_constructors used to rewrite typed
@@ -7848,11 +7872,11 @@ static int cc__apply_phase3_host_lowering_passes(CCPassChain* chain,
        mode.  With real typed structs, the typed ctor calls parse and
        type-check as-is, so the rewrite is both redundant and harmful
        (it forced a __CCResultGeneric return into a typed Result slot). */
-    if (cc_pass_chain_apply(chain, cc_rewrite_generic_family_ufcs_parser_safe(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_try_exprs(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_optional_unwrap(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_cc_concurrent(chain->src, chain->len)) < 0) return -1;
-    if (cc_pass_chain_apply(chain, cc__rewrite_link_directives(chain->src, chain->len)) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc_rewrite_generic_family_ufcs_parser_safe, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_try_exprs, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_optional_unwrap, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_cc_concurrent, chain->src, chain->len) < 0) return -1;
+    if (CC_CHAIN_PASS(chain, cc__rewrite_link_directives, chain->src, chain->len) < 0) return -1;
     return 0;
 }
 
@@ -7878,7 +7902,7 @@ static char* cc__canonicalize_cc_for_comptime(const char* input,
     cc_type_registry_clear(reg);
 
     cc_pass_chain_init(&chain, input, input_len);
-    if (cc_pass_chain_apply(&chain, cc__rewrite_link_directives(chain.src, chain.len)) < 0) goto cleanup;
+    if (CC_CHAIN_PASS(&chain, cc__rewrite_link_directives, chain.src, chain.len) < 0) goto cleanup;
     if (cc__apply_phase1_canonical_passes(&chain, input_path) != 0) goto cleanup;
 
     out = strdup(chain.src);
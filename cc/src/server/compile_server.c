@@ -0,0 +1,510 @@
+/*
+ * cc/src/server/compile_server.c
+ *
+ * See compile_server.h for the model. Wire format, one request per
+ * connection:
+ *
+ *   client -> server   CCServerRequest, carrying fds 0/1/2 as SCM_RIGHTS
+ *                      payload: cwd\0 argv[0]\0 ... argv[argc-1]\0
+ *                               env[0]\0 ... env[envc-1]\0
+ *   server -> client   CCServerReply
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE                             /* struct ucred */
+#endif
+
+#include "compile_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "util/path.h"
+
+extern char** environ;
+
+#define CC_SERVER_MAGIC 0x43435331u             /* "CCS1" */
+#define CC_SERVER_MAX_PAYLOAD (16u << 20)
+
+enum {
+    CC_SERVER_REPLY_DONE = 0,                   /* status = exit code (128+sig if killed) */
+    CC_SERVER_REPLY_LOCAL = 1,                  /* compile locally (fork failed) */
+    CC_SERVER_REPLY_MISMATCH = 2,               /* server runs a different ccc binary */
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t argc;
+    uint32_t envc;
+    uint32_t payload_len;
+    uint64_t fingerprint;
+} CCServerRequest;
+
+typedef struct {
+    int32_t kind;
+    int32_t status;
+} CCServerReply;
+
+static volatile sig_atomic_t g_cc_server_stop = 0;
+
+/* The server's fingerprint, taken at startup: re-stat'ing later would see
+   the rebuilt binary and call it our own. */
+static uint64_t g_cc_server_fp = 0;
+
+/* ------------------------------------------------------------------------- */
+/* Helpers                                                                   */
+/* ------------------------------------------------------------------------- */
+
+/* Size + mtime of the running binary: a rebuilt ccc must not be served by
+   an old server. */
+static uint64_t cc__srv_fingerprint(void) {
+    char exe[PATH_MAX];
+    struct stat st;
+    uint64_t h = 1469598103934665603ULL;
+    if (!cc_path_self_exe(exe, sizeof(exe)) || stat(exe, &st) != 0) return 0;
+    const unsigned char* parts[2] = { (const unsigned char*)&st.st_size,
+                                      (const unsigned char*)&st.st_mtime };
+    size_t lens[2] = { sizeof(st.st_size), sizeof(st.st_mtime) };
+    for (int k = 0; k < 2; ++k) {
+        for (size_t i = 0; i < lens[k]; ++i) {
+            h ^= (uint64_t)parts[k][i];
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+#ifdef MSG_NOSIGNAL
+#define CC_SRV_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define CC_SRV_SEND_FLAGS 0                     /* SO_NOSIGPIPE set on connect */
+#endif
+
+/* Socket writes must not raise SIGPIPE: a server that hangs up early (a
+   mismatch answer) must reach the error path, not kill the client. */
+static int cc__srv_write_all(int fd, const void* buf, size_t n) {
+    const char* p = (const char*)buf;
+    while (n > 0) {
+        ssize_t w = send(fd, p, n, CC_SRV_SEND_FLAGS);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+static int cc__srv_read_all(int fd, void* buf, size_t n) {
+    char* p = (char*)buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        p += r;
+        n -= (size_t)r;
+    }
+    return 0;
+}
+
+static int cc__srv_sockaddr(const char* path, struct sockaddr_un* sa) {
+    if (!path || !path[0]) return -1;
+    memset(sa, 0, sizeof(*sa));
+    sa->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(sa->sun_path)) return -1;
+    strcpy(sa->sun_path, path);
+    return 0;
+}
+
+/* Uid of the process on the other end of a connected unix socket. The
+   client hands over its environment and stdio, and the server runs code
+   as itself: each side only talks to its own user. */
+static int cc__srv_peer_uid(int fd, uid_t* out) {
+#if defined(__linux__)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) return -1;
+    *out = cred.uid;
+#else
+    gid_t gid;
+    if (getpeereid(fd, out, &gid) != 0) return -1;
+#endif
+    return 0;
+}
+
+/* The fallback socket lives in a per-user directory rather than straight
+   in /tmp, where anyone can pre-create the path. Refuse a directory that
+   is a symlink, someone else's, or open to group/other. */
+static int cc__srv_private_dir(const char* dir) {
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return -1;
+    struct stat st;
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != getuid() ||
+        (st.st_mode & 077) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static void cc__srv_append(char** buf, size_t* len, size_t* cap, const char* s) {
+    size_t n = strlen(s) + 1;
+    if (!*buf && *cap) return;                  /* earlier allocation failed */
+    if (*len + n > *cap) {
+        size_t nc = *cap ? *cap * 2 : 4096;
+        while (nc < *len + n) nc *= 2;
+        char* nb = (char*)realloc(*buf, nc);
+        if (!nb) { free(*buf); *buf = NULL; *cap = 1; return; }
+        *buf = nb;
+        *cap = nc;
+    }
+    memcpy(*buf + *len, s, n);
+    *len += n;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Client                                                                    */
+/* ------------------------------------------------------------------------- */
+
+int cc_server_default_socket(const char* repo_root, char* out, size_t out_sz) {
+    int n;
+    if (repo_root && repo_root[0]) {
+        n = snprintf(out, out_sz, "%s/out/ccc-server.sock", repo_root);
+    } else {
+        char dir[64];
+        snprintf(dir, sizeof(dir), "/tmp/ccc-%ld", (long)getuid());
+        if (cc__srv_private_dir(dir) != 0) {
+            fprintf(stderr, "ccc: %s is not a private directory owned by this user\n", dir);
+            return -1;
+        }
+        n = snprintf(out, out_sz, "%s/server.sock", dir);
+    }
+    return (n > 0 && (size_t)n < out_sz) ? 0 : -1;
+}
+
+int cc_server_client_socket(const char* repo_root, char* out, size_t out_sz) {
+    const char* explicit_path = getenv("CCC_SERVER_SOCKET");
+    if (explicit_path && explicit_path[0]) {
+        if (strlen(explicit_path) >= out_sz) return 0;
+        strcpy(out, explicit_path);
+        return 1;
+    }
+    const char* on = getenv("CCC_SERVER");
+    if (!on || !on[0] || on[0] == '0') return 0;
+    return cc_server_default_socket(repo_root, out, out_sz) == 0;
+}
+
+int cc_server_forward(const char* sock_path, int argc, char** argv, int* exit_code) {
+    struct sockaddr_un sa;
+    if (!exit_code || cc__srv_sockaddr(sock_path, &sa) != 0) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&sa, sizeof(sa)) != 0) {
+        close(fd);
+        return -1;
+    }
+    uid_t peer;
+    if (cc__srv_peer_uid(fd, &peer) != 0 || peer != getuid()) {
+        fprintf(stderr, "ccc: compile server on %s belongs to another user; compiling locally\n",
+                sock_path);
+        close(fd);
+        return -1;
+    }
+#ifdef SO_NOSIGPIPE
+    {
+        int one = 1;
+        (void)setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    }
+#endif
+
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd))) { close(fd); return -1; }
+    char* payload = NULL;
+    size_t len = 0, cap = 0;
+    uint32_t envc = 0;
+    cc__srv_append(&payload, &len, &cap, cwd);
+    for (int i = 0; i < argc; ++i) cc__srv_append(&payload, &len, &cap, argv[i]);
+    for (char** e = environ; e && *e; ++e, ++envc) cc__srv_append(&payload, &len, &cap, *e);
+    if (!payload || len > CC_SERVER_MAX_PAYLOAD) {
+        free(payload);
+        close(fd);
+        return -1;
+    }
+
+    CCServerRequest req = {
+        .magic = CC_SERVER_MAGIC,
+        .argc = (uint32_t)argc,
+        .envc = envc,
+        .payload_len = (uint32_t)len,
+        .fingerprint = cc__srv_fingerprint(),
+    };
+    int fds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    union {
+        struct cmsghdr h;
+        char buf[CMSG_SPACE(sizeof(fds))];
+    } ctl;
+    memset(&ctl, 0, sizeof(ctl));
+    struct iovec iov = { .iov_base = &req, .iov_len = sizeof(req) };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+    struct cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(fd, &msg, CC_SRV_SEND_FLAGS);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != (ssize_t)sizeof(req) || cc__srv_write_all(fd, payload, len) != 0) {
+        free(payload);
+        close(fd);
+        return -1;
+    }
+    free(payload);
+
+    CCServerReply reply;
+    if (cc__srv_read_all(fd, &reply, sizeof(reply)) != 0) {
+        /* The worker may already have produced output; running again
+           locally could duplicate side effects, so report instead. */
+        close(fd);
+        fprintf(stderr, "ccc: compile server dropped the request (%s)\n", sock_path);
+        *exit_code = 1;
+        return 0;
+    }
+    close(fd);
+    if (reply.kind == CC_SERVER_REPLY_MISMATCH) {
+        /* The server may be serving other clients built from its own
+           binary; leave it running and let the user restart it. */
+        fprintf(stderr, "ccc: compile server on %s runs a different ccc build; "
+                        "restart it or unset CCC_SERVER/CCC_SERVER_SOCKET\n", sock_path);
+        *exit_code = 1;
+        return 0;
+    }
+    if (reply.kind != CC_SERVER_REPLY_DONE) return -1;
+    *exit_code = reply.status;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Server                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static void cc__srv_on_stop(int sig) {
+    (void)sig;
+    g_cc_server_stop = 1;
+}
+
+static void cc__srv_reply(int conn, int kind, int status) {
+    CCServerReply reply = { .kind = kind, .status = status };
+    (void)cc__srv_write_all(conn, &reply, sizeof(reply));
+}
+
+/* Handler process: one per connection. Runs the request in a worker so a
+   crashing compile still gets its status reported. */
+static int cc__srv_handle(int conn, CCServerMainFn main_fn) {
+    uid_t peer;
+    if (cc__srv_peer_uid(conn, &peer) != 0 || peer != getuid()) return 1;
+    CCServerRequest req;
+    int fds[3] = { -1, -1, -1 };
+    union {
+        struct cmsghdr h;
+        char buf[CMSG_SPACE(sizeof(fds))];
+    } ctl;
+    struct iovec iov = { .iov_base = &req, .iov_len = sizeof(req) };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+    ssize_t got;
+    do {
+        got = recvmsg(conn, &msg, 0);
+    } while (got < 0 && errno == EINTR);
+    for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS &&
+            cm->cmsg_len == CMSG_LEN(sizeof(fds))) {
+            memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+        }
+    }
+    if (got != (ssize_t)sizeof(req) || req.magic != CC_SERVER_MAGIC || fds[0] < 0 ||
+        req.payload_len > CC_SERVER_MAX_PAYLOAD || req.argc == 0) {
+        return 1;
+    }
+    if (req.fingerprint != g_cc_server_fp) {
+        cc__srv_reply(conn, CC_SERVER_REPLY_MISMATCH, 0);
+        return 0;
+    }
+
+    char* payload = (char*)malloc((size_t)req.payload_len + 1);
+    char** argv = (char**)calloc((size_t)req.argc + 1, sizeof(char*));
+    char** envp = (char**)calloc((size_t)req.envc + 1, sizeof(char*));
+    if (!payload || !argv || !envp ||
+        cc__srv_read_all(conn, payload, req.payload_len) != 0) {
+        return 1;
+    }
+    payload[req.payload_len] = '\0';
+    char* p = payload;
+    char* end = payload + req.payload_len;
+    const char* cwd = p;
+    p += strlen(p) + 1;
+    for (uint32_t i = 0; i < req.argc; ++i) {
+        if (p >= end) return 1;
+        argv[i] = p;
+        p += strlen(p) + 1;
+    }
+    for (uint32_t i = 0; i < req.envc; ++i) {
+        if (p >= end) return 1;
+        envp[i] = p;
+        p += strlen(p) + 1;
+    }
+
+    /* Closes when the worker exits; nothing else in it is inherited past
+       an exec. */
+    int done_pipe[2];
+    if (pipe(done_pipe) != 0) return 1;
+    fcntl(done_pipe[1], F_SETFD, FD_CLOEXEC);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        cc__srv_reply(conn, CC_SERVER_REPLY_LOCAL, 0);
+        return 1;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        close(done_pipe[0]);
+        close(conn);
+        for (int i = 0; i < 3; ++i) {
+            if (fds[i] != i) {
+                dup2(fds[i], i);
+                close(fds[i]);
+            }
+        }
+        signal(SIGPIPE, SIG_DFL);
+        if (chdir(cwd) != 0) {
+            fprintf(stderr, "ccc: server: chdir %s: %s\n", cwd, strerror(errno));
+            exit(1);
+        }
+        environ = envp;
+        exit(main_fn((int)req.argc, argv));
+    }
+
+    close(done_pipe[1]);
+    for (int i = 0; i < 3; ++i) close(fds[i]);
+    /* Wait for the worker, or for the client to hang up (then kill the
+       worker and everything it spawned). */
+    for (;;) {
+        struct pollfd pf[2] = {
+            { .fd = done_pipe[0], .events = POLLIN },
+            { .fd = conn, .events = POLLIN },
+        };
+        int r = poll(pf, 2, -1);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0 || pf[0].revents) break;
+        if (pf[1].revents) {
+            kill(-pid, SIGKILL);
+            break;
+        }
+    }
+    int st = 0;
+    while (waitpid(pid, &st, 0) < 0 && errno == EINTR) {}
+    int status = WIFEXITED(st) ? WEXITSTATUS(st) : WIFSIGNALED(st) ? 128 + WTERMSIG(st) : 1;
+    cc__srv_reply(conn, CC_SERVER_REPLY_DONE, status);
+    return 0;
+}
+
+int cc_server_run(const char* sock_path, int idle_sec,
+                  CCServerWarmFn warm, CCServerMainFn main_fn) {
+    struct sockaddr_un sa;
+    if (!main_fn || cc__srv_sockaddr(sock_path, &sa) != 0) {
+        fprintf(stderr, "ccc: server: bad socket path '%s'\n", sock_path ? sock_path : "");
+        return 1;
+    }
+
+    /* A live server already owns the path: nothing to do. A dead one left
+       its socket file behind: take it over. */
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0) {
+        int live = connect(probe, (struct sockaddr*)&sa, sizeof(sa)) == 0;
+        close(probe);
+        if (live) {
+            fprintf(stderr, "ccc: server already listening on %s\n", sock_path);
+            return 0;
+        }
+    }
+    unlink(sock_path);
+
+    g_cc_server_fp = cc__srv_fingerprint();
+    if (warm) warm();
+
+    /* Create the socket file owner-only from the start: a chmod after
+       bind() leaves a window where other users can connect. */
+    mode_t old_mask = umask(0077);
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int bound_ok = lfd >= 0 && bind(lfd, (struct sockaddr*)&sa, sizeof(sa)) == 0;
+    umask(old_mask);
+    if (!bound_ok || listen(lfd, 128) != 0) {
+        fprintf(stderr, "ccc: server: cannot listen on %s: %s\n", sock_path, strerror(errno));
+        if (lfd >= 0) close(lfd);
+        return 1;
+    }
+    struct stat bound;
+    int have_bound = stat(sock_path, &bound) == 0;
+
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = cc__srv_on_stop;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGINT, &act, NULL);
+    sigaction(SIGTERM, &act, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGCHLD, SIG_IGN);                   /* auto-reap handlers */
+
+    fprintf(stderr, "ccc: compile server listening on %s (pid %ld)\n", sock_path, (long)getpid());
+    while (!g_cc_server_stop) {
+        struct pollfd pf = { .fd = lfd, .events = POLLIN };
+        int r = poll(&pf, 1, idle_sec > 0 ? idle_sec * 1000 : -1);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) break;
+        if (r == 0) {
+            fprintf(stderr, "ccc: compile server idle for %ds, exiting\n", idle_sec);
+            break;
+        }
+        int conn = accept(lfd, NULL, NULL);
+        if (conn < 0) continue;
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(lfd);
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGCHLD, SIG_DFL);
+            _exit(cc__srv_handle(conn, main_fn));
+        }
+        close(conn);
+    }
+
+    close(lfd);
+    /* Only remove the socket if a newer server has not replaced it. */
+    struct stat now;
+    if (have_bound && stat(sock_path, &now) == 0 &&
+        now.st_ino == bound.st_ino && now.st_dev == bound.st_dev) {
+        unlink(sock_path);
+    }
+    return 0;
+}
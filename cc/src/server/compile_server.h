@@ -0,0 +1,88 @@
+/*
+ * cc/src/server/compile_server.h
+ *
+ * Opt-in compile server (`ccc --server`).
+ *
+ * Every ccc invocation is a fresh process: exec + dynamic linking, path
+ * discovery, and a cold start for everything the lowering pipeline reads
+ * from disk. The server keeps one warm ccc process listening on a unix
+ * socket and serves each client invocation from a fork() of it:
+ *
+ *     client (ccc)                      server (ccc --server)
+ *     ------------                      ---------------------
+ *     connect, send argv/cwd/environ ─▶ accept, fork a handler
+ *     + stdin/stdout/stderr (SCM_RIGHTS)  handler forks the worker:
+ *                                           dup2 client fds, chdir, environ,
+ *                                           run ccc's main, exit(rc)
+ *     wait for the status   ◀───────── handler reports exit code / signal
+ *     exit(status)
+ *
+ * The fork model is deliberate: ccc's passes keep per-TU state in globals
+ * (type registry, result-fn registry, UFCS tables), so a worker must start
+ * from exactly the state a fresh process would have. Before it starts
+ * accepting, the server compiles one prelude-only probe TU in its own
+ * process: that fills the on-disk lowered-header and comptime dylib caches
+ * and leaves the prelude's type registry, result-fn tables, lowered-header
+ * memo, path discovery and the binary's pages warm in the server. Every
+ * worker starts from that snapshot copy-on-write -- the same state the
+ * second TU of a multi-file `ccc build` sees. Nothing a worker learns
+ * flows back into the server.
+ *
+ * Staleness: the client sends the size + mtime of its executable. A
+ * server built from a different binary answers "mismatch" and keeps
+ * serving; the client reports an error instead of compiling. A client
+ * that cannot reach a server, or finds one run by another user, compiles
+ * locally; the server likewise drops connections from other users (peer
+ * credentials on both ends). A client that goes away (Ctrl-C, cc_test
+ * build timeout) gets its worker's process group killed.
+ */
+
+#ifndef CC_COMPILE_SERVER_H
+#define CC_COMPILE_SERVER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ccc's main, run by each worker with the client's argv. */
+typedef int (*CCServerMainFn)(int argc, char** argv);
+
+/* One-time warm-up, run in the server before it accepts connections. */
+typedef void (*CCServerWarmFn)(void);
+
+/*
+ * Socket the client should use, or 0 if the client should not try a
+ * server: `CCC_SERVER_SOCKET=path` names one explicitly, `CCC_SERVER=1`
+ * selects `<repo_root>/out/ccc-server.sock`.
+ */
+int cc_server_client_socket(const char* repo_root, char* out, size_t out_sz);
+
+/* Default socket path for `ccc --server` without --socket:
+   `<repo_root>/out/ccc-server.sock`, or `/tmp/ccc-<uid>/server.sock`
+   without a repo root (the directory is created 0700 and must be ours). */
+int cc_server_default_socket(const char* repo_root, char* out, size_t out_sz);
+
+/*
+ * Forward this invocation to the server at `sock_path`.
+ *
+ * Returns 0 and sets *exit_code when the server ran it (or refused it as
+ * built from a different binary); -1 when the caller should compile
+ * locally (no server, fork failure, protocol error).
+ */
+int cc_server_forward(const char* sock_path, int argc, char** argv, int* exit_code);
+
+/*
+ * Serve requests on `sock_path` until SIGINT/SIGTERM or
+ * `idle_sec` seconds without a connection (0 = never). Returns a process
+ * exit code.
+ */
+int cc_server_run(const char* sock_path, int idle_sec,
+                  CCServerWarmFn warm, CCServerMainFn main_fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CC_COMPILE_SERVER_H */
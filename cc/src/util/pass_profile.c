@@ -0,0 +1,227 @@
+#include "util/pass_profile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CC_PASS_PROFILE_DEPTH 32
+#define CC_PASS_PROFILE_NAMES 128
+
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    size_t bytes;
+    int reparses;
+} CCPassFrame;
+
+typedef struct {
+    const char* name;
+    int calls;
+    uint64_t ns;
+    size_t bytes;
+    int reparses;
+} CCPassTotal;
+
+static int g_pass_profile_mode = -1;    /* -1 unknown, else bit 1 = table, bit 2 = trace */
+static const char* g_pass_trace_path = NULL;
+static int g_pass_trace_fd = -1;
+static const char* g_pass_tu = NULL;
+static uint64_t g_pass_tu_start_ns = 0;
+static CCPassFrame g_pass_stack[CC_PASS_PROFILE_DEPTH];
+static int g_pass_depth = 0;
+static CCPassTotal g_pass_totals[CC_PASS_PROFILE_NAMES];
+static int g_pass_total_count = 0;
+static int g_pass_tu_reparses = 0;
+
+static uint64_t cc__pass_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int cc_pass_profile_enabled(void) {
+    if (g_pass_profile_mode < 0) {
+        const char* t = getenv("CC_TIME_PASSES");
+        const char* p = getenv("CC_TRACE_PASSES");
+        g_pass_profile_mode = 0;
+        if (t && t[0] && t[0] != '0') g_pass_profile_mode |= 1;
+        if (p && p[0]) {
+            g_pass_profile_mode |= 2;
+            g_pass_trace_path = p;
+        }
+    }
+    return g_pass_profile_mode;
+}
+
+void cc_pass_profile_reset(void) {
+    if (g_pass_trace_fd >= 0) close(g_pass_trace_fd);
+    g_pass_trace_fd = -1;
+    g_pass_profile_mode = -1;
+    g_pass_trace_path = NULL;
+    g_pass_tu = NULL;
+    g_pass_depth = 0;
+    g_pass_total_count = 0;
+    g_pass_tu_reparses = 0;
+}
+
+void cc_pass_profile_trace_reset(const char* path) {
+    if (!path || !path[0]) return;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "cc: cannot write pass trace %s: %s\n", path, strerror(errno));
+        return;
+    }
+    /* JSON array form; the closing ']' is optional for trace viewers, which
+       lets every compiling process append independently. */
+    (void)write(fd, "[\n", 2);
+    close(fd);
+}
+
+/* Escape s as a JSON string body into out (cap bytes), the way the runtime
+   tracer's Perfetto export does: '"' and '\' get a backslash, control
+   characters become \u00XX. A string that does not fit is cut between
+   escapes, so the event stays valid JSON. */
+static const char* cc__pass_json_str(char* out, size_t cap, const char* s) {
+    size_t n = 0;
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        char esc[8];
+        int k;
+        if (c == '"' || c == '\\') k = snprintf(esc, sizeof(esc), "\\%c", c);
+        else if (c < 0x20) k = snprintf(esc, sizeof(esc), "\\u%04x", c);
+        else {
+            esc[0] = (char)c;
+            k = 1;
+        }
+        if (n + (size_t)k >= cap) break;
+        memcpy(out + n, esc, (size_t)k);
+        n += (size_t)k;
+    }
+    out[n] = '\0';
+    return out;
+}
+
+static void cc__pass_trace_event(const char* name, uint64_t start_ns, uint64_t dur_ns, size_t bytes, int reparses) {
+    if (!(g_pass_profile_mode & 2)) return;
+    if (g_pass_trace_fd < 0) {
+        g_pass_trace_fd = open(g_pass_trace_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (g_pass_trace_fd < 0) {
+            g_pass_profile_mode &= ~2;
+            return;
+        }
+    }
+    char name_json[256], tu_json[1024], line[1536];
+    int n = snprintf(line, sizeof(line),
+                     "{\"name\":\"%s\",\"cat\":\"lower\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"pid\":%d,\"tid\":0,\"args\":{\"tu\":\"%s\",\"bytes\":%zu,\"reparses\":%d}},\n",
+                     cc__pass_json_str(name_json, sizeof(name_json), name),
+                     start_ns / 1000.0, dur_ns / 1000.0, (int)getpid(),
+                     cc__pass_json_str(tu_json, sizeof(tu_json), g_pass_tu), bytes, reparses);
+    if (n > 0 && (size_t)n < sizeof(line)) (void)write(g_pass_trace_fd, line, (size_t)n);
+}
+
+void cc_pass_profile_tu_begin(const char* input_path) {
+    if (!cc_pass_profile_enabled()) return;
+    g_pass_tu = input_path;
+    g_pass_tu_start_ns = cc__pass_now_ns();
+    g_pass_depth = 0;
+    g_pass_total_count = 0;
+    g_pass_tu_reparses = 0;
+}
+
+static int cc__pass_total_cmp(const void* a, const void* b) {
+    const CCPassTotal* x = (const CCPassTotal*)a;
+    const CCPassTotal* y = (const CCPassTotal*)b;
+    if (x->ns != y->ns) return x->ns < y->ns ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+void cc_pass_profile_tu_end(void) {
+    if (!cc_pass_profile_enabled() || !g_pass_tu) return;
+    while (g_pass_depth > 0) cc_pass_end(0);
+    uint64_t dur = cc__pass_now_ns() - g_pass_tu_start_ns;
+    cc__pass_trace_event("tu", g_pass_tu_start_ns, dur, 0, g_pass_tu_reparses);
+    if (g_pass_profile_mode & 1) {
+        qsort(g_pass_totals, (size_t)g_pass_total_count, sizeof(g_pass_totals[0]), cc__pass_total_cmp);
+        fprintf(stderr, "=== pass timings: %s (%.1f ms, %d reparses) ===\n",
+                g_pass_tu, dur / 1e6, g_pass_tu_reparses);
+        fprintf(stderr, "  %10s %6s  %5s %8s %12s  %s\n", "ms", "%", "calls", "reparses", "bytes", "pass");
+        for (int i = 0; i < g_pass_total_count; ++i) {
+            const CCPassTotal* t = &g_pass_totals[i];
+            fprintf(stderr, "  %10.2f %5.1f%%  %5d %8d %12zu  %s\n",
+                    t->ns / 1e6, dur ? 100.0 * (double)t->ns / (double)dur : 0.0,
+                    t->calls, t->reparses, t->bytes, t->name);
+        }
+    }
+    g_pass_tu = NULL;
+}
+
+void cc_pass_begin(const char* name) {
+    if (!cc_pass_profile_enabled() || !g_pass_tu) return;
+    if (g_pass_depth < CC_PASS_PROFILE_DEPTH) {
+        CCPassFrame* f = &g_pass_stack[g_pass_depth];
+        f->name = name;
+        f->bytes = 0;
+        f->reparses = 0;
+        f->start_ns = cc__pass_now_ns();
+    }
+    g_pass_depth++;
+}
+
+void cc_pass_end(size_t bytes_out) {
+    if (!cc_pass_profile_enabled() || !g_pass_tu || g_pass_depth == 0) return;
+    g_pass_depth--;
+    if (g_pass_depth >= CC_PASS_PROFILE_DEPTH) return;
+    CCPassFrame* f = &g_pass_stack[g_pass_depth];
+    uint64_t dur = cc__pass_now_ns() - f->start_ns;
+    f->bytes += bytes_out;
+    /* Text produced by nested passes counts toward the enclosing pass too. */
+    if (g_pass_depth > 0 && g_pass_depth - 1 < CC_PASS_PROFILE_DEPTH) g_pass_stack[g_pass_depth - 1].bytes += f->bytes;
+    cc__pass_trace_event(f->name, f->start_ns, dur, f->bytes, f->reparses);
+    CCPassTotal* t = NULL;
+    for (int i = 0; i < g_pass_total_count; ++i) {
+        if (g_pass_totals[i].name == f->name || strcmp(g_pass_totals[i].name, f->name) == 0) {
+            t = &g_pass_totals[i];
+            break;
+        }
+    }
+    if (!t && g_pass_total_count < CC_PASS_PROFILE_NAMES) {
+        t = &g_pass_totals[g_pass_total_count++];
+        memset(t, 0, sizeof(*t));
+        t->name = f->name;
+    }
+    if (!t) return;
+    /* A pass nested inside itself (reparse -> preprocess -> ...) is counted
+       once: only the outermost frame adds time. */
+    int outer = 1;
+    for (int i = 0; i < g_pass_depth && i < CC_PASS_PROFILE_DEPTH; ++i) {
+        if (g_pass_stack[i].name == f->name) { outer = 0; break; }
+    }
+    t->calls++;
+    if (outer) {
+        t->ns += dur;
+        t->bytes += f->bytes;
+        t->reparses += f->reparses;
+    }
+}
+
+void cc_pass_note_reparse(void) {
+    if (!cc_pass_profile_enabled() || !g_pass_tu) return;
+    g_pass_tu_reparses++;
+    for (int i = 0; i < g_pass_depth && i < CC_PASS_PROFILE_DEPTH; ++i) g_pass_stack[i].reparses++;
+}
+
+char* cc_pass_end_text(char* result) {
+    cc_pass_end(result && result != (char*)-1 ? strlen(result) + 1 : 0);
+    return result;
+}
+
+int cc_pass_end_int(int result) {
+    cc_pass_end(0);
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef CC_UTIL_PASS_PROFILE_H
+#define CC_UTIL_PASS_PROFILE_H
+
+#include <stddef.h>
+
+/* Per-pass timing for the lowering pipeline (`ccc --time-passes`,
+   `ccc --trace-passes PATH`).
+
+   Passes nest: cc_pass_begin/cc_pass_end bracket one pass; every frame
+   records inclusive wall time, the bytes of new TU text it produced, and
+   how many AST reparses started while it was open. Both flags are carried
+   to child processes as CC_TIME_PASSES=1 / CC_TRACE_PASSES=<path>, which is
+   also how the profiler is switched on; with neither set every call is a
+   single branch.
+
+   --time-passes prints one table per TU to stderr when the TU finishes.
+   --trace-passes appends Chrome trace-event JSON ("X" events, one pid per
+   compiling process) to PATH; load it in chrome://tracing or Perfetto. */
+
+int cc_pass_profile_enabled(void);
+
+/* Forget the cached mode so the next call rereads the environment (a
+   `ccc --server` worker, which inherits the server's warm-up state). */
+void cc_pass_profile_reset(void);
+
+/* Start a fresh trace file (called once by the top-level ccc process). */
+void cc_pass_profile_trace_reset(const char* path);
+
+void cc_pass_profile_tu_begin(const char* input_path);
+void cc_pass_profile_tu_end(void);
+
+/* `name` must outlive the TU (string literals). */
+void cc_pass_begin(const char* name);
+void cc_pass_end(size_t bytes_out);
+void cc_pass_note_reparse(void);
+
+/* Expression helpers for text passes: time `fn(args)` under the name `fn`.
+   CC_PASS_TEXT is for passes returning a new TU buffer (NULL = unchanged,
+   (char*)-1 = error); the buffer size is recorded as the pass's bytes. */
+char* cc_pass_end_text(char* result);
+int cc_pass_end_int(int result);
+
+#define CC_PASS_TEXT(fn, ...) (cc_pass_begin(#fn), cc_pass_end_text(fn(__VA_ARGS__)))
+#define CC_PASS_INT(fn, ...) (cc_pass_begin(#fn), cc_pass_end_int(fn(__VA_ARGS__)))
+
+#endif /* CC_UTIL_PASS_PROFILE_H */
@@ -188,3 +188,7 @@ int cc_path_find_repo_root(const char* path, char* out, size_t out_cap) {
     return cc__find_repo_root_from(path, out, out_cap);
 }
 
+int cc_path_self_exe(char* out, size_t out_cap) {
+    return cc__self_exe_path(out, out_cap);
+}
+
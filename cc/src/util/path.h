@@ -10,5 +10,9 @@
 const char* cc_path_rel_to_repo(const char* path, char* out, size_t out_cap);
 int cc_path_find_repo_root(const char* path, char* out, size_t out_cap);
 
+/* Absolute path of the running executable (/proc/self/exe on Linux,
+   _NSGetExecutablePath on macOS). Returns 1 on success, 0 otherwise. */
+int cc_path_self_exe(char* out, size_t out_cap);
+
 #endif /* CC_UTIL_PATH_H */
 
@@ -0,0 +1,217 @@
+#include "prof_symbolize.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    char* module;
+    unsigned long addr;
+    char* name;          /* NULL until resolved */
+} CCProfFrame;
+
+typedef struct {
+    char* stack;
+    unsigned long count;
+} CCProfLine;
+
+static int cc__prof_frame_cmp(const void* a, const void* b) {
+    const CCProfFrame* x = (const CCProfFrame*)a;
+    const CCProfFrame* y = (const CCProfFrame*)b;
+    int c = strcmp(x->module, y->module);
+    if (c) return c;
+    return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+
+static int cc__prof_line_cmp(const void* a, const void* b) {
+    return strcmp(((const CCProfLine*)a)->stack, ((const CCProfLine*)b)->stack);
+}
+
+/* Split "<module>+0x<hex>" in place; `tok` has no ';'. */
+static int cc__prof_parse_frame(char* tok, size_t len, CCProfFrame* out) {
+    if (strncmp(tok, "spawn:", 6) == 0) {
+        tok += 6;
+        len -= 6;
+    }
+    if (len < 4 || tok[0] != '/') return 0;
+    char* plus = NULL;
+    for (size_t i = len; i-- > 0;) {
+        if (tok[i] == '+') { plus = tok + i; break; }
+    }
+    if (!plus || plus[1] != '0' || plus[2] != 'x') return 0;
+    char* end = NULL;
+    unsigned long addr = strtoul(plus + 3, &end, 16);
+    if (end != tok + len) return 0;
+    out->module = strndup(tok, (size_t)(plus - tok));
+    out->addr = addr;
+    out->name = NULL;
+    return out->module != NULL;
+}
+
+/* Resolve frames[lo, hi), which all share one module. */
+static void cc__prof_resolve_module(CCProfFrame* frames, size_t lo, size_t hi) {
+    const char* module = frames[lo].module;
+    if (strchr(module, '\'') || access(module, R_OK) != 0) return;
+    char tmpl[] = "/tmp/ccc-prof-XXXXXX";
+    int fd = mkstemp(tmpl);
+    if (fd < 0) return;
+    FILE* addrs = fdopen(fd, "w");
+    if (!addrs) {
+        close(fd);
+        unlink(tmpl);
+        return;
+    }
+    for (size_t i = lo; i < hi; i++) fprintf(addrs, "0x%lx\n", frames[i].addr);
+    fclose(addrs);
+
+    size_t cmd_len = strlen(module) + strlen(tmpl) + 64;
+    char* cmd = (char*)malloc(cmd_len);
+    if (cmd) {
+        snprintf(cmd, cmd_len, "addr2line -f -C -e '%s' < %s 2>/dev/null", module, tmpl);
+        FILE* p = popen(cmd, "r");
+        if (p) {
+            char fn[4096], loc[4096];
+            for (size_t i = lo; i < hi; i++) {
+                if (!fgets(fn, sizeof(fn), p) || !fgets(loc, sizeof(loc), p)) break;
+                fn[strcspn(fn, "\n")] = '\0';
+                if (fn[0] && strcmp(fn, "??") != 0) frames[i].name = strdup(fn);
+            }
+            pclose(p);
+        }
+        free(cmd);
+    }
+    unlink(tmpl);
+}
+
+static void cc__prof_put(char** buf, size_t* len, size_t* cap, const char* s, size_t n) {
+    if (*len + n + 1 > *cap) {
+        size_t nc = *cap ? *cap * 2 : 256;
+        while (nc < *len + n + 1) nc *= 2;
+        char* nb = (char*)realloc(*buf, nc);
+        if (!nb) return;
+        *buf = nb;
+        *cap = nc;
+    }
+    memcpy(*buf + *len, s, n);
+    *len += n;
+    (*buf)[*len] = '\0';
+}
+
+int cc_prof_symbolize(const char* in_path, FILE* out) {
+    FILE* in = fopen(in_path, "r");
+    if (!in) return errno;
+
+    CCProfLine* lines = NULL;
+    size_t nlines = 0, lines_cap = 0;
+    CCProfFrame* frames = NULL;
+    size_t nframes = 0, frames_cap = 0;
+    char* buf = NULL;
+    size_t buf_cap = 0;
+    int rc = 0;
+    ssize_t got;
+    while ((got = getline(&buf, &buf_cap, in)) > 0) {
+        while (got > 0 && (buf[got - 1] == '\n' || buf[got - 1] == '\r')) buf[--got] = '\0';
+        char* sp = strrchr(buf, ' ');
+        if (!sp) continue;
+        *sp = '\0';
+        if (nlines == lines_cap) {
+            size_t nc = lines_cap ? lines_cap * 2 : 256;
+            CCProfLine* nl = (CCProfLine*)realloc(lines, nc * sizeof(*nl));
+            if (!nl) { rc = ENOMEM; break; }
+            lines = nl;
+            lines_cap = nc;
+        }
+        lines[nlines].stack = strdup(buf);
+        lines[nlines].count = strtoul(sp + 1, NULL, 10);
+        if (!lines[nlines].stack) { rc = ENOMEM; break; }
+        nlines++;
+        for (char* tok = buf; *tok;) {
+            size_t n = strcspn(tok, ";");
+            CCProfFrame f;
+            if (cc__prof_parse_frame(tok, n, &f)) {
+                if (nframes == frames_cap) {
+                    size_t nc = frames_cap ? frames_cap * 2 : 256;
+                    CCProfFrame* nf = (CCProfFrame*)realloc(frames, nc * sizeof(*nf));
+                    if (!nf) { free(f.module); rc = ENOMEM; break; }
+                    frames = nf;
+                    frames_cap = nc;
+                }
+                frames[nframes++] = f;
+            }
+            tok += n;
+            if (*tok == ';') tok++;
+        }
+        if (rc) break;
+    }
+    fclose(in);
+
+    if (rc == 0) {
+        qsort(frames, nframes, sizeof(*frames), cc__prof_frame_cmp);
+        size_t w = 0;
+        for (size_t i = 0; i < nframes; i++) {
+            if (w > 0 && cc__prof_frame_cmp(&frames[w - 1], &frames[i]) == 0) {
+                free(frames[i].module);
+                continue;
+            }
+            frames[w++] = frames[i];
+        }
+        nframes = w;
+        for (size_t lo = 0; lo < nframes;) {
+            size_t hi = lo + 1;
+            while (hi < nframes && strcmp(frames[hi].module, frames[lo].module) == 0) hi++;
+            cc__prof_resolve_module(frames, lo, hi);
+            lo = hi;
+        }
+
+        /* Rewrite each stack, then merge the ones that now read the same. */
+        for (size_t i = 0; i < nlines; i++) {
+            char* sym = NULL;
+            size_t len = 0, cap = 0;
+            for (char* tok = lines[i].stack; *tok;) {
+                size_t n = strcspn(tok, ";");
+                char saved = tok[n];
+                tok[n] = '\0';
+                CCProfFrame key;
+                const CCProfFrame* hit = NULL;
+                if (cc__prof_parse_frame(tok, n, &key)) {
+                    hit = (const CCProfFrame*)bsearch(&key, frames, nframes, sizeof(*frames), cc__prof_frame_cmp);
+                    free(key.module);
+                }
+                if (len) cc__prof_put(&sym, &len, &cap, ";", 1);
+                if (hit && hit->name) {
+                    if (strncmp(tok, "spawn:", 6) == 0) cc__prof_put(&sym, &len, &cap, "spawn:", 6);
+                    cc__prof_put(&sym, &len, &cap, hit->name, strlen(hit->name));
+                } else {
+                    cc__prof_put(&sym, &len, &cap, tok, n);
+                }
+                tok[n] = saved;
+                tok += n;
+                if (*tok == ';') tok++;
+            }
+            if (sym) {
+                free(lines[i].stack);
+                lines[i].stack = sym;
+            }
+        }
+        qsort(lines, nlines, sizeof(*lines), cc__prof_line_cmp);
+        for (size_t i = 0; i < nlines;) {
+            unsigned long count = 0;
+            size_t j = i;
+            while (j < nlines && strcmp(lines[j].stack, lines[i].stack) == 0) count += lines[j++].count;
+            fprintf(out, "%s %lu\n", lines[i].stack, count);
+            i = j;
+        }
+    }
+
+    for (size_t i = 0; i < nlines; i++) free(lines[i].stack);
+    free(lines);
+    for (size_t i = 0; i < nframes; i++) {
+        free(frames[i].module);
+        free(frames[i].name);
+    }
+    free(frames);
+    free(buf);
+    return rc;
+}
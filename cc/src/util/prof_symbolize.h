@@ -0,0 +1,13 @@
+#ifndef CC_UTIL_PROF_SYMBOLIZE_H
+#define CC_UTIL_PROF_SYMBOLIZE_H
+
+#include <stdio.h>
+
+/* `ccc prof FILE`: resolve the "<module>+0x<vaddr>" frames of a CC_PROF
+   folded-stack file to function names (addr2line, one process per module)
+   and write the result to `out`, merging stacks that symbolize to the same
+   line. Frames that do not resolve are kept as they are. Returns 0 or an
+   errno value. */
+int cc_prof_symbolize(const char* in_path, FILE* out);
+
+#endif /* CC_UTIL_PROF_SYMBOLIZE_H */
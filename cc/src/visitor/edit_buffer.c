@@ -78,22 +78,181 @@ int cc_edit_buffer_add_defs(CCEditBuffer* eb, const char* defs, size_t len) {
     return 0;
 }
 
-/* Compare edits for sorting: by start_off descending, then priority descending */
+/* Compare edits for sorting: by start_off ascending, then priority ascending.
+ * At one offset the lower-priority text comes first in the output, which
+ * is where the old end-to-start application left it. */
 static int edit_cmp(const void* a, const void* b) {
     const CCEdit* ea = (const CCEdit*)a;
     const CCEdit* eb = (const CCEdit*)b;
-    
-    /* Sort by start_off descending (apply from end to start) */
-    if (ea->start_off > eb->start_off) return -1;
-    if (ea->start_off < eb->start_off) return 1;
-    
-    /* At same position, higher priority first */
-    if (ea->priority > eb->priority) return -1;
-    if (ea->priority < eb->priority) return 1;
-    
+    if (ea->start_off < eb->start_off) return -1;
+    if (ea->start_off > eb->start_off) return 1;
+    if (ea->priority < eb->priority) return -1;
+    if (ea->priority > eb->priority) return 1;
+    return 0;
+}
+
+/* Two edits overlap if the earlier one runs past the start of the next.
+ * Expects edits sorted with edit_cmp. */
+static int edits_overlap(const CCEdit* prev, const CCEdit* cur) {
+    return prev->end_off > cur->start_off;
+}
+
+static int same_pass(const char* a, const char* b) {
+    if (a == b) return 1;
+    return a && b && strcmp(a, b) == 0;
+}
+
+/* Stricter than apply: two different passes inserting at one offset also
+ * conflict, because priority alone does not say what their relative order
+ * would have been had they run one after the other. */
+int cc_edit_buffer_has_conflicts(CCEditBuffer* eb) {
+    if (!eb || eb->count < 2) return 0;
+    qsort(eb->edits, eb->count, sizeof(CCEdit), edit_cmp);
+    for (int i = 1; i < eb->count; i++) {
+        const CCEdit* prev = &eb->edits[i - 1];
+        const CCEdit* cur = &eb->edits[i];
+        if (edits_overlap(prev, cur)) return 1;
+        if (prev->start_off == prev->end_off && cur->start_off == cur->end_off &&
+            prev->start_off == cur->start_off && !same_pass(prev->pass_name, cur->pass_name)) {
+            return 1;
+        }
+    }
     return 0;
 }
 
+void cc_edit_track_init(CCEditTrack* t, CCEditBuffer* eb, int priority, const char* pass_name) {
+    if (!t) return;
+    memset(t, 0, sizeof(*t));
+    t->eb = eb;
+    t->priority = priority;
+    t->pass_name = pass_name;
+}
+
+void cc_edit_track_free(CCEditTrack* t) {
+    if (!t) return;
+    for (int i = 0; i < t->count; i++) free(t->spans[i].text);
+    free(t->spans);
+    memset(t, 0, sizeof(*t));
+}
+
+/* Source offset of working-copy offset `cur`, which must not fall strictly
+ * inside a span. Spans ending at or before `cur` shift it. */
+static size_t edit_track_src_of(const CCEditTrack* t, size_t cur) {
+    size_t src = cur;
+    for (int i = 0; i < t->count && t->spans[i].cur_end <= cur; i++) {
+        const CCEditTrackSpan* sp = &t->spans[i];
+        src = src - (sp->cur_end - sp->cur_start) + (sp->src_end - sp->src_start);
+    }
+    return src;
+}
+
+/* Does splice [start, end) cut into or cover span `sp`? A splice that only
+ * touches a span's edge leaves it alone; so does one next to a deletion. */
+static int edit_track_absorbs(const CCEditTrackSpan* sp, size_t start, size_t end) {
+    if (sp->cur_start == sp->cur_end) return start < sp->cur_start && sp->cur_start < end;
+    return sp->cur_start < end && sp->cur_end > start;
+}
+
+int cc_edit_track_splice(CCEditTrack* t, size_t start, size_t end, const char* repl, size_t repl_len) {
+    if (!t || start > end) return -1;
+    /* A span the splice cuts into is absorbed whole: widen [start, end) to
+     * its edges and keep its bytes outside the splice. Spans are disjoint,
+     * so at most the first and last absorbed span stick out. */
+    size_t lo = start, hi = end;
+    const char* pre = "";
+    size_t pre_len = 0;
+    const char* post = "";
+    size_t post_len = 0;
+    int first = -1, last = -1;
+    for (int i = 0; i < t->count; i++) {
+        const CCEditTrackSpan* sp = &t->spans[i];
+        if (!edit_track_absorbs(sp, start, end)) continue;
+        if (first < 0) first = i;
+        last = i;
+        if (sp->cur_start < start) {
+            lo = sp->cur_start;
+            pre = sp->text;
+            pre_len = start - sp->cur_start;
+        }
+        if (sp->cur_end > end) {
+            hi = sp->cur_end;
+            post = sp->text + (end - sp->cur_start);
+            post_len = sp->cur_end - end;
+        }
+    }
+    if (first < 0) {
+        first = 0;
+        while (first < t->count && t->spans[first].cur_end <= lo) first++;
+        last = first - 1;
+    }
+
+    /* Source bytes covered: the untouched stretches of [lo, hi) plus the
+     * source spans of everything absorbed. */
+    size_t covered = hi - lo;
+    for (int i = first; i <= last; i++) {
+        const CCEditTrackSpan* sp = &t->spans[i];
+        covered = covered - (sp->cur_end - sp->cur_start) + (sp->src_end - sp->src_start);
+    }
+    size_t text_len = pre_len + repl_len + post_len;
+    CCEditTrackSpan ns;
+    ns.cur_start = lo;
+    ns.cur_end = lo + text_len;
+    ns.src_start = edit_track_src_of(t, lo);
+    ns.src_end = ns.src_start + covered;
+    ns.text = (char*)malloc(text_len + 1);
+    if (!ns.text) return -1;
+    memcpy(ns.text, pre, pre_len);
+    if (repl_len) memcpy(ns.text + pre_len, repl, repl_len);
+    memcpy(ns.text + pre_len + repl_len, post, post_len);
+    ns.text[text_len] = '\0';
+
+    int removed = last - first + 1;
+    if (removed == 0 && t->count == t->capacity) {
+        int new_cap = t->capacity ? t->capacity * 2 : 32;
+        CCEditTrackSpan* grown = realloc(t->spans, (size_t)new_cap * sizeof(*grown));
+        if (!grown) { free(ns.text); return -1; }
+        t->spans = grown;
+        t->capacity = new_cap;
+    }
+    for (int i = first; i <= last; i++) free(t->spans[i].text);
+    memmove(&t->spans[first + 1], &t->spans[last + 1], (size_t)(t->count - last - 1) * sizeof(*t->spans));
+    t->spans[first] = ns;
+    t->count = t->count - removed + 1;
+    /* Everything after the splice moves by the change in length. */
+    for (int i = first + 1; i < t->count; i++) {
+        t->spans[i].cur_start = t->spans[i].cur_start - (hi - lo) + text_len;
+        t->spans[i].cur_end = t->spans[i].cur_end - (hi - lo) + text_len;
+    }
+    return 0;
+}
+
+int cc_edit_track_commit(CCEditTrack* t) {
+    if (!t || !t->eb || !t->eb->src) return -1;
+    const char* src = t->eb->src;
+    int added = 0;
+    for (int i = 0; i < t->count; i++) {
+        const CCEditTrackSpan* sp = &t->spans[i];
+        size_t ss = sp->src_start, se = sp->src_end;
+        const char* text = sp->text;
+        size_t tl = sp->cur_end - sp->cur_start;
+        /* Keep only the bytes that changed, so neighbouring passes can
+         * still edit what this one copied through. */
+        while (ss < se && tl > 0 && src[ss] == text[0]) { ss++; text++; tl--; }
+        while (ss < se && tl > 0 && src[se - 1] == text[tl - 1]) { se--; tl--; }
+        if (ss == se && tl == 0) continue;
+        char* repl = (char*)malloc(tl + 1);
+        if (!repl) return -1;
+        memcpy(repl, text, tl);
+        repl[tl] = '\0';
+        int prio = ss == se ? t->priority - CC_EDIT_INSERT_BIAS : t->priority;
+        int rc = cc_edit_buffer_add(t->eb, ss, se, repl, prio, t->pass_name);
+        free(repl);
+        if (rc != 0) return -1;
+        added++;
+    }
+    return added;
+}
+
 /* Find insertion point for protos (after last #include line) */
 static size_t find_protos_insertion_point(const char* src, size_t len) {
     size_t last_include_end = 0;
@@ -127,25 +286,23 @@ static size_t find_protos_insertion_point(const char* src, size_t len) {
 
 char* cc_edit_buffer_apply(CCEditBuffer* eb, size_t* out_len) {
     if (!eb || !eb->src) return NULL;
-    
-    /* Sort edits by position descending */
+
     if (eb->count > 1) {
         qsort(eb->edits, eb->count, sizeof(CCEdit), edit_cmp);
     }
-    
+
     /* Validate: no overlapping edits */
-    for (int i = 0; i < eb->count - 1; i++) {
-        /* After sorting descending, edits[i] starts at or after edits[i+1] */
-        if (eb->edits[i].start_off < eb->edits[i + 1].end_off) {
+    for (int i = 1; i < eb->count; i++) {
+        if (edits_overlap(&eb->edits[i - 1], &eb->edits[i])) {
             fprintf(stderr, "cc_edit_buffer: overlapping edits at %zu-%zu and %zu-%zu (passes: %s, %s)\n",
+                    eb->edits[i - 1].start_off, eb->edits[i - 1].end_off,
                     eb->edits[i].start_off, eb->edits[i].end_off,
-                    eb->edits[i + 1].start_off, eb->edits[i + 1].end_off,
-                    eb->edits[i].pass_name ? eb->edits[i].pass_name : "?",
-                    eb->edits[i + 1].pass_name ? eb->edits[i + 1].pass_name : "?");
+                    eb->edits[i - 1].pass_name ? eb->edits[i - 1].pass_name : "?",
+                    eb->edits[i].pass_name ? eb->edits[i].pass_name : "?");
             return NULL;
         }
     }
-    
+
     /* Calculate output size */
     size_t result_len = eb->src_len;
     for (int i = 0; i < eb->count; i++) {
@@ -153,75 +310,42 @@ char* cc_edit_buffer_apply(CCEditBuffer* eb, size_t* out_len) {
         size_t added = strlen(eb->edits[i].replacement);
         result_len = result_len - removed + added;
     }
+    size_t body_len = result_len;
     result_len += eb->protos_len + eb->defs_len;
-    
-    /* Allocate result buffer */
+
     char* result = malloc(result_len + 1);
     if (!result) return NULL;
-    
-    /* Copy source with edits applied (end-to-start) */
-    char* working = malloc(eb->src_len + 1);
-    if (!working) { free(result); return NULL; }
-    memcpy(working, eb->src, eb->src_len);
-    working[eb->src_len] = '\0';
-    size_t working_len = eb->src_len;
-    
-    /* Apply edits end-to-start */
+
+    /* One forward copy: kept source, replacement, kept source, ... */
+    size_t pos = 0, cursor = 0;
     for (int i = 0; i < eb->count; i++) {
-        CCEdit* e = &eb->edits[i];
-        size_t removed = e->end_off - e->start_off;
+        const CCEdit* e = &eb->edits[i];
         size_t added = strlen(e->replacement);
-        
-        /* Make room or shrink */
-        size_t new_len = working_len - removed + added;
-        char* new_working = malloc(new_len + 1);
-        if (!new_working) { free(working); free(result); return NULL; }
-        
-        /* Copy: [0, start_off) + replacement + [end_off, working_len) */
-        memcpy(new_working, working, e->start_off);
-        memcpy(new_working + e->start_off, e->replacement, added);
-        memcpy(new_working + e->start_off + added, working + e->end_off, working_len - e->end_off);
-        new_working[new_len] = '\0';
-        
-        free(working);
-        working = new_working;
-        working_len = new_len;
+        memcpy(result + pos, eb->src + cursor, e->start_off - cursor);
+        pos += e->start_off - cursor;
+        memcpy(result + pos, e->replacement, added);
+        pos += added;
+        cursor = e->end_off;
     }
-    
+    memcpy(result + pos, eb->src + cursor, eb->src_len - cursor);
+    pos += eb->src_len - cursor;
+
     /* Insert protos after includes */
     if (eb->protos_len > 0) {
-        size_t insert_pt = find_protos_insertion_point(working, working_len);
-        size_t new_len = working_len + eb->protos_len;
-        char* new_working = malloc(new_len + 1);
-        if (!new_working) { free(working); free(result); return NULL; }
-        
-        memcpy(new_working, working, insert_pt);
-        memcpy(new_working + insert_pt, eb->protos, eb->protos_len);
-        memcpy(new_working + insert_pt + eb->protos_len, working + insert_pt, working_len - insert_pt);
-        new_working[new_len] = '\0';
-        
-        free(working);
-        working = new_working;
-        working_len = new_len;
+        size_t insert_pt = find_protos_insertion_point(result, body_len);
+        memmove(result + insert_pt + eb->protos_len, result + insert_pt, body_len - insert_pt);
+        memcpy(result + insert_pt, eb->protos, eb->protos_len);
+        pos += eb->protos_len;
     }
-    
+
     /* Append defs at end */
     if (eb->defs_len > 0) {
-        size_t new_len = working_len + eb->defs_len;
-        char* new_working = realloc(working, new_len + 1);
-        if (!new_working) { free(working); free(result); return NULL; }
-        
-        memcpy(new_working + working_len, eb->defs, eb->defs_len);
-        new_working[new_len] = '\0';
-        working = new_working;
-        working_len = new_len;
+        memcpy(result + pos, eb->defs, eb->defs_len);
+        pos += eb->defs_len;
     }
-    
-    /* Move to result */
-    free(result);
-    result = working;
-    
-    if (out_len) *out_len = working_len;
+    result[pos] = '\0';
+
+    if (out_len) *out_len = pos;
     return result;
 }
 
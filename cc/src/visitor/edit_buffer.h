@@ -54,8 +54,52 @@ int cc_edit_buffer_add_protos(CCEditBuffer* eb, const char* protos, size_t len);
 /* Add generated code to be appended at end of file. */
 int cc_edit_buffer_add_defs(CCEditBuffer* eb, const char* defs, size_t len);
 
+/* Priority offset given to zero-width tracked edits so they sort ahead of
+ * a replacement that starts at the same offset. */
+#define CC_EDIT_INSERT_BIAS (1 << 20)
+
+/* Splices a pass makes on a working copy of eb->src, kept as spans of the
+ * original source. A pass that rewrites its copy in place (UFCS works
+ * bottom-up and may rewrite an expression that already holds an earlier
+ * rewrite) reports each splice here in working-copy offsets; a splice that
+ * covers earlier ones absorbs them. cc_edit_track_commit narrows each span
+ * to the bytes that really changed and adds it to the EditBuffer, so the
+ * pass's edits come straight from its AST walk rather than from a diff. */
+typedef struct CCEditTrackSpan {
+    size_t cur_start, cur_end;  /* In the working copy */
+    size_t src_start, src_end;  /* In eb->src */
+    char* text;                 /* Working-copy bytes [cur_start, cur_end) (owned) */
+} CCEditTrackSpan;
+
+typedef struct CCEditTrack {
+    CCEditBuffer* eb;
+    CCEditTrackSpan* spans;     /* Disjoint, sorted by cur_start */
+    int count;
+    int capacity;
+    int priority;
+    const char* pass_name;
+} CCEditTrack;
+
+void cc_edit_track_init(CCEditTrack* t, CCEditBuffer* eb, int priority, const char* pass_name);
+
+/* The pass replaced working-copy bytes [start, end) with `repl`.
+ * Returns 0, or -1 on allocation failure (the track is then unusable). */
+int cc_edit_track_splice(CCEditTrack* t, size_t start, size_t end, const char* repl, size_t repl_len);
+
+/* Add the tracked spans to t->eb. Returns the number of edits added, or -1. */
+int cc_edit_track_commit(CCEditTrack* t);
+
+void cc_edit_track_free(CCEditTrack* t);
+
+/* 1 if the collected edits cannot be merged safely: overlapping spans, or
+ * two different passes (by pass_name) inserting at one offset; 0 otherwise.
+ * Sorts the edits. Used by the phase-3 batch; cc_edit_buffer_apply itself
+ * only rejects overlaps. */
+int cc_edit_buffer_has_conflicts(CCEditBuffer* eb);
+
 /* Apply all edits and produce the transformed source.
- * Edits are sorted by position (descending) and applied end-to-start.
+ * Edits are sorted by position and copied in one forward pass; at equal
+ * offsets lower-priority text comes first. Fails on overlapping edits.
  * Returns newly allocated string (caller owns), or NULL on error.
  */
 char* cc_edit_buffer_apply(CCEditBuffer* eb, size_t* out_len);
@@ -0,0 +1,107 @@
+#include "pass_blocking_regions.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/text.h"
+
+static const char k_cc_blocking_prologue[] = " cc_blocking_enter(); @defer cc_blocking_exit();";
+
+int cc__wrap_blocking_bodies(const char* in, size_t in_len, char** out, size_t* out_len) {
+    if (!in || !out || !out_len) return 0;
+    *out = NULL;
+    *out_len = 0;
+
+    /* Pass 1: collect insertion offsets (just past each wrapped body's '{').
+       Only file scope is scanned: every braced group is stepped over whole.
+       Remember which markers the current declaration carries and whether it
+       looks like a function (a parameter list, no '='). */
+    size_t* at = NULL;
+    size_t n_at = 0, cap_at = 0;
+    int hdr_blocking = 0, hdr_async = 0, hdr_params = 0, hdr_init = 0;
+    int line_start = 1;
+    for (size_t i = 0; i < in_len; ) {
+        size_t j = cc_skip_ws_and_comments(in, in_len, i);
+        if (j != i) {
+            if (memchr(in + i, '\n', j - i)) line_start = 1;
+            i = j;
+            continue;
+        }
+        char c = in[i];
+        if (line_start && c == '#') {
+            while (i < in_len && in[i] != '\n') {
+                if (in[i] == '\\' && i + 1 < in_len && in[i + 1] == '\n') i++;
+                i++;
+            }
+            continue;
+        }
+        line_start = 0;
+        if (c == '"' || c == '\'') {
+            /* A newline ends an unterminated literal; don't run away. */
+            i++;
+            while (i < in_len && in[i] != c && in[i] != '\n') i += (in[i] == '\\' && i + 1 < in_len) ? 2 : 1;
+            if (i < in_len && in[i] == c) i++;
+            continue;
+        }
+
+        if (c == '{') {
+            if (hdr_blocking && !hdr_async && hdr_params && !hdr_init) {
+                if (n_at == cap_at) {
+                    size_t nc = cap_at ? cap_at * 2 : 16;
+                    size_t* na = (size_t*)realloc(at, nc * sizeof(*at));
+                    if (!na) { free(at); return 0; }
+                    at = na;
+                    cap_at = nc;
+                }
+                at[n_at++] = i + 1;
+            }
+            size_t rbrace = 0;
+            if (!cc_find_matching_brace(in, in_len, i, &rbrace)) break;
+            hdr_blocking = hdr_async = hdr_params = hdr_init = 0;
+            i = rbrace + 1;
+            continue;
+        }
+
+        if (c == ';') {
+            hdr_blocking = hdr_async = hdr_params = hdr_init = 0;
+        } else if (c == '(') {
+            hdr_params = 1;
+        } else if (c == '=') {
+            hdr_init = 1;
+        } else if (c == '@') {
+            size_t id = i + 1;
+            size_t e = id;
+            while (e < in_len && cc_is_ident_char(in[e])) e++;
+            if (e - id == 8 && memcmp(in + id, "blocking", 8) == 0) hdr_blocking = 1;
+            else if (e - id == 5 && memcmp(in + id, "async", 5) == 0) hdr_async = 1;
+            i = e;
+            continue;
+        }
+        i++;
+    }
+    if (n_at == 0) {
+        free(at);
+        return 0;
+    }
+
+    /* Pass 2: splice. Offsets are increasing (collected in scan order). */
+    size_t pro_len = sizeof(k_cc_blocking_prologue) - 1;
+    size_t len = in_len + n_at * pro_len;
+    char* buf = (char*)malloc(len + 1);
+    if (!buf) { free(at); return 0; }
+    size_t r = 0, w = 0;
+    for (size_t k = 0; k < n_at; k++) {
+        memcpy(buf + w, in + r, at[k] - r);
+        w += at[k] - r;
+        r = at[k];
+        memcpy(buf + w, k_cc_blocking_prologue, pro_len);
+        w += pro_len;
+    }
+    memcpy(buf + w, in + r, in_len - r);
+    w += in_len - r;
+    buf[w] = '\0';
+    free(at);
+    *out = buf;
+    *out_len = w;
+    return 1;
+}
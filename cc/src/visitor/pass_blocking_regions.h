@@ -0,0 +1,15 @@
+#ifndef CC_PASS_BLOCKING_REGIONS_H
+#define CC_PASS_BLOCKING_REGIONS_H
+
+#include <stddef.h>
+
+/* `@blocking` function definitions: opens every non-@async `@blocking`
+   function body with `cc_blocking_enter(); @defer cc_blocking_exit();` so a
+   fiber calling it hands its worker off for the duration of the call. Must
+   run before the @defer pass and before markers are stripped. Declarations
+   and `@async @blocking` functions (whose call edges already go through
+   run_blocking) are left alone.
+   Returns 1 and sets *out when anything was inserted, 0 otherwise. */
+int cc__wrap_blocking_bodies(const char* in, size_t in_len, char** out, size_t* out_len);
+
+#endif /* CC_PASS_BLOCKING_REGIONS_H */
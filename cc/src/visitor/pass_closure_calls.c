@@ -447,6 +447,31 @@ static void cc__emit_arg_range(const char* src,
     cc__emit_range_with_call_spans(src, a0, a1, spans, span_idx, io_out, io_len, io_cap);
 }
 
+/* Offset of the top-level comma between a 2-ary call's arguments, or 0. */
+static size_t cc__closure_call_comma(const char* src, const CCClosureCallSpan* sp) {
+    size_t args_s = sp->lparen + 1;
+    size_t args_e = sp->rparen_end - 1;
+    int par = 0, brk = 0, br = 0;
+    int ins = 0; char q = 0;
+    for (size_t i = args_s; i < args_e; i++) {
+        char ch = src[i];
+        if (ins) {
+            if (ch == '\\' && i + 1 < args_e) { i++; continue; }
+            if (ch == q) ins = 0;
+            continue;
+        }
+        if (ch == '"' || ch == '\'') { ins = 1; q = ch; continue; }
+        if (ch == '(') par++;
+        else if (ch == ')') { if (par) par--; }
+        else if (ch == '[') brk++;
+        else if (ch == ']') { if (brk) brk--; }
+        else if (ch == '{') br++;
+        else if (ch == '}') { if (br) br--; }
+        else if (ch == ',' && par == 0 && brk == 0 && br == 0) return i;
+    }
+    return 0;
+}
+
 static void cc__emit_call_replacement(const char* src,
                                       const char* callee,
                                       const CCClosureCallSpan* spans,
@@ -457,27 +482,9 @@ static void cc__emit_call_replacement(const char* src,
     const CCClosureCallSpan* sp = &spans[span_idx];
     size_t args_s = sp->lparen + 1;
     size_t args_e = sp->rparen_end - 1;
-    /* Find comma for arity=2 in original args text (top-level only). */
     size_t comma = 0;
     if (sp->arity == 2) {
-        int par = 0, brk = 0, br = 0;
-        int ins = 0; char q = 0;
-        for (size_t i = args_s; i < args_e; i++) {
-            char ch = src[i];
-            if (ins) {
-                if (ch == '\\' && i + 1 < args_e) { i++; continue; }
-                if (ch == q) ins = 0;
-                continue;
-            }
-            if (ch == '"' || ch == '\'') { ins = 1; q = ch; continue; }
-            if (ch == '(') par++;
-            else if (ch == ')') { if (par) par--; }
-            else if (ch == '[') brk++;
-            else if (ch == ']') { if (brk) brk--; }
-            else if (ch == '{') br++;
-            else if (ch == '}') { if (br) br--; }
-            else if (ch == ',' && par == 0 && brk == 0 && br == 0) { comma = i; break; }
-        }
+        comma = cc__closure_call_comma(src, sp);
         if (!comma) return; /* malformed; emit nothing */
     }
 
@@ -531,15 +538,15 @@ static void cc__emit_range_with_call_spans(const char* src,
     if (cur < end) cc__append_n(io_out, io_len, io_cap, src + cur, end - cur);
 }
 
-int cc__rewrite_all_closure_calls_with_nodes(const CCASTRoot* root,
-                                            const CCVisitorCtx* ctx,
-                                            const char* in_src,
-                                            size_t in_len,
-                                            char** out_src,
-                                            size_t* out_len) {
-    if (!root || !ctx || !in_src || !out_src || !out_len) return 0;
-    *out_src = NULL;
-    *out_len = 0;
+/* Find the closure calls in `in_src` and their nesting. On success the
+   spans are sorted by position, parents before children; the caller frees
+   them with cc__free_closure_call_spans. Returns the span count (0: none). */
+static int cc__find_closure_call_spans(const CCASTRoot* root,
+                                       const CCVisitorCtx* ctx,
+                                       const char* in_src,
+                                       size_t in_len,
+                                       CCClosureCallSpan** out_spans) {
+    *out_spans = NULL;
     if (!root->nodes || root->node_count <= 0) return 0;
 
     const NodeView* n = (const NodeView*)root->nodes;
@@ -701,6 +708,39 @@ int cc__rewrite_all_closure_calls_with_nodes(const CCASTRoot* root,
         }
         if (sp < (int)(sizeof(stack)/sizeof(stack[0]))) stack[sp++] = i;
     }
+    *out_spans = spans;
+    return sn;
+}
+
+static void cc__free_closure_call_spans(CCClosureCallSpan* spans, int sn) {
+    for (int i = 0; i < sn; i++) free(spans[i].children);
+    free(spans);
+}
+
+/* Callee name of a closure call span into nm[cap]; 0 if it does not fit. */
+static size_t cc__closure_call_name(const char* src, const CCClosureCallSpan* sp, char* nm, size_t cap) {
+    size_t nm_s = sp->name_start;
+    size_t nm_e = sp->lparen;
+    while (nm_e > nm_s && (src[nm_e - 1] == ' ' || src[nm_e - 1] == '\t' || src[nm_e - 1] == '\n' || src[nm_e - 1] == '\r')) nm_e--;
+    size_t nn = nm_e > nm_s ? (nm_e - nm_s) : 0;
+    if (nn == 0 || nn >= cap) return 0;
+    memcpy(nm, src + nm_s, nn);
+    nm[nn] = '\0';
+    return nn;
+}
+
+int cc__rewrite_all_closure_calls_with_nodes(const CCASTRoot* root,
+                                            const CCVisitorCtx* ctx,
+                                            const char* in_src,
+                                            size_t in_len,
+                                            char** out_src,
+                                            size_t* out_len) {
+    if (!root || !ctx || !in_src || !out_src || !out_len) return 0;
+    *out_src = NULL;
+    *out_len = 0;
+    CCClosureCallSpan* spans = NULL;
+    int sn = cc__find_closure_call_spans(root, ctx, in_src, in_len, &spans);
+    if (sn <= 0) return 0;
 
     /* Emit rewritten source */
     char* out = NULL;
@@ -726,8 +766,7 @@ int cc__rewrite_all_closure_calls_with_nodes(const CCASTRoot* root,
     }
     if (cur < in_len) cc__append_n(&out, &out_len2, &out_cap2, in_src + cur, in_len - cur);
 
-    for (int i = 0; i < sn; i++) free(spans[i].children);
-    free(spans);
+    cc__free_closure_call_spans(spans, sn);
 
     if (!out) return 0;
     *out_src = out;
@@ -735,26 +774,48 @@ int cc__rewrite_all_closure_calls_with_nodes(const CCASTRoot* root,
     return 1;
 }
 
-/* NEW: Collect closure call edits into EditBuffer.
-   NOTE: This pass has complex span nesting logic.
-   For now, this function runs the rewrite and uses a coarse-grained edit.
-   Future: refactor to collect edits directly. */
+/* Collect closure call edits into EditBuffer.
+   Each call becomes up to three edits against the source: the callee and
+   `(` turn into `cc_closureN_call(c, (intptr_t)(`, a 2-ary call's comma
+   into `), (intptr_t)(`, and the closing `)` into `))`. The argument text
+   is never part of an edit, so UFCS edits collected from the same parse
+   (and nested closure calls) land between them. A call that cannot be
+   lowered (malformed arguments, oversized callee) is left as written,
+   together with the calls nested in it. */
 int cc__collect_closure_calls_edits(const CCASTRoot* root,
                                     const CCVisitorCtx* ctx,
                                     CCEditBuffer* eb) {
     if (!root || !ctx || !eb || !eb->src) return 0;
 
-    char* rewritten = NULL;
-    size_t rewritten_len = 0;
-    int r = cc__rewrite_all_closure_calls_with_nodes(root, ctx, eb->src, eb->src_len, &rewritten, &rewritten_len);
-    if (r <= 0 || !rewritten) return 0;
+    const char* src = eb->src;
+    CCClosureCallSpan* spans = NULL;
+    int sn = cc__find_closure_call_spans(root, ctx, src, eb->src_len, &spans);
+    if (sn <= 0) return 0;
+    unsigned char* skip = (unsigned char*)calloc((size_t)sn, 1);
+    if (!skip) { cc__free_closure_call_spans(spans, sn); return -1; }
 
-    if (rewritten_len != eb->src_len || memcmp(rewritten, eb->src, eb->src_len) != 0) {
-        if (cc_edit_buffer_add(eb, 0, eb->src_len, rewritten, 90, "closure_calls") == 0) {
-            free(rewritten);
-            return 1;
+    int added = 0;
+    for (int i = 0; i < sn && added >= 0; i++) {
+        const CCClosureCallSpan* sp = &spans[i];
+        char nm[128];
+        size_t comma = sp->arity == 2 ? cc__closure_call_comma(src, sp) : 0;
+        if ((sp->parent >= 0 && skip[sp->parent]) || !cc__closure_call_name(src, sp, nm, sizeof(nm)) ||
+            (sp->arity == 2 && !comma)) {
+            skip[i] = 1;
+            continue;
         }
+        char head[256];
+        snprintf(head, sizeof(head), "%s(%s, (intptr_t)(",
+                 sp->arity == 1 ? "cc_closure1_call" : "cc_closure2_call", nm);
+        if (cc_edit_buffer_add(eb, sp->name_start, sp->lparen + 1, head, 90, "closure_calls") != 0 ||
+            (comma && cc_edit_buffer_add(eb, comma, comma + 1, "), (intptr_t)(", 90, "closure_calls") != 0) ||
+            cc_edit_buffer_add(eb, sp->rparen_end - 1, sp->rparen_end, "))", 90, "closure_calls") != 0) {
+            added = -1;
+            break;
+        }
+        added += comma ? 3 : 2;
     }
-    free(rewritten);
-    return 0;
+    free(skip);
+    cc__free_closure_call_spans(spans, sn);
+    return added;
 }
@@ -299,7 +299,10 @@ static size_t cc__skip_decl_noise(const char* s, size_t pos, size_t end) {
             while (attr_end < end && cc__is_ident_char(s[attr_end])) attr_end++;
             if (attr_end > attr_start &&
                 (cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "async") ||
-                 cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "unsafe"))) {
+                 cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "unsafe") ||
+                 cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "blocking") ||
+                 cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "noblock") ||
+                 cc__keyword_eq_range(s + attr_start, attr_end - attr_start, "latency_sensitive"))) {
                 pos = attr_end;
                 continue;
             }
@@ -0,0 +1,372 @@
+#include "pass_fiber_local.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/path.h"
+#include "util/text.h"
+#include "visitor/pass_common.h"
+
+CC_DEFINE_SB_APPEND_FMT
+
+typedef struct {
+    char* name;
+    char* type;
+} CCFiberLocal;
+
+/* A significant token before the current one: an identifier in[a..b), or
+   a punctuator / literal / number summarized by `p`. */
+typedef struct {
+    size_t a, b;
+    char p;                       /* 0 for identifiers */
+} CCFlTok;
+
+#define CC_FL_TOK_HISTORY 8
+#define CC_FL_MAX_BRACES 256
+#define CC_FL_MAX_NEST 256
+
+/* Skip a string or char literal starting at s[i] (the opening quote). A
+   newline ends an unterminated literal; don't run away. */
+static size_t cc__fl_skip_literal(const char* s, size_t i, size_t n) {
+    char q = s[i++];
+    while (i < n && s[i] != q && s[i] != '\n') i += (s[i] == '\\' && i + 1 < n) ? 2 : 1;
+    return (i < n && s[i] == q) ? i + 1 : i;
+}
+
+static int cc__fl_line_of(const char* s, size_t off) {
+    int line = 1;
+    for (size_t i = 0; i < off; i++) {
+        if (s[i] == '\n') line++;
+    }
+    return line;
+}
+
+static void cc__fl_error(const CCVisitorCtx* ctx, const char* s, size_t off, const char* msg, const char* name) {
+    char rel[1024];
+    const char* f = cc_path_rel_to_repo(ctx && ctx->input_path ? ctx->input_path : "<input>", rel, sizeof(rel));
+    if (name) cc_pass_error_cat(f, cc__fl_line_of(s, off), 1, CC_ERR_SYNTAX, "@fiber_local '%s' %s", name, msg);
+    else cc_pass_error_cat(f, cc__fl_line_of(s, off), 1, CC_ERR_SYNTAX, "@fiber_local %s", msg);
+}
+
+static int cc__fl_is_word(const char* s, size_t a, size_t b, const char* w) {
+    size_t wl = strlen(w);
+    return b - a == wl && memcmp(s + a, w, wl) == 0;
+}
+
+/* Copy s[a..b) with whitespace runs collapsed to one space, trimmed. */
+static char* cc__fl_squash(const char* s, size_t a, size_t b) {
+    char* t = (char*)malloc(b - a + 1);
+    if (!t) return NULL;
+    size_t w = 0;
+    int sp = 0;
+    for (size_t i = a; i < b; i++) {
+        if (isspace((unsigned char)s[i])) { sp = 1; continue; }
+        if (sp && w) t[w++] = ' ';
+        sp = 0;
+        t[w++] = s[i];
+    }
+    t[w] = '\0';
+    return t;
+}
+
+/* Parse the declaration whose `@fiber_local` marker ends at `p`. On success
+   fills *fl, sets *semi to the terminating ';' and returns 0. */
+static int cc__fl_parse_decl(const CCVisitorCtx* ctx, const char* in, size_t in_len, size_t at, size_t p,
+                             CCFiberLocal* fl, size_t* semi) {
+    size_t type_start = (size_t)-1;
+    size_t name_start = 0, name_end = 0;
+    for (;;) {
+        p = cc_skip_ws_and_comments(in, in_len, p);
+        if (p >= in_len) {
+            cc__fl_error(ctx, in, at, "declaration is missing its ';'", NULL);
+            return -1;
+        }
+        char c = in[p];
+        if (c == ';') break;
+        if (c == '=') {
+            char nm[128];
+            snprintf(nm, sizeof(nm), "%.*s", (int)(name_end - name_start), in + name_start);
+            cc__fl_error(ctx, in, at, "cannot have an initializer; a fiber starts with it zeroed or inherited",
+                         name_end ? nm : NULL);
+            return -1;
+        }
+        if (c == ',' || c == '(' || c == '[' || c == '{' || c == '@') {
+            cc__fl_error(ctx, in, at, "takes one plain variable per declaration (`@fiber_local T name;`)", NULL);
+            return -1;
+        }
+        if (cc_is_ident_start(c)) {
+            size_t e = p;
+            while (e < in_len && cc_is_ident_char(in[e])) e++;
+            if (type_start == (size_t)-1 && cc__fl_is_word(in, p, e, "static")) {
+                p = e;
+                continue;
+            }
+            if (type_start == (size_t)-1) type_start = p;
+            name_start = p;
+            name_end = e;
+            p = e;
+            continue;
+        }
+        if (type_start == (size_t)-1) type_start = p;
+        p++;
+    }
+    if (type_start == (size_t)-1 || name_end == 0 || name_start == type_start) {
+        cc__fl_error(ctx, in, at, "needs a type and a name (`@fiber_local T name;`)", NULL);
+        return -1;
+    }
+    fl->name = cc_strndup(in + name_start, name_end - name_start);
+    fl->type = cc__fl_squash(in, type_start, name_start);
+    *semi = p;
+    return (fl->name && fl->type) ? 0 : -1;
+}
+
+/* Identifiers that can sit right before an expression operand; any other
+   identifier directly before a name makes that name a declarator. */
+static int cc__fl_is_expr_keyword(const char* s, const CCFlTok* t) {
+    static const char* const kw[] = { "return", "sizeof", "case", "goto", "else", "do",
+                                      "_Alignof", "alignof", "await", NULL };
+    for (int k = 0; kw[k]; k++) {
+        if (cc__fl_is_word(s, t->a, t->b, kw[k])) return 1;
+    }
+    return 0;
+}
+
+/* Before a `*`: does this identifier name a type? Builtin type keywords,
+   `struct/union/enum Tag`, and `_t` typedefs or CC-style capitalized names.
+   The last two only when they begin the declaration -- right after `;`,
+   `{`, `}` or a storage class / qualifier, or after `(` and `,` inside a
+   parameter list -- so that `FACTOR * name` and `g(SCALE * name)` in an
+   expression stay multiplications. */
+static int cc__fl_is_type_word(const char* s, const CCFlTok* t, const CCFlTok* before, int in_params) {
+    static const char* const kw[] = { "void", "char", "short", "int", "long", "float", "double",
+                                      "signed", "unsigned", "_Bool", "bool", NULL };
+    static const char* const lead[] = { "static", "extern", "register", "const", "volatile",
+                                        "_Thread_local", "inline", NULL };
+    for (int k = 0; kw[k]; k++) {
+        if (cc__fl_is_word(s, t->a, t->b, kw[k])) return 1;
+    }
+    if (before && before->p == 0 &&
+        (cc__fl_is_word(s, before->a, before->b, "struct") || cc__fl_is_word(s, before->a, before->b, "union") ||
+         cc__fl_is_word(s, before->a, before->b, "enum"))) {
+        return 1;
+    }
+    int named = (t->b - t->a > 2 && s[t->b - 2] == '_' && s[t->b - 1] == 't') ||
+                (s[t->a] >= 'A' && s[t->a] <= 'Z');
+    if (!named) return 0;
+    if (!before) return 1;
+    if (before->p == 0) {
+        for (int k = 0; lead[k]; k++) {
+            if (cc__fl_is_word(s, before->a, before->b, lead[k])) return 1;
+        }
+        return 0;
+    }
+    if (before->p == '(' || before->p == ',') return in_params;
+    return before->p == ';' || before->p == '{' || before->p == '}';
+}
+
+/* Is the identifier after tok[0] (most recent first) being declared --
+   `T name`, `T *name`, `struct S *const name`? `in_params` says the
+   innermost open bracket is a parameter list. */
+static int cc__fl_declares(const char* s, const CCFlTok* tok, int n_tok, int in_params) {
+    if (n_tok == 0) return 0;
+    if (tok[0].p == 0) return !cc__fl_is_expr_keyword(s, &tok[0]);
+    if (tok[0].p != '*') return 0;
+    int j = 0;
+    while (j < n_tok && (tok[j].p == '*' ||
+                         (tok[j].p == 0 && (cc__fl_is_word(s, tok[j].a, tok[j].b, "const") ||
+                                            cc__fl_is_word(s, tok[j].a, tok[j].b, "volatile") ||
+                                            cc__fl_is_word(s, tok[j].a, tok[j].b, "restrict"))))) {
+        j++;
+    }
+    if (j >= n_tok || tok[j].p != 0) return 0;
+    return cc__fl_is_type_word(s, &tok[j], j + 1 < n_tok ? &tok[j + 1] : NULL, in_params);
+}
+
+int cc__lower_fiber_locals(const CCVisitorCtx* ctx,
+                           const char* in,
+                           size_t in_len,
+                           char** out_src,
+                           size_t* out_len) {
+    if (!in || !out_src || !out_len) return 0;
+    *out_src = NULL;
+    *out_len = 0;
+
+    CCFiberLocal* vars = NULL;
+    size_t n_vars = 0, cap_vars = 0;
+    char* out = NULL;
+    size_t ol = 0, oc = 0;
+    size_t copied = 0;            /* in[0..copied) has been emitted */
+    int depth = 0;
+    int line_start = 1;
+    size_t decl_start = (size_t)-1; /* first token of the current top-level declaration */
+    CCFlTok tok[CC_FL_TOK_HISTORY];   /* tok[0] is the most recent */
+    int n_tok = 0;
+    int braces = 0;
+    unsigned char record_body[CC_FL_MAX_BRACES]; /* per open '{': struct/union member list */
+    char nest[CC_FL_MAX_NEST];                   /* per open bracket: its char, 'P' for a parameter list */
+
+    for (size_t i = 0; i < in_len; ) {
+        size_t j = cc_skip_ws_and_comments(in, in_len, i);
+        if (j != i) {
+            if (memchr(in + i, '\n', j - i)) line_start = 1;
+            i = j;
+            continue;
+        }
+        char c = in[i];
+        if (line_start && c == '#') {
+            while (i < in_len && in[i] != '\n') {
+                if (in[i] == '\\' && i + 1 < in_len && in[i + 1] == '\n') i++;
+                i++;
+            }
+            continue;
+        }
+        line_start = 0;
+        if (depth == 0 && decl_start == (size_t)-1) decl_start = i;
+
+        size_t tok_start = i;
+        char tok_p = c;
+        if (c == '"' || c == '\'') {
+            i = cc__fl_skip_literal(in, i, in_len);
+        } else if (c == '{' || c == '(' || c == '[') {
+            if (c == '{') {
+                /* `struct Tag {` / `union {`: names declared inside are members. */
+                int rec = 0;
+                for (int k = 0; k < n_tok && k < 2 && tok[k].p == 0 && !rec; k++) {
+                    rec = cc__fl_is_word(in, tok[k].a, tok[k].b, "struct") ||
+                          cc__fl_is_word(in, tok[k].a, tok[k].b, "union");
+                }
+                if (braces < CC_FL_MAX_BRACES) record_body[braces] = (unsigned char)rec;
+                braces++;
+            }
+            /* A `(` right after a declarator at file or block scope opens a
+               parameter list; any other `(` holds an expression. */
+            char kind = c;
+            if (c == '(' && n_tok > 0 && tok[0].p == 0 &&
+                (depth == 0 || (depth <= CC_FL_MAX_NEST && nest[depth - 1] == '{')) &&
+                cc__fl_declares(in, tok + 1, n_tok - 1, 0)) {
+                kind = 'P';
+            }
+            if (depth < CC_FL_MAX_NEST) nest[depth] = kind;
+            depth++;
+            i++;
+        } else if (c == '}' || c == ')' || c == ']') {
+            if (depth > 0) depth--;
+            if (c == '}' && braces > 0) braces--;
+            if (depth == 0 && c == '}') decl_start = (size_t)-1;
+            i++;
+        } else if (c == ';') {
+            if (depth == 0) decl_start = (size_t)-1;
+            i++;
+        } else if (c == '@' && i + 12 <= in_len && memcmp(in + i + 1, "fiber_local", 11) == 0 &&
+                   (i + 12 == in_len || !cc_is_ident_char(in[i + 12]))) {
+            if (depth != 0) {
+                cc__fl_error(ctx, in, i, "is only allowed at file scope", NULL);
+                goto fail;
+            }
+            /* Only `static` may precede the marker. */
+            for (size_t p = decl_start; p < i; ) {
+                p = cc_skip_ws_and_comments(in, i, p);
+                if (p >= i) break;
+                size_t e = p;
+                while (e < i && cc_is_ident_char(in[e])) e++;
+                if (!cc__fl_is_word(in, p, e, "static")) {
+                    cc__fl_error(ctx, in, i, "must start the declaration (only `static` may precede it)", NULL);
+                    goto fail;
+                }
+                p = e;
+            }
+            CCFiberLocal fl = {0};
+            size_t semi = 0;
+            if (cc__fl_parse_decl(ctx, in, in_len, i, i + 12, &fl, &semi) != 0) {
+                free(fl.name);
+                free(fl.type);
+                goto fail;
+            }
+            if (n_vars == cap_vars) {
+                size_t nc = cap_vars ? cap_vars * 2 : 8;
+                CCFiberLocal* nv = (CCFiberLocal*)realloc(vars, nc * sizeof(*nv));
+                if (!nv) { free(fl.name); free(fl.type); goto fail; }
+                vars = nv;
+                cap_vars = nc;
+            }
+            vars[n_vars++] = fl;
+
+            cc_sb_append(&out, &ol, &oc, in + copied, decl_start - copied);
+            cc_sb_append_fmt(&out, &ol, &oc,
+                           "static CCFlsVar __cc_fls_%s; "
+                           "_Static_assert(sizeof(%s) <= sizeof(void*), \"@fiber_local '%s' must fit in a pointer\");",
+                           fl.name, fl.type, fl.name);
+            for (size_t p = decl_start; p <= semi; p++) {
+                if (in[p] == '\n') cc_sb_append(&out, &ol, &oc, "\n", 1);
+            }
+            copied = semi + 1;
+            decl_start = (size_t)-1;
+            i = semi + 1;
+            tok_p = ';';
+        } else if (c >= '0' && c <= '9') {
+            while (i < in_len && (cc_is_ident_char(in[i]) || in[i] == '.')) i++;
+        } else if (cc_is_ident_start(c)) {
+            size_t e = i;
+            while (e < in_len && cc_is_ident_char(in[e])) e++;
+            /* `@defer`, `@async`, ...: the marker word is not a type. */
+            tok_p = (n_tok > 0 && tok[0].p == '@' && tok[0].b == i) ? '@' : 0;
+            int member = n_tok > 0 && (tok[0].p == '.' || tok[0].p == 'm');
+            int in_record = braces > 0 && braces <= CC_FL_MAX_BRACES && record_body[braces - 1];
+            for (size_t k = 0; k < n_vars && !member && !in_record; k++) {
+                if (!cc__fl_is_word(in, i, e, vars[k].name)) continue;
+                /* Uses are matched by name, so a local, parameter or function
+                   reusing it would silently alias the fiber-local. */
+                int in_params = depth > 0 && depth <= CC_FL_MAX_NEST && nest[depth - 1] == 'P';
+                if (cc__fl_declares(in, tok, n_tok, in_params)) {
+                    cc__fl_error(ctx, in, i,
+                                 "is redeclared here; locals, parameters and functions "
+                                 "cannot reuse a fiber-local's name",
+                                 vars[k].name);
+                    goto fail;
+                }
+                cc_sb_append(&out, &ol, &oc, in + copied, i - copied);
+                cc_sb_append_fmt(&out, &ol, &oc, "(*(%s*)cc_fls_var_ref(&__cc_fls_%s))",
+                               vars[k].type, vars[k].name);
+                copied = e;
+                break;
+            }
+            i = e;
+        } else if (c == '-' && i + 1 < in_len && in[i + 1] == '>') {
+            tok_p = 'm';                /* member arrow */
+            i += 2;
+        } else {
+            i++;
+        }
+
+        memmove(tok + 1, tok, (CC_FL_TOK_HISTORY - 1) * sizeof(tok[0]));
+        tok[0].a = tok_start;
+        tok[0].b = i;
+        tok[0].p = tok_p;
+        if (n_tok < CC_FL_TOK_HISTORY) n_tok++;
+    }
+
+    if (n_vars == 0) {
+        free(out);
+        return 0;
+    }
+    cc_sb_append(&out, &ol, &oc, in + copied, in_len - copied);
+    for (size_t k = 0; k < n_vars; k++) {
+        free(vars[k].name);
+        free(vars[k].type);
+    }
+    free(vars);
+    *out_src = out;
+    *out_len = ol;
+    return 1;
+
+fail:
+    for (size_t k = 0; k < n_vars; k++) {
+        free(vars[k].name);
+        free(vars[k].type);
+    }
+    free(vars);
+    free(out);
+    return -1;
+}
@@ -0,0 +1,22 @@
+#ifndef CC_PASS_FIBER_LOCAL_H
+#define CC_PASS_FIBER_LOCAL_H
+
+#include <stddef.h>
+
+#include "visitor/visitor.h"
+
+/* `@fiber_local T name;` (file scope, no initializer) becomes a zeroed
+   `static CCFlsVar __cc_fls_name;` plus a _Static_assert that T fits in a
+   pointer, and every later use of `name` becomes
+   `(*(T*)cc_fls_var_ref(&__cc_fls_name))`. Uses are matched by identifier:
+   member accesses and struct/union fields with the same name are skipped,
+   and a later local, parameter or function declaring the name is an error
+   rather than a silent alias. Line structure is preserved.
+   Returns 1 if rewritten, 0 if unchanged, -1 on error (diagnostic emitted). */
+int cc__lower_fiber_locals(const CCVisitorCtx* ctx,
+                           const char* in_src,
+                           size_t in_len,
+                           char** out_src,
+                           size_t* out_len);
+
+#endif /* CC_PASS_FIBER_LOCAL_H */
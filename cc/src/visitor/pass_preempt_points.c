@@ -0,0 +1,100 @@
+#include "pass_preempt_points.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/text.h"
+
+static const char k_cc_preempt_call[] = " cc_preempt_point();";
+
+int cc__insert_preempt_points(const char* in, size_t in_len, char** out, size_t* out_len) {
+    if (!in || !out || !out_len) return 0;
+    *out = NULL;
+    *out_len = 0;
+
+    /* Pass 1: collect insertion offsets (just past each loop body's '{'). */
+    size_t* at = NULL;
+    size_t n_at = 0, cap_at = 0;
+    int line_start = 1;
+    int in_lc = 0, in_bc = 0, in_str = 0;
+    char q = 0;
+    for (size_t i = 0; i < in_len; ) {
+        char c = in[i];
+        char c2 = (i + 1 < in_len) ? in[i + 1] : 0;
+        if (in_bc) { if (c == '*' && c2 == '/') { in_bc = 0; i++; } i++; continue; }
+        /* A newline also ends an unterminated literal; don't run away. */
+        if (c == '\n') { line_start = 1; in_lc = 0; in_str = 0; i++; continue; }
+        if (in_lc) { i++; continue; }
+        if (in_str) {
+            if (c == '\\' && i + 1 < in_len) { i += 2; continue; }
+            if (c == q) in_str = 0;
+            i++;
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r') { i++; continue; }
+        /* Preprocessor lines (with continuations): macro bodies are not ours. */
+        if (line_start && c == '#') {
+            while (i < in_len && in[i] != '\n') {
+                if (in[i] == '\\' && i + 1 < in_len && in[i + 1] == '\n') i++;
+                i++;
+            }
+            continue;
+        }
+        line_start = 0;
+        if (c == '/' && c2 == '/') { in_lc = 1; i += 2; continue; }
+        if (c == '/' && c2 == '*') { in_bc = 1; i += 2; continue; }
+        if (c == '"' || c == '\'') { in_str = 1; q = c; i++; continue; }
+        if (!cc_is_ident_start(c)) { i++; continue; }
+
+        size_t id = i;
+        while (i < in_len && cc_is_ident_char(in[i])) i++;
+        size_t id_len = i - id;
+        size_t body = in_len;
+        if ((id_len == 3 && memcmp(in + id, "for", 3) == 0) ||
+            (id_len == 5 && memcmp(in + id, "while", 5) == 0)) {
+            size_t p = cc_skip_ws_and_comments(in, in_len, i);
+            size_t rpar = 0;
+            if (cc_find_matching_paren(in, in_len, p, &rpar)) {
+                body = cc_skip_ws_and_comments(in, in_len, rpar + 1);
+            }
+        } else if (id_len == 2 && memcmp(in + id, "do", 2) == 0) {
+            body = cc_skip_ws_and_comments(in, in_len, i);
+        }
+        /* `do { } while (x);` ends in ';', so the trailing while never matches. */
+        if (body < in_len && in[body] == '{') {
+            if (n_at == cap_at) {
+                size_t nc = cap_at ? cap_at * 2 : 64;
+                size_t* na = (size_t*)realloc(at, nc * sizeof(*at));
+                if (!na) { free(at); return 0; }
+                at = na;
+                cap_at = nc;
+            }
+            at[n_at++] = body + 1;
+        }
+    }
+    if (n_at == 0) {
+        free(at);
+        return 0;
+    }
+
+    /* Pass 2: splice. Offsets are increasing (collected in scan order). */
+    size_t call_len = sizeof(k_cc_preempt_call) - 1;
+    size_t len = in_len + n_at * call_len;
+    char* buf = (char*)malloc(len + 1);
+    if (!buf) { free(at); return 0; }
+    size_t r = 0, w = 0;
+    for (size_t k = 0; k < n_at; k++) {
+        memcpy(buf + w, in + r, at[k] - r);
+        w += at[k] - r;
+        r = at[k];
+        memcpy(buf + w, k_cc_preempt_call, call_len);
+        w += call_len;
+    }
+    memcpy(buf + w, in + r, in_len - r);
+    w += in_len - r;
+    buf[w] = '\0';
+    free(at);
+    *out = buf;
+    *out_len = w;
+    return 1;
+}
@@ -0,0 +1,13 @@
+#ifndef CC_PASS_PREEMPT_POINTS_H
+#define CC_PASS_PREEMPT_POINTS_H
+
+#include <stddef.h>
+
+/* Preemption safe points (`ccc --preempt-points`, CC_PREEMPT_POINTS=1):
+   inserts `cc_preempt_point();` at the top of every braced `for`, `while`
+   and `do` body so a CPU-bound fiber yields when the scheduler asks it to.
+   Runs on the final lowered C; loops with unbraced bodies are left alone.
+   Returns 1 and sets *out when anything was inserted, 0 otherwise. */
+int cc__insert_preempt_points(const char* in, size_t in_len, char** out, size_t* out_len);
+
+#endif /* CC_PASS_PREEMPT_POINTS_H */
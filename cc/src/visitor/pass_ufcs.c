@@ -279,12 +279,15 @@ static int cc__rewrite_ufcs_text_fallback(const CCVisitorCtx* ctx,
     return 1;
 }
 
-int cc__rewrite_ufcs_spans_with_nodes(const CCASTRoot* root,
-                                     const CCVisitorCtx* ctx,
-                                     const char* in_src,
-                                     size_t in_len,
-                                     char** out_src,
-                                     size_t* out_len) {
+/* The span rewrite behind cc__rewrite_ufcs_spans_with_nodes. With a
+   `track`, every splice on the working copy is reported to it as well. */
+static int cc__ufcs_rewrite_spans(const CCASTRoot* root,
+                                  const CCVisitorCtx* ctx,
+                                  const char* in_src,
+                                  size_t in_len,
+                                  CCEditTrack* track,
+                                  char** out_src,
+                                  size_t* out_len) {
     if (!root || !ctx || !ctx->input_path || !in_src || !out_src || !out_len) return 0;
     *out_src = NULL;
     *out_len = 0;
@@ -519,6 +522,15 @@ int cc__rewrite_ufcs_spans_with_nodes(const CCASTRoot* root,
                 size_t repl_len = strlen(out_buf);
                 size_t new_len = cur_len - expr_len + repl_len;
                 char* next = (char*)malloc(new_len + 1);
+                if (next && track && cc_edit_track_splice(track, sp.start, sp.end, out_buf, repl_len) != 0) {
+                    free(next);
+                    free(expr);
+                    free(out_buf);
+                    free(nodes);
+                    free(done);
+                    free(cur);
+                    return -1;
+                }
                 if (next) {
                     memcpy(next, cur, sp.start);
                     memcpy(next + sp.start, out_buf, repl_len);
@@ -549,6 +561,15 @@ int cc__rewrite_ufcs_spans_with_nodes(const CCASTRoot* root,
     return 1;
 }
 
+int cc__rewrite_ufcs_spans_with_nodes(const CCASTRoot* root,
+                                     const CCVisitorCtx* ctx,
+                                     const char* in_src,
+                                     size_t in_len,
+                                     char** out_src,
+                                     size_t* out_len) {
+    return cc__ufcs_rewrite_spans(root, ctx, in_src, in_len, NULL, out_src, out_len);
+}
+
 static int cc__is_ident_start_char(char c) {
     return isalpha((unsigned char)c) || c == '_';
 }
@@ -843,33 +864,23 @@ static size_t cc__ufcs_extend_chain_end(const char* s, size_t len, size_t end) {
 
 /* Path helpers are now in pass_common.h */
 
-/* NEW: Collect UFCS edits into EditBuffer.
-   NOTE: UFCS is complex (incremental processing with chain extension).
-   For now, this function runs the rewrite and diffs the result to extract edits.
-   Future: refactor to collect edits directly without intermediate rewrite. */
-int cc__collect_ufcs_edits(const CCASTRoot* root,
-                           const CCVisitorCtx* ctx,
-                           CCEditBuffer* eb) {
-    if (!root || !ctx || !eb || !eb->src) return 0;
-
-    cc_ufcs_set_symbols(ctx->symbols);
+/* Legacy text fallback (CC_UFCS_TEXT_FALLBACK=1): it rewrites whole lines
+   with no spans to track, so its output goes in as one whole-file edit.
+   That is coarse but exact, and this path is only a debugging aid. */
+static int cc__collect_ufcs_edits_text_fallback(const CCASTRoot* root,
+                                                const CCVisitorCtx* ctx,
+                                                CCEditBuffer* eb) {
     char* rewritten = NULL;
     size_t rewritten_len = 0;
     int r = cc__rewrite_ufcs_spans_with_nodes(root, ctx, eb->src, eb->src_len, &rewritten, &rewritten_len);
-    /* AST-only UFCS: the text fallback is off by default.  The final-UFCS
-     * sweep in visit_codegen splices lifted closure bodies into src_ufcs
-     * before reparsing so TCC sees every UFCS call site in the translation
-     * unit, including those inside `() => { ... }` bodies.  Set
-     * CC_UFCS_TEXT_FALLBACK=1 to re-enable the legacy text pass as a
-     * diagnostic safety net while debugging UFCS rewrites. */
-    if (getenv("CC_UFCS_TEXT_FALLBACK") && eb->src && eb->src_len > 0) {
+    if (r < 0) return -1;
+    if (eb->src_len > 0) {
         const char* base_src = rewritten ? rewritten : eb->src;
         size_t base_len = rewritten ? rewritten_len : eb->src_len;
         char* fallback = NULL;
         size_t fallback_len = 0;
         int fr = cc__rewrite_ufcs_text_fallback(ctx, base_src, base_len, &fallback, &fallback_len);
         if (fr < 0) {
-            cc_ufcs_set_symbols(NULL);
             free(rewritten);
             return -1;
         }
@@ -877,24 +888,48 @@ int cc__collect_ufcs_edits(const CCASTRoot* root,
             if (rewritten) free(rewritten);
             rewritten = fallback;
             rewritten_len = fallback_len;
-            r = 1;
         }
     }
-    cc_ufcs_set_symbols(NULL);
-    if (r < 0) return -1;
-    if (r == 0 || !rewritten) return 0;
-
-    /* UFCS does many small same-line transforms. Rather than diff, for now we use a
-       single "replace all" edit which is semantically correct but coarse.
-       Future: track individual span rewrites for finer-grained edits. */
+    if (!rewritten) return 0;
+    int added = 0;
     if (rewritten_len != eb->src_len || memcmp(rewritten, eb->src, eb->src_len) != 0) {
-        /* Replace entire source - this works but loses granularity.
-           Since UFCS is typically first in its group, this is acceptable. */
-        if (cc_edit_buffer_add(eb, 0, eb->src_len, rewritten, 100, "ufcs") == 0) {
-            free(rewritten);
-            return 1;
-        }
+        added = cc_edit_buffer_add(eb, 0, eb->src_len, rewritten, 100, "ufcs") == 0 ? 1 : -1;
     }
     free(rewritten);
-    return 0;
+    return added;
+}
+
+/* Collect UFCS edits into EditBuffer.
+   The span rewrite still works on a copy, bottom-up, so chains and nested
+   calls see earlier rewrites; each splice it makes is tracked back to the
+   source (CCEditTrack) and committed as an edit narrowed to the bytes
+   that changed. Receivers and arguments copied through stay editable by
+   passes that share this parse. */
+int cc__collect_ufcs_edits(const CCASTRoot* root,
+                           const CCVisitorCtx* ctx,
+                           CCEditBuffer* eb) {
+    if (!root || !ctx || !eb || !eb->src) return 0;
+
+    cc_ufcs_set_symbols(ctx->symbols);
+    /* AST-only UFCS: the text fallback is off by default.  The final-UFCS
+     * sweep in visit_codegen splices lifted closure bodies into src_ufcs
+     * before reparsing so TCC sees every UFCS call site in the translation
+     * unit, including those inside `() => { ... }` bodies.  Set
+     * CC_UFCS_TEXT_FALLBACK=1 to re-enable the legacy text pass as a
+     * diagnostic safety net while debugging UFCS rewrites. */
+    if (getenv("CC_UFCS_TEXT_FALLBACK")) {
+        int added = cc__collect_ufcs_edits_text_fallback(root, ctx, eb);
+        cc_ufcs_set_symbols(NULL);
+        return added;
+    }
+    CCEditTrack track;
+    cc_edit_track_init(&track, eb, 100, "ufcs");
+    char* rewritten = NULL;
+    size_t rewritten_len = 0;
+    int r = cc__ufcs_rewrite_spans(root, ctx, eb->src, eb->src_len, &track, &rewritten, &rewritten_len);
+    cc_ufcs_set_symbols(NULL);
+    free(rewritten);
+    int added = r < 0 ? -1 : r == 0 ? 0 : cc_edit_track_commit(&track);
+    cc_edit_track_free(&track);
+    return added;
 }
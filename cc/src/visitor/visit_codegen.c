@@ -12,6 +12,9 @@
 
 #include "visitor/ufcs.h"
 #include "visitor/pass_strip_markers.h"
+#include "visitor/pass_blocking_regions.h"
+#include "visitor/pass_fiber_local.h"
+#include "visitor/pass_preempt_points.h"
 #include "visitor/pass_await_normalize.h"
 #include "visitor/pass_ufcs.h"
 #include "visitor/pass_closure_calls.h"
@@ -30,11 +33,13 @@
 #include "visitor/visitor_fileutil.h"
 #include "visitor/text_span.h"
 #include "comptime/hook_compile.h"
+#include "ir/verifier.h"
 #include "header/lower_header.h"
 #include "parser/tcc_bridge.h"
 #include "preprocess/preprocess.h"
 #include "preprocess/type_registry.h"
 #include "result_spec.h"
+#include "util/pass_profile.h"
 #include "util/path.h"
 #include "util/text.h"
 
@@ -58,13 +63,17 @@ static int cc__is_parser_placeholder_type_codegen(const char* type_name);
 typedef int (*CCCodegenEditCollectorFn)(const CCASTRoot* root,
                                         const CCVisitorCtx* ctx,
                                         CCEditBuffer* eb);
-static int cc__apply_coarse_codegen_pass(const CCASTRoot* root,
-                                         const CCVisitorCtx* ctx,
-                                         char** src_io,
-                                         size_t* len_io,
-                                         const char* base_src,
-                                         CCCodegenEditCollectorFn collect,
-                                         int* out_changed);
+static int cc__apply_coarse_codegen_pass_named(const char* name,
+                                               const CCASTRoot* root,
+                                               const CCVisitorCtx* ctx,
+                                               char** src_io,
+                                               size_t* len_io,
+                                               const char* base_src,
+                                               CCCodegenEditCollectorFn collect,
+                                               int* out_changed);
+/* Timed under --time-passes as the collector's name. */
+#define cc__apply_coarse_codegen_pass(root, ctx, src_io, len_io, base_src, collect, out_changed) \
+    cc__apply_coarse_codegen_pass_named(#collect, root, ctx, src_io, len_io, base_src, collect, out_changed)
 
 static const char* cc__canonicalize_placeholder_family_type_codegen(const char* type_name,
                                                                     char* scratch,
@@ -300,19 +309,23 @@ static char* cc__neutralize_comments_for_reparse(const char* src, size_t n) {
     return out;
 }
 
-static int cc__apply_coarse_codegen_pass(const CCASTRoot* root,
-                                         const CCVisitorCtx* ctx,
-                                         char** src_io,
-                                         size_t* len_io,
-                                         const char* base_src,
-                                         CCCodegenEditCollectorFn collect,
-                                         int* out_changed) {
+static int cc__apply_coarse_codegen_pass_named(const char* name,
+                                               const CCASTRoot* root,
+                                               const CCVisitorCtx* ctx,
+                                               char** src_io,
+                                               size_t* len_io,
+                                               const char* base_src,
+                                               CCCodegenEditCollectorFn collect,
+                                               int* out_changed) {
     CCEditBuffer eb;
+    size_t bytes_out = 0;
     if (out_changed) *out_changed = 0;
     if (!root || !ctx || !src_io || !*src_io || !len_io || !collect) return 0;
+    cc_pass_begin(name);
     cc_edit_buffer_init(&eb, *src_io, *len_io);
     if (collect(root, ctx, &eb) < 0) {
         cc_edit_buffer_free(&eb);
+        cc_pass_end(0);
         return -1;
     }
     if (eb.count > 0) {
@@ -322,10 +335,12 @@ static int cc__apply_coarse_codegen_pass(const CCASTRoot* root,
             if (*src_io != base_src) free(*src_io);
             *src_io = rewritten;
             *len_io = new_len;
+            bytes_out = new_len + 1;
             if (out_changed) *out_changed = 1;
         }
     }
     cc_edit_buffer_free(&eb);
+    cc_pass_end(bytes_out);
     return 0;
 }
 
@@ -704,10 +719,25 @@ static char* cc__rewrite_parser_placeholder_ufcs_lowers(const char* src, size_t
     return out;
 }
 
-/* Helper: reparse source string to AST (in-memory). */
+static CCASTRoot* cc__reparse_source_to_ast_impl(const char* src, size_t src_len,
+                                                 const char* input_path, CCSymbolTable* symbols,
+                                                 const char* stage);
+
+/* Helper: reparse source string to AST (in-memory). Each call is counted
+   against every open pass under --time-passes. */
 static CCASTRoot* cc__reparse_source_to_ast(const char* src, size_t src_len,
                                             const char* input_path, CCSymbolTable* symbols,
                                             const char* stage) {
+    cc_pass_note_reparse();
+    cc_pass_begin("reparse");
+    CCASTRoot* root = cc__reparse_source_to_ast_impl(src, src_len, input_path, symbols, stage);
+    cc_pass_end(0);
+    return root;
+}
+
+static CCASTRoot* cc__reparse_source_to_ast_impl(const char* src, size_t src_len,
+                                                 const char* input_path, CCSymbolTable* symbols,
+                                                 const char* stage) {
     CCTypeRegistry* saved_reg = cc_type_registry_get_global();
     CCTypeRegistry* temp_reg = cc_type_registry_new();
     char* nursery_rewritten = cc_rewrite_nursery_create_destroy_proto(src, src_len, input_path);
@@ -795,6 +825,99 @@ done:
     return root;
 }
 
+/* Legacy phase-3 order for UFCS and closure calls: apply UFCS, reparse,
+   collect closure calls from the new AST. Used when the batched edits
+   conflict, with CC_PHASE3_NO_BATCH=1, and as the reference output under
+   CC_VERIFY_IR=1. */
+static int cc__phase3_ufcs_closure_calls_sequential(const CCASTRoot* root,
+                                                    const CCVisitorCtx* ctx,
+                                                    char** src_io,
+                                                    size_t* len_io,
+                                                    const char* base_src,
+                                                    int* out_changed) {
+    int ufcs_changed = 0, calls_changed = 0;
+    CCASTRoot* owned = NULL;
+    if (cc__apply_coarse_codegen_pass(root, ctx, src_io, len_io, base_src,
+                                      cc__collect_ufcs_edits, &ufcs_changed) < 0) {
+        return -1;
+    }
+    if (ufcs_changed) {
+        owned = cc__reparse_source_to_ast(*src_io, *len_io, ctx->input_path, ctx->symbols,
+                                          "phase3 after coarse UFCS rewrite");
+        if (!owned) return -1;
+        root = owned;
+    }
+    int rc = cc__apply_coarse_codegen_pass(root, ctx, src_io, len_io, base_src,
+                                           cc__collect_closure_calls_edits, &calls_changed);
+    if (owned) cc_tcc_bridge_free_ast(owned);
+    if (rc < 0) return -1;
+    *out_changed = ufcs_changed || calls_changed;
+    return 0;
+}
+
+/* UFCS and closure calls over one parse: both collectors record edits
+   against the same source while walking it, and the edits go through one
+   EditBuffer. Neither pass's edits cover the argument text it copies
+   through, so a closure call nested in a UFCS call (or the reverse) merges
+   and the result matches the sequential one without the reparse between.
+   Returns 1 without touching *src_io if the two passes' spans collide. */
+static int cc__phase3_ufcs_closure_calls_batched(const CCASTRoot* root,
+                                                 const CCVisitorCtx* ctx,
+                                                 char** src_io,
+                                                 size_t* len_io,
+                                                 const char* base_src,
+                                                 int* out_changed) {
+    CCEditBuffer eb;
+    int rc = 0;
+    size_t bytes_out = 0;
+    *out_changed = 0;
+    if (!root || !ctx || !*src_io) return 0;
+    cc_edit_buffer_init(&eb, *src_io, *len_io);
+    cc_pass_begin("cc__collect_ufcs_edits");
+    int ufcs_n = cc__collect_ufcs_edits(root, ctx, &eb);
+    cc_pass_end(0);
+    if (ufcs_n < 0) { rc = -1; goto done; }
+    cc_pass_begin("cc__collect_closure_calls_edits");
+    int calls_n = cc__collect_closure_calls_edits(root, ctx, &eb);
+    cc_pass_end(0);
+    if (calls_n < 0) { rc = -1; goto done; }
+    if (eb.count == 0) goto done;
+    if (ufcs_n > 0 && calls_n > 0 && cc_edit_buffer_has_conflicts(&eb)) {
+        if (getenv("CC_DEBUG_PHASE3_BATCH")) {
+            fprintf(stderr, "CC: phase3 batch: ufcs/closure-call edits overlap, running sequentially\n");
+        }
+        rc = 1;
+        goto done;
+    }
+    cc_pass_begin("phase3_batch_apply");
+    size_t new_len = 0;
+    char* rewritten = cc_edit_buffer_apply(&eb, &new_len);
+    if (rewritten) bytes_out = new_len + 1;
+    cc_pass_end(bytes_out);
+    if (!rewritten) { rc = -1; goto done; }
+    if (cc_ir_verify_active()) {
+        char* ref = strdup(*src_io);
+        size_t ref_len = *len_io;
+        int ref_changed = 0;
+        if (ref && cc__phase3_ufcs_closure_calls_sequential(root, ctx, &ref, &ref_len, NULL, &ref_changed) == 0 &&
+            cc_ir_verify_diff("phase3.ufcs_closure_calls", ref, ref_len, rewritten, new_len) != 0) {
+            /* Keep the sequential output; the diagnostic is already out. */
+            free(rewritten);
+            rewritten = ref;
+            new_len = ref_len;
+            ref = NULL;
+        }
+        free(ref);
+    }
+    if (*src_io != base_src) free(*src_io);
+    *src_io = rewritten;
+    *len_io = new_len;
+    *out_changed = 1;
+done:
+    cc_edit_buffer_free(&eb);
+    return rc;
+}
+
 /* AST-driven async lowering (implemented in `cc/src/visitor/async_ast.c`). */
 int cc_async_rewrite_state_machine_ast(const CCASTRoot* root,
                                        const CCVisitorCtx* ctx,
@@ -2999,7 +3122,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         cc__read_entire_file(ctx->input_path, &src_all, &src_len);
     }
     if (src_all && src_len && ctx && ctx->symbols) {
-        src_regs = cc_preprocess_comptime_source(ctx->input_path);
+        src_regs = CC_PASS_TEXT(cc_preprocess_comptime_source, ctx->input_path);
     }
 
     char* src_ufcs = src_all;
@@ -3064,7 +3187,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                 fprintf(stderr, "  pattern[%zu] = %s\n", ti, pat);
             }
         }
-        char* blanked = cc__blank_comptime_blocks_preserve_layout(src_ufcs, src_ufcs_len);
+        char* blanked = CC_PASS_TEXT(cc__blank_comptime_blocks_preserve_layout, src_ufcs, src_ufcs_len);
         if (blanked) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = blanked;
@@ -3075,7 +3198,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     src_regs = NULL;
 
     if (src_ufcs && src_ufcs_len) {
-        char* lowered_includes = cc_rewrite_local_cch_includes_to_lowered_headers(src_ufcs, src_ufcs_len, ctx->input_path);
+        char* lowered_includes = CC_PASS_TEXT(cc_rewrite_local_cch_includes_to_lowered_headers, src_ufcs, src_ufcs_len, ctx->input_path);
         if (lowered_includes) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = lowered_includes;
@@ -3083,7 +3206,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         }
     }
     if (src_ufcs && src_ufcs_len) {
-        char* lowered_system_includes = cc_rewrite_system_cch_includes_to_lowered_headers(src_ufcs, src_ufcs_len);
+        char* lowered_system_includes = CC_PASS_TEXT(cc_rewrite_system_cch_includes_to_lowered_headers, src_ufcs, src_ufcs_len);
         if (lowered_system_includes) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = lowered_system_includes;
@@ -3092,7 +3215,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     }
 
     if (src_ufcs && src_ufcs_len) {
-        char* rewritten = cc_rewrite_nursery_create_destroy_proto(src_ufcs, src_ufcs_len, ctx->input_path);
+        char* rewritten = CC_PASS_TEXT(cc_rewrite_nursery_create_destroy_proto, src_ufcs, src_ufcs_len, ctx->input_path);
         if (rewritten == (char*)-1) {
             fclose(out);
             if (src_ufcs != src_all) free(src_ufcs);
@@ -3107,7 +3230,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     }
 
     if (src_ufcs && src_ufcs_len && ctx->symbols) {
-        char* rewritten = cc_rewrite_registered_type_create_destroy(src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols);
+        char* rewritten = CC_PASS_TEXT(cc_rewrite_registered_type_create_destroy, src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols);
         if (rewritten == (char*)-1) {
             fclose(out);
             if (src_ufcs != src_all) free(src_ufcs);
@@ -3128,7 +3251,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
      * recognises the CCAsyncVoidRet marker and still treats the function
      * as originally void-returning (bare `return;` stays valid). */
     if (src_ufcs && src_ufcs_len && cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@async")) {
-        char* rewritten = cc__rewrite_async_void_ret(src_ufcs, src_ufcs_len);
+        char* rewritten = CC_PASS_TEXT(cc__rewrite_async_void_ret, src_ufcs, src_ufcs_len);
         if (rewritten) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rewritten;
@@ -3139,7 +3262,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     /* Lower @await fname(...) -> cc_block_on(ReturnType, fname(...)) before
      * any AST reparse, so TCC never sees the @await token. */
     if (src_ufcs && src_ufcs_len && cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@await")) {
-        char* rewritten = cc__rewrite_at_await(src_ufcs, src_ufcs_len);
+        char* rewritten = CC_PASS_TEXT(cc__rewrite_at_await, src_ufcs, src_ufcs_len);
         if (rewritten) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rewritten;
@@ -3149,7 +3272,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
 
     /* Rewrite `if @try (T x = expr) { ... }` into expanded form */
     if (src_ufcs && src_ufcs_len) {
-        char* rewritten = cc__rewrite_if_try_syntax(src_ufcs, src_ufcs_len);
+        char* rewritten = CC_PASS_TEXT(cc__rewrite_if_try_syntax, src_ufcs, src_ufcs_len);
         if (rewritten) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rewritten;
@@ -3159,7 +3282,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
 
     /* Rewrite generic container syntax: CCVec<T> -> CCVec_T, cc_vec_new<T>() -> CCVec_T_init() */
     if (src_ufcs && src_ufcs_len) {
-        char* rewritten = cc_rewrite_generic_containers(src_ufcs, src_ufcs_len, ctx->input_path);
+        char* rewritten = CC_PASS_TEXT(cc_rewrite_generic_containers, src_ufcs, src_ufcs_len, ctx->input_path);
         if (rewritten) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rewritten;
@@ -3172,7 +3295,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     if (src_ufcs && src_ufcs_len) {
         char* rewritten = NULL;
         size_t rewritten_len = 0;
-        if (cc__rewrite_with_deadline_syntax(src_ufcs, src_ufcs_len, &rewritten, &rewritten_len) == 0 && rewritten) {
+        if (CC_PASS_INT(cc__rewrite_with_deadline_syntax, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len) == 0 && rewritten) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rewritten;
             src_ufcs_len = rewritten_len;
@@ -3183,7 +3306,26 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     if (src_ufcs && src_ufcs_len) {
         char* rewritten = NULL;
         size_t rewritten_len = 0;
-        int r = cc__rewrite_match_syntax(ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
+        int r = CC_PASS_INT(cc__rewrite_match_syntax, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
+        if (r < 0) {
+            fclose(out);
+            if (src_ufcs != src_all) free(src_ufcs);
+            free(src_all);
+            return EINVAL;
+        }
+        if (r > 0 && rewritten) {
+            if (src_ufcs != src_all) free(src_ufcs);
+            src_ufcs = rewritten;
+            src_ufcs_len = rewritten_len;
+        }
+    }
+
+    /* Lower `@fiber_local` declarations and uses; the reparse below sees the
+       CCFlsVar form the preprocessor already handed to TCC. */
+    if (src_ufcs && cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@fiber_local")) {
+        char* rewritten = NULL;
+        size_t rewritten_len = 0;
+        int r = CC_PASS_INT(cc__lower_fiber_locals, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
         if (r < 0) {
             fclose(out);
             if (src_ufcs != src_all) free(src_ufcs);
@@ -3202,7 +3344,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
        declarations or function parameters, so TCC does not have to accept a
        temporary `recv.method(...)` spelling just to let later passes run. */
     if (src_ufcs && ctx) {
-        char* rew = cc_rewrite_generic_family_ufcs_parser_safe(src_ufcs, src_ufcs_len);
+        char* rew = CC_PASS_TEXT(cc_rewrite_generic_family_ufcs_parser_safe, src_ufcs, src_ufcs_len);
         if (rew) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rew;
@@ -3216,9 +3358,11 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     char* closure_defs = NULL;
     size_t closure_defs_len = 0;
 
-    /* Phase 3 currently uses coarse whole-file rewrites for several AST-driven
-       passes. Run them sequentially with reparsing between changed passes so
-       whole-file snapshots do not collide in the shared edit buffer. */
+    /* Phase 3 AST-driven passes. UFCS and closure calls record their edits
+       during the walk, so they batch over one parse; autoblock consumes
+       their output and await normalization consumes autoblock's, so those
+       two still run after a reparse as whole-file edits, and only when the
+       TU has @async/await at all. */
 #ifdef CC_TCC_EXT_AVAILABLE
     if (src_ufcs && root && root->nodes && root->node_count > 0 && ctx->symbols) {
         const CCASTRoot* phase3_root = root;
@@ -3255,30 +3399,19 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             phase3_root = phase3_owned_root;
         }
         cc__collect_registered_ufcs_var_types(ctx->symbols, src_ufcs, src_ufcs_len);
-        if (cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
-                                          src_all, cc__collect_ufcs_edits, &phase3_changed) < 0) {
-            fclose(out);
-            if (src_ufcs != src_all) free(src_ufcs);
-            free(src_all);
-            free(closure_protos);
-            free(closure_defs);
-            return EINVAL;
-        }
-        if (phase3_changed) {
-            phase3_owned_root = cc__reparse_source_to_ast(src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols,
-                                                          "phase3 after coarse UFCS rewrite");
-            if (!phase3_owned_root) {
-                fclose(out);
-                if (src_ufcs != src_all) free(src_ufcs);
-                free(src_all);
-                free(closure_protos);
-                free(closure_defs);
-                return EINVAL;
-            }
-            phase3_root = phase3_owned_root;
-        }
-        if (cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
-                                          src_all, cc__collect_closure_calls_edits, &phase3_changed) < 0) {
+        /* UFCS and closure calls share phase3_root (see
+           cc__phase3_ufcs_closure_calls_batched); only overlapping edits
+           fall back to the reparse between them. */
+        int batch_rc = 1;
+        if (!getenv("CC_PHASE3_NO_BATCH")) {
+            batch_rc = cc__phase3_ufcs_closure_calls_batched(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
+                                                             src_all, &phase3_changed);
+        }
+        if (batch_rc > 0) {
+            batch_rc = cc__phase3_ufcs_closure_calls_sequential(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
+                                                                src_all, &phase3_changed);
+        }
+        if (batch_rc < 0) {
             if (phase3_owned_root) cc_tcc_bridge_free_ast(phase3_owned_root);
             fclose(out);
             if (src_ufcs != src_all) free(src_ufcs);
@@ -3287,18 +3420,27 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             free(closure_defs);
             return EINVAL;
         }
-        if (phase3_changed) {
-            if (getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP") && src_ufcs) {
-                const char* dump_path = getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP");
-                FILE* df = dump_path ? fopen(dump_path, "w") : NULL;
-                if (df) {
-                    fwrite(src_ufcs, 1, src_ufcs_len, df);
-                    fclose(df);
-                }
+        if (phase3_changed && getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP") && src_ufcs) {
+            const char* dump_path = getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP");
+            FILE* df = dump_path ? fopen(dump_path, "w") : NULL;
+            if (df) {
+                fwrite(src_ufcs, 1, src_ufcs_len, df);
+                fclose(df);
             }
+        }
+        /* autoblock and await normalization only fire inside @async
+           functions / on await expressions, so without either token the
+           rest of phase 3 is a no-op and needs no fresh AST. */
+        int phase3_async = src_ufcs &&
+                           (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@async") ||
+                            cc_contains_token_top_level(src_ufcs, src_ufcs_len, "await"));
+        int phase3_site_mode = src_ufcs &&
+                               (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@blocking") ||
+                                cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@noblock"));
+        if (phase3_changed && phase3_async && !phase3_site_mode) {
             if (phase3_owned_root) cc_tcc_bridge_free_ast(phase3_owned_root);
             phase3_owned_root = cc__reparse_source_to_ast(src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols,
-                                                          "phase3 after closure-call rewrite");
+                                                          "phase3 after UFCS + closure-call rewrite");
             if (!phase3_owned_root) {
                 fclose(out);
                 if (src_ufcs != src_all) free(src_ufcs);
@@ -3314,14 +3456,15 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
          * comment markers (`/​*@CC_SITE=blocking*​/ f(...)`) so pass_autoblock
          * can observe them while scanning src_ufcs.  Reparse afterwards so
          * AST offsets reflect the shifted callee positions. */
-        if (src_ufcs &&
-            (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@blocking") ||
-             cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@noblock"))) {
-            char* cs = cc__rewrite_at_call_site_mode(src_ufcs, src_ufcs_len);
+        if (phase3_site_mode) {
+            char* cs = CC_PASS_TEXT(cc__rewrite_at_call_site_mode, src_ufcs, src_ufcs_len);
             if (cs) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = cs;
                 src_ufcs_len = strlen(cs);
+                phase3_changed = 1;
+            }
+            if (phase3_changed && phase3_async) {
                 if (phase3_owned_root) cc_tcc_bridge_free_ast(phase3_owned_root);
                 phase3_owned_root = cc__reparse_source_to_ast(src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols,
                                                               "phase3 after call-site mode rewrite");
@@ -3336,7 +3479,8 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                 phase3_root = phase3_owned_root;
             }
         }
-        if (cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
+        if (phase3_async &&
+            cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
                                           src_all, cc__collect_autoblocking_edits, &phase3_changed) < 0) {
             if (phase3_owned_root) cc_tcc_bridge_free_ast(phase3_owned_root);
             fclose(out);
@@ -3346,7 +3490,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             free(closure_defs);
             return EINVAL;
         }
-        if (phase3_changed) {
+        if (phase3_async && phase3_changed) {
             if (getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP") && src_ufcs) {
                 const char* dump_path = getenv("CC_DEBUG_POST_AUTOBLOCK_DUMP");
                 FILE* df = dump_path ? fopen(dump_path, "w") : NULL;
@@ -3368,7 +3512,8 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             }
             phase3_root = phase3_owned_root;
         }
-        if (cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
+        if (phase3_async &&
+            cc__apply_coarse_codegen_pass(phase3_root, ctx, &src_ufcs, &src_ufcs_len,
                                           src_all, cc__collect_await_normalize_edits, &phase3_changed) < 0) {
             if (phase3_owned_root) cc_tcc_bridge_free_ast(phase3_owned_root);
             fclose(out);
@@ -3402,7 +3547,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         /* Lower `cc_channel_pair(&tx, &rx);` BEFORE channel type rewrite (it needs `[~]` patterns). */
         {
             size_t rp_len = 0;
-            char* rp = cc__rewrite_channel_pair_calls_text(ctx, src_ufcs, src_ufcs_len, &rp_len);
+            char* rp = CC_PASS_TEXT(cc__rewrite_channel_pair_calls_text, ctx, src_ufcs, src_ufcs_len, &rp_len);
             if (!rp) {
                 fclose(out);
                 if (src_ufcs != src_all) free(src_ufcs);
@@ -3419,7 +3564,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         if (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "send_task") ||
             cc_contains_token_top_level(src_ufcs, src_ufcs_len, "cc_channel_send_task")) {
             size_t st_len = 0;
-            char* st = cc__rewrite_chan_send_task_text(ctx, src_ufcs, src_ufcs_len, &st_len);
+            char* st = CC_PASS_TEXT(cc__rewrite_chan_send_task_text, ctx, src_ufcs, src_ufcs_len, &st_len);
             if (st) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = st;
@@ -3432,7 +3577,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
            T[~N ordered <] becomes CCChanRx (ordered is a flag on the channel).
            Must happen before AST creation so closure positions are correct. */
         {
-            char* rew = cc__rewrite_chan_handle_types_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew = CC_PASS_TEXT(cc__rewrite_chan_handle_types_text, ctx, src_ufcs, src_ufcs_len);
             if (rew) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rew;
@@ -3447,7 +3592,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
        during these in-memory reparses. Canonicalize containers here so the
        subsequent reparses see the same receiver shapes as the main parser. */
     if (src_ufcs && ctx && ctx->input_path) {
-        char* rew = cc_rewrite_generic_containers(src_ufcs, src_ufcs_len, ctx->input_path);
+        char* rew = CC_PASS_TEXT(cc_rewrite_generic_containers, src_ufcs, src_ufcs_len, ctx->input_path);
         if (rew) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rew;
@@ -3460,7 +3605,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
        receiver families before the reparse-driven AST passes so later stages see
        stable lowered calls instead of relying on span matching. */
     if (src_ufcs && ctx) {
-        char* rew = cc_rewrite_generic_family_ufcs_parser_safe(src_ufcs, src_ufcs_len);
+        char* rew = CC_PASS_TEXT(cc_rewrite_generic_family_ufcs_parser_safe, src_ufcs, src_ufcs_len);
         if (rew) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rew;
@@ -3526,7 +3671,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
          cc_contains_token_top_level(src_ufcs, src_ufcs_len, "?>"))) {
         char* ru_out = NULL;
         size_t ru_out_len = 0;
-        if (cc__rewrite_result_unwrap(ctx, src_ufcs, src_ufcs_len, &ru_out, &ru_out_len) > 0 && ru_out) {
+        if (CC_PASS_INT(cc__rewrite_result_unwrap, ctx, src_ufcs, src_ufcs_len, &ru_out, &ru_out_len) > 0 && ru_out) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = ru_out;
             src_ufcs_len = ru_out_len;
@@ -3534,8 +3679,11 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
     }
 
     /* Reparse the current TU source to get an up-to-date stub-AST for statement-level lowering.
-       These rewrites run before marker stripping to keep spans stable. */
-    if (src_ufcs && ctx && ctx->symbols) {
+       These rewrites run before marker stripping to keep spans stable.
+       Closure literals are the only consumer, so a TU without `=>` skips
+       the reparse. */
+    if (src_ufcs && ctx && ctx->symbols &&
+        cc_contains_token_top_level(src_ufcs, src_ufcs_len, "=>")) {
         cc__debug_dump_reparse_source("stage1_pre_stmt", src_ufcs, src_ufcs_len, ctx->input_path);
         CCASTRoot* root3 = cc__reparse_source_to_ast(src_ufcs, src_ufcs_len, ctx->input_path, ctx->symbols,
                                                      "statement-lowering input");
@@ -3578,13 +3726,26 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         cc_tcc_bridge_free_ast(root3);
     }
 
+    /* Open `@blocking` function bodies with a blocking region. Emits an
+       `@defer`, so it runs just ahead of the @defer pass (and before marker
+       stripping, which removes the `@blocking` it keys on). */
+    if (src_ufcs && cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@blocking")) {
+        char* rewritten = NULL;
+        size_t rewritten_len = 0;
+        if (CC_PASS_INT(cc__wrap_blocking_bodies, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len)) {
+            if (src_ufcs != src_all) free(src_ufcs);
+            src_ufcs = rewritten;
+            src_ufcs_len = rewritten_len;
+        }
+    }
+
     /* Lower @defer (and hard-error on cancel) using a syntax-driven pass.
        IMPORTANT: this must run BEFORE async lowering so `@defer` can be made suspend-safe. */
     if (src_ufcs && (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "@defer") ||
                      cc_contains_token_top_level(src_ufcs, src_ufcs_len, "cancel"))) {
         char* rewritten = NULL;
         size_t rewritten_len = 0;
-        int r = cc__rewrite_defer_syntax(ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
+        int r = CC_PASS_INT(cc__rewrite_defer_syntax, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
         if (r < 0) {
             fclose(out);
             if (src_ufcs != src_all) free(src_ufcs);
@@ -3622,7 +3783,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
 
         char* rewritten = NULL;
         size_t rewritten_len = 0;
-        int ar = cc_async_rewrite_state_machine_ast(root2, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
+        int ar = CC_PASS_INT(cc_async_rewrite_state_machine_ast, root2, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
         cc_tcc_bridge_free_ast(root2);
         if (ar < 0) {
             fclose(out);
@@ -3659,7 +3820,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
        the host compiler when the receiver type is one of the registered
        parser-safe UFCS families. */
     if (src_ufcs && ctx) {
-        char* rew = cc_rewrite_generic_family_ufcs_parser_safe(src_ufcs, src_ufcs_len);
+        char* rew = CC_PASS_TEXT(cc_rewrite_generic_family_ufcs_parser_safe, src_ufcs, src_ufcs_len);
         if (rew) {
             if (src_ufcs != src_all) free(src_ufcs);
             src_ufcs = rew;
@@ -3780,7 +3941,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         /* Lower `cc_channel_pair(&tx, &rx);` into `cc_channel_pair_create(...)` */
         {
             size_t rp_len = 0;
-            char* rp = cc__rewrite_channel_pair_calls_text(ctx, src_ufcs, src_ufcs_len, &rp_len);
+            char* rp = CC_PASS_TEXT(cc__rewrite_channel_pair_calls_text, ctx, src_ufcs, src_ufcs_len, &rp_len);
             if (!rp) {
                 fclose(out);
                 return EINVAL;
@@ -3793,7 +3954,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         if (cc_contains_token_top_level(src_ufcs, src_ufcs_len, "send_task") ||
             cc_contains_token_top_level(src_ufcs, src_ufcs_len, "cc_channel_send_task")) {
             size_t st_len = 0;
-            char* st = cc__rewrite_chan_send_task_text(ctx, src_ufcs, src_ufcs_len, &st_len);
+            char* st = CC_PASS_TEXT(cc__rewrite_chan_send_task_text, ctx, src_ufcs, src_ufcs_len, &st_len);
             if (st) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = st;
@@ -3802,7 +3963,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         }
         /* Final safety: ensure invalid surface syntax like `T[~ ... >]` does not reach the C compiler. */
         {
-            char* rew_string = cc_rewrite_string_templates_text(src_ufcs, src_ufcs_len, ctx->input_path);
+            char* rew_string = CC_PASS_TEXT(cc_rewrite_string_templates_text, src_ufcs, src_ufcs_len, ctx->input_path);
             if (rew_string == (char*)-1) {
                 fclose(out);
                 return EINVAL;
@@ -3814,7 +3975,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             }
         }
         {
-            char* rew_slice = cc__rewrite_slice_types_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew_slice = CC_PASS_TEXT(cc__rewrite_slice_types_text, ctx, src_ufcs, src_ufcs_len);
             if (!rew_slice) {
                 fclose(out);
                 return EINVAL;
@@ -3824,7 +3985,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             src_ufcs_len = strlen(src_ufcs);
         }
         {
-            char* rew = cc__rewrite_chan_handle_types_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew = CC_PASS_TEXT(cc__rewrite_chan_handle_types_text, ctx, src_ufcs, src_ufcs_len);
             if (!rew) {
             fclose(out);
                 return EINVAL;
@@ -3842,7 +4003,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         cc_result_spec_table_set_global(&cc__cg_result_specs);
         /* Rewrite T!>(E) -> CCResult_T_E and collect result type pairs */
         {
-            char* rew_res = cc__rewrite_result_types_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew_res = CC_PASS_TEXT(cc__rewrite_result_types_text, ctx, src_ufcs, src_ufcs_len);
             if (rew_res) {
             if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rew_res;
@@ -3856,7 +4017,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
            `res.value` / `res.error` -> `res.u.value` / `res.u.error`
            while keeping the compact union ABI in generated C. */
         {
-            char* rew_res_fields = cc__rewrite_result_field_sugar_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew_res_fields = CC_PASS_TEXT(cc__rewrite_result_field_sugar_text, ctx, src_ufcs, src_ufcs_len);
             if (rew_res_fields) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rew_res_fields;
@@ -3868,7 +4029,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
          * retired, no such insertion is needed. */
         /* Rewrite cc_ok(v) -> cc_ok_CCResult_T_E(v) based on enclosing function return type */
         {
-            char* rew_infer = cc__rewrite_inferred_result_constructors(src_ufcs, src_ufcs_len);
+            char* rew_infer = CC_PASS_TEXT(cc__rewrite_inferred_result_constructors, src_ufcs, src_ufcs_len);
             if (rew_infer) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rew_infer;
@@ -3882,7 +4043,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
              cc_contains_token_top_level(src_ufcs, src_ufcs_len, "!>"))) {
             char* ru_out = NULL;
             size_t ru_out_len = 0;
-            int ru_r = cc__rewrite_result_unwrap(ctx, src_ufcs, src_ufcs_len, &ru_out, &ru_out_len);
+            int ru_r = CC_PASS_INT(cc__rewrite_result_unwrap, ctx, src_ufcs, src_ufcs_len, &ru_out, &ru_out_len);
             if (ru_r < 0) {
                 fclose(out);
                 if (src_ufcs != src_all) free(src_ufcs);
@@ -3903,7 +4064,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
              cc_contains_token_top_level(src_ufcs, src_ufcs_len, "<?"))) {
             char* err_out = NULL;
             size_t err_out_len = 0;
-            int err_r = cc__rewrite_err_syntax(ctx, src_ufcs, src_ufcs_len, &err_out, &err_out_len);
+            int err_r = CC_PASS_INT(cc__rewrite_err_syntax, ctx, src_ufcs, src_ufcs_len, &err_out, &err_out_len);
             if (err_r < 0) {
                 fclose(out);
                 if (src_ufcs != src_all) free(src_ufcs);
@@ -3919,7 +4080,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         }
         /* Rewrite try expr -> cc_try(expr) */
         {
-            char* rew_try = cc__rewrite_try_exprs_text(ctx, src_ufcs, src_ufcs_len);
+            char* rew_try = CC_PASS_TEXT(cc__rewrite_try_exprs_text, ctx, src_ufcs, src_ufcs_len);
             if (rew_try) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rew_try;
@@ -3935,7 +4096,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
            before other text passes. */
         {
             size_t st_len = 0;
-            char* st = cc__rewrite_chan_send_task_text(ctx, src_ufcs, src_ufcs_len, &st_len);
+            char* st = CC_PASS_TEXT(cc__rewrite_chan_send_task_text, ctx, src_ufcs, src_ufcs_len, &st_len);
             if (st) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = st;
@@ -3950,7 +4111,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             cc_contains_token_top_level(src_ufcs, src_ufcs_len, "cancel")) {
             char* rewritten = NULL;
             size_t rewritten_len = 0;
-            int r = cc__rewrite_defer_syntax(ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
+            int r = CC_PASS_INT(cc__rewrite_defer_syntax, ctx, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len);
             if (r < 0) {
                 fclose(out);
                 if (src_ufcs != src_all) free(src_ufcs);
@@ -4004,7 +4165,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                         cc__collect_registered_ufcs_var_types(ctx->symbols, closure_defs, closure_defs_len);
                     }
                 }
-                rewritten = cc__rewrite_parser_placeholder_ufcs_lowers(closure_defs, closure_defs_len);
+                rewritten = CC_PASS_TEXT(cc__rewrite_parser_placeholder_ufcs_lowers, closure_defs, closure_defs_len);
                 if (temp_reg) {
                     cc_type_registry_set_global(saved_reg);
                     cc_type_registry_free(temp_reg);
@@ -4160,7 +4321,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         }
 
         {
-            char* rewritten = cc__rewrite_result_helper_family_to_visible_type(src_ufcs, src_ufcs_len);
+            char* rewritten = CC_PASS_TEXT(cc__rewrite_result_helper_family_to_visible_type, src_ufcs, src_ufcs_len);
             if (rewritten) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rewritten;
@@ -4174,7 +4335,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
            `__cc_vec_generic_*` / `__cc_map_generic_*` placeholders are
            no longer emitted into src_ufcs. */
         {
-            char* rewritten = cc__rewrite_string_helper_family_to_visible_type(src_ufcs, src_ufcs_len);
+            char* rewritten = CC_PASS_TEXT(cc__rewrite_string_helper_family_to_visible_type, src_ufcs, src_ufcs_len);
             if (rewritten) {
                 if (src_ufcs != src_all) free(src_ufcs);
                 src_ufcs = rewritten;
@@ -4423,7 +4584,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                     cc__collect_registered_ufcs_var_types(ctx->symbols, src_ufcs, src_ufcs_len);
                 }
             }
-            rewritten = cc__rewrite_parser_placeholder_ufcs_lowers(src_ufcs, src_ufcs_len);
+            rewritten = CC_PASS_TEXT(cc__rewrite_parser_placeholder_ufcs_lowers, src_ufcs, src_ufcs_len);
             if (temp_reg) {
                 cc_type_registry_set_global(saved_reg);
                 cc_type_registry_free(temp_reg);
@@ -4592,9 +4753,30 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
         }
         free(container_decl_buf);
         container_decl_buf = NULL;
-        
+
+        /* Preemption safe points at loop back-edges (`ccc --preempt-points`).
+           Runs on the final TU text here and again on closure_defs below,
+           which are written separately: loops in spawned lambdas live there. */
+        const char* preempt_env = getenv("CC_PREEMPT_POINTS");
+        int preempt_points = preempt_env && preempt_env[0] && preempt_env[0] != '0';
+        if (preempt_points) {
+            char* rewritten = NULL;
+            size_t rewritten_len = 0;
+            if (CC_PASS_INT(cc__insert_preempt_points, src_ufcs, src_ufcs_len, &rewritten, &rewritten_len)) {
+                if (src_ufcs != src_all) free(src_ufcs);
+                src_ufcs = rewritten;
+                src_ufcs_len = rewritten_len;
+            }
+        }
+
         fwrite(src_ufcs, 1, src_ufcs_len, out);
         if (src_ufcs_len == 0 || src_ufcs[src_ufcs_len - 1] != '\n') fputc('\n', out);
+        if (preempt_points) {
+            /* Tell the scheduler at load time that this TU polls, so sysmon
+               asks before evicting (see cc__preempt_points_register). */
+            fputs("static void __attribute__((constructor)) cc__preempt_points_tu(void) "
+                  "{ cc__preempt_points_register(); }\n", out);
+        }
 
         if (closure_defs && closure_defs_len > 0) {
             /* Run @defer lowering on closure definitions too (handles @defer inside spawn closures) */
@@ -4614,7 +4796,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
             if (cc_contains_token_top_level(closure_defs, closure_defs_len, "send_task") ||
                 cc_contains_token_top_level(closure_defs, closure_defs_len, "cc_channel_send_task")) {
                 size_t rewritten_len = 0;
-                char* rewritten = cc__rewrite_chan_send_task_text(ctx, closure_defs, closure_defs_len, &rewritten_len);
+                char* rewritten = CC_PASS_TEXT(cc__rewrite_chan_send_task_text, ctx, closure_defs, closure_defs_len, &rewritten_len);
                 if (rewritten) {
                     free(closure_defs);
                     closure_defs = rewritten;
@@ -4631,7 +4813,7 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                         cc__collect_registered_ufcs_var_types(ctx->symbols, closure_defs, closure_defs_len);
                     }
                 }
-                rewritten = cc__rewrite_parser_placeholder_ufcs_lowers(closure_defs, closure_defs_len);
+                rewritten = CC_PASS_TEXT(cc__rewrite_parser_placeholder_ufcs_lowers, closure_defs, closure_defs_len);
                 if (temp_reg) {
                     cc_type_registry_set_global(saved_reg);
                     cc_type_registry_free(temp_reg);
@@ -4642,6 +4824,15 @@ int cc_visit_codegen(const CCASTRoot* root, CCVisitorCtx* ctx, const char* outpu
                     closure_defs_len = strlen(rewritten);
                 }
             }
+            if (preempt_points) {
+                char* rewritten = NULL;
+                size_t rewritten_len = 0;
+                if (CC_PASS_INT(cc__insert_preempt_points, closure_defs, closure_defs_len, &rewritten, &rewritten_len)) {
+                    free(closure_defs);
+                    closure_defs = rewritten;
+                    closure_defs_len = rewritten_len;
+                }
+            }
             
             /* Emit closure declarations/definitions at end-of-file so all user
                types are already in scope and exact signatures are valid. */
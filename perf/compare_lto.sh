@@ -0,0 +1,33 @@
+#!/bin/bash
+# compare_lto.sh - --release vs --release --lto on the channel and spawn hot paths
+#
+# Builds each benchmark twice and prints both runs' summary lines. Under
+# --lto the runtime is rebuilt with -flto and linked together with the user
+# TU, so the branded fast paths of cc_chan_send/recv/try_* and
+# cc_nursery_spawn can inline into the benchmark loops.
+
+set -e
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+REPO_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+CCC="$REPO_ROOT/out/cc/bin/ccc"
+OUT="$SCRIPT_DIR/out/lto"
+
+mkdir -p "$OUT"
+
+BENCHES=(perf_buffered_base perf_spawn_ladder)
+
+for b in "${BENCHES[@]}"; do
+    "$CCC" build --release "$SCRIPT_DIR/$b.ccs" -o "$OUT/${b}_release" >/dev/null
+    "$CCC" build --release --lto "$SCRIPT_DIR/$b.ccs" -o "$OUT/${b}_lto" >/dev/null
+done
+
+for b in "${BENCHES[@]}"; do
+    echo "================================================================="
+    echo "$b"
+    echo "================================================================="
+    for flavor in release lto; do
+        echo "--- $flavor"
+        "$OUT/${b}_$flavor" | grep -E "median|spawns/sec|vs " || true
+    done
+    echo ""
+done
@@ -27,7 +27,9 @@ echo ""
 # 1. Build implementations
 echo "Building tests..."
 mkdir -p "$STRESS_DIR/out" "$SCRIPT_DIR/out"
-$CCC build --release "$STRESS_DIR/noisy_neighbor.ccs" -o "$STRESS_DIR/out/noisy_neighbor"
+# --preempt-points lets sysmon time-slice the hogs on the 4 workers rather
+# than evicting workers and growing the thread count (see Peak threads).
+$CCC build --release --preempt-points "$STRESS_DIR/noisy_neighbor.ccs" -o "$STRESS_DIR/out/noisy_neighbor"
 gcc -O2 "$STRESS_DIR/pthread_noisy_baseline.c" -o "$STRESS_DIR/out/pthread_noisy_baseline" -lpthread
 if command -v zig &>/dev/null; then
     zig build-exe "$SCRIPT_DIR/zig/noisy_neighbor.zig" -O ReleaseFast -lc \
@@ -0,0 +1,110 @@
+#!/bin/bash
+# compile_time_corpus.sh - Compile-time regression corpus for the ccc lowering pipeline
+#
+# Lowers a fixed corpus to C with --emit-c-only --time-passes and reports, per
+# translation unit, the median wall time across RUNS and the three most
+# expensive passes of the last run:
+#   - real_projects/redis/redis_idiomatic.ccs, redis_cc/redis_cc.ccs
+#   - real_projects/pigz/pigz_idiomatic.ccs, pigz_cc/pigz_cc.ccs
+#   - synthetic TUs generated below: many small functions using closures,
+#     UFCS, channels and @defer, at SYNTH_SIZES function counts
+# The synthetic TUs scale with the number of rewrite sites, so a pass that
+# goes quadratic (or starts reparsing per site) shows up as a ratio that
+# grows with size. TRACE=1 also writes a Chrome trace (chrome://tracing,
+# ui.perfetto.dev) of every pass to perf/out/compile_time_trace.json.
+
+set -e
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+REPO_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+CCC="$REPO_ROOT/out/cc/bin/ccc"
+RUNS=${RUNS:-3}
+SYNTH_SIZES=${SYNTH_SIZES:-"250 1000 4000"}
+OUT="$SCRIPT_DIR/out/compile_time"
+
+mkdir -p "$OUT"
+
+# synth N: a TU with N functions, each exercising the heavier rewrites.
+synth() {
+    local n=$1 f="$OUT/synth_$1.ccs"
+    {
+        echo '#include <ccc/cc_runtime.cch>'
+        echo '#include <stdio.h>'
+        echo ''
+        echo 'struct Box { int v; };'
+        echo 'static inline int Box_get(struct Box* b) { return b->v; }'
+        echo 'static inline void Box_add(struct Box* b, int d) { b->v += d; }'
+        echo ''
+        for i in $(seq "$n"); do
+            cat <<EOF
+static int synth_fn_$i(int x) {
+    struct Box b = { x };
+    b.add($i);
+    int[~4 >] tx;
+    int[~4 <] rx;
+    cc_channel_pair(&tx, &rx);
+    @defer chan_free(rx);
+    int v = b.get();
+    @nursery closing(tx) {
+        spawn(() => {
+            (void)chan_send(tx, v);
+        });
+    }
+    int got = 0;
+    (void)chan_recv(rx, &got);
+    return got;
+}
+
+EOF
+        done
+        echo 'int main(void) {'
+        echo '    long sum = 0;'
+        for i in $(seq "$n"); do
+            echo "    sum += synth_fn_$i($i);"
+        done
+        echo '    printf("%ld\n", sum);'
+        echo '    return 0;'
+        echo '}'
+    } > "$f"
+    echo "$f"
+}
+
+CORPUS=(
+    "$REPO_ROOT/real_projects/redis/redis_idiomatic.ccs"
+    "$REPO_ROOT/real_projects/redis/redis_cc/redis_cc.ccs"
+    "$REPO_ROOT/real_projects/pigz/pigz_idiomatic.ccs"
+    "$REPO_ROOT/real_projects/pigz/pigz_cc/pigz_cc.ccs"
+)
+for n in $SYNTH_SIZES; do
+    CORPUS+=("$(synth "$n")")
+done
+
+# --trace-passes starts a fresh trace; later invocations append to it
+# through CC_TRACE_PASSES, which is what the flag sets for child processes.
+TRACE_FILE="$SCRIPT_DIR/out/compile_time_trace.json"
+TRACE_ARGS=()
+[ "${TRACE:-0}" = "1" ] && TRACE_ARGS=(--trace-passes "$TRACE_FILE")
+
+echo "ccc: $CCC, runs per TU: $RUNS"
+echo ""
+printf "%-28s %10s   %s\n" "TU" "median ms" "top passes (inclusive ms)"
+printf "%-28s %10s   %s\n" "--" "---------" "-------------------------"
+
+for src in "${CORPUS[@]}"; do
+    stem=$(basename "$src" .ccs)
+    log="$OUT/$stem.passes"
+    : > "$OUT/$stem.times"
+    for _ in $(seq "$RUNS"); do
+        "$CCC" --emit-c-only --no-cache --time-passes "${TRACE_ARGS[@]}" \
+            "$src" -o "$OUT/$stem.c" >/dev/null 2>"$log"
+        if [ "${TRACE:-0}" = "1" ]; then
+            TRACE_ARGS=()
+            export CC_TRACE_PASSES="$TRACE_FILE"
+        fi
+        # "=== pass timings: <tu> (<ms> ms, <n> reparses) ===" heads the table.
+        sed -n 's/^=== pass timings: .* (\([0-9.]*\) ms,.*/\1/p' "$log" | head -1 >> "$OUT/$stem.times"
+    done
+    median=$(sort -n "$OUT/$stem.times" | awk '{v[NR]=$1} END {print v[int((NR+1)/2)]}')
+    top=$(awk '$1 ~ /^[0-9.]+$/ {print $1, $NF}' "$log" \
+        | sort -rn | head -3 | awk '{printf "%s %s  ", $2, $1}')
+    printf "%-28s %10s   %s\n" "$stem" "$median" "$top"
+done
@@ -0,0 +1,91 @@
+/* CCBufReader / CCBufWriter over a tiny (16-byte) buffer so every edge case
+ * is cheap to hit:
+ *   - lines that fit come back as views into the reader's buffer, including
+ *     one that straddles a refill;
+ *   - a line longer than the buffer is copied out, intact;
+ *   - the final line has no trailing newline;
+ *   - a custom delimiter and the owned-copy reader;
+ *   - cc_file_read_line() returns the same lines, short ones included. */
+
+#include <ccc/std/prelude.cch>
+#include <stdio.h>
+#include <string.h>
+
+#define CAP 16
+
+static const char* k_lines[] = {
+    "alpha\n",
+    "bravo-charlie\n",                           /* straddles the first refill */
+    "this line is much longer than sixteen bytes\n",
+    "x\n",
+    "tail-no-newline",
+};
+
+static int slice_eq(CCSlice s, const char* want) {
+    return s.len == strlen(want) && memcmp(s.ptr, want, s.len) == 0;
+}
+
+int main(void) {
+    const char* path = "/tmp/cc_buf_reader_smoke.txt";
+    CCArena arena = cc_arena_heap(kilobytes(16));
+    if (!arena.base) return 1;
+    size_t nlines = sizeof(k_lines) / sizeof(k_lines[0]);
+
+    CCFile f;
+    if (cc_file_open(&f, path, "w+") != 0) return 2;
+    CCBufWriter w;
+    if (cc_buf_writer_init(&w, &f, &arena, CAP) != 0) return 3;
+    for (size_t i = 0; i < nlines; ++i) {
+        CCResult_size_t_CCIoError wr = cc_buf_writer_write(&w, cc_slice_from_buffer((void*)k_lines[i], strlen(k_lines[i])));
+        if (!wr.ok) return 4;
+    }
+    if (!cc_buf_writer_flush(&w).ok || w.len != 0) return 5;
+
+    /* Views. */
+    cc_file_seek(&f, 0, SEEK_SET);
+    CCBufReader r;
+    if (cc_buf_reader_init(&r, &f, &arena, CAP) != 0) return 6;
+    for (size_t i = 0; i < nlines; ++i) {
+        CCResult_CCSlice_CCIoError res = cc_buf_reader_read_line_view(&r, &arena);
+        if (!res.ok || !slice_eq(res.u.value, k_lines[i])) return 10 + (int)i;
+        const char* p = (const char*)res.u.value.ptr;
+        int in_buf = p >= r.buf && p < r.buf + r.cap;
+        if (in_buf != (strlen(k_lines[i]) <= CAP)) return 20 + (int)i;
+    }
+    CCResult_CCSlice_CCIoError end = cc_buf_reader_read_line_view(&r, &arena);
+    if (!end.ok || end.u.value.len != 0) return 30;
+
+    /* Custom delimiter, owned copies that survive further reads. */
+    cc_file_seek(&f, 0, SEEK_SET);
+    if (cc_buf_reader_init(&r, &f, &arena, CAP) != 0) return 31;
+    CCResult_CCSlice_CCIoError a = cc_buf_reader_read_until(&r, '-', &arena);
+    CCResult_CCSlice_CCIoError b = cc_buf_reader_read_until(&r, '-', &arena);
+    if (!a.ok || !b.ok) return 32;
+    if (!slice_eq(a.u.value, "alpha\nbravo-") || !slice_eq(b.u.value, "charlie\nthis line is much longer than sixteen bytes\nx\ntail-")) return 33;
+
+    /* cc_buf_reader_next hands out buffered bytes before reading more. */
+    char rest[64];
+    size_t rest_len = 0;
+    for (;;) {
+        CCResult_CCSlice_CCIoError chunk = cc_buf_reader_next(&r, sizeof(rest) - rest_len);
+        if (!chunk.ok) return 34;
+        if (chunk.u.value.len == 0) break;
+        memcpy(rest + rest_len, chunk.u.value.ptr, chunk.u.value.len);
+        rest_len += chunk.u.value.len;
+    }
+    if (!slice_eq(cc_slice_from_buffer(rest, rest_len), "no-newline")) return 35;
+
+    /* Unbuffered line reader agrees. */
+    cc_file_seek(&f, 0, SEEK_SET);
+    for (size_t i = 0; i < nlines; ++i) {
+        CCSlice line;
+        CCResult_bool_CCIoError res = cc_file_read_line_into(&f, &arena, &line);
+        if (!res.ok || !res.u.value || !slice_eq(line, k_lines[i])) return 40 + (int)i;
+    }
+
+    cc_file_close(&f);
+    cc_arena_free(&arena);
+    remove(path);
+    printf("buf reader ok\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+/* Broadcast (1:N) channels: every subscription sees every value.
+ *
+ *   - SUBSCRIBERS fibers each receive all ITEMS, in order, from one BLOCK-policy
+ *     publisher whose ring is much smaller than ITEMS (so the publisher must
+ *     park on the slowest subscriber), then observe EPIPE after close.
+ *   - LAG_ERROR: a subscriber that falls a full ring behind gets EOVERFLOW
+ *     once, then resumes at the oldest retained value.
+ *   - DROP_NEW: send returns EAGAIN while a subscriber is a ring behind.
+ *   - Closing a subscription detaches it instead of blocking the publisher. */
+
+#include <ccc/std/prelude.cch>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#define SUBSCRIBERS 16
+#define ITEMS 2000
+
+static _Atomic int g_ok = 0;
+
+static void* subscriber_fiber(void* arg) {
+    CCChan* sub = (CCChan*)arg;
+    int expect = 0, v = 0, rc;
+    while ((rc = cc_chan_recv(sub, &v, sizeof(v))) == 0) {
+        if (v != expect) {
+            fprintf(stderr, "subscriber %p: got %d want %d\n", (void*)sub, v, expect);
+            return NULL;
+        }
+        expect++;
+    }
+    if (rc == EPIPE && expect == ITEMS) atomic_fetch_add(&g_ok, 1);
+    return NULL;
+}
+
+static void* publisher_fiber(void* arg) {
+    CCChan* ch = (CCChan*)arg;
+    for (int i = 0; i < ITEMS; ++i) {
+        if (cc_chan_send(ch, &i, sizeof(i)) != 0) return NULL;
+    }
+    cc_chan_close(ch);
+    return NULL;
+}
+
+static CCChan* make_bcast(size_t cap, CCChanMode mode) {
+    CCChanTx tx;
+    CCChanRx rx;
+    if (cc_chan_pair_create_full(cap, mode, false, sizeof(int), false, CC_CHAN_TOPO_1_N, &tx, &rx) != 0) return NULL;
+    return tx.raw;
+}
+
+int main(void) {
+    /* Fan-out under BLOCK backpressure. */
+    CCChan* ch = make_bcast(8, CC_CHAN_MODE_BLOCK);
+    if (!ch || cc_chan_broadcast_set_policy(ch, CC_CHAN_BCAST_BLOCK) != 0) return 1;
+    CCChan* subs[SUBSCRIBERS];
+    for (int i = 0; i < SUBSCRIBERS; ++i) {
+        subs[i] = cc_chan_subscribe(ch);
+        if (!subs[i]) return 2;
+    }
+    int probe = 0;
+    if (cc_chan_send(subs[0], &probe, sizeof(probe)) != EINVAL) return 3;  /* receive-only */
+    CCNursery* n = cc_nursery_create(NULL);
+    if (!n) return 4;
+    for (int i = 0; i < SUBSCRIBERS; ++i) cc_nursery_spawn(n, subscriber_fiber, subs[i]);
+    cc_nursery_spawn(n, publisher_fiber, ch);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    if (atomic_load(&g_ok) != SUBSCRIBERS) {
+        fprintf(stderr, "fan-out: %d/%d subscribers saw every item\n", atomic_load(&g_ok), SUBSCRIBERS);
+        return 5;
+    }
+    for (int i = 0; i < SUBSCRIBERS; ++i) cc_chan_free(subs[i]);
+    cc_chan_free(ch);
+
+    /* LAG_ERROR: overwrite, then report the gap once. */
+    ch = make_bcast(4, CC_CHAN_MODE_BLOCK);
+    CCChan* slow = cc_chan_subscribe(ch);
+    if (!slow || cc_chan_broadcast_set_policy(ch, CC_CHAN_BCAST_LAG_ERROR) != 0) return 6;
+    for (int i = 0; i < 10; ++i) {
+        if (cc_chan_try_send(ch, &i, sizeof(i)) != 0) return 7;
+    }
+    int v = -1;
+    if (cc_chan_try_recv(slow, &v, sizeof(v)) != EOVERFLOW || cc_chan_broadcast_lagged(slow) != 6) return 8;
+    if (cc_chan_try_recv(slow, &v, sizeof(v)) != 0 || v != 6) return 9;
+    cc_chan_free(slow);
+    cc_chan_free(ch);
+
+    /* DROP_NEW: the publisher is refused while a subscriber is a ring behind;
+     * closing (detaching) that subscriber frees the publisher. */
+    ch = make_bcast(2, CC_CHAN_MODE_DROP_NEW);
+    slow = cc_chan_subscribe(ch);
+    for (int i = 0; i < 2; ++i) {
+        if (cc_chan_send(ch, &i, sizeof(i)) != 0) return 10;
+    }
+    v = 2;
+    if (cc_chan_send(ch, &v, sizeof(v)) != EAGAIN) return 11;
+    if (cc_chan_try_recv(slow, &v, sizeof(v)) != 0 || v != 0) return 12;
+    v = 2;
+    if (cc_chan_send(ch, &v, sizeof(v)) != 0) return 13;
+    cc_chan_close(slow);
+    if (cc_chan_try_recv(slow, &v, sizeof(v)) != EPIPE) return 14;
+    for (int i = 3; i < 8; ++i) {
+        if (cc_chan_send(ch, &i, sizeof(i)) != 0) return 15;
+    }
+    cc_chan_free(slow);
+    cc_chan_free(ch);
+
+    printf("chan broadcast ok\n");
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* Compiler-internal smoke test for the closure-call collector:
+ *
+ *   - cc__collect_closure_calls_edits records edits against the source
+ *     (callee + `(`, a 2-ary call's comma, the closing `)`) whose result
+ *     matches the whole-file cc__rewrite_all_closure_calls_with_nodes,
+ *     including a closure call nested in another's arguments.
+ *   - No edit covers argument text: an edit another pass makes inside the
+ *     arguments merges without a conflict.
+ *
+ * Built with -Icc/src (see closure_calls_edits_smoke.cflags). The stub AST
+ * is built by hand in the layout the patched TCC emits.
+ */
+#include "ir/ir.c"
+#include "visitor/edit_buffer.c"
+#include "visitor/pass_closure_calls.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int g_failed = 0;
+
+#define CHECK(cond, msg)                         \
+    do {                                         \
+        if (!(cond)) {                           \
+            printf("FAIL: %s\n", msg);           \
+            g_failed = 1;                        \
+        }                                        \
+    } while (0)
+
+static const char* k_src =
+    "CCClosure1 f;\n"
+    "CCClosure2 g;\n"
+    "int main(void) {\n"
+    "    int r = f(g(1, v.len()));\n"
+    "    return g(r, 2);\n"
+    "}\n";
+
+static CCNodeView k_nodes[] = {
+    {CC_AST_NODE_CALL, -1, "t.ccs", 4, 4, 13, 28, 0, 0, "f", "CCClosure1"},
+    {CC_AST_NODE_CALL, -1, "t.ccs", 4, 4, 15, 27, 0, 0, "g", "CCClosure2"},
+    {CC_AST_NODE_CALL, -1, "t.ccs", 5, 5, 12, 18, 0, 0, "g", "CCClosure2"},
+};
+
+int main(void) {
+    CCASTRoot root;
+    memset(&root, 0, sizeof(root));
+    root.nodes = (const struct CCASTStubNode*)k_nodes;
+    root.node_count = (int)(sizeof(k_nodes) / sizeof(k_nodes[0]));
+    CCVisitorCtx ctx = {NULL, "t.ccs"};
+    size_t len = strlen(k_src);
+
+    char* whole = NULL;
+    size_t whole_len = 0;
+    CHECK(cc__rewrite_all_closure_calls_with_nodes(&root, &ctx, k_src, len, &whole, &whole_len) == 1,
+          "whole-file rewrite runs");
+    CHECK(whole && strstr(whole, "cc_closure1_call(f, (intptr_t)(cc_closure2_call(g, (intptr_t)(1), (intptr_t)( v.len()))))"),
+          "whole-file rewrite lowers the nested calls");
+
+    CCEditBuffer eb;
+    cc_edit_buffer_init(&eb, k_src, len);
+    CHECK(cc__collect_closure_calls_edits(&root, &ctx, &eb) == 8, "one 1-ary and two 2-ary calls give eight edits");
+    size_t out_len = 0;
+    char* out = cc_edit_buffer_apply(&eb, &out_len);
+    CHECK(out && whole && out_len == whole_len && memcmp(out, whole, out_len) == 0,
+          "edits reproduce the whole-file rewrite");
+    free(out);
+
+    /* Another pass rewriting `v.len()` inside the arguments. */
+    const char* recv = strstr(k_src, "v.len()");
+    size_t at = (size_t)(recv - k_src);
+    CHECK(cc_edit_buffer_add(&eb, at, at + 7, "Vec_len(&v)", 100, "ufcs") == 0, "add argument edit");
+    CHECK(cc_edit_buffer_has_conflicts(&eb) == 0, "argument edit does not conflict");
+    out = cc_edit_buffer_apply(&eb, &out_len);
+    CHECK(out && strstr(out, "(intptr_t)( Vec_len(&v))))"), "argument edit merges inside the call");
+    free(out);
+    cc_edit_buffer_free(&eb);
+    free(whole);
+
+    if (g_failed) return 1;
+    printf("closure_calls_edits_smoke: OK\n");
+    return 0;
+}
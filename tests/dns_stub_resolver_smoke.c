@@ -0,0 +1,302 @@
+/* Built-in DNS stub resolver against a local stub DNS server fixture.
+ *
+ * The fixture thread serves UDP and TCP on one loopback port:
+ *   svc.cc.test  A 10.0.0.7 / AAAA fd00::7, TTL 1s, answered after 50ms so
+ *                concurrent fiber lookups overlap and must coalesce
+ *   nx.cc.test   NXDOMAIN with an SOA (negative TTL 60s)
+ *   big.cc.test  truncated over UDP, A 10.0.0.8 over TCP
+ *   alias.cc.test  CNAME real.cc.test, A 10.0.0.9 for real.cc.test, plus an
+ *                  A 10.0.0.66 for evil.cc.test that must be ignored
+ *   spoof.cc.test  only an A 10.0.0.66 owned by evil.cc.test (no answer)
+ * and counts every question it sees, so the test can assert exactly how many
+ * queries the coalescing and TTL cache let through. */
+
+#include <ccc/std/prelude.cch>
+#include <ccc/std/dns.cch>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define LOOKUP_FIBERS 16
+
+static int g_udp_fd = -1;
+static int g_tcp_fd = -1;
+static int g_port = 0;
+static _Atomic int g_stop = 0;
+static _Atomic int g_svc_a = 0;
+static _Atomic int g_svc_aaaa = 0;
+static _Atomic int g_nx_a = 0;
+static _Atomic int g_big_udp = 0;
+static _Atomic int g_big_tcp = 0;
+static _Atomic int g_total = 0;
+static _Atomic int g_fiber_ok = 0;
+
+/* Encode a dotted name as labels; returns its length with the root byte. */
+static size_t put_name(uint8_t* p, const char* name) {
+    size_t n = 0;
+    while (*name) {
+        const char* dot = strchr(name, '.');
+        size_t l = dot ? (size_t)(dot - name) : strlen(name);
+        p[n++] = (uint8_t)l;
+        memcpy(p + n, name, l);
+        n += l;
+        name += l + (dot ? 1 : 0);
+    }
+    p[n++] = 0;
+    return n;
+}
+
+/* Append one IN record; a NULL owner points back at the question name. */
+static size_t put_rr(uint8_t* p, const char* owner, uint16_t type, uint32_t ttl,
+                     const void* rdata, uint16_t rdlen) {
+    size_t n = 2;
+    if (owner) {
+        n = put_name(p, owner);
+    } else {
+        p[0] = 0xC0; p[1] = 0x0C;
+    }
+    p += n;
+    p[0] = (uint8_t)(type >> 8); p[1] = (uint8_t)type;
+    p[2] = 0; p[3] = 1;
+    p[4] = (uint8_t)(ttl >> 24); p[5] = (uint8_t)(ttl >> 16); p[6] = (uint8_t)(ttl >> 8); p[7] = (uint8_t)ttl;
+    p[8] = (uint8_t)(rdlen >> 8); p[9] = (uint8_t)rdlen;
+    memcpy(p + 10, rdata, rdlen);
+    return n + 10 + rdlen;
+}
+
+/* Build the reply for query q (qlen bytes) into out; returns its length. */
+static size_t answer(const uint8_t* q, size_t qlen, int over_tcp, uint8_t* out) {
+    char name[256];
+    size_t off = 12, n = 0;
+    while (off < qlen && q[off]) {
+        uint8_t l = q[off++];
+        if (n) name[n++] = '.';
+        memcpy(name + n, q + off, l);
+        n += l;
+        off += l;
+    }
+    name[n] = '\0';
+    off++;
+    uint16_t qtype = (uint16_t)((q[off] << 8) | q[off + 1]);
+    size_t qend = off + 4;
+
+    memcpy(out, q, qend);
+    out[2] = 0x81;  /* QR | RD */
+    out[3] = 0x80;  /* RA, NOERROR */
+    memset(out + 6, 0, 6);
+    size_t len = qend;
+    atomic_fetch_add(&g_total, 1);
+
+    if (strcmp(name, "svc.cc.test") == 0) {
+        usleep(50000);
+        if (qtype == 1) {
+            static const uint8_t v4[4] = {10, 0, 0, 7};
+            atomic_fetch_add(&g_svc_a, 1);
+            len += put_rr(out + len, NULL, 1, 1, v4, 4);
+            out[7] = 1;
+        } else if (qtype == 28) {
+            uint8_t v6[16] = {0xfd, 0};
+            v6[15] = 7;
+            atomic_fetch_add(&g_svc_aaaa, 1);
+            len += put_rr(out + len, NULL, 28, 1, v6, 16);
+            out[7] = 1;
+        }
+    } else if (strcmp(name, "alias.cc.test") == 0 || strcmp(name, "spoof.cc.test") == 0) {
+        static const uint8_t real[4] = {10, 0, 0, 9};
+        static const uint8_t evil[4] = {10, 0, 0, 66};
+        if (qtype == 1) {
+            if (name[0] == 'a') {
+                /* Out of order: the chain walk must not depend on it. */
+                uint8_t target[64];
+                size_t tlen = put_name(target, "real.cc.test");
+                len += put_rr(out + len, "real.cc.test", 1, 300, real, 4);
+                len += put_rr(out + len, NULL, 5, 300, target, (uint16_t)tlen);
+                out[7] = 2;
+            }
+            len += put_rr(out + len, "evil.cc.test", 1, 300, evil, 4);
+            out[7]++;
+        }
+    } else if (strcmp(name, "big.cc.test") == 0) {
+        if (!over_tcp) {
+            atomic_fetch_add(&g_big_udp, 1);
+            out[2] |= 0x02;  /* TC */
+        } else if (qtype == 1) {
+            static const uint8_t v4[4] = {10, 0, 0, 8};
+            atomic_fetch_add(&g_big_tcp, 1);
+            len += put_rr(out + len, NULL, 1, 300, v4, 4);
+            out[7] = 1;
+        }
+    } else {
+        uint8_t soa[22] = {0, 0};  /* mname=".", rname=".", then 5 u32s */
+        soa[21] = 60;              /* minimum = 60s */
+        if (strcmp(name, "nx.cc.test") == 0 && qtype == 1) atomic_fetch_add(&g_nx_a, 1);
+        out[3] = 0x83;  /* NXDOMAIN */
+        len += put_rr(out + len, NULL, 6, 60, soa, sizeof(soa));
+        out[9] = 1;     /* NSCOUNT */
+    }
+    return len;
+}
+
+static void* dns_fixture(void* arg) {
+    (void)arg;
+    uint8_t q[512], out[1024];
+    while (!atomic_load(&g_stop)) {
+        struct pollfd pfd[2] = {{g_udp_fd, POLLIN, 0}, {g_tcp_fd, POLLIN, 0}};
+        if (poll(pfd, 2, 20) <= 0) continue;
+        if (pfd[0].revents & POLLIN) {
+            struct sockaddr_storage from;
+            socklen_t from_len = sizeof(from);
+            ssize_t n = recvfrom(g_udp_fd, q, sizeof(q), 0, (struct sockaddr*)&from, &from_len);
+            if (n >= 12) {
+                size_t len = answer(q, (size_t)n, 0, out);
+                sendto(g_udp_fd, out, len, 0, (struct sockaddr*)&from, from_len);
+            }
+        }
+        if (pfd[1].revents & POLLIN) {
+            int c = accept(g_tcp_fd, NULL, NULL);
+            if (c < 0) continue;
+            uint8_t hdr[2];
+            if (recv(c, hdr, 2, MSG_WAITALL) == 2) {
+                size_t qlen = (size_t)((hdr[0] << 8) | hdr[1]);
+                if (qlen <= sizeof(q) && recv(c, q, qlen, MSG_WAITALL) == (ssize_t)qlen) {
+                    size_t len = answer(q, qlen, 1, out + 2);
+                    out[0] = (uint8_t)(len >> 8);
+                    out[1] = (uint8_t)len;
+                    send(c, out, len + 2, 0);
+                }
+            }
+            close(c);
+        }
+    }
+    return NULL;
+}
+
+static int start_fixture(pthread_t* t) {
+    for (int tries = 0; tries < 20; ++tries) {
+        struct sockaddr_in sa = {0};
+        sa.sin_family = AF_INET;
+        sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        g_udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        socklen_t sl = sizeof(sa);
+        if (bind(g_udp_fd, (struct sockaddr*)&sa, sizeof(sa)) != 0 ||
+            getsockname(g_udp_fd, (struct sockaddr*)&sa, &sl) != 0) return -1;
+        g_tcp_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(g_tcp_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(g_tcp_fd, (struct sockaddr*)&sa, sizeof(sa)) == 0 && listen(g_tcp_fd, 16) == 0) {
+            g_port = ntohs(sa.sin_port);
+            return pthread_create(t, NULL, dns_fixture, NULL);
+        }
+        close(g_udp_fd);
+        close(g_tcp_fd);
+    }
+    return -1;
+}
+
+static int has_v4(CCSlice s, uint8_t last) {
+    const CCIpAddr* a = (const CCIpAddr*)s.ptr;
+    for (size_t i = 0; i < s.len; ++i) {
+        if (a[i].family == 4 && a[i].addr.v4[0] == 10 && a[i].addr.v4[3] == last) return 1;
+    }
+    return 0;
+}
+
+static void* lookup_fiber(void* arg) {
+    (void)arg;
+    CCArena a = cc_arena_heap(kilobytes(1));
+    CCNetError err = CC_NET_OK;
+    CCSlice r = cc_dns_lookup(&a, "svc.cc.test", 11, &err);
+    if (err == CC_NET_OK && r.len == 2 && has_v4(r, 7)) atomic_fetch_add(&g_fiber_ok, 1);
+    cc_arena_free(&a);
+    return NULL;
+}
+
+int main(void) {
+    pthread_t fixture;
+    if (start_fixture(&fixture) != 0) return 1;
+
+    const char* hosts_path = "/tmp/cc_dns_smoke_hosts";
+    const char* conf_path = "/tmp/cc_dns_smoke_resolv.conf";
+    FILE* f = fopen(hosts_path, "w");
+    if (!f) return 2;
+    fputs("10.9.8.7 hosted.cc.test hosted\n", f);
+    fclose(f);
+    f = fopen(conf_path, "w");
+    if (!f) return 3;
+    fputs("search cc.test\noptions ndots:1 timeout:1 attempts:2\n", f);
+    fclose(f);
+    char servers[64];
+    snprintf(servers, sizeof(servers), "127.0.0.1:%d", g_port);
+    setenv("CC_DNS_NAMESERVERS", servers, 1);
+    setenv("CC_DNS_HOSTS", hosts_path, 1);
+    setenv("CC_DNS_RESOLV_CONF", conf_path, 1);
+    cc_dns_reload_config();
+
+    /* Concurrent fiber lookups coalesce onto one A + one AAAA query. */
+    CCNursery* n = cc_nursery_create(NULL);
+    if (!n) return 4;
+    for (int i = 0; i < LOOKUP_FIBERS; ++i) cc_nursery_spawn(n, lookup_fiber, NULL);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    if (atomic_load(&g_fiber_ok) != LOOKUP_FIBERS) return 5;
+    if (atomic_load(&g_svc_a) != 1 || atomic_load(&g_svc_aaaa) != 1) return 6;
+
+    CCArena a = cc_arena_heap(kilobytes(4));
+    CCNetError err = CC_NET_OK;
+
+    /* Positive cache hit from a plain thread; names are case-insensitive and
+     * a trailing dot is the same name. */
+    CCSlice r = cc_dns_lookup(&a, "SVC.cc.test.", 12, &err);
+    if (err != CC_NET_OK || r.len != 2 || !has_v4(r, 7) || atomic_load(&g_svc_a) != 1) return 7;
+
+    /* Negative answers are cached for the SOA TTL. */
+    r = cc_dns_lookup(&a, "nx.cc.test", 10, &err);
+    if (err != CC_NET_DNS_FAILURE || r.len != 0) return 8;
+    r = cc_dns_lookup(&a, "nx.cc.test", 10, &err);
+    if (err != CC_NET_DNS_FAILURE || atomic_load(&g_nx_a) != 1) return 9;
+
+    /* hosts entries never reach the network; short names use the search list. */
+    int before = atomic_load(&g_total);
+    r = cc_dns_lookup(&a, "hosted", 6, &err);
+    if (err != CC_NET_OK || r.len != 1 || !has_v4(r, 7) || atomic_load(&g_total) != before) return 10;
+    r = cc_dns_lookup_family(&a, "svc", 3, CC_DNS_IPV4, &err);
+    if (err != CC_NET_OK || !has_v4(r, 7)) return 11;
+
+    /* Truncated UDP answers are retried over TCP. */
+    r = cc_dns_lookup_family(&a, "big.cc.test", 11, CC_DNS_IPV4, &err);
+    if (err != CC_NET_OK || !has_v4(r, 8) || atomic_load(&g_big_udp) != 1 || atomic_load(&g_big_tcp) != 1) return 12;
+
+    /* Only records owned by the name or a CNAME target along its chain count. */
+    r = cc_dns_lookup_family(&a, "alias.cc.test", 13, CC_DNS_IPV4, &err);
+    if (err != CC_NET_OK || r.len != 1 || !has_v4(r, 9)) return 15;
+    r = cc_dns_lookup_family(&a, "spoof.cc.test", 13, CC_DNS_IPV4, &err);
+    if (err != CC_NET_DNS_FAILURE || r.len != 0) return 16;
+
+    /* Reverse lookups consult hosts too. */
+    CCIpAddr ip = cc_ip_parse("10.9.8.7", 8, &err);
+    r = cc_dns_reverse(&a, &ip, &err);
+    if (err != CC_NET_OK || r.len != 14 || memcmp(r.ptr, "hosted.cc.test", 14) != 0) return 13;
+
+    /* Entries expire with their TTL. */
+    int svc_before = atomic_load(&g_svc_a);
+    usleep(1100000);
+    r = cc_dns_lookup_family(&a, "svc.cc.test", 11, CC_DNS_IPV4, &err);
+    if (err != CC_NET_OK || atomic_load(&g_svc_a) != svc_before + 1) return 14;
+
+    cc_arena_free(&a);
+    atomic_store(&g_stop, 1);
+    pthread_join(fixture, NULL);
+    close(g_udp_fd);
+    close(g_tcp_fd);
+    unlink(hosts_path);
+    unlink(conf_path);
+    printf("dns stub resolver ok\n");
+    return 0;
+}
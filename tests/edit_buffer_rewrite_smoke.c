@@ -0,0 +1,170 @@
+/* Compiler-internal smoke test for the phase-3 batch machinery:
+ *
+ *   - CCEditBuffer: spans from two passes over the same source merge into
+ *     one output; overlapping spans and cross-pass inserts at one
+ *     offset are reported by cc_edit_buffer_has_conflicts, while
+ *     cc_edit_buffer_apply only refuses real overlaps.
+ *   - CCEditTrack: in-place splices on a working copy, including ones that
+ *     cover earlier splices (a UFCS call around a rewritten argument),
+ *     commit to source edits that reproduce the working copy.
+ *
+ * Built with -Icc/src (see edit_buffer_rewrite_smoke.cflags) and links the
+ * translation unit directly.
+ */
+#include "visitor/edit_buffer.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int g_failed = 0;
+
+#define CHECK(cond, msg)                         \
+    do {                                         \
+        if (!(cond)) {                           \
+            printf("FAIL: %s\n", msg);           \
+            g_failed = 1;                        \
+        }                                        \
+    } while (0)
+
+static void test_merge_two_passes(void) {
+    const char* src = "f(a);\nint y;\ng(b);\n";
+    CCEditBuffer eb;
+    cc_edit_buffer_init(&eb, src, strlen(src));
+    CHECK(cc_edit_buffer_add(&eb, 0, 1, "F", 100, "ufcs") == 0, "first pass adds a span");
+    CHECK(cc_edit_buffer_add(&eb, 16, 16, ", 2", 90, "closure_calls") == 0, "second pass adds a span");
+    CHECK(cc_edit_buffer_has_conflicts(&eb) == 0, "disjoint passes do not conflict");
+    size_t len = 0;
+    char* merged = cc_edit_buffer_apply(&eb, &len);
+    CHECK(merged && strcmp(merged, "F(a);\nint y;\ng(b, 2);\n") == 0, "merged output has both rewrites");
+    free(merged);
+    cc_edit_buffer_free(&eb);
+}
+
+static void test_overlap_conflict(void) {
+    const char* src = "x = f(a);\n";
+    CCEditBuffer eb;
+    cc_edit_buffer_init(&eb, src, strlen(src));
+    (void)cc_edit_buffer_add(&eb, 4, 8, "g(a)", 0, "p1");
+    (void)cc_edit_buffer_add(&eb, 6, 7, "b", 0, "p2");
+    CHECK(cc_edit_buffer_has_conflicts(&eb) == 1, "overlapping spans conflict");
+    size_t len = 0;
+    char* out = cc_edit_buffer_apply(&eb, &len);
+    CHECK(out == NULL, "apply refuses overlapping spans");
+    free(out);
+    cc_edit_buffer_free(&eb);
+}
+
+static void test_same_offset_inserts(void) {
+    const char* src = "call();\n";
+    CCEditBuffer eb;
+    size_t len = 0;
+
+    /* Two passes inserting at one offset: a batch conflict, but apply still
+     * orders them by priority as it always has. */
+    cc_edit_buffer_init(&eb, src, strlen(src));
+    (void)cc_edit_buffer_add(&eb, 0, 0, "A;", 10, "p1");
+    (void)cc_edit_buffer_add(&eb, 0, 0, "B;", 5, "p2");
+    CHECK(cc_edit_buffer_has_conflicts(&eb) == 1, "cross-pass inserts at one offset conflict");
+    char* out = cc_edit_buffer_apply(&eb, &len);
+    CHECK(out && strcmp(out, "B;A;call();\n") == 0, "apply orders same-offset inserts by priority");
+    free(out);
+    cc_edit_buffer_free(&eb);
+
+    /* Same pass name through different pointers is still one pass. */
+    char name_a[] = "pass";
+    char name_b[] = "pass";
+    cc_edit_buffer_init(&eb, src, strlen(src));
+    (void)cc_edit_buffer_add(&eb, 0, 0, "A;", 1, name_a);
+    (void)cc_edit_buffer_add(&eb, 0, 0, "B;", 2, name_b);
+    CHECK(cc_edit_buffer_has_conflicts(&eb) == 0, "same-pass inserts do not conflict");
+    cc_edit_buffer_free(&eb);
+}
+
+/* Splice cur[start, end) -> repl in place and report it to the track. */
+static int track_splice(CCEditTrack* t, char* cur, size_t* cur_len, size_t start, size_t end, const char* repl) {
+    size_t rl = strlen(repl);
+    if (cc_edit_track_splice(t, start, end, repl, rl) != 0) return -1;
+    memmove(cur + start + rl, cur + end, *cur_len - end + 1);
+    memcpy(cur + start, repl, rl);
+    *cur_len = *cur_len - (end - start) + rl;
+    return 0;
+}
+
+static int track_round_trip(CCEditBuffer* eb, CCEditTrack* t, const char* cur, size_t cur_len) {
+    int n = cc_edit_track_commit(t);
+    size_t len = 0;
+    char* out = n >= 0 ? cc_edit_buffer_apply(eb, &len) : NULL;
+    int ok = out && len == cur_len && memcmp(out, cur, len) == 0;
+    free(out);
+    return ok ? n : -1;
+}
+
+static void test_edit_track(void) {
+    const char* src = "x = a.f(b.g(1)) + c.h();\n";
+    char cur[256];
+    size_t cur_len = strlen(src);
+    memcpy(cur, src, cur_len + 1);
+    CCEditBuffer eb;
+    CCEditTrack t;
+    cc_edit_buffer_init(&eb, src, strlen(src));
+    cc_edit_track_init(&t, &eb, 100, "ufcs");
+    /* Bottom-up, the way the UFCS pass goes. */
+    (void)track_splice(&t, cur, &cur_len, 18, 23, "h(&c)");
+    (void)track_splice(&t, cur, &cur_len, 8, 14, "g(&b, 1)");
+    (void)track_splice(&t, cur, &cur_len, 4, 17, "f(&a, g(&b, 1))");
+    CHECK(strcmp(cur, "x = f(&a, g(&b, 1)) + h(&c);\n") == 0, "working copy");
+    CHECK(t.count == 2, "outer splice absorbs the argument's");
+    CHECK(track_round_trip(&eb, &t, cur, cur_len) == 2, "tracked splices reproduce the working copy");
+    /* Narrowed to the changed bytes: `1))` is not part of any edit. */
+    CHECK(eb.edits[0].end_off <= strlen("x = a.f(b.g("), "outer edit narrowed");
+    cc_edit_track_free(&t);
+    cc_edit_buffer_free(&eb);
+
+    /* Deterministic random splices, overlapping earlier ones at random. */
+    unsigned seed = 777u;
+    for (int iter = 0; iter < 2000; iter++) {
+        char s[96];
+        seed = seed * 1103515245u + 12345u;
+        size_t sl = 10 + (seed >> 16) % 60;
+        for (size_t i = 0; i < sl; i++) {
+            seed = seed * 1103515245u + 12345u;
+            s[i] = "abc(),. "[(seed >> 16) % 8];
+        }
+        s[sl] = '\0';
+        char w[1024];
+        size_t wl = sl;
+        memcpy(w, s, sl + 1);
+        cc_edit_buffer_init(&eb, s, sl);
+        cc_edit_track_init(&t, &eb, 100, "p");
+        int ok = 1;
+        for (int k = 0; k < 8 && ok; k++) {
+            seed = seed * 1103515245u + 12345u;
+            size_t a = (seed >> 16) % (wl + 1);
+            seed = seed * 1103515245u + 12345u;
+            size_t b = (seed >> 20) % 3 == 0 ? a : a + (seed >> 16) % (wl - a + 1);
+            char r[8];
+            size_t rl = (seed >> 8) % 6;
+            for (size_t q = 0; q < rl; q++) r[q] = "XYZ_(<"[(seed >> (q + 3)) % 6];
+            r[rl] = '\0';
+            ok = track_splice(&t, w, &wl, a, b, r) == 0;
+        }
+        if (!ok || track_round_trip(&eb, &t, w, wl) < 0) {
+            printf("FAIL: random track %d\n", iter);
+            g_failed = 1;
+            iter = 2000;
+        }
+        cc_edit_track_free(&t);
+        cc_edit_buffer_free(&eb);
+    }
+}
+
+int main(void) {
+    test_merge_two_passes();
+    test_overlap_conflict();
+    test_same_offset_inserts();
+    test_edit_track();
+    if (g_failed) return 1;
+    printf("edit_buffer_rewrite_smoke: OK\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+/* cc_file_map + cc_file_map_scan:
+ *   - the mapping matches what was written;
+ *   - a scan with tiny chunks (and one line longer than a chunk) visits every
+ *     byte exactly once, each chunk starting at a line start and ending at a
+ *     newline or the end of the file;
+ *   - a non-zero callback result stops the scan and is returned;
+ *   - an empty file maps to an empty slice. */
+
+#include <ccc/std/prelude.cch>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LINES 2000
+
+static _Atomic size_t g_bytes = 0;
+static _Atomic size_t g_lines = 0;
+static _Atomic int g_bad = 0;
+static const char* g_base = NULL;
+static size_t g_len = 0;
+
+static int count_chunk(CCSlice chunk, size_t index, void* arg) {
+    (void)index; (void)arg;
+    const char* p = (const char*)chunk.ptr;
+    if (p != g_base && p[-1] != '\n') atomic_store(&g_bad, 1);
+    if (p + chunk.len != g_base + g_len && p[chunk.len - 1] != '\n') atomic_store(&g_bad, 2);
+    size_t lines = 0;
+    for (size_t i = 0; i < chunk.len; ++i) lines += p[i] == '\n';
+    atomic_fetch_add(&g_bytes, chunk.len);
+    atomic_fetch_add(&g_lines, lines);
+    return 0;
+}
+
+static int stop_at_three(CCSlice chunk, size_t index, void* arg) {
+    (void)chunk; (void)arg;
+    return index == 3 ? 42 : 0;
+}
+
+int main(void) {
+    const char* path = "/tmp/cc_file_map_smoke.txt";
+    FILE* f = fopen(path, "w");
+    if (!f) return 1;
+    for (int i = 0; i < LINES; ++i) {
+        if (i == 700) {
+            for (int k = 0; k < 300; ++k) fputc('z', f);
+            fputc('\n', f);
+        } else {
+            fprintf(f, "line %d\n", i);
+        }
+    }
+    fputs("last line without newline", f);
+    fclose(f);
+
+    CCSlice map;
+    CCResult_size_t_CCIoError mr = cc_file_map(path, &map);
+    if (!mr.ok || mr.u.value != map.len || map.len == 0) return 2;
+    if (memcmp(map.ptr, "line 0\nline 1\n", 14) != 0) return 3;
+    g_base = (const char*)map.ptr;
+    g_len = map.len;
+
+    if (cc_file_map_scan(map, 64, count_chunk, NULL) != 0) return 4;
+    if (atomic_load(&g_bad)) return 5;
+    if (atomic_load(&g_bytes) != map.len || atomic_load(&g_lines) != LINES) return 6;
+
+    if (cc_file_map_scan(map, 64, stop_at_three, NULL) != 42) return 7;
+    if (cc_file_map_advise(map, CC_FILE_MAP_RANDOM) != 0) return 8;
+    cc_file_unmap(&map);
+    if (map.ptr || map.len) return 9;
+
+    f = fopen(path, "w");
+    fclose(f);
+    mr = cc_file_map(path, &map);
+    if (!mr.ok || mr.u.value != 0 || map.len != 0) return 10;
+    if (cc_file_map_scan(map, 0, count_chunk, NULL) != 0) return 11;
+    cc_file_unmap(&map);
+    remove(path);
+
+    printf("file map ok\n");
+    return 0;
+}
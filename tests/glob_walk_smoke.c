@@ -0,0 +1,172 @@
+/* Parallel glob walk.
+ *
+ *   - `root/ ** / *.c` over a nested tree returns every .c file once, sorted,
+ *     including files directly under root (** matches zero directories).
+ *   - A wildcard directory segment prunes: `root/lib* / *.c` never reports
+ *     files under root/app.
+ *   - Multi-component tails after ** match trailing path components, with
+ *     zero directories in between too (`root/ ** / d1 / *.c` finds root/d1).
+ *   - cc_glob_stream feeds a channel drained by a fiber; the count matches
+ *     cc_glob and the channel is closed when the walk ends.
+ *   - A missing root reports ENOENT through cc_glob_stream. */
+
+#include <ccc/std/prelude.cch>
+#include <ccc/std/dir.cch>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LIBS 6
+#define DEPTH 3
+#define FILES 5
+
+static char g_root[256];
+static int g_expect_c = 0;
+static _Atomic int g_streamed = 0;
+static _Atomic int g_stream_rc = -1;
+
+static void touch(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f) fclose(f);
+}
+
+static void build_tree(void) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/top.c", g_root);
+    touch(path);
+    g_expect_c++;
+    /* d1 right under the root: `root/ ** / d1` matches it with zero directories. */
+    snprintf(path, sizeof(path), "%s/d1", g_root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/d1/x.c", g_root);
+    touch(path);
+    g_expect_c++;
+    for (int l = 0; l < LIBS; ++l) {
+        snprintf(path, sizeof(path), "%s/%s%d", g_root, l % 2 ? "app" : "lib", l);
+        mkdir(path, 0755);
+        size_t base = strlen(path);
+        for (int d = 0; d < DEPTH; ++d) {
+            for (int f = 0; f < FILES; ++f) {
+                snprintf(path + base, sizeof(path) - base, "/f%d.%s", f, f % 2 ? "h" : "c");
+                touch(path);
+                if (f % 2 == 0) g_expect_c++;
+            }
+            snprintf(path + base, sizeof(path) - base, "/d%d", d);
+            mkdir(path, 0755);
+            base = strlen(path);
+        }
+    }
+}
+
+static void remove_tree(const char* path) {
+    CCArena a = cc_arena_heap(4096);
+    CCResult_CCDirIterptr_CCIoError it = cc_dir_open(&a, path);
+    if (cc_is_err(it)) { cc_arena_free(&a); return; }
+    CCDirIter* iter = cc_unwrap(it);
+    for (;;) {
+        CCResult_CCDirEntry_CCIoError e = cc_dir_next(iter, &a);
+        if (cc_is_err(e)) break;
+        CCDirEntry ent = cc_unwrap(e);
+        char child[512];
+        snprintf(child, sizeof(child), "%s/%.*s", path, (int)ent.name.len, (const char*)ent.name.ptr);
+        if (ent.type == CC_DIRENT_DIR) remove_tree(child);
+        else unlink(child);
+    }
+    cc_dir_close(iter);
+    cc_arena_free(&a);
+    rmdir(path);
+}
+
+typedef struct {
+    char pattern[512];
+    CCChan* ch;
+} StreamJob;
+
+static void* walk_fiber(void* arg) {
+    StreamJob* job = (StreamJob*)arg;
+    atomic_store(&g_stream_rc, cc_glob_stream(job->pattern, job->ch));
+    return NULL;
+}
+
+static void* drain_fiber(void* arg) {
+    StreamJob* job = (StreamJob*)arg;
+    CCGlobEntry e;
+    while (cc_chan_recv(job->ch, &e, sizeof(e)) == 0) {
+        if (e.type != CC_DIRENT_FILE || e.len != strlen(e.path)) atomic_store(&g_streamed, -1000000);
+        atomic_fetch_add(&g_streamed, 1);
+        cc_glob_entry_free(&e);
+    }
+    return NULL;
+}
+
+int main(void) {
+    snprintf(g_root, sizeof(g_root), "/tmp/cc_glob_walk_%d", (int)getpid());
+    remove_tree(g_root);
+    if (mkdir(g_root, 0755) != 0) return 1;
+    build_tree();
+
+    CCArena arena = cc_arena_heap(64 * 1024);
+    char pattern[512];
+
+    /* Recursive: every .c once, sorted. */
+    snprintf(pattern, sizeof(pattern), "%s/**/*.c", g_root);
+    CCGlobResult all = cc_glob(&arena, pattern);
+    if ((int)all.count != g_expect_c) { fprintf(stderr, "all: %zu != %d\n", all.count, g_expect_c); return 2; }
+    for (size_t i = 1; i < all.count; ++i) {
+        if (strcmp(cc_glob_result_get(&all, i - 1), cc_glob_result_get(&all, i)) >= 0) return 3;
+    }
+
+    /* Wildcard directory segment prunes app*: top level .c of lib dirs only. */
+    snprintf(pattern, sizeof(pattern), "%s/lib*/*.c", g_root);
+    CCGlobResult libs = cc_glob(&arena, pattern);
+    if (libs.count != (LIBS / 2) * ((FILES + 1) / 2)) { fprintf(stderr, "libs: %zu\n", libs.count); return 4; }
+    for (size_t i = 0; i < libs.count; ++i) {
+        if (strstr(cc_glob_result_get(&libs, i), "/app")) return 5;
+    }
+
+    /* Multi-component tail: only files directly under a d1 directory,
+     * including root/d1 itself. */
+    snprintf(pattern, sizeof(pattern), "%s/**/d1/*.c", g_root);
+    CCGlobResult d1 = cc_glob(&arena, pattern);
+    if (d1.count != LIBS * ((FILES + 1) / 2) + 1) { fprintf(stderr, "d1: %zu\n", d1.count); return 6; }
+    char top_d1[512];
+    snprintf(top_d1, sizeof(top_d1), "%s/d1/x.c", g_root);
+    int saw_top_d1 = 0;
+    for (size_t i = 0; i < d1.count; ++i) {
+        if (strcmp(cc_glob_result_get(&d1, i), top_d1) == 0) saw_top_d1 = 1;
+    }
+    if (!saw_top_d1) { fprintf(stderr, "d1: %s not matched\n", top_d1); return 6; }
+
+    /* Streamed through a channel. */
+    StreamJob job;
+    snprintf(job.pattern, sizeof(job.pattern), "%s/**/*.c", g_root);
+    job.ch = cc_chan_create(16);
+    if (!job.ch) return 7;
+    cc_chan_init_elem(job.ch, sizeof(CCGlobEntry));
+    CCNursery* n = cc_nursery_create(NULL);
+    cc_nursery_spawn(n, walk_fiber, &job);
+    cc_nursery_spawn(n, drain_fiber, &job);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    cc_chan_free(job.ch);
+    if (atomic_load(&g_stream_rc) != 0 || atomic_load(&g_streamed) != g_expect_c) {
+        fprintf(stderr, "stream: rc=%d got %d\n", atomic_load(&g_stream_rc), atomic_load(&g_streamed));
+        return 8;
+    }
+
+    /* Missing root. */
+    CCChan* ch = cc_chan_create(4);
+    cc_chan_init_elem(ch, sizeof(CCGlobEntry));
+    snprintf(pattern, sizeof(pattern), "%s/missing/**/*.c", g_root);
+    if (cc_glob_stream(pattern, ch) != ENOENT) return 9;
+    cc_chan_free(ch);
+
+    cc_arena_free(&arena);
+    remove_tree(g_root);
+    printf("glob walk ok\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+/* Compiler-internal smoke test for the lowered-header cache:
+ *
+ *   - a miss lowers once and installs the entry whole (no tmp file left);
+ *   - a hit returns the entry's bytes without lowering again;
+ *   - different header text, or the same text at another path, is a
+ *     different key;
+ *   - a header lowering leaves unchanged is cached as a copy of the input;
+ *   - CCC_NO_HEADER_CACHE=1 lowers every time;
+ *   - cc_lower_header_install leaves an identical .h (and its mtime) alone
+ *     and replaces a different one.
+ *
+ * Built with -Icc/src (see header_cache_smoke.cflags). cc_lower_header_string
+ * is stubbed, so no TCC is involved.
+ */
+#include "util/path.c"
+#include "header/header_cache.c"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+static int g_failed = 0;
+static int g_lowered = 0;
+
+#define CHECK(cond, msg)                         \
+    do {                                         \
+        if (!(cond)) {                           \
+            printf("FAIL: %s\n", msg);           \
+            g_failed = 1;                        \
+        }                                        \
+    } while (0)
+
+/* Stub lowering: counts calls; text containing "plain" needs no change. */
+char* cc_lower_header_string(const char* input, size_t input_len, const char* input_path) {
+    (void)input_path;
+    g_lowered++;
+    if (strstr(input, "plain")) return NULL;
+    static const char tag[] = "/* lowered */\n";
+    char* out = (char*)malloc(sizeof(tag) + input_len);
+    if (!out) return NULL;
+    memcpy(out, tag, sizeof(tag) - 1);
+    memcpy(out + sizeof(tag) - 1, input, input_len);
+    out[sizeof(tag) - 1 + input_len] = '\0';
+    return out;
+}
+
+static char* entry_for(const char* text, const char* path) {
+    static char entries[8][1200];
+    static int next = 0;
+    char* e = entries[next++ % 8];
+    if (cc__hc_entry_path(text, strlen(text), path, e, sizeof(entries[0])) != 0) return NULL;
+    return e;
+}
+
+/* Does the entry's directory hold a `<entry>.tmp.<pid>` leftover? */
+static int tmp_left_behind(const char* entry) {
+    char dir[1200];
+    snprintf(dir, sizeof(dir), "%s", entry);
+    char* slash = strrchr(dir, '/');
+    if (!slash) return 0;
+    *slash = '\0';
+    const char* base = slash + 1;
+    DIR* d = opendir(dir);
+    if (!d) return 0;
+    int found = 0;
+    struct dirent* de;
+    while ((de = readdir(d)) != NULL) {
+        if (strncmp(de->d_name, base, strlen(base)) == 0 && strstr(de->d_name, ".tmp.")) found = 1;
+    }
+    closedir(d);
+    return found;
+}
+
+static void test_miss_then_hit(const char* path) {
+    const char* text = "int f(void);\n";
+    char* entry = entry_for(text, path);
+    CHECK(entry != NULL, "entry path");
+    if (!entry) return;
+    unlink(entry);
+
+    g_lowered = 0;
+    char* a = cc_lower_header_cached(text, strlen(text), path);
+    CHECK(a && strcmp(a, "/* lowered */\nint f(void);\n") == 0, "miss returns the lowered text");
+    CHECK(g_lowered == 1, "miss lowers once");
+    char* stored = cc__hc_read_file(entry, NULL);
+    CHECK(stored && a && strcmp(stored, a) == 0, "miss installs the entry");
+    CHECK(!tmp_left_behind(entry), "install leaves no tmp file");
+    free(stored);
+
+    char* b = cc_lower_header_cached(text, strlen(text), path);
+    CHECK(b && a && strcmp(a, b) == 0, "hit returns the same text");
+    CHECK(g_lowered == 1, "hit does not lower");
+    free(a);
+    free(b);
+
+    /* The hit path serves the entry's bytes, not a fresh lowering. */
+    FILE* f = fopen(entry, "wb");
+    if (f) {
+        fputs("/* from cache */\n", f);
+        fclose(f);
+    }
+    char* c = cc_lower_header_cached(text, strlen(text), path);
+    CHECK(c && strcmp(c, "/* from cache */\n") == 0, "hit reads the entry");
+    free(c);
+    unlink(entry);
+}
+
+static void test_key_changes(const char* path, const char* other_path) {
+    const char* text = "int g(void);\n";
+    char* base = entry_for(text, path);
+    char* other_text = entry_for("int h(void);\n", path);
+    char* other_file = entry_for(text, other_path);
+    CHECK(base && other_text && strcmp(base, other_text) != 0, "different text changes the key");
+    CHECK(base && other_file && strcmp(base, other_file) != 0, "different path changes the key");
+
+    if (!base || !other_file) return;
+    unlink(base);
+    unlink(other_file);
+    g_lowered = 0;
+    free(cc_lower_header_cached(text, strlen(text), path));
+    free(cc_lower_header_cached(text, strlen(text), other_path));
+    CHECK(g_lowered == 2, "each path lowers on its own");
+    unlink(base);
+    unlink(other_file);
+}
+
+static void test_unchanged_and_opt_out(const char* path) {
+    const char* text = "/* plain */ int k;\n";
+    char* entry = entry_for(text, path);
+    if (entry) unlink(entry);
+    char* a = cc_lower_header_cached(text, strlen(text), path);
+    CHECK(a && strcmp(a, text) == 0, "unchanged header comes back as a copy");
+    free(a);
+    if (entry) unlink(entry);
+
+    const char* lowered = "int m;\n";
+    setenv("CCC_NO_HEADER_CACHE", "1", 1);
+    g_lowered = 0;
+    free(cc_lower_header_cached(lowered, strlen(lowered), path));
+    free(cc_lower_header_cached(lowered, strlen(lowered), path));
+    CHECK(g_lowered == 2, "CCC_NO_HEADER_CACHE lowers every time");
+    char* e = entry_for(lowered, path);
+    struct stat st;
+    CHECK(e && stat(e, &st) != 0, "CCC_NO_HEADER_CACHE installs nothing");
+    unsetenv("CCC_NO_HEADER_CACHE");
+}
+
+static void test_install(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cc_header_cache_smoke_%d.h", (int)getpid());
+    const char* text = "#define X 1\n";
+    CHECK(cc_lower_header_install(path, text, strlen(text)) == 0, "install a new .h");
+
+    struct timeval old[2] = { { 1000000000, 0 }, { 1000000000, 0 } };
+    utimes(path, old);
+    CHECK(cc_lower_header_install(path, text, strlen(text)) == 0, "install identical bytes");
+    struct stat st;
+    CHECK(stat(path, &st) == 0 && st.st_mtime == 1000000000, "identical .h keeps its mtime");
+
+    const char* text2 = "#define X 2\n";
+    CHECK(cc_lower_header_install(path, text2, strlen(text2)) == 0, "install changed bytes");
+    char* have = cc__hc_read_file(path, NULL);
+    CHECK(have && strcmp(have, text2) == 0, "changed .h is replaced");
+    CHECK(stat(path, &st) == 0 && st.st_mtime != 1000000000, "changed .h gets a new mtime");
+    free(have);
+    unlink(path);
+}
+
+int main(void) {
+    char path[64], other_path[64];
+    snprintf(path, sizeof(path), "/tmp/cc_header_cache_smoke_%d/a.cch", (int)getpid());
+    snprintf(other_path, sizeof(other_path), "/tmp/cc_header_cache_smoke_%d/b.cch", (int)getpid());
+    test_miss_then_hit(path);
+    test_key_changes(path, other_path);
+    test_unchanged_and_opt_out(path);
+    test_install();
+    if (g_failed) return 1;
+    printf("header_cache_smoke: OK\n");
+    return 0;
+}
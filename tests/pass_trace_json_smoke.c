@@ -0,0 +1,38 @@
+/* Compiler-internal smoke test for the --trace-passes JSON writer: a TU path
+ * holding quotes, backslashes and control characters comes out escaped, so
+ * the event line is still valid JSON.
+ *
+ * Built with -Icc/src (see pass_trace_json_smoke.cflags).
+ */
+#include "util/pass_profile.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cc_pass_trace_json_smoke_%d.json", (int)getpid());
+    setenv("CC_TRACE_PASSES", path, 1);
+    cc_pass_profile_reset();
+    cc_pass_profile_trace_reset(path);
+
+    cc_pass_profile_tu_begin("dir\\a \"b\"\tc.ccs");
+    cc_pass_profile_tu_end();
+    cc_pass_profile_reset();
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return 1;
+    char buf[2048];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    unlink(path);
+
+    if (!strstr(buf, "\"tu\":\"dir\\\\a \\\"b\\\"\\u0009c.ccs\"")) {
+        printf("FAIL: tu path not escaped: %s\n", buf);
+        return 1;
+    }
+    printf("pass_trace_json_smoke: OK\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+/* Compiler-internal smoke test for the --preempt-points text pass:
+ * cc__insert_preempt_points must put the call just past the '{' of every
+ * braced for/while/do body, and nowhere else -- not inside string or char
+ * literals, comments or #define lines, and not after the `while (x);` that
+ * closes a do-loop.
+ *
+ * Built with -Icc/src (see preempt_points_pass_smoke.cflags).
+ */
+#include "visitor/pass_preempt_points.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int g_failed = 0;
+
+/* `@` in `expect` marks each place the call should land. */
+static void check(const char* name, const char* src, const char* expect) {
+    char want[1024];
+    size_t w = 0;
+    for (const char* p = expect; *p && w + sizeof(k_cc_preempt_call) < sizeof(want); p++) {
+        if (*p == '@') {
+            memcpy(want + w, k_cc_preempt_call, sizeof(k_cc_preempt_call) - 1);
+            w += sizeof(k_cc_preempt_call) - 1;
+        } else {
+            want[w++] = *p;
+        }
+    }
+    want[w] = '\0';
+
+    char* out = NULL;
+    size_t out_len = 0;
+    int changed = cc__insert_preempt_points(src, strlen(src), &out, &out_len);
+    const char* got = changed ? out : src;
+    if (changed != (strchr(expect, '@') != NULL) || strcmp(got, want) != 0 ||
+        (changed && out_len != strlen(want))) {
+        printf("FAIL: %s\n  got:  %s\n  want: %s\n", name, got, want);
+        g_failed = 1;
+    }
+    free(out);
+}
+
+int main(void) {
+    check("for", "for (int i = 0; i < n; i++) { f(); }",
+                 "for (int i = 0; i < n; i++) {@ f(); }");
+    check("while", "while (x) {\n}\n", "while (x) {@\n}\n");
+    check("do-while", "do { x--; } while (x);", "do {@ x--; } while (x);");
+    check("nested parens", "while (f((a), \")\")) {}", "while (f((a), \")\")) {@}");
+    check("comment before body", "for (;;) /* c { */ {}", "for (;;) /* c { */ {@}");
+    check("unbraced", "for (;;) x++;\nwhile (y) y--;", "for (;;) x++;\nwhile (y) y--;");
+    check("ident suffix", "format(x) {} dowhile {} for_each(x) {}", "format(x) {} dowhile {} for_each(x) {}");
+
+    check("string", "puts(\"for (;;) { }\"); puts(\"while(1){\");",
+                    "puts(\"for (;;) { }\"); puts(\"while(1){\");");
+    check("escaped quote", "s = \"\\\" while (1) {\"; do {}", "s = \"\\\" while (1) {\"; do {@}");
+    check("char literal", "c = '{'; while (c) {}", "c = '{'; while (c) {@}");
+    check("line comment", "// for (;;) {\nwhile (1) {}", "// for (;;) {\nwhile (1) {@}");
+    check("block comment", "/* while (1) {\n do { */ for (;;) {}", "/* while (1) {\n do { */ for (;;) {@}");
+    check("#define", "#define SPIN while (1) { }\nfor (;;) {}", "#define SPIN while (1) { }\nfor (;;) {@}");
+    check("#define continued", "  #define LOOP(x) \\\n    for (;;) { x; }\nint y;", "  #define LOOP(x) \\\n    for (;;) { x; }\nint y;");
+    check("# after comment", "/* a\n */ while (z) {}", "/* a\n */ while (z) {@}");
+
+    if (g_failed) return 1;
+    printf("preempt_points_pass_smoke: OK\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* Fiber-native process I/O and exit waits, on a single worker thread:
+ *   - a fiber waiting for `sleep` to exit parks, so a sibling fiber keeps
+ *     running and finishes first;
+ *   - 1 MiB through `cat` (stdin fed while stdout drains) and a child that
+ *     fills stderr before writing stdout both complete without deadlock;
+ *   - 16 concurrent captures from fibers all succeed;
+ *   - cc_process_wait_timeout_ms times out on a live child, and the SIGCHLD
+ *     path (no pidfd) reaps it after a kill. */
+
+#include <ccc/std/prelude.cch>
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIG (1 << 20)
+#define CONCURRENT 16
+
+static _Atomic int g_sleep_done = 0;
+static _Atomic int g_ticker_done_first = 0;
+static _Atomic int g_capture_ok = 0;
+
+static CCResult_CCProcessOutput_CCIoError run_sh(CCArena* arena, const char* script, CCSlice input) {
+    const char* args[] = {"/bin/sh", "-c", script, NULL};
+    CCProcessConfig cfg = {0};
+    cfg.program = "/bin/sh";
+    cfg.args = args;
+    cfg.pipe_stdout = true;
+    cfg.pipe_stderr = true;
+    return cc_process_run_with_input(arena, &cfg, input);
+}
+
+static void* sleeper_fiber(void* arg) {
+    (void)arg;
+    const char* args[] = {"sleep", "0.2", NULL};
+    CCProcessConfig cfg = {.program = "sleep", .args = args};
+    CCResult_CCProcess_CCIoError sp = cc_process_spawn(&cfg);
+    if (cc_is_err(sp)) return NULL;
+    CCProcess proc = cc_unwrap(sp);
+    CCResult_CCProcessStatus_CCIoError st = cc_process_wait(&proc);
+    if (!cc_is_err(st) && cc_unwrap(st).exited) atomic_store(&g_sleep_done, 1);
+    return NULL;
+}
+
+static void* ticker_fiber(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 50; ++i) cc_yield();
+    if (!atomic_load(&g_sleep_done)) atomic_store(&g_ticker_done_first, 1);
+    return NULL;
+}
+
+static void* capture_fiber(void* arg) {
+    int id = (int)(intptr_t)arg;
+    CCArena arena = cc_arena_heap(kilobytes(64));
+    char script[64];
+    snprintf(script, sizeof(script), "echo out%d; echo err%d >&2", id, id);
+    CCResult_CCProcessOutput_CCIoError res = run_sh(&arena, script, cc_slice_empty());
+    if (!cc_is_err(res)) {
+        CCProcessOutput out = cc_unwrap(res);
+        char want_out[32], want_err[32];
+        int lo = snprintf(want_out, sizeof(want_out), "out%d\n", id);
+        int le = snprintf(want_err, sizeof(want_err), "err%d\n", id);
+        if (out.status.exit_code == 0 && out.stdout_data.len == (size_t)lo && out.stderr_data.len == (size_t)le &&
+            memcmp(out.stdout_data.ptr, want_out, lo) == 0 && memcmp(out.stderr_data.ptr, want_err, le) == 0) {
+            atomic_fetch_add(&g_capture_ok, 1);
+        }
+    }
+    cc_arena_free(&arena);
+    return NULL;
+}
+
+int main(void) {
+    setenv("CC_WORKERS", "1", 1);
+
+    /* Exit wait parks instead of holding the only worker. */
+    CCNursery* n = cc_nursery_create(NULL);
+    if (!n) return 1;
+    cc_nursery_spawn(n, sleeper_fiber, NULL);
+    cc_nursery_spawn(n, ticker_fiber, NULL);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    if (!atomic_load(&g_sleep_done)) return 2;
+    if (!atomic_load(&g_ticker_done_first)) return 3;
+
+    /* Full-duplex capture larger than any pipe buffer. */
+    CCArena arena = cc_arena_heap(megabytes(8));
+    char* big = (char*)malloc(BIG);
+    for (int i = 0; i < BIG; ++i) big[i] = (char)('a' + i % 26);
+    CCResult_CCProcessOutput_CCIoError res = run_sh(&arena, "cat", cc_slice_from_buffer(big, BIG));
+    if (cc_is_err(res)) return 4;
+    CCProcessOutput out = cc_unwrap(res);
+    if (out.stdout_data.len != BIG || memcmp(out.stdout_data.ptr, big, BIG) != 0) return 5;
+    free(big);
+
+    res = run_sh(&arena, "head -c 300000 /dev/zero >&2; echo done", cc_slice_empty());
+    if (cc_is_err(res)) return 6;
+    out = cc_unwrap(res);
+    if (out.stderr_data.len != 300000 || out.stdout_data.len != 5) return 7;
+
+    /* Many captures at once from fibers. */
+    n = cc_nursery_create(NULL);
+    for (int i = 0; i < CONCURRENT; ++i) cc_nursery_spawn(n, capture_fiber, (void*)(intptr_t)i);
+    cc_nursery_wait(n);
+    cc_nursery_free(n);
+    if (atomic_load(&g_capture_ok) != CONCURRENT) return 8;
+
+    /* Timeout, then the SIGCHLD self-pipe path. */
+    const char* args[] = {"sleep", "5", NULL};
+    CCProcessConfig cfg = {.program = "sleep", .args = args};
+    CCResult_CCProcess_CCIoError sp = cc_process_spawn(&cfg);
+    if (cc_is_err(sp)) return 9;
+    CCProcess proc = cc_unwrap(sp);
+    CCResult_CCProcessStatus_CCIoError st = cc_process_wait_timeout_ms(&proc, 50);
+    if (!cc_is_err(st) || cc_unwrap_err(st).os_code != ETIMEDOUT) return 10;
+    if (proc.exit_fd >= 0) {
+        close(proc.exit_fd);
+        proc.exit_fd = -1;
+    }
+    cc_process_kill(&proc, SIGKILL);
+    st = cc_process_wait_timeout_ms(&proc, 5000);
+    if (cc_is_err(st) || !cc_unwrap(st).signaled || proc.pid != -1) return 11;
+
+    cc_arena_free(&arena);
+    printf("process fiber io ok\n");
+    return 0;
+}
@@ -319,6 +319,12 @@ static int test_requires_async(const char* stem) {
     return file_exists(p);
 }
 
+static int test_requires_tls(const char* stem) {
+    char p[512];
+    snprintf(p, sizeof(p), "tests/%s.requires_tls", stem);
+    return file_exists(p);
+}
+
 /* Per-test environment sidecar support.
  *
  * A `tests/STEM.env` file is read line-by-line.  Each non-empty,
@@ -439,17 +445,22 @@ static int run_one_test(const char* stem,
 
     /* Sidecars */
     char exp_stdout_path[512], exp_stderr_path[512], exp_compile_err_path[512], ldflags_path[512];
+    char cflags_path[512];
     snprintf(exp_stdout_path, sizeof(exp_stdout_path), "tests/%s.stdout", stem);
     snprintf(exp_stderr_path, sizeof(exp_stderr_path), "tests/%s.stderr", stem);
     snprintf(exp_compile_err_path, sizeof(exp_compile_err_path), "tests/%s.compile_err", stem);
     snprintf(ldflags_path, sizeof(ldflags_path), "tests/%s.ldflags", stem);
+    snprintf(cflags_path, sizeof(cflags_path), "tests/%s.cflags", stem);
 
     unsigned char *exp_stdout = NULL, *exp_stderr = NULL, *exp_compile_err = NULL, *ldflags = NULL;
     size_t exp_stdout_len = 0, exp_stderr_len = 0, exp_compile_err_len = 0, ldflags_len = 0;
+    unsigned char* cflags = NULL;
+    size_t cflags_len = 0;
     (void)read_entire_file_alloc(exp_stdout_path, &exp_stdout, &exp_stdout_len);
     (void)read_entire_file_alloc(exp_stderr_path, &exp_stderr, &exp_stderr_len);
     (void)read_entire_file_alloc(exp_compile_err_path, &exp_compile_err, &exp_compile_err_len);
     (void)read_entire_file_alloc(ldflags_path, &ldflags, &ldflags_len);
+    (void)read_entire_file_alloc(cflags_path, &cflags, &cflags_len);
 
     char ldflags_clean[1024];
     ldflags_clean[0] = '\0';
@@ -461,20 +472,34 @@ static int run_one_test(const char* stem,
         trim_trailing_ws_inplace(ldflags_clean);
     }
 
+    /* tests/STEM.cflags: extra host compile flags, passed as --cc-flags. */
+    char cc_flags_arg[1100];
+    cc_flags_arg[0] = '\0';
+    if (cflags && cflags_len) {
+        char cflags_clean[1024];
+        size_t n = cflags_len < sizeof(cflags_clean) - 1 ? cflags_len : sizeof(cflags_clean) - 1;
+        memcpy(cflags_clean, cflags, n);
+        cflags_clean[n] = '\0';
+        replace_newlines_with_spaces(cflags_clean);
+        trim_trailing_ws_inplace(cflags_clean);
+        if (cflags_clean[0]) snprintf(cc_flags_arg, sizeof(cc_flags_arg), "--cc-flags \"%s\" ", cflags_clean);
+    }
+    free(cflags);
+
     /* 1) Build via ccc build (this is the build system under test) */
     char build_cmd[3072];
     const char* cache_flag = use_cache ? "" : "--no-cache ";
     if (ldflags_clean[0]) {
         snprintf(build_cmd, sizeof(build_cmd),
-                 "./cc/bin/ccc build %s--out-dir %s --bin-dir %s --link %s -o %s --ld-flags \"%s\"",
-                 cache_flag,
+                 "./cc/bin/ccc build %s%s--out-dir %s --bin-dir %s --link %s -o %s --ld-flags \"%s\"",
+                 cache_flag, cc_flags_arg,
                  (out_dir && out_dir[0]) ? out_dir : "out",
                  (bin_dir && bin_dir[0]) ? bin_dir : "bin",
                  input_path, bin_out, ldflags_clean);
     } else {
         snprintf(build_cmd, sizeof(build_cmd),
-                 "./cc/bin/ccc build %s--out-dir %s --bin-dir %s --link %s -o %s",
-                 cache_flag,
+                 "./cc/bin/ccc build %s%s--out-dir %s --bin-dir %s --link %s -o %s",
+                 cache_flag, cc_flags_arg,
                  (out_dir && out_dir[0]) ? out_dir : "out",
                  (bin_dir && bin_dir[0]) ? bin_dir : "bin",
                  input_path, bin_out);
@@ -550,9 +575,45 @@ static int run_one_test(const char* stem,
     return 0;
 }
 
+#define CC_TEST_SERVER_SOCK "out/ccc-server.sock"
+
+/* Start `ccc --server` and point every test build at it. The idle timeout
+   reaps the server if cc_test dies before stop_compile_server runs. */
+static pid_t start_compile_server(int verbose) {
+    (void)unlink(CC_TEST_SERVER_SOCK);
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        execl("./cc/bin/ccc", "ccc", "--server", "--socket", CC_TEST_SERVER_SOCK,
+              "--idle-timeout", "60", (char*)NULL);
+        _exit(127);
+    }
+    for (int waited_ms = 0; waited_ms < 10000; waited_ms += 10) {
+        if (file_exists(CC_TEST_SERVER_SOCK)) {
+            setenv("CCC_SERVER_SOCKET", CC_TEST_SERVER_SOCK, 1);
+            if (verbose) fprintf(stderr, "cc_test: compile server pid %d on %s\n", (int)pid, CC_TEST_SERVER_SOCK);
+            return pid;
+        }
+        int st = 0;
+        if (waitpid(pid, &st, WNOHANG) == pid) break;
+        usleep(10 * 1000);
+    }
+    fprintf(stderr, "cc_test: compile server did not start; compiling locally\n");
+    kill(pid, SIGTERM);
+    (void)waitpid(pid, NULL, 0);
+    return -1;
+}
+
+static void stop_compile_server(pid_t pid) {
+    if (pid <= 0) return;
+    unsetenv("CCC_SERVER_SOCKET");
+    kill(pid, SIGTERM);
+    (void)waitpid(pid, NULL, 0);
+}
+
 static void usage(const char* prog) {
     fprintf(stderr, "Usage:\n");
-    fprintf(stderr, "  %s [--list] [--filter SUBSTR] [--verbose] [--jobs N] [--build-timeout SECONDS] [--run-timeout SECONDS] [--use-cache] [--clean]\n", prog);
+    fprintf(stderr, "  %s [--list] [--filter SUBSTR] [--verbose] [--jobs N] [--build-timeout SECONDS] [--run-timeout SECONDS] [--use-cache] [--clean] [--server]\n", prog);
 }
 
 int main(int argc, char** argv) {
@@ -562,6 +623,7 @@ int main(int argc, char** argv) {
     int jobs = 6;
     int use_cache = 0;
     int clean = 0;
+    int use_server = 0;
     int build_timeout_sec = 300;
     int run_timeout_sec = 10;
     for (int i = 1; i < argc; ++i) {
@@ -569,6 +631,7 @@ int main(int argc, char** argv) {
         if (strcmp(argv[i], "--list") == 0) { list_only = 1; continue; }
         if (strcmp(argv[i], "--use-cache") == 0) { use_cache = 1; continue; }
         if (strcmp(argv[i], "--clean") == 0) { clean = 1; continue; }
+        if (strcmp(argv[i], "--server") == 0) { use_server = 1; continue; }
         if (strcmp(argv[i], "--build-timeout") == 0) {
             if (i + 1 >= argc) { fprintf(stderr, "--build-timeout requires a value\n"); return 2; }
             build_timeout_sec = atoi(argv[++i]);
@@ -609,6 +672,10 @@ int main(int argc, char** argv) {
         const char* env = getenv("CC_TEST_CLEAN");
         if (env && strcmp(env, "1") == 0) clean = 1;
     }
+    {
+        const char* env = getenv("CC_TEST_SERVER");
+        if (env && strcmp(env, "1") == 0) use_server = 1;
+    }
     {
         const char* env = getenv("CC_TEST_BUILD_TIMEOUT");
         if (env && *env) {
@@ -636,6 +703,7 @@ int main(int argc, char** argv) {
         fprintf(stderr, "cc_test: failed to open tests/\n");
         return 2;
     }
+    pid_t server_pid = (use_server && !list_only) ? start_compile_server(verbose) : -1;
 
     int ran = 0;
     int failed = 0;
@@ -660,6 +728,13 @@ int main(int argc, char** argv) {
                 continue;
             }
         }
+        if (test_requires_tls(stem)) {
+            const char* env = getenv("CC_ENABLE_TLS");
+            if (!(env && strcmp(env, "1") == 0)) {
+                if (verbose) fprintf(stderr, "[SKIP] %s (set CC_ENABLE_TLS=1)\n", stem);
+                continue;
+            }
+        }
 
         char path[512];
         snprintf(path, sizeof(path), "tests/%s", name);
@@ -727,6 +802,7 @@ int main(int argc, char** argv) {
     }
     free(pids);
     free(pid_names);
+    stop_compile_server(server_pid);
 
     if (list_only) return 0;
     if (ran == 0) {